@@ -0,0 +1,833 @@
+#include <benchmark/benchmark.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <thread>
+#include <vector>
+
+#include "ringbuf.hpp"
+#include "ringbuf_spsc.hpp"
+#include "ringbuf_mpsc.hpp"
+#include "ringbuf_fixed.hpp"
+#include "static_ringbuf.hpp"
+
+/*
+ * Swept parameters.
+ *
+ * Pool sizes go from L1-resident to larger than a typical last level cache.
+ */
+
+static const std::vector<int64_t> axItemSizes = { 8, 64, 512, 4096, 32768, 65536 };
+static const std::vector<int64_t> axPoolSizes = { 16 * 1024, 1024 * 1024, 64 * 1024 * 1024 };
+static const std::vector<int64_t> axFillLevels = { 0, 50, 90 };
+
+/* Space taken by an item of a ringbuf (header plus data). */
+static std::size_t getItemSpan( const std::size_t xItemSize )
+{
+	return sizeof( rbItem_t ) + xItemSize;
+}
+
+/* Item size, pool size: only pools holding at least 4 items. */
+static void itemPoolArgs( benchmark::internal::Benchmark* pxBench )
+{
+	for( int64_t xPool : axPoolSizes )
+	{
+		for( int64_t xItem : axItemSizes )
+		{
+			if( ( 4 * getItemSpan( xItem ) ) <= ( std::size_t )xPool )
+			{
+				pxBench->Args( { xItem, xPool } );
+			}
+		}
+	}
+}
+
+/* Item size, pool size, fill level [%]. */
+static void itemPoolFillArgs( benchmark::internal::Benchmark* pxBench )
+{
+	for( int64_t xPool : axPoolSizes )
+	{
+		for( int64_t xItem : axItemSizes )
+		{
+			for( int64_t xFill : axFillLevels )
+			{
+				if( ( 4 * getItemSpan( xItem ) ) <= ( std::size_t )xPool )
+				{
+					pxBench->Args( { xItem, xPool, xFill } );
+				}
+			}
+		}
+	}
+}
+
+/*
+ * Pushes items until the given percentage of the pool is used, always
+ * leaving room for one more item so that a push never evicts.
+ */
+static void fillBuffer( ringbuf& xBuf, const uint8_t* pcItem, const std::size_t xItemSize,
+                        const std::size_t xPoolSize, const std::size_t xFill )
+{
+	const std::size_t xMaxCnt = ( xPoolSize / getItemSpan( xItemSize ) ) - 2;
+	const std::size_t xCnt = std::min( xMaxCnt, ( xPoolSize * xFill ) / ( 100 * getItemSpan( xItemSize ) ) );
+
+	for( std::size_t i = 0; i < xCnt; ++i )
+	{
+		xBuf.push( pcItem, xItemSize );
+	}
+}
+
+static void setThroughput( benchmark::State& state, const std::size_t xItemSize )
+{
+	state.SetItemsProcessed( state.iterations() );
+	state.SetBytesProcessed( state.iterations() * xItemSize );
+}
+
+/* Nearest-rank percentile of the samples [ns], which get sorted. */
+static double getPercentile( std::vector<double>& xSamples, const double dPercent )
+{
+	std::size_t xRank = ( std::size_t )( ( dPercent / 100.0 ) * ( double )( xSamples.size() - 1 ) );
+
+	std::nth_element( xSamples.begin(), xSamples.begin() + xRank, xSamples.end() );
+
+	return xSamples[ xRank ];
+}
+
+static void setPercentiles( benchmark::State& state, const char* pcName, std::vector<double>& xSamples )
+{
+	if( !xSamples.empty() )
+	{
+		state.counters[ std::string( pcName ) + "_p50_ns" ] = getPercentile( xSamples, 50.0 );
+		state.counters[ std::string( pcName ) + "_p99_ns" ] = getPercentile( xSamples, 99.0 );
+		state.counters[ std::string( pcName ) + "_p999_ns" ] = getPercentile( xSamples, 99.9 );
+		state.counters[ std::string( pcName ) + "_max_ns" ] = *std::max_element( xSamples.begin(), xSamples.end() );
+	}
+}
+
+
+
+/*
+ * Push only: the buffer is always full, so every push evicts the oldest
+ * items (RB_OVERFLOW_OVERWRITE).
+ */
+static void BM_push( benchmark::State& state )
+{
+	const std::size_t xItemSize = state.range( 0 );
+	const std::size_t xPoolSize = state.range( 1 );
+
+	std::vector<uint8_t> memPool( xPoolSize );
+	std::vector<uint8_t> item( xItemSize, 0xA5 );
+
+	ringbuf testBuf( memPool.data(), xPoolSize );
+
+	for( auto _ : state )
+	{
+		benchmark::DoNotOptimize( testBuf.push( item.data(), xItemSize ) );
+	}
+
+	setThroughput( state, xItemSize );
+}
+BENCHMARK( BM_push )->Apply( itemPoolArgs );
+
+
+/*
+ * Reads every item from the tail to the head, then starts again:
+ * the whole pool is streamed through the cache.
+ */
+static void BM_getData( benchmark::State& state )
+{
+	const std::size_t xItemSize = state.range( 0 );
+	const std::size_t xPoolSize = state.range( 1 );
+
+	std::vector<uint8_t> memPool( xPoolSize );
+	std::vector<uint8_t> item( xItemSize, 0xA5 );
+	std::vector<uint8_t> dataBuf( xItemSize );
+
+	ringbuf testBuf( memPool.data(), xPoolSize );
+
+	fillBuffer( testBuf, item.data(), xItemSize, xPoolSize, 100 );
+
+	const rbItem_t* pxItem = testBuf.getTail();
+
+	for( auto _ : state )
+	{
+		testBuf.getData( pxItem, dataBuf.data() );
+		benchmark::DoNotOptimize( dataBuf.data() );
+
+		pxItem = ( pxItem == testBuf.getHead() ) ? testBuf.getTail() : testBuf.getNext( pxItem );
+	}
+
+	setThroughput( state, xItemSize );
+}
+BENCHMARK( BM_getData )->Apply( itemPoolArgs );
+
+
+/*
+ * Queue usage at a steady fill level: push at the head, read and delete
+ * the tail.
+ */
+static void BM_push_getData_deleteTail( benchmark::State& state )
+{
+	const std::size_t xItemSize = state.range( 0 );
+	const std::size_t xPoolSize = state.range( 1 );
+	const std::size_t xFill = state.range( 2 );
+
+	std::vector<uint8_t> memPool( xPoolSize );
+	std::vector<uint8_t> item( xItemSize, 0xA5 );
+	std::vector<uint8_t> dataBuf( xItemSize );
+
+	ringbuf testBuf( memPool.data(), xPoolSize );
+
+	fillBuffer( testBuf, item.data(), xItemSize, xPoolSize, xFill );
+
+	for( auto _ : state )
+	{
+		testBuf.push( item.data(), xItemSize );
+		testBuf.getData( testBuf.getTail(), dataBuf.data() );
+		benchmark::DoNotOptimize( dataBuf.data() );
+		testBuf.deleteTail();
+	}
+
+	setThroughput( state, xItemSize );
+}
+BENCHMARK( BM_push_getData_deleteTail )->Apply( itemPoolFillArgs );
+
+
+/*
+ * Same as above, timing every call on its own to report latency
+ * percentiles. Includes the overhead of reading the clock.
+ */
+static void BM_latency( benchmark::State& state )
+{
+	typedef std::chrono::steady_clock clock;
+
+	const std::size_t xItemSize = state.range( 0 );
+	const std::size_t xPoolSize = state.range( 1 );
+	const std::size_t xFill = state.range( 2 );
+
+	std::vector<uint8_t> memPool( xPoolSize );
+	std::vector<uint8_t> item( xItemSize, 0xA5 );
+	std::vector<uint8_t> dataBuf( xItemSize );
+
+	std::vector<double> xPushNs;
+	std::vector<double> xGetNs;
+	std::vector<double> xDeleteNs;
+
+	ringbuf testBuf( memPool.data(), xPoolSize );
+
+	fillBuffer( testBuf, item.data(), xItemSize, xPoolSize, xFill );
+
+	for( auto _ : state )
+	{
+		const clock::time_point xT0 = clock::now();
+		testBuf.push( item.data(), xItemSize );
+		const clock::time_point xT1 = clock::now();
+		testBuf.getData( testBuf.getTail(), dataBuf.data() );
+		const clock::time_point xT2 = clock::now();
+		testBuf.deleteTail();
+		const clock::time_point xT3 = clock::now();
+
+		benchmark::DoNotOptimize( dataBuf.data() );
+
+		xPushNs.push_back( std::chrono::duration<double, std::nano>( xT1 - xT0 ).count() );
+		xGetNs.push_back( std::chrono::duration<double, std::nano>( xT2 - xT1 ).count() );
+		xDeleteNs.push_back( std::chrono::duration<double, std::nano>( xT3 - xT2 ).count() );
+	}
+
+	setThroughput( state, xItemSize );
+
+	setPercentiles( state, "push", xPushNs );
+	setPercentiles( state, "getData", xGetNs );
+	setPercentiles( state, "deleteTail", xDeleteNs );
+}
+BENCHMARK( BM_latency )->Apply( itemPoolFillArgs );
+
+
+/*
+ * Wrap-heavy pattern: the pool holds 2.5 items, so every other item
+ * rolls over the end of the pool. Compares the item layouts.
+ */
+static void BM_wrap( benchmark::State& state )
+{
+	const std::size_t xItemSize = state.range( 0 );
+	const rbLayout_t eLayout = ( rbLayout_t )state.range( 1 );
+
+	std::size_t xPoolSize = ( 5 * getItemSpan( xItemSize ) ) / 2;
+
+	std::vector<uint8_t> memPool;
+	std::vector<uint8_t> item( xItemSize, 0xA5 );
+	std::vector<uint8_t> dataBuf( xItemSize );
+
+	uint8_t* pcPool = nullptr;
+
+	if( eLayout == RB_LAYOUT_MIRRORED )
+	{
+		pcPool = ringbuf::mapMirroredPool( &xPoolSize );
+	}
+	else
+	{
+		memPool.resize( xPoolSize );
+		pcPool = memPool.data();
+	}
+
+	if( pcPool == nullptr )
+	{
+		state.SkipWithError( "Mirrored pool not available." );
+	}
+	else
+	{
+		ringbuf testBuf( pcPool, xPoolSize, eLayout );
+
+		rbConstSpan_t axSpans[ 2 ];
+
+		for( auto _ : state )
+		{
+			testBuf.push( item.data(), xItemSize );
+			testBuf.peek( testBuf.getTail(), axSpans );
+			benchmark::DoNotOptimize( axSpans );
+			testBuf.getData( testBuf.getTail(), dataBuf.data() );
+			benchmark::DoNotOptimize( dataBuf.data() );
+			testBuf.deleteTail();
+		}
+
+		setThroughput( state, xItemSize );
+
+		if( eLayout == RB_LAYOUT_MIRRORED )
+		{
+			ringbuf::unmapMirroredPool( pcPool, xPoolSize );
+		}
+	}
+}
+BENCHMARK( BM_wrap )->ArgsProduct( { axItemSizes, { RB_LAYOUT_SPLIT, RB_LAYOUT_CONTIGUOUS, RB_LAYOUT_MIRRORED } } );
+
+
+/*
+ * scan() of a full buffer for a pattern found in no item: every byte of
+ * item data is searched. The items hold random bytes, or random lowercase
+ * words where the first byte of the pattern is frequent. Build with -mavx2
+ * to measure the AVX2 kernel, with -U__SSE2__ the scalar one.
+ */
+static bool countScanMatch( const rbItem_t* pxItem, void* pvContext )
+{
+	( void )pxItem;
+
+	++*( std::size_t* )pvContext;
+
+	return true;
+}
+
+static void BM_scan( benchmark::State& state )
+{
+	const std::size_t xItemSize = state.range( 0 );
+	const std::size_t xPoolSize = state.range( 1 );
+	const bool isText = ( state.range( 2 ) != 0 );
+
+	std::vector<uint8_t> memPool( xPoolSize );
+	std::vector<uint8_t> item( xItemSize );
+	const uint8_t pattern[ 8 ] = { 'n', 'o', 't', ' ', 'h', 'e', 'r', 'e' };
+
+	ringbuf testBuf( memPool.data(), xPoolSize );
+
+	/* Fill the whole pool with pseudo-random data. */
+	uint32_t ulRand = 1;
+
+	for( std::size_t i = 0; i < xItemSize; ++i )
+	{
+		ulRand = ( ulRand * 1103515245U ) + 12345U;
+
+		if( isText )
+		{
+			const uint8_t cLetter = ( uint8_t )( ( ulRand >> 16 ) % 27 );
+
+			item[ i ] = ( cLetter == 26 ) ? ' ' : ( uint8_t )( 'a' + cLetter );
+		}
+		else
+		{
+			item[ i ] = ( uint8_t )( ulRand >> 16 );
+		}
+	}
+
+	while( testBuf.getStats().xEvictedItems == 0 )
+	{
+		testBuf.push( item.data(), xItemSize );
+	}
+
+	std::size_t xMatchCnt = 0;
+
+	for( auto _ : state )
+	{
+		benchmark::DoNotOptimize( testBuf.scan( pattern, sizeof( pattern ), countScanMatch, &xMatchCnt ) );
+	}
+
+	state.SetItemsProcessed( state.iterations() * testBuf.getItemsCnt() );
+	state.SetBytesProcessed( state.iterations() * testBuf.getItemsCnt() * xItemSize );
+}
+BENCHMARK( BM_scan )->ArgsProduct( { { 64, 512, 4096 }, axPoolSizes, { 0, 1 } } );
+
+
+/*
+ * Log records stored raw or compressed (setCompression()) in a 1 MB pool:
+ * push() of records cut from a stream of log lines, and getData() of the
+ * records retained. The "retained" counter is the number of records the
+ * full pool holds.
+ */
+static void fillLogText( std::vector<char>& xText )
+{
+	uint32_t ulRand = 1;
+	char acLine[ 160 ];
+
+	while( xText.size() < ( 256 * 1024 ) )
+	{
+		ulRand = ( ulRand * 1103515245U ) + 12345U;
+
+		const uint32_t ulValue = ulRand >> 8;
+		const int iLineSize = snprintf( acLine, sizeof( acLine ),
+		                                "2026-10-17T12:%02u:%02u.%06uZ INFO  sensor[%u] temperature=%u.%u humidity=%u%% status=ok\n",
+		                                ( ulValue >> 20 ) % 60, ( ulValue >> 14 ) % 60, ulValue % 1000000, ( ulValue >> 4 ) % 32,
+		                                15 + ( ulValue % 20 ), ( ulValue >> 3 ) % 10, 30 + ( ( ulValue >> 6 ) % 40 ) );
+
+		xText.insert( xText.end(), acLine, acLine + iLineSize );
+	}
+}
+
+static void BM_compress_push( benchmark::State& state )
+{
+	const std::size_t xItemSize = state.range( 0 );
+	const bool isCompressed = ( state.range( 1 ) != 0 );
+	const std::size_t xPoolSize = 1024 * 1024;
+
+	std::vector<uint8_t> memPool( xPoolSize );
+	std::vector<uint8_t> codecBuf( RB_CODEC_BUF_SIZE( xItemSize ) );
+	std::vector<char> logText;
+
+	fillLogText( logText );
+
+	ringbuf testBuf( memPool.data(), xPoolSize );
+
+	if( isCompressed )
+	{
+		testBuf.setCompression( codecBuf.data(), codecBuf.size() );
+	}
+
+	std::size_t xOffset = 0;
+
+	for( auto _ : state )
+	{
+		benchmark::DoNotOptimize( testBuf.push( &logText[ xOffset ], xItemSize ) );
+
+		xOffset = ( xOffset + xItemSize ) % ( logText.size() - xItemSize );
+	}
+
+	setThroughput( state, xItemSize );
+	state.counters[ "retained" ] = testBuf.getItemsCnt();
+}
+BENCHMARK( BM_compress_push )->ArgsProduct( { { 128, 512, 2048 }, { 0, 1 } } );
+
+static void BM_compress_getData( benchmark::State& state )
+{
+	const std::size_t xItemSize = state.range( 0 );
+	const bool isCompressed = ( state.range( 1 ) != 0 );
+	const std::size_t xPoolSize = 1024 * 1024;
+
+	std::vector<uint8_t> memPool( xPoolSize );
+	std::vector<uint8_t> codecBuf( RB_CODEC_BUF_SIZE( xItemSize ) );
+	std::vector<uint8_t> dataBuf( xItemSize );
+	std::vector<char> logText;
+
+	fillLogText( logText );
+
+	ringbuf testBuf( memPool.data(), xPoolSize );
+
+	if( isCompressed )
+	{
+		testBuf.setCompression( codecBuf.data(), codecBuf.size() );
+	}
+
+	for( std::size_t xOffset = 0; testBuf.getStats().xEvictedItems == 0; xOffset = ( xOffset + xItemSize ) % ( logText.size() - xItemSize ) )
+	{
+		testBuf.push( &logText[ xOffset ], xItemSize );
+	}
+
+	const rbItem_t* pxItem = testBuf.getTail();
+
+	for( auto _ : state )
+	{
+		benchmark::DoNotOptimize( testBuf.getData( pxItem, dataBuf.data() ) );
+
+		pxItem = ( pxItem == testBuf.getHead() ) ? testBuf.getTail() : testBuf.getNext( pxItem );
+	}
+
+	setThroughput( state, xItemSize );
+	state.counters[ "retained" ] = testBuf.getItemsCnt();
+}
+BENCHMARK( BM_compress_getData )->ArgsProduct( { { 128, 512, 2048 }, { 0, 1 } } );
+
+
+/*
+ * Sensor samples stored raw (push()) or as deltas (pushDelta(), a keyframe
+ * every 32 samples) in a 1 MB pool: insertion of a slowly changing stream,
+ * and getSamples() of runs of 64 samples retained. The "retained" counter
+ * is the number of samples the full pool holds.
+ */
+struct benchSample {
+	int64_t llTime;             /* [ns] */
+	double dTemperature;        /* 1/16 degree steps of the sensor. */
+	double dPressure;           /* [hPa] with one decimal. */
+	int32_t lAdc;
+	int32_t lStatus;
+};
+
+static const rbField_t axBenchFields[] = { RB_FIELD_INT64, RB_FIELD_DOUBLE, RB_FIELD_DOUBLE, RB_FIELD_INT32, RB_FIELD_INT32 };
+
+static constexpr std::size_t xBenchFieldsCnt = sizeof( axBenchFields ) / sizeof( axBenchFields[ 0 ] );
+
+static void nextSample( benchSample* pxSample, uint32_t* pulRand )
+{
+	*pulRand = ( *pulRand * 1103515245U ) + 12345U;
+
+	const uint32_t ulValue = *pulRand >> 8;
+
+	pxSample->llTime += 1000000 + ( ulValue % 64 );
+	pxSample->dTemperature = 0.0625 * ( 336 + ( ( ulValue >> 6 ) % 4 ) );
+	pxSample->dPressure = ( ( ( ulValue >> 8 ) % 8 ) == 0 ) ? ( 1013.0 + ( 0.1 * ( ( ulValue >> 11 ) % 10 ) ) ) : pxSample->dPressure;
+	pxSample->lAdc += ( int32_t )( ( ulValue >> 14 ) % 33 ) - 16;
+}
+
+static void BM_delta_push( benchmark::State& state )
+{
+	const bool isDelta = ( state.range( 0 ) != 0 );
+	const std::size_t xPoolSize = 1024 * 1024;
+
+	std::vector<uint8_t> memPool( xPoolSize );
+	std::vector<uint8_t> deltaBuf( RB_DELTA_BUF_SIZE( xBenchFieldsCnt ) );
+
+	ringbuf testBuf( memPool.data(), xPoolSize );
+
+	testBuf.setDelta( axBenchFields, xBenchFieldsCnt, 32, deltaBuf.data(), deltaBuf.size() );
+
+	benchSample xSample = { 0, 21.0, 1013.0, 2048, 1 };
+	uint32_t ulRand = 1;
+
+	for( auto _ : state )
+	{
+		nextSample( &xSample, &ulRand );
+
+		benchmark::DoNotOptimize( isDelta ? testBuf.pushDelta( &xSample ) : testBuf.push( &xSample, sizeof( xSample ) ) );
+	}
+
+	setThroughput( state, sizeof( benchSample ) );
+	state.counters[ "retained" ] = testBuf.getItemsCnt();
+}
+BENCHMARK( BM_delta_push )->Arg( 0 )->Arg( 1 );
+
+static void BM_delta_getSamples( benchmark::State& state )
+{
+	const bool isDelta = ( state.range( 0 ) != 0 );
+	const std::size_t xPoolSize = 1024 * 1024;
+	const std::size_t xRunCnt = 64;
+
+	std::vector<uint8_t> memPool( xPoolSize );
+	std::vector<uint8_t> deltaBuf( RB_DELTA_BUF_SIZE( xBenchFieldsCnt ) );
+	std::vector<benchSample> dataBuf( xRunCnt );
+	std::vector<uint32_t> indexBuf( 64 * 1024 );
+
+	ringbuf testBuf( memPool.data(), xPoolSize );
+
+	testBuf.setDelta( axBenchFields, xBenchFieldsCnt, 32, deltaBuf.data(), deltaBuf.size() );
+	testBuf.setIndex( indexBuf.data(), indexBuf.size() );
+
+	benchSample xSample = { 0, 21.0, 1013.0, 2048, 1 };
+	uint32_t ulRand = 1;
+
+	while( testBuf.getStats().xEvictedItems == 0 )
+	{
+		nextSample( &xSample, &ulRand );
+
+		isDelta ? testBuf.pushDelta( &xSample ) : testBuf.push( &xSample, sizeof( xSample ) );
+	}
+
+	/* Runs start anywhere, usually in the middle of a keyframe interval. */
+	std::size_t xItemIdx = 0;
+
+	for( auto _ : state )
+	{
+		benchmark::DoNotOptimize( testBuf.getSamples( testBuf.getItem( xItemIdx ), xRunCnt, ( uint8_t* )dataBuf.data() ) );
+
+		xItemIdx = ( xItemIdx + 1000 ) % ( testBuf.getItemsCnt() - xRunCnt );
+	}
+
+	state.SetItemsProcessed( state.iterations() * xRunCnt );
+	state.SetBytesProcessed( state.iterations() * xRunCnt * sizeof( benchSample ) );
+	state.counters[ "retained" ] = testBuf.getItemsCnt();
+}
+BENCHMARK( BM_delta_getSamples )->Arg( 0 )->Arg( 1 );
+
+
+/*
+ * ringbuf_spsc used from a single thread, at a steady fill level.
+ */
+static void BM_spsc_push_getData_deleteTail( benchmark::State& state )
+{
+	const std::size_t xItemSize = state.range( 0 );
+	const std::size_t xPoolSize = state.range( 1 );
+	const std::size_t xFill = state.range( 2 );
+
+	std::vector<uint8_t> memPool( xPoolSize );
+	std::vector<uint8_t> item( xItemSize, 0xA5 );
+	std::vector<uint8_t> dataBuf( xItemSize );
+
+	ringbuf_spsc testBuf( memPool.data(), xPoolSize );
+
+	const std::size_t xItemSpan = sizeof( rbSpscItem_t ) + xItemSize;
+	const std::size_t xCnt = std::min( ( xPoolSize / xItemSpan ) - 2, ( xPoolSize * xFill ) / ( 100 * xItemSpan ) );
+
+	for( std::size_t i = 0; i < xCnt; ++i )
+	{
+		testBuf.push( item.data(), xItemSize );
+	}
+
+	for( auto _ : state )
+	{
+		testBuf.push( item.data(), xItemSize );
+		testBuf.getData( dataBuf.data() );
+		benchmark::DoNotOptimize( dataBuf.data() );
+		testBuf.deleteTail();
+	}
+
+	setThroughput( state, xItemSize );
+}
+BENCHMARK( BM_spsc_push_getData_deleteTail )->Apply( itemPoolFillArgs );
+
+
+/*
+ * ringbuf_fixed with the item size known at compile time, to compare
+ * with BM_push_getData_deleteTail at the same item sizes.
+ */
+template< std::size_t N >
+struct fixedItem {
+	uint8_t data[ N ];
+};
+
+/* Pool size, fill level [%]. */
+static void poolFillArgs( benchmark::internal::Benchmark* pxBench )
+{
+	for( int64_t xPool : axPoolSizes )
+	{
+		for( int64_t xFill : axFillLevels )
+		{
+			pxBench->Args( { xPool, xFill } );
+		}
+	}
+}
+
+template< std::size_t N >
+static void BM_fixed_push_getData_deleteTail( benchmark::State& state )
+{
+	const std::size_t xPoolSize = state.range( 0 );
+	const std::size_t xFill = state.range( 1 );
+
+	std::vector<fixedItem<N>> memPool( xPoolSize / N );
+	fixedItem<N> item = fixedItem<N>();
+	fixedItem<N> dataBuf = fixedItem<N>();
+
+	std::memset( item.data, 0xA5, N );
+
+	ringbuf_fixed<fixedItem<N>> testBuf( ( uint8_t* )memPool.data(), memPool.size() * N );
+
+	const std::size_t xCnt = std::min( testBuf.getCapacity() - 1, ( testBuf.getCapacity() * xFill ) / 100 );
+
+	for( std::size_t i = 0; i < xCnt; ++i )
+	{
+		testBuf.push( item );
+	}
+
+	for( auto _ : state )
+	{
+		testBuf.push( item );
+		testBuf.getData( testBuf.getTail(), dataBuf.data );
+		benchmark::DoNotOptimize( dataBuf.data );
+		testBuf.deleteTail();
+	}
+
+	setThroughput( state, N );
+}
+BENCHMARK_TEMPLATE( BM_fixed_push_getData_deleteTail, 8 )->Apply( poolFillArgs );
+BENCHMARK_TEMPLATE( BM_fixed_push_getData_deleteTail, 64 )->Apply( poolFillArgs );
+BENCHMARK_TEMPLATE( BM_fixed_push_getData_deleteTail, 512 )->Apply( poolFillArgs );
+
+
+/*
+ * static_ringbuf with an L1-resident storage of compile-time size, to
+ * compare with BM_push_getData_deleteTail for the 16 KB pool.
+ */
+static void BM_static_push_getData_deleteTail( benchmark::State& state )
+{
+	const std::size_t xItemSize = state.range( 0 );
+	const std::size_t xFill = state.range( 1 );
+
+	static static_ringbuf<16 * 1024> testBuf;
+
+	std::vector<uint8_t> item( xItemSize, 0xA5 );
+	std::vector<uint8_t> dataBuf( xItemSize );
+
+	const std::size_t xItemSpan = sizeof( std::size_t ) + xItemSize;
+	const std::size_t xCnt = std::min( ( testBuf.getCapacity() / xItemSpan ) - 2, ( testBuf.getCapacity() * xFill ) / ( 100 * xItemSpan ) );
+
+	testBuf.flush();
+
+	for( std::size_t i = 0; i < xCnt; ++i )
+	{
+		testBuf.push( item.data(), xItemSize );
+	}
+
+	for( auto _ : state )
+	{
+		testBuf.push( item.data(), xItemSize );
+		testBuf.getData( dataBuf.data() );
+		benchmark::DoNotOptimize( dataBuf.data() );
+		testBuf.deleteTail();
+	}
+
+	setThroughput( state, xItemSize );
+}
+BENCHMARK( BM_static_push_getData_deleteTail )->ArgsProduct( { { 8, 64, 512 }, axFillLevels } );
+
+
+/*
+ * ringbuf_spsc with a producer thread and a consumer thread: both run
+ * the same number of iterations, waiting for each other when the buffer
+ * is full or empty.
+ */
+static void BM_spsc_threads( benchmark::State& state )
+{
+	constexpr std::size_t xPoolSize = 64 * 1024;
+
+	static uint8_t memPool[ xPoolSize ];
+	static ringbuf_spsc testBuf( memPool, xPoolSize );
+
+	const std::size_t xItemSize = state.range( 0 );
+
+	std::vector<uint8_t> item( xItemSize, 0xA5 );
+
+	if( state.thread_index() == 0 )
+	{
+		for( auto _ : state )
+		{
+			while( !testBuf.push( item.data(), xItemSize ) )
+			{
+				std::this_thread::yield();
+			}
+		}
+	}
+	else
+	{
+		for( auto _ : state )
+		{
+			while( !testBuf.getData( item.data() ) )
+			{
+				std::this_thread::yield();
+			}
+
+			testBuf.deleteTail();
+		}
+	}
+
+	setThroughput( state, xItemSize );
+}
+BENCHMARK( BM_spsc_threads )->Arg( 8 )->Arg( 64 )->Arg( 512 )->Arg( 4096 )->Threads( 2 )->UseRealTime();
+
+
+/*
+ * Same as BM_spsc_threads, with both sides sleeping in waitForSpace() and
+ * waitForData() instead of yielding in a loop.
+ */
+static void BM_spsc_wait_threads( benchmark::State& state )
+{
+	constexpr std::size_t xPoolSize = 64 * 1024;
+
+	static uint8_t memPool[ xPoolSize ];
+	static ringbuf_spsc testBuf( memPool, xPoolSize );
+
+	const std::size_t xItemSize = state.range( 0 );
+
+	std::vector<uint8_t> item( xItemSize, 0xA5 );
+
+	if( state.thread_index() == 0 )
+	{
+		for( auto _ : state )
+		{
+			while( !testBuf.waitForSpace( xItemSize, 1000000U ) )
+			{
+			}
+
+			testBuf.push( item.data(), xItemSize );
+		}
+	}
+	else
+	{
+		for( auto _ : state )
+		{
+			while( !testBuf.waitForData( 1000000U ) )
+			{
+			}
+
+			testBuf.getData( item.data() );
+			testBuf.deleteTail();
+		}
+	}
+
+	setThroughput( state, xItemSize );
+}
+BENCHMARK( BM_spsc_wait_threads )->Arg( 8 )->Arg( 64 )->Arg( 512 )->Arg( 4096 )->Threads( 2 )->UseRealTime();
+
+
+/*
+ * ringbuf_mpsc with several producer threads and one consumer thread:
+ * the consumer (thread 0) takes the items of all the producers.
+ */
+static void BM_mpsc_threads( benchmark::State& state )
+{
+	constexpr std::size_t xPoolSize = 64 * 1024;
+
+	static uint8_t memPool[ xPoolSize ];
+	static ringbuf_mpsc testBuf( memPool, xPoolSize );
+
+	const std::size_t xItemSize = state.range( 0 );
+	const std::size_t xProducersCnt = state.threads() - 1;
+
+	std::vector<uint8_t> item( xItemSize, 0xA5 );
+
+	if( state.thread_index() == 0 )
+	{
+		for( auto _ : state )
+		{
+			for( std::size_t i = 0; i < xProducersCnt; ++i )
+			{
+				while( !testBuf.getData( item.data() ) )
+				{
+					std::this_thread::yield();
+				}
+
+				testBuf.deleteTail();
+			}
+		}
+
+		state.SetItemsProcessed( state.iterations() * xProducersCnt );
+		state.SetBytesProcessed( state.iterations() * xProducersCnt * xItemSize );
+	}
+	else
+	{
+		for( auto _ : state )
+		{
+			while( !testBuf.push( item.data(), xItemSize ) )
+			{
+				std::this_thread::yield();
+			}
+		}
+	}
+}
+BENCHMARK( BM_mpsc_threads )->Arg( 8 )->Arg( 64 )->Arg( 512 )->ThreadRange( 2, 16 )->UseRealTime();
+
+
+BENCHMARK_MAIN();
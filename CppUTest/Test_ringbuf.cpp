@@ -1,7 +1,15 @@
 #include "CppUTest/TestHarness.h"
 
 #include <iostream>
+#include <algorithm>
+#include <atomic>
 #include <cstring>
+#include <thread>
+
+#if defined( __linux__ )
+#include <cstdlib>
+#include <unistd.h>
+#endif
 
 extern "C"
 {
@@ -209,7 +217,7 @@ TEST( ringbuf, push_2_items_rollover)
 	*
 	*/
 
-	constexpr uint32_t mem_pool_size = 54U;
+	constexpr uint32_t mem_pool_size = 2 * sizeof( rbItem_t ) + 6;
 	
 	uint8_t memPool[ mem_pool_size ]; 
 	
@@ -249,7 +257,7 @@ TEST( ringbuf, push_3_items)
 	*
 	*/
 
-	constexpr uint32_t mem_pool_size = 94;
+	constexpr uint32_t mem_pool_size = 3 * sizeof( rbItem_t ) + 22;
 
 	uint8_t memPool[ mem_pool_size ]; 
 	
@@ -289,7 +297,7 @@ TEST( ringbuf, push_3_items_rollover)
 	*
 	*/
 
-	constexpr uint32_t mem_pool_size = 86U;
+	constexpr uint32_t mem_pool_size = 3 * sizeof( rbItem_t ) + 14;
 
 	uint8_t memPool[ mem_pool_size ]; 
 	
@@ -329,7 +337,7 @@ TEST( ringbuf, push_4_items)
 	*
 	*/
 	
-	constexpr uint32_t mem_pool_size = 100;
+	constexpr uint32_t mem_pool_size = 3 * sizeof( rbItem_t ) + 28;
 	
 	uint8_t memPool[ mem_pool_size ]; 
 	
@@ -382,13 +390,13 @@ TEST( ringbuf, push_5_items)
 	*
 	*/
 	
-	constexpr uint32_t mem_pool_size = 100;
+	constexpr uint32_t mem_pool_size = 3 * sizeof( rbItem_t ) + 28;
 	
 	uint8_t memPool[ mem_pool_size ]; 
 	
 	ringbuf testBuf( memPool, mem_pool_size );
 	
-	constexpr uint32_t buf5_size = 70;
+	constexpr uint32_t buf5_size = 2 * sizeof( rbItem_t ) + 22;
 
 	uint8_t testItem1[ ] = { 1, 2, 3, 4, 5, 6, 7, 8};
 	uint8_t testItem2[ ] = { 11, 12, 13, 14, 15, 16, 17, 18, 19, 20};
@@ -426,7 +434,7 @@ TEST( ringbuf, roll_over_items)
 	*
 	*/
 	
-	constexpr uint32_t mem_pool_size = 100;
+	constexpr uint32_t mem_pool_size = 2 * sizeof( rbItem_t ) + 52;
 	
 	uint8_t memPool[ mem_pool_size ]; 
 	
@@ -505,9 +513,9 @@ TEST( ringbuf, flush )
 
 	CHECK_TRUE( testRBuf.getTail() == testRBuf.getHead() );
 
-	CHECK_TRUE( testRBuf.getTail()->pxNext == testRBuf.getHead()->pxPrev );
+	CHECK_TRUE( testRBuf.getNext( testRBuf.getTail() ) == testRBuf.getPrev( testRBuf.getHead() ) );
 
-	CHECK_TRUE( testRBuf.getTail()->pxPrev == testRBuf.getHead()->pxNext );
+	CHECK_TRUE( testRBuf.getPrev( testRBuf.getTail() ) == testRBuf.getNext( testRBuf.getHead() ) );
 }
 
 
@@ -518,7 +526,7 @@ TEST( ringbuf, get_head_tail )
 	*
 	*/
 	
-	constexpr uint32_t mem_pool_size = 82;
+	constexpr uint32_t mem_pool_size = 3 * sizeof( rbItem_t ) + 10;
 	
 	uint8_t memPool[ mem_pool_size ]; 
 	
@@ -545,27 +553,28 @@ TEST( ringbuf, get_head_tail )
 	/* Check head. */
 	const rbItem_t* pHead = testBuf.getHead();
 	CHECK_EQUAL( sizeof( testItem3 ), pHead->xItemSize );
-	CHECK_EQUAL( sizeof( testItem2 ), pHead->pxPrev->xItemSize );
+	CHECK_EQUAL( sizeof( testItem2 ), testBuf.getPrev( pHead )->xItemSize );
 
 	/* Check tail. */
 	const rbItem_t* pTail = testBuf.getTail();
 	CHECK_EQUAL( sizeof( testItem1 ), pTail->xItemSize);
-	CHECK_EQUAL( sizeof( testItem2 ), pTail->pxNext->xItemSize );
+	CHECK_EQUAL( sizeof( testItem2 ), testBuf.getNext( pTail )->xItemSize );
 
 	/* Prev pointer checks. */
-	CHECK_TRUE( ( pHead->pxPrev == pTail->pxNext ) );
-	CHECK_TRUE( ( pHead->pxPrev->pxPrev == pTail ) );
-	CHECK_TRUE( ( pHead->pxPrev->pxPrev->pxPrev == pTail ) );
-	CHECK_TRUE( ( pHead->pxPrev->pxPrev->pxPrev == pTail->pxPrev ) );
+	CHECK_TRUE( ( testBuf.getPrev( pHead ) == testBuf.getNext( pTail ) ) );
+	CHECK_TRUE( ( testBuf.getPrev( testBuf.getPrev( pHead ) ) == pTail ) );
+	CHECK_TRUE( ( testBuf.getPrev( testBuf.getPrev( testBuf.getPrev( pHead ) ) ) == pTail ) );
+	CHECK_TRUE( ( testBuf.getPrev( testBuf.getPrev( testBuf.getPrev( pHead ) ) ) == testBuf.getPrev( pTail ) ) );
 
 	/* Next pointer checks. */
-	CHECK_TRUE( ( pHead->pxPrev == pTail->pxNext ) );
-	CHECK_TRUE( ( pTail->pxNext->pxNext == pHead ) );
-	CHECK_TRUE( ( pTail->pxNext->pxNext->pxNext == pHead ) );
-	CHECK_TRUE( ( pTail->pxNext->pxNext->pxNext == pHead->pxNext ) );
+	CHECK_TRUE( ( testBuf.getPrev( pHead ) == testBuf.getNext( pTail ) ) );
+	CHECK_TRUE( ( testBuf.getNext( testBuf.getNext( pTail ) ) == pHead ) );
+	CHECK_TRUE( ( testBuf.getNext( testBuf.getNext( testBuf.getNext( pTail ) ) ) == pHead ) );
+	CHECK_TRUE( ( testBuf.getNext( testBuf.getNext( testBuf.getNext( pTail ) ) ) == testBuf.getNext( pHead ) ) );
 }
 
 
+
 TEST( ringbuf, getDataEmpty )
 {
 	/*
@@ -641,7 +650,7 @@ TEST( ringbuf, getData_2 )
 	*/
 	
 
-	constexpr uint32_t mem_pool_size = 128;
+	constexpr uint32_t mem_pool_size = 4 * sizeof( rbItem_t ) + 32;
 	
 	uint8_t memPool[ mem_pool_size ]; 
 	
@@ -676,7 +685,7 @@ TEST( ringbuf, getData_2 )
 	CHECK_EQUAL( 0, memcmp( testItem4, dataBuf4, sizeof( testItem4 ) ) );
 
 	/* Get Head->pxPrev data. */
-	testBuf.getData( pHead->pxPrev, dataBuf3 );
+	testBuf.getData( testBuf.getPrev( pHead ), dataBuf3 );
 
 	CHECK_EQUAL( 0, memcmp( testItem3, dataBuf3, sizeof( testItem3 ) ) );
 
@@ -687,12 +696,13 @@ TEST( ringbuf, getData_2 )
 	CHECK_EQUAL( 0, memcmp( testItem1, dataBuf1, sizeof( testItem1 ) ) );
 
 	/* Get Tail->pxNext data. */
-	testBuf.getData( pTail->pxNext, dataBuf2 );
+	testBuf.getData( testBuf.getNext( pTail ), dataBuf2 );
 
 	CHECK_EQUAL( 0, memcmp( testItem2, dataBuf2, sizeof( testItem2 ) ) );
 }
 
 
+
 TEST( ringbuf, getData_rollover1 )
 {
 	/*
@@ -701,7 +711,7 @@ TEST( ringbuf, getData_rollover1 )
 	*/
 	
 	/* All data of 3rd item rolls-over. */
-	constexpr uint32_t mem_pool_size = 84U;
+	constexpr uint32_t mem_pool_size = 3 * sizeof( rbItem_t ) + 12;
 	
 	uint8_t memPool[ mem_pool_size ]; 
 	
@@ -748,7 +758,7 @@ TEST( ringbuf, getData_rollover2 )
 	*/
 	
 	/* Data of 3rd item partially rolls-over. */
-	constexpr uint32_t mem_pool_size = 86U;
+	constexpr uint32_t mem_pool_size = 3 * sizeof( rbItem_t ) + 14;
 	
 	uint8_t memPool[ mem_pool_size ]; 
 	
@@ -795,7 +805,7 @@ TEST( ringbuf, getData_rollover3 )
 	*/
 	
 	/* All buffer filled and then 1 item added. */
-	constexpr uint32_t mem_pool_size = 88U;
+	constexpr uint32_t mem_pool_size = 3 * sizeof( rbItem_t ) + 16;
 	
 	uint8_t memPool[ mem_pool_size ]; 
 	
@@ -862,15 +872,15 @@ TEST(ringbuf, getData_different_type )
 	*/
 
 	/* Get second item pushed. (Tail->Next)*/
-	const rbItem_t* pItem2 = myFirstRingBuf.getTail()->pxNext;
+	const rbItem_t* pItem2 = myFirstRingBuf.getNext( myFirstRingBuf.getTail() );
 
 	uint8_t rxBuf1[ sizeof( item1 ) ] = {0};
 	uint8_t rxBuf2[ sizeof( item2 ) ] = {0};
 	uint8_t rxBuf3[ sizeof( item3 ) ] = {0};
 
-	myFirstRingBuf.getData( pItem2->pxPrev, rxBuf1 );
+	myFirstRingBuf.getData( myFirstRingBuf.getPrev( pItem2 ), rxBuf1 );
 	myFirstRingBuf.getData( pItem2, rxBuf2 );
-	myFirstRingBuf.getData( pItem2->pxNext, rxBuf3 );
+	myFirstRingBuf.getData( myFirstRingBuf.getNext( pItem2 ), rxBuf3 );
 
 	CHECK_EQUAL( 7,  rxBuf2[1]  );
 
@@ -881,4 +891,2187 @@ TEST(ringbuf, getData_different_type )
 
 }
 
+
+	
+
+
+TEST( ringbuf, reserve_commit )
+{
+	/*
+	* TEST data. 
+	*
+	*/
+
+	constexpr uint32_t mem_pool_size = 128U;
+
+	uint8_t memPool[ mem_pool_size ]; 
+
+	ringbuf testBuf( memPool, mem_pool_size );
+
+	uint8_t testItem1[ ] = { 1, 2, 3, 4, 5, 6 };
+
+	uint8_t dataBuf[ 10 ] = { 0 };
+
+	rbSpan_t axSpans[ 2 ];
+
+
+	/*
+	* TEST sequence. 
+	*
+	*/
+
+	CHECK_TRUE( testBuf.reserve( sizeof( testItem1 ), axSpans ) );
+
+	/* Data does not roll over. */
+	CHECK_EQUAL( sizeof( testItem1 ), axSpans[ 0 ].xSize );
+	CHECK_EQUAL( 0, axSpans[ 1 ].xSize );
+
+	/* Nothing pushed until commit. */
+	CHECK_TRUE( testBuf.isEmpty() );
+	CHECK_FALSE( testBuf.push( testItem1, sizeof( testItem1 ) ) );
+	CHECK_FALSE( testBuf.reserve( sizeof( testItem1 ), axSpans ) );
+
+	memcpy( axSpans[ 0 ].pcData, testItem1, sizeof( testItem1 ) );
+
+	CHECK_TRUE( testBuf.commit() );
+	CHECK_FALSE( testBuf.commit() );
+
+	CHECK_EQUAL( 1, testBuf.getItemsCnt() );
+	CHECK_EQUAL( sizeof( testItem1 ), testBuf.getHeadSize() );
+
+	testBuf.getData( testBuf.getHead(), dataBuf );
+
+	CHECK_EQUAL( 0, memcmp( testItem1, dataBuf, sizeof( testItem1 ) ) );
+}
+
+
+TEST( ringbuf, reserve_rollover )
+{
+	/*
+	* TEST data. 
+	*
+	*/
+
+	/* Data of 3rd item partially rolls-over. */
+	constexpr uint32_t mem_pool_size = 3 * sizeof( rbItem_t ) + 14;
+
+	uint8_t memPool[ mem_pool_size ]; 
+
+	ringbuf testBuf( memPool, mem_pool_size );
+
+	uint8_t testItem1[ ] = { 1, 2, 3, 4, 5, 6};
+	uint8_t testItem2[ ] = { 11, 12, 13, 14, 15, 16};
+	uint8_t testItem3[ ] = { 21, 22, 23, 24, 25};
+
+	uint8_t dataHead[ 10 ] = { 0 };
+
+	rbSpan_t axSpans[ 2 ];
+
+
+	/*
+	* TEST sequence. 
+	*
+	*/
+
+	testBuf.push( testItem1, sizeof( testItem1 ) );
+	testBuf.push( testItem2, sizeof( testItem2 ) );
+
+	CHECK_TRUE( testBuf.reserve( sizeof( testItem3 ), axSpans ) );
+
+	/* Data is split in two parts. */
+	CHECK_TRUE( axSpans[ 1 ].xSize > 0 );
+	CHECK_EQUAL( sizeof( testItem3 ), axSpans[ 0 ].xSize + axSpans[ 1 ].xSize );
+	CHECK_TRUE( axSpans[ 1 ].pcData == memPool );
+
+	memcpy( axSpans[ 0 ].pcData, testItem3, axSpans[ 0 ].xSize );
+	memcpy( axSpans[ 1 ].pcData, testItem3 + axSpans[ 0 ].xSize, axSpans[ 1 ].xSize );
+
+	CHECK_TRUE( testBuf.commit() );
+
+	/* Check number of items, first element removed. */
+	CHECK_EQUAL( 2, testBuf.getItemsCnt() );
+
+	testBuf.getData( testBuf.getHead(), dataHead );
+
+	CHECK_EQUAL( 0, memcmp( testItem3, dataHead, sizeof( testItem3 ) ) );
+}
+
+
+TEST( ringbuf, reserve_abort )
+{
+	/*
+	* TEST data. 
+	*
+	*/
+
+	constexpr uint32_t mem_pool_size = 128U;
+
+	uint8_t memPool[ mem_pool_size ]; 
+
+	ringbuf testBuf( memPool, mem_pool_size );
+
+	uint8_t testItem1[ ] = { 1, 2, 3 };
+
+	rbSpan_t axSpans[ 2 ];
+
+
+	/*
+	* TEST sequence. 
+	*
+	*/
+
+	testBuf.push( testItem1, sizeof( testItem1 ) );
+
+	CHECK_TRUE( testBuf.reserve( 10, axSpans ) );
+
+	testBuf.abort();
+
+	/* Nothing to commit anymore. */
+	CHECK_FALSE( testBuf.commit() );
+	CHECK_EQUAL( 1, testBuf.getItemsCnt() );
+
+	/* Push allowed again. */
+	CHECK_TRUE( testBuf.push( testItem1, sizeof( testItem1 ) ) );
+	CHECK_EQUAL( 2, testBuf.getItemsCnt() );
+}
+
+
+TEST( ringbuf, peek_consume )
+{
+	/*
+	* TEST data. 
+	*
+	*/
+
+	/* Data of 3rd item partially rolls-over. */
+	constexpr uint32_t mem_pool_size = 3 * sizeof( rbItem_t ) + 14;
+
+	uint8_t memPool[ mem_pool_size ]; 
+
+	ringbuf testBuf( memPool, mem_pool_size );
+
+	uint8_t testItem1[ ] = { 1, 2, 3, 4, 5, 6};
+	uint8_t testItem2[ ] = { 11, 12, 13, 14, 15, 16};
+	uint8_t testItem3[ ] = { 21, 22, 23, 24, 25};
+
+	rbConstSpan_t axSpans[ 2 ];
+
+
+	/*
+	* TEST sequence. 
+	*
+	*/
+
+	/* Empty ring buf. */
+	CHECK_FALSE( testBuf.peek( testBuf.getTail(), axSpans ) );
+	CHECK_FALSE( testBuf.consume() );
+
+	testBuf.push( testItem1, sizeof( testItem1 ) );
+	testBuf.push( testItem2, sizeof( testItem2 ) );
+	testBuf.push( testItem3, sizeof( testItem3 ) );
+
+	/* Tail data is contiguous. */
+	CHECK_TRUE( testBuf.peek( testBuf.getTail(), axSpans ) );
+	CHECK_EQUAL( sizeof( testItem2 ), axSpans[ 0 ].xSize );
+	CHECK_EQUAL( 0, axSpans[ 1 ].xSize );
+	CHECK_EQUAL( 0, memcmp( testItem2, axSpans[ 0 ].pcData, sizeof( testItem2 ) ) );
+
+	/* Head data is split in two parts. */
+	CHECK_TRUE( testBuf.peek( testBuf.getHead(), axSpans ) );
+	CHECK_TRUE( axSpans[ 1 ].xSize > 0 );
+	CHECK_EQUAL( sizeof( testItem3 ), axSpans[ 0 ].xSize + axSpans[ 1 ].xSize );
+	CHECK_EQUAL( 0, memcmp( testItem3, axSpans[ 0 ].pcData, axSpans[ 0 ].xSize ) );
+	CHECK_EQUAL( 0, memcmp( testItem3 + axSpans[ 0 ].xSize, axSpans[ 1 ].pcData, axSpans[ 1 ].xSize ) );
+
+	/* Release the tail. */
+	CHECK_TRUE( testBuf.consume() );
+	CHECK_EQUAL( 1, testBuf.getItemsCnt() );
+	CHECK_EQUAL( sizeof( testItem3 ), testBuf.getTailSize() );
+}
+
+
+TEST( ringbuf, contiguous_rollover )
+{
+	/*
+	* TEST data. 
+	*
+	*/
+
+	/* Data of 3rd item would partially roll-over. */
+	constexpr uint32_t mem_pool_size = 3 * sizeof( rbItem_t ) + 14;
+
+	uint8_t memPool[ mem_pool_size ]; 
+
+	ringbuf testBuf( memPool, mem_pool_size, RB_LAYOUT_CONTIGUOUS );
+
+	uint8_t testItem1[ ] = { 1, 2, 3, 4, 5, 6};
+	uint8_t testItem2[ ] = { 11, 12, 13, 14, 15, 16};
+	uint8_t testItem3[ ] = { 21, 22, 23, 24, 25};
+
+	uint8_t dataTail[ 10 ] = { 0 };
+
+	rbConstSpan_t axSpans[ 2 ];
+
+
+	/*
+	* TEST sequence. 
+	*
+	*/
+
+	testBuf.push( testItem1, sizeof( testItem1 ) );
+	testBuf.push( testItem2, sizeof( testItem2 ) );
+	testBuf.push( testItem3, sizeof( testItem3 ) );
+
+	/* Check number of items, first element removed. */
+	CHECK_EQUAL( 2, testBuf.getItemsCnt() );
+
+	/* Head is moved to the start of the pool. */
+	CHECK_TRUE( ( const uint8_t* )testBuf.getHead() == memPool );
+	CHECK_TRUE( testBuf.getNext( testBuf.getTail() ) == testBuf.getHead() );
+
+	/* Head data is in one part. */
+	CHECK_TRUE( testBuf.peek( testBuf.getHead(), axSpans ) );
+	CHECK_EQUAL( sizeof( testItem3 ), axSpans[ 0 ].xSize );
+	CHECK_EQUAL( 0, axSpans[ 1 ].xSize );
+	CHECK_EQUAL( 0, memcmp( testItem3, axSpans[ 0 ].pcData, sizeof( testItem3 ) ) );
+
+	testBuf.getData( testBuf.getTail(), dataTail );
+
+	CHECK_EQUAL( 0, memcmp( testItem2, dataTail, sizeof( testItem2 ) ) );
+}
+
+
+TEST( ringbuf, contiguous_never_split )
+{
+	/*
+	* TEST data. 
+	*
+	*/
+
+	constexpr uint32_t mem_pool_size = 301U;
+
+	uint8_t memPool[ mem_pool_size ]; 
+
+	ringbuf testBuf( memPool, mem_pool_size, RB_LAYOUT_CONTIGUOUS );
+
+	uint8_t testItem[ 64 ];
+
+	rbConstSpan_t axSpans[ 2 ];
+
+	bool isAlwaysContiguous = true;
+
+
+	/*
+	* TEST sequence. 
+	*
+	*/
+
+	for( uint32_t i = 0; i < 1000; ++i )
+	{
+		const size_t xSize = 1 + ( ( i * 37 ) % sizeof( testItem ) );
+
+		memset( testItem, ( int )i, xSize );
+
+		CHECK_TRUE( testBuf.push( testItem, xSize ) );
+
+		testBuf.peek( testBuf.getHead(), axSpans );
+
+		isAlwaysContiguous &= ( axSpans[ 0 ].xSize == xSize );
+		isAlwaysContiguous &= ( axSpans[ 0 ].pcData + xSize <= &memPool[ mem_pool_size ] );
+		isAlwaysContiguous &= ( 0 == memcmp( testItem, axSpans[ 0 ].pcData, xSize ) );
+	}
+
+	CHECK_TRUE( isAlwaysContiguous );
+}
+
+
+#if defined( __linux__ )
+
+TEST( ringbuf, mirrored_rollover )
+{
+	/*
+	* TEST data. 
+	*
+	*/
+
+	size_t mem_pool_size = 1000U;
+
+	uint8_t* memPool = ringbuf::mapMirroredPool( &mem_pool_size );
+
+	CHECK_TRUE( memPool != nullptr );
+
+	/* Size rounded up to a page multiple. */
+	CHECK_TRUE( mem_pool_size >= 1000U );
+
+	ringbuf testBuf( memPool, mem_pool_size, RB_LAYOUT_MIRRORED );
+
+	uint8_t testItem[ 700 ];
+	uint8_t dataBuf[ 700 ];
+
+	rbConstSpan_t axSpans[ 2 ];
+
+	bool isDataOk = true;
+	bool isRolledOver = false;
+
+
+	/*
+	* TEST sequence. 
+	*
+	*/
+
+	/* Memory past the end aliases the start. */
+	memPool[ 3 ] = 0x5A;
+	CHECK_EQUAL( 0x5A, memPool[ mem_pool_size + 3 ] );
+
+	for( uint32_t i = 0; i < 200; ++i )
+	{
+		const size_t xSize = 100 + ( ( i * 97 ) % 600 );
+
+		memset( testItem, ( int )i, xSize );
+
+		CHECK_TRUE( testBuf.push( testItem, xSize ) );
+
+		/* Data is always accessed in one part. */
+		testBuf.peek( testBuf.getHead(), axSpans );
+
+		isDataOk &= ( axSpans[ 0 ].xSize == xSize ) && ( axSpans[ 1 ].xSize == 0 );
+		isDataOk &= ( 0 == memcmp( testItem, axSpans[ 0 ].pcData, xSize ) );
+
+		isRolledOver |= ( axSpans[ 0 ].pcData + xSize > &memPool[ mem_pool_size ] );
+
+		testBuf.getData( testBuf.getHead(), dataBuf );
+
+		isDataOk &= ( 0 == memcmp( testItem, dataBuf, xSize ) );
+	}
+
+	CHECK_TRUE( isDataOk );
+	CHECK_TRUE( isRolledOver );
+
+	ringbuf::unmapMirroredPool( memPool, mem_pool_size );
+}
+
+#endif
+
+
+TEST( ringbuf, get_next_prev )
+{
+	/*
+	* TEST data. 
+	*
+	*/
+	
+	constexpr uint32_t mem_pool_size = 3 * sizeof( rbItem_t ) + 10;
+	
+	uint8_t memPool[ mem_pool_size ]; 
 	
+	ringbuf testBuf( memPool, mem_pool_size );
+
+	uint8_t testItem1[  ] = {1, 2, 3, 4, 5, 6};
+	uint8_t testItem2[  ] = { 7 };
+	uint8_t testItem3[  ] = { 8, 9, 10 };
+
+	uint8_t dataBuf[ 10 ] = { 0 };
+	
+	
+	/*
+	* TEST sequence. 
+	*
+	*/
+	
+	/* Push items. */
+	testBuf.push( testItem1, sizeof( testItem1 ) );
+	testBuf.push( testItem2, sizeof( testItem2 ) );
+	testBuf.push( testItem3, sizeof( testItem3 ) );
+
+	const rbItem_t* pHead = testBuf.getHead();
+	const rbItem_t* pTail = testBuf.getTail();
+
+	/* Walk from the tail. */
+	CHECK_EQUAL( sizeof( testItem2 ), testBuf.getNext( pTail )->xItemSize );
+	CHECK_TRUE( testBuf.getNext( testBuf.getNext( pTail ) ) == pHead );
+
+	/* Walk from the head. */
+	CHECK_EQUAL( sizeof( testItem2 ), testBuf.getPrev( pHead )->xItemSize );
+	CHECK_TRUE( testBuf.getPrev( testBuf.getPrev( pHead ) ) == pTail );
+
+	/* Head and tail are linked to themselves. */
+	CHECK_TRUE( testBuf.getNext( pHead ) == pHead );
+	CHECK_TRUE( testBuf.getPrev( pTail ) == pTail );
+
+	testBuf.getData( testBuf.getNext( pTail ), dataBuf );
+
+	CHECK_EQUAL( 0, memcmp( testItem2, dataBuf, sizeof( testItem2 ) ) );
+
+#if ( RINGBUF_CFG_COMPACT_HEADER == 1 ) && ( RINGBUF_CFG_ITEM_SEQUENCE == 0 ) && ( RINGBUF_CFG_ITEM_TIMESTAMP == 0 )
+	/* Links and size take 32 bits each. */
+	CHECK_EQUAL( 12, sizeof( rbItem_t ) );
+#endif
+}
+
+
+TEST( ringbuf, push_batch )
+{
+	/*
+	* TEST data. 
+	*
+	*/
+
+	constexpr uint32_t mem_pool_size = 3 * sizeof( rbItem_t ) + 56;
+
+	uint8_t memPool[ mem_pool_size ]; 
+
+	ringbuf testBuf( memPool, mem_pool_size );
+
+	uint8_t  testItem1[ ] = { 1, 2, 3, 4, 5 };
+	uint16_t testItem2[ ] = { 101, 102, 103 };
+	uint8_t  testItem3[ ] = { 21 };
+
+	const rbConstSpan_t axBatch[ ] = { { testItem1, sizeof( testItem1 ) },
+	                                   { ( const uint8_t* )testItem2, sizeof( testItem2 ) },
+	                                   { testItem3, sizeof( testItem3 ) } };
+
+	uint8_t dataBuf[ 10 ] = { 0 };
+
+
+	/*
+	* TEST sequence. 
+	*
+	*/
+
+	/* Empty batch. */
+	CHECK_FALSE( testBuf.pushBatch( axBatch, 0 ) );
+
+	CHECK_TRUE( testBuf.pushBatch( axBatch, 3 ) );
+
+	CHECK_EQUAL( 3, testBuf.getItemsCnt() );
+	CHECK_EQUAL( sizeof( testItem1 ), testBuf.getTailSize() );
+	CHECK_EQUAL( sizeof( testItem3 ), testBuf.getHeadSize() );
+
+	/* Items are linked in order. */
+	const rbItem_t* pItem = testBuf.getNext( testBuf.getTail() );
+
+	CHECK_TRUE( testBuf.getNext( pItem ) == testBuf.getHead() );
+	CHECK_TRUE( testBuf.getPrev( pItem ) == testBuf.getTail() );
+
+	testBuf.getData( pItem, dataBuf );
+
+	CHECK_EQUAL( 0, memcmp( testItem2, dataBuf, sizeof( testItem2 ) ) );
+}
+
+
+TEST( ringbuf, push_batch_delete_tail )
+{
+	/*
+	* TEST data. 
+	*
+	*/
+
+	constexpr uint32_t mem_pool_size = 3 * sizeof( rbItem_t ) + 28;
+
+	uint8_t memPool[ mem_pool_size ]; 
+
+	ringbuf testBuf( memPool, mem_pool_size );
+
+	uint8_t testItem1[ ] = { 1, 2, 3, 4, 5, 6, 7, 8};
+	uint8_t testItem2[ ] = { 11, 12, 13, 14, 15, 16, 17, 18, 19, 20};
+	uint8_t testItem3[ ] = { 21, 22, 23, 24, 25, 26, 27, 28, 29, 30};
+
+	const rbConstSpan_t axBatch[ ] = { { testItem2, sizeof( testItem2 ) },
+	                                   { testItem3, sizeof( testItem3 ) } };
+
+	uint8_t dataHead[ 10 ] = { 0 };
+
+	uint8_t testTooBig[ 60 ];
+
+	const rbConstSpan_t axTooBig[ ] = { { testTooBig, sizeof( testTooBig ) },
+	                                    { testTooBig, sizeof( testTooBig ) } };
+
+
+	/*
+	* TEST sequence. 
+	*
+	*/
+
+	testBuf.push( testItem1, sizeof( testItem1 ) );
+	testBuf.push( testItem2, sizeof( testItem2 ) );
+
+	/* Tail items deleted to fit the whole batch. */
+	CHECK_TRUE( testBuf.pushBatch( axBatch, 2 ) );
+
+	CHECK_EQUAL( 2, testBuf.getItemsCnt() );
+	CHECK_EQUAL( sizeof( testItem2 ), testBuf.getTailSize() );
+
+	testBuf.getData( testBuf.getHead(), dataHead );
+
+	CHECK_EQUAL( 0, memcmp( testItem3, dataHead, sizeof( testItem3 ) ) );
+
+	/* Batch bigger than the buffer is rejected, nothing deleted. */
+	CHECK_FALSE( testBuf.pushBatch( axTooBig, 2 ) );
+	CHECK_EQUAL( 2, testBuf.getItemsCnt() );
+}
+
+
+/* Drain callback copying item data one after the other into the context buffer. */
+static bool drainToBuffer( const rbConstSpan_t* pxSpans, void* pvContext )
+{
+	uint8_t** ppcDst = ( uint8_t** )pvContext;
+
+	memcpy( *ppcDst, pxSpans[ 0 ].pcData, pxSpans[ 0 ].xSize );
+	memcpy( *ppcDst + pxSpans[ 0 ].xSize, pxSpans[ 1 ].pcData, pxSpans[ 1 ].xSize );
+
+	*ppcDst += pxSpans[ 0 ].xSize + pxSpans[ 1 ].xSize;
+
+	return true;
+}
+
+
+TEST( ringbuf, drain )
+{
+	/*
+	* TEST data. 
+	*
+	*/
+
+	/* Data of 3rd item partially rolls-over. */
+	constexpr uint32_t mem_pool_size = 3 * sizeof( rbItem_t ) + 14;
+
+	uint8_t memPool[ mem_pool_size ]; 
+
+	ringbuf testBuf( memPool, mem_pool_size );
+
+	uint8_t testItem1[ ] = { 1, 2, 3, 4, 5, 6};
+	uint8_t testItem2[ ] = { 11, 12, 13, 14, 15, 16};
+	uint8_t testItem3[ ] = { 21, 22, 23, 24, 25};
+
+	uint8_t dataBuf[ 20 ] = { 0 };
+	uint8_t* pcDst = dataBuf;
+
+
+	/*
+	* TEST sequence. 
+	*
+	*/
+
+	/* Empty ring buf. */
+	CHECK_EQUAL( 0, testBuf.drain( drainToBuffer, &pcDst, 10, 100 ) );
+
+	testBuf.push( testItem1, sizeof( testItem1 ) );
+	testBuf.push( testItem2, sizeof( testItem2 ) );
+	testBuf.push( testItem3, sizeof( testItem3 ) );
+
+	CHECK_EQUAL( 2, testBuf.getItemsCnt() );
+
+	/* Byte limit stops before the second item. */
+	CHECK_EQUAL( 1, testBuf.drain( drainToBuffer, &pcDst, 10, 10 ) );
+	CHECK_EQUAL( 1, testBuf.getItemsCnt() );
+	CHECK_EQUAL( sizeof( testItem3 ), testBuf.getTailSize() );
+	CHECK_TRUE( testBuf.getTail() == testBuf.getHead() );
+
+	/* Rolled over item is handed out whole. */
+	CHECK_EQUAL( 1, testBuf.drain( drainToBuffer, &pcDst, 10, 100 ) );
+	CHECK_TRUE( testBuf.isEmpty() );
+
+	CHECK_EQUAL( 0, memcmp( testItem2, dataBuf, sizeof( testItem2 ) ) );
+	CHECK_EQUAL( 0, memcmp( testItem3, dataBuf + sizeof( testItem2 ), sizeof( testItem3 ) ) );
+}
+
+
+/* Spans collected by drain() and read after it returns. */
+struct drainSpans
+{
+	rbConstSpan_t axSpans[ 4 ][ 2 ];
+	size_t xCnt;
+};
+
+static bool drainToSpans( const rbConstSpan_t* pxSpans, void* pvContext )
+{
+	drainSpans* pxDrained = ( drainSpans* )pvContext;
+
+	pxDrained->axSpans[ pxDrained->xCnt ][ 0 ] = pxSpans[ 0 ];
+	pxDrained->axSpans[ pxDrained->xCnt ][ 1 ] = pxSpans[ 1 ];
+	pxDrained->xCnt++;
+
+	return true;
+}
+
+
+TEST( ringbuf, drain_spans_valid )
+{
+	/*
+	* TEST data. 
+	*
+	*/
+
+	/* Data of 3rd item rolls over to the start of the pool. */
+	constexpr uint32_t mem_pool_size = ( 3U * sizeof( rbItem_t ) ) + 28U;
+
+	uint8_t memPool[ mem_pool_size ]; 
+
+	ringbuf testBuf( memPool, mem_pool_size );
+
+	uint8_t testItem1[ 10 ];
+	uint8_t testItem2[ 10 ];
+	uint8_t testItem3[ 30 ];
+
+	for( uint8_t i = 0; i < sizeof( testItem3 ); ++i )
+	{
+		testItem3[ i ] = 100U + i;
+	}
+
+	memset( testItem1, 1, sizeof( testItem1 ) );
+	memset( testItem2, 2, sizeof( testItem2 ) );
+
+	drainSpans xDrained = { };
+
+	uint8_t dataBuf[ 30 ] = { 0 };
+
+
+	/*
+	* TEST sequence. 
+	*
+	*/
+
+	CHECK_TRUE( testBuf.push( testItem1, sizeof( testItem1 ) ) );
+	CHECK_TRUE( testBuf.push( testItem2, sizeof( testItem2 ) ) );
+	CHECK_TRUE( testBuf.deleteTail() );
+	CHECK_TRUE( testBuf.push( testItem3, sizeof( testItem3 ) ) );
+
+	CHECK_EQUAL( 2, testBuf.getItemsCnt() );
+
+	/* All items drained, spans read once drain() returns. */
+	CHECK_EQUAL( 2, testBuf.drain( drainToSpans, &xDrained, 10, 100 ) );
+	CHECK_TRUE( testBuf.isEmpty() );
+	CHECK_EQUAL( 2, xDrained.xCnt );
+
+	CHECK_EQUAL( sizeof( testItem2 ), xDrained.axSpans[ 0 ][ 0 ].xSize );
+	CHECK_EQUAL( 0, xDrained.axSpans[ 0 ][ 1 ].xSize );
+	CHECK_EQUAL( 0, memcmp( testItem2, xDrained.axSpans[ 0 ][ 0 ].pcData, sizeof( testItem2 ) ) );
+
+	CHECK_TRUE( xDrained.axSpans[ 1 ][ 1 ].pcData == memPool );
+	CHECK_EQUAL( sizeof( testItem3 ), xDrained.axSpans[ 1 ][ 0 ].xSize + xDrained.axSpans[ 1 ][ 1 ].xSize );
+	CHECK_EQUAL( 0, memcmp( testItem3, xDrained.axSpans[ 1 ][ 0 ].pcData, xDrained.axSpans[ 1 ][ 0 ].xSize ) );
+	CHECK_EQUAL( 0, memcmp( testItem3 + xDrained.axSpans[ 1 ][ 0 ].xSize, xDrained.axSpans[ 1 ][ 1 ].pcData, xDrained.axSpans[ 1 ][ 1 ].xSize ) );
+
+	/* Emptied buffer hands out no stale item. */
+	CHECK_EQUAL( 0, testBuf.getHeadSize() );
+	CHECK_FALSE( testBuf.getData( testBuf.getHead(), dataBuf ) );
+
+	/* Next item takes the start of the pool. */
+	CHECK_TRUE( testBuf.push( testItem3, sizeof( testItem3 ) ) );
+	CHECK_EQUAL( 1, testBuf.getItemsCnt() );
+	CHECK_TRUE( testBuf.getHead() == ( const rbItem_t* )memPool );
+	CHECK_TRUE( testBuf.getData( testBuf.getHead(), dataBuf ) );
+	CHECK_EQUAL( 0, memcmp( testItem3, dataBuf, sizeof( testItem3 ) ) );
+}
+
+
+TEST( ringbuf, drain_max_items )
+{
+	/*
+	* TEST data. 
+	*
+	*/
+
+	constexpr uint32_t mem_pool_size = 256U;
+
+	uint8_t memPool[ mem_pool_size ]; 
+
+	ringbuf testBuf( memPool, mem_pool_size );
+
+	uint8_t testItem[ ] = { 1, 2, 3 };
+
+	uint8_t dataBuf[ 20 ] = { 0 };
+	uint8_t* pcDst = dataBuf;
+
+
+	/*
+	* TEST sequence. 
+	*
+	*/
+
+	for( uint8_t i = 0; i < 5; ++i )
+	{
+		testItem[ 0 ] = i;
+		testBuf.push( testItem, sizeof( testItem ) );
+	}
+
+	CHECK_EQUAL( 3, testBuf.drain( drainToBuffer, &pcDst, 3, 100 ) );
+	CHECK_EQUAL( 2, testBuf.getItemsCnt() );
+
+	/* Tail is the 4th item pushed. */
+	testBuf.getData( testBuf.getTail(), dataBuf );
+
+	CHECK_EQUAL( 3, dataBuf[ 0 ] );
+	CHECK_TRUE( testBuf.getPrev( testBuf.getTail() ) == testBuf.getTail() );
+
+	/* Callback refusing items keeps them. */
+	CHECK_EQUAL( 0, testBuf.drain( []( const rbConstSpan_t*, void* ) { return false; }, nullptr, 10, 100 ) );
+	CHECK_EQUAL( 2, testBuf.getItemsCnt() );
+}
+
+
+TEST( ringbuf, overflow_policy )
+{
+	/*
+	* TEST data. 
+	*
+	*/
+
+	constexpr uint32_t mem_pool_size = 3 * ( sizeof( rbItem_t ) + 16 ) + 8;
+
+	uint8_t memPool[ mem_pool_size ]; 
+
+	ringbuf testBuf( memPool, mem_pool_size );
+
+	uint8_t testItem[ 16 ] = { 0 };
+
+	rbConstSpan_t axItems[ 2 ] = { { testItem, sizeof( testItem ) }, { testItem, sizeof( testItem ) } };
+
+	rbConstSpan_t axTooBig[ 4 ] = { { testItem, sizeof( testItem ) }, { testItem, sizeof( testItem ) },
+	                                { testItem, sizeof( testItem ) }, { testItem, sizeof( testItem ) } };
+
+
+	/*
+	* TEST sequence. 
+	*
+	*/
+
+	/* Nothing lost yet. */
+	CHECK_EQUAL( 0, testBuf.getStats().xEvictedItems );
+	CHECK_EQUAL( 0, testBuf.getStats().xRejectedItems );
+
+	/* Producer cannot be blocked. */
+	CHECK_FALSE( testBuf.setOverflowPolicy( RB_OVERFLOW_BLOCK ) );
+	CHECK_TRUE( testBuf.setOverflowPolicy( RB_OVERFLOW_REJECT ) );
+
+	for( uint8_t i = 0; i < 3; ++i )
+	{
+		testItem[ 0 ] = i;
+		CHECK_TRUE( testBuf.push( testItem, sizeof( testItem ) ) );
+	}
+
+	/* Full: new items are refused, old ones retained. */
+	CHECK_FALSE( testBuf.push( testItem, sizeof( testItem ) ) );
+	CHECK_FALSE( testBuf.pushBatch( axItems, 2 ) );
+
+	CHECK_EQUAL( 3, testBuf.getItemsCnt() );
+	CHECK_EQUAL( 0, testBuf.getStats().xEvictedItems );
+	CHECK_EQUAL( 3, testBuf.getStats().xRejectedItems );
+	CHECK_EQUAL( 3 * sizeof( testItem ), testBuf.getStats().xRejectedBytes );
+
+	/* Back to overwrite: the oldest items make room. */
+	CHECK_TRUE( testBuf.setOverflowPolicy( RB_OVERFLOW_OVERWRITE ) );
+
+	testItem[ 0 ] = 3;
+	CHECK_TRUE( testBuf.push( testItem, sizeof( testItem ) ) );
+
+	CHECK_EQUAL( 3, testBuf.getItemsCnt() );
+	CHECK_EQUAL( 1, testBuf.getStats().xEvictedItems );
+	CHECK_EQUAL( sizeof( testItem ), testBuf.getStats().xEvictedBytes );
+	CHECK_EQUAL( 3, testBuf.getStats().xRejectedItems );
+
+	/* Batch larger than the pool is refused and counted, even when empty. */
+	testBuf.flush();
+
+	CHECK_FALSE( testBuf.pushBatch( axTooBig, 4 ) );
+	CHECK_EQUAL( 7, testBuf.getStats().xRejectedItems );
+
+	CHECK_TRUE( testBuf.setOverflowPolicy( RB_OVERFLOW_REJECT ) );
+	CHECK_FALSE( testBuf.pushBatch( axTooBig, 4 ) );
+
+	CHECK_TRUE( testBuf.isEmpty() );
+	CHECK_EQUAL( 11, testBuf.getStats().xRejectedItems );
+	CHECK_EQUAL( 11 * sizeof( testItem ), testBuf.getStats().xRejectedBytes );
+}
+
+
+TEST( ringbuf, image_recover )
+{
+	/*
+	* TEST data. 
+	*
+	*/
+
+	constexpr uint32_t image_size = sizeof( rbImage_t ) + 256U;
+
+	alignas( rbImage_t ) static uint8_t memImage[ image_size ];
+	alignas( rbImage_t ) static uint8_t memImageCopy[ image_size ];
+
+	uint8_t testItem[ 20 ];
+	uint8_t dataBuf[ 20 ];
+
+
+	/*
+	* TEST sequence. 
+	*
+	*/
+
+	ringbuf testBuf( memImage, image_size, RB_IMAGE_CREATE );
+
+	CHECK_FALSE( testBuf.isRecovered() );
+
+	/* Several laps of the pool. */
+	for( uint8_t i = 0; i < 40; ++i )
+	{
+		std::memset( testItem, i, sizeof( testItem ) );
+		CHECK_TRUE( testBuf.push( testItem, 1 + ( i % sizeof( testItem ) ) ) );
+	}
+
+	const std::size_t xItemsCnt = testBuf.getItemsCnt();
+
+	/* Crash: the image is found again at another address. */
+	std::memcpy( memImageCopy, memImage, image_size );
+
+	ringbuf recoveredBuf( memImageCopy, image_size, RB_IMAGE_RECOVER );
+
+	CHECK_TRUE( recoveredBuf.isRecovered() );
+	CHECK_EQUAL( xItemsCnt, recoveredBuf.getItemsCnt() );
+
+	const rbItem_t* pxItem = testBuf.getTail();
+	const rbItem_t* pxRecoveredItem = recoveredBuf.getTail();
+
+	for( std::size_t i = 0; i < xItemsCnt; ++i )
+	{
+		CHECK_TRUE( ( const uint8_t* )pxRecoveredItem >= memImageCopy );
+		CHECK_TRUE( ( const uint8_t* )pxRecoveredItem < ( memImageCopy + image_size ) );
+		CHECK_EQUAL( pxItem->xItemSize, pxRecoveredItem->xItemSize );
+
+		CHECK_TRUE( recoveredBuf.getData( pxRecoveredItem, dataBuf ) );
+		CHECK_TRUE( testBuf.getData( pxItem, testItem ) );
+		CHECK_EQUAL( 0, memcmp( testItem, dataBuf, pxItem->xItemSize ) );
+
+		pxItem = testBuf.getNext( pxItem );
+		pxRecoveredItem = recoveredBuf.getNext( pxRecoveredItem );
+	}
+
+	CHECK_TRUE( pxRecoveredItem == recoveredBuf.getHead() );
+
+	/* Recording goes on. */
+	std::memset( testItem, 40, sizeof( testItem ) );
+	CHECK_TRUE( recoveredBuf.push( testItem, sizeof( testItem ) ) );
+	CHECK_EQUAL( sizeof( testItem ), recoveredBuf.getHeadSize() );
+
+	/* Recovered again in place. */
+	ringbuf reopenedBuf( memImageCopy, image_size, RB_IMAGE_RECOVER );
+
+	CHECK_TRUE( reopenedBuf.isRecovered() );
+	CHECK_EQUAL( recoveredBuf.getItemsCnt(), reopenedBuf.getItemsCnt() );
+	CHECK_TRUE( reopenedBuf.getData( reopenedBuf.getHead(), dataBuf ) );
+	CHECK_EQUAL( 40, dataBuf[ 0 ] );
+}
+
+
+TEST( ringbuf, image_recover_interrupted )
+{
+	/*
+	* TEST data. 
+	*
+	*/
+
+	constexpr uint32_t image_size = sizeof( rbImage_t ) + 512U;
+
+	alignas( rbImage_t ) static uint8_t memImage[ image_size ];
+
+	uint8_t testItem[ 16 ] = { 0 };
+	uint8_t dataBuf[ 16 ];
+
+	rbImage_t xStaleImage;
+
+
+	/*
+	* TEST sequence. 
+	*
+	*/
+
+	ringbuf testBuf( memImage, image_size, RB_IMAGE_CREATE );
+
+	for( uint8_t i = 0; i < 5; ++i )
+	{
+		testItem[ 0 ] = i;
+		CHECK_TRUE( testBuf.push( testItem, sizeof( testItem ) ) );
+	}
+
+	std::memcpy( &xStaleImage, memImage, sizeof( rbImage_t ) );
+
+	testItem[ 0 ] = 5;
+	CHECK_TRUE( testBuf.deleteTail() );
+	CHECK_TRUE( testBuf.push( testItem, sizeof( testItem ) ) );
+
+	/* Crash before the image header recorded the new tail and head. */
+	std::memcpy( memImage, &xStaleImage, sizeof( rbImage_t ) );
+
+	ringbuf recoveredBuf( memImage, image_size, RB_IMAGE_RECOVER );
+
+	CHECK_TRUE( recoveredBuf.isRecovered() );
+	CHECK_EQUAL( 5, recoveredBuf.getItemsCnt() );
+
+	CHECK_TRUE( recoveredBuf.getData( recoveredBuf.getTail(), dataBuf ) );
+	CHECK_EQUAL( 1, dataBuf[ 0 ] );
+
+	CHECK_TRUE( recoveredBuf.getData( recoveredBuf.getHead(), dataBuf ) );
+	CHECK_EQUAL( 5, dataBuf[ 0 ] );
+}
+
+
+TEST( ringbuf, image_recover_invalid )
+{
+	/*
+	* TEST data. 
+	*
+	*/
+
+	constexpr uint32_t image_size = sizeof( rbImage_t ) + 256U;
+
+	alignas( rbImage_t ) static uint8_t memImage[ image_size ];
+
+	uint8_t testItem[ 16 ] = { 0 };
+
+	rbSpan_t axSpans[ 2 ];
+
+
+	/*
+	* TEST sequence. 
+	*
+	*/
+
+	/* Not an image: initialized empty. */
+	std::memset( memImage, 0xA5, image_size );
+
+	ringbuf garbageBuf( memImage, image_size, RB_IMAGE_RECOVER );
+
+	CHECK_FALSE( garbageBuf.isRecovered() );
+	CHECK_TRUE( garbageBuf.isEmpty() );
+	CHECK_TRUE( garbageBuf.push( testItem, sizeof( testItem ) ) );
+
+	/* Empty image. */
+	garbageBuf.flush();
+
+	ringbuf emptyBuf( memImage, image_size, RB_IMAGE_RECOVER );
+
+	CHECK_TRUE( emptyBuf.isRecovered() );
+	CHECK_TRUE( emptyBuf.isEmpty() );
+
+	/* Broken chain. */
+	for( uint8_t i = 0; i < 3; ++i )
+	{
+		CHECK_TRUE( emptyBuf.push( testItem, sizeof( testItem ) ) );
+	}
+
+	( ( rbItem_t* )emptyBuf.getNext( emptyBuf.getTail() ) )->xItemSize = 0;
+
+	ringbuf brokenBuf( memImage, image_size, RB_IMAGE_RECOVER );
+
+	CHECK_FALSE( brokenBuf.isRecovered() );
+	CHECK_TRUE( brokenBuf.isEmpty() );
+
+	/* Image smaller than the one recorded. */
+	CHECK_TRUE( brokenBuf.push( testItem, sizeof( testItem ) ) );
+
+	ringbuf truncatedBuf( memImage, image_size - 8U, RB_IMAGE_RECOVER );
+
+	CHECK_FALSE( truncatedBuf.isRecovered() );
+
+	/* Item not starting where the previous one ends. */
+	ringbuf shiftedBuf( memImage, image_size, RB_IMAGE_CREATE );
+
+	for( uint8_t i = 0; i < 3; ++i )
+	{
+		CHECK_TRUE( shiftedBuf.push( testItem, sizeof( testItem ) ) );
+	}
+
+	( ( rbItem_t* )shiftedBuf.getTail() )->xItemSize += 8U;
+
+	ringbuf shiftedRecBuf( memImage, image_size, RB_IMAGE_RECOVER );
+
+	CHECK_FALSE( shiftedRecBuf.isRecovered() );
+	CHECK_TRUE( shiftedRecBuf.isEmpty() );
+
+	/* Image smaller than its header: left untouched, nothing inserted. */
+	std::memset( memImage, 0xA5, image_size );
+
+	ringbuf tinyBuf( memImage, sizeof( rbImage_t ) - 8U, RB_IMAGE_CREATE );
+
+	CHECK_FALSE( tinyBuf.isRecovered() );
+	CHECK_TRUE( tinyBuf.isEmpty() );
+	CHECK_FALSE( tinyBuf.push( testItem, sizeof( testItem ) ) );
+	CHECK_FALSE( tinyBuf.reserve( 1, axSpans ) );
+	CHECK_EQUAL( 0xA5, memImage[ 0 ] );
+	CHECK_EQUAL( 0xA5, memImage[ image_size - 1 ] );
+}
+
+
+#if defined( __linux__ )
+
+TEST( ringbuf, image_file )
+{
+	/*
+	* TEST data. 
+	*
+	*/
+
+	char imagePath[] = "/tmp/ringbuf_image_XXXXXX";
+
+	const int iFd = mkstemp( imagePath );
+
+	std::size_t xImageSize = 4096U;
+	std::size_t xMappedSize = 0;
+
+	uint8_t testItem[ 100 ] = { 0 };
+	uint8_t dataBuf[ 100 ];
+
+
+	/*
+	* TEST sequence. 
+	*
+	*/
+
+	CHECK_TRUE( iFd >= 0 );
+	close( iFd );
+
+	uint8_t* pcImage = ringbuf::mapImage( imagePath, &xImageSize );
+
+	CHECK_TRUE( pcImage != nullptr );
+
+	ringbuf testBuf( pcImage, xImageSize, RB_IMAGE_CREATE );
+
+	for( uint8_t i = 0; i < 100; ++i )
+	{
+		testItem[ 0 ] = i;
+		CHECK_TRUE( testBuf.push( testItem, sizeof( testItem ) ) );
+	}
+
+	CHECK_TRUE( testBuf.syncImage() );
+
+	const std::size_t xItemsCnt = testBuf.getItemsCnt();
+
+	ringbuf::unmapImage( pcImage, xImageSize );
+
+	/* Post-mortem: open the file as it is. */
+	pcImage = ringbuf::mapImage( imagePath, &xMappedSize );
+
+	CHECK_TRUE( pcImage != nullptr );
+	CHECK_EQUAL( xImageSize, xMappedSize );
+
+	ringbuf recoveredBuf( pcImage, xMappedSize, RB_IMAGE_RECOVER );
+
+	CHECK_TRUE( recoveredBuf.isRecovered() );
+	CHECK_EQUAL( xItemsCnt, recoveredBuf.getItemsCnt() );
+	CHECK_TRUE( recoveredBuf.getData( recoveredBuf.getHead(), dataBuf ) );
+	CHECK_EQUAL( 99, dataBuf[ 0 ] );
+
+	ringbuf::unmapImage( pcImage, xMappedSize );
+
+	unlink( imagePath );
+}
+
+#endif
+
+
+/* Scan callback counting the items matched, stopping at the given count. */
+struct scanCount {
+	std::size_t xMatchCnt;
+	std::size_t xStopCnt;
+	uint8_t ucFirstByte;
+};
+
+static bool countMatch( const rbItem_t* pxItem, void* pvContext )
+{
+	scanCount* pxCount = ( scanCount* )pvContext;
+
+	( void )pxItem;
+
+	return ( ++pxCount->xMatchCnt < pxCount->xStopCnt );
+}
+
+static bool isFirstByte( const rbConstSpan_t* pxSpans, void* pvContext )
+{
+	return ( pxSpans[ 0 ].pcData[ 0 ] == ( ( scanCount* )pvContext )->ucFirstByte );
+}
+
+/* Number of items holding the pattern, found with copies and a naive search. */
+static std::size_t countPattern( ringbuf& xBuf, const uint8_t* pcPattern, const std::size_t xPatternSize )
+{
+	std::size_t xCnt = 0;
+	uint8_t dataBuf[ 256 ];
+
+	const rbItem_t* pxItem = xBuf.getTail();
+
+	for( std::size_t i = 0; i < xBuf.getItemsCnt(); ++i )
+	{
+		bool isFound = false;
+
+		xBuf.getData( pxItem, dataBuf );
+
+		for( std::size_t k = 0; !isFound && ( ( k + xPatternSize ) <= pxItem->xItemSize ); ++k )
+		{
+			isFound = ( memcmp( &dataBuf[ k ], pcPattern, xPatternSize ) == 0 );
+		}
+
+		xCnt += isFound ? 1 : 0;
+		pxItem = xBuf.getNext( pxItem );
+	}
+
+	return xCnt;
+}
+
+TEST( ringbuf, scan_pattern )
+{
+	/*
+	* TEST data. 
+	*
+	*/
+
+	constexpr uint32_t mem_pool_size = 512;
+
+	uint8_t memPool[ mem_pool_size ]; 
+
+	ringbuf testBuf( memPool, mem_pool_size );
+
+	uint8_t testItem[ 160 ];
+
+	uint8_t dataBuf[ 160 ];
+
+	rbConstSpan_t axSpans[ 2 ];
+
+	std::size_t xSplitCnt = 0;
+
+
+	/*
+	* TEST sequence. 
+	*
+	*/
+
+	/* Empty pattern matches nothing. */
+	scanCount xCount = { 0, SIZE_MAX, 0 };
+	CHECK_EQUAL( 0, testBuf.scan( testItem, 0, countMatch, &xCount ) );
+
+	for( std::size_t i = 0; i < 300; ++i )
+	{
+		const std::size_t xItemSize = 1 + ( ( i * 37 ) % 150 );
+
+		for( std::size_t k = 0; k < xItemSize; ++k )
+		{
+			testItem[ k ] = ( uint8_t )( ( i + ( k * k ) ) % 13 );
+		}
+
+		CHECK_TRUE( testBuf.push( testItem, xItemSize ) );
+
+		CHECK_TRUE( testBuf.peek( testBuf.getHead(), axSpans ) );
+		xSplitCnt += ( axSpans[ 1 ].xSize > 0 ) ? 1 : 0;
+
+		/* Patterns of the new item, across the split when there is one. */
+		testBuf.getData( testBuf.getHead(), dataBuf );
+
+		for( std::size_t xPatternSize = 1; xPatternSize <= std::min( ( std::size_t )40, xItemSize ); xPatternSize += 3 )
+		{
+			const std::size_t xStart = ( axSpans[ 0 ].xSize > ( xPatternSize / 2 ) ) ? std::min( axSpans[ 0 ].xSize - ( xPatternSize / 2 ), xItemSize - xPatternSize ) : 0;
+
+			xCount.xMatchCnt = 0;
+			CHECK_EQUAL( countPattern( testBuf, &dataBuf[ xStart ], xPatternSize ), testBuf.scan( &dataBuf[ xStart ], xPatternSize, countMatch, &xCount ) );
+			CHECK_EQUAL( xCount.xMatchCnt, countPattern( testBuf, &dataBuf[ xStart ], xPatternSize ) );
+			CHECK_TRUE( xCount.xMatchCnt > 0 );
+		}
+	}
+
+	CHECK_TRUE( xSplitCnt > 10 );
+
+	/* Pattern not present. */
+	memset( testItem, 0xFF, 20 );
+	CHECK_EQUAL( 0, testBuf.scan( testItem, 20, countMatch, &xCount ) );
+
+	/* Callback stops the scan. */
+	xCount.xMatchCnt = 0;
+	xCount.xStopCnt = 2;
+	testItem[ 0 ] = 0;
+	CHECK_EQUAL( 2, testBuf.scan( testItem, 1, countMatch, &xCount ) );
+}
+
+TEST( ringbuf, scan_predicate )
+{
+	/*
+	* TEST data. 
+	*
+	*/
+
+	constexpr uint32_t mem_pool_size = 6 * ( sizeof( rbItem_t ) + 16 ) + 16;
+
+	uint8_t memPool[ mem_pool_size ]; 
+
+	ringbuf testBuf( memPool, mem_pool_size );
+
+	uint8_t testItem[ 16 ] = { 0 };
+
+	scanCount xCount = { 0, SIZE_MAX, 1 };
+
+
+	/*
+	* TEST sequence. 
+	*
+	*/
+
+	for( uint8_t i = 0; i < 6; ++i )
+	{
+		testItem[ 0 ] = i % 2;
+		CHECK_TRUE( testBuf.push( testItem, sizeof( testItem ) ) );
+	}
+
+	CHECK_EQUAL( 3, testBuf.scan( isFirstByte, countMatch, &xCount ) );
+	CHECK_EQUAL( 3, xCount.xMatchCnt );
+
+	xCount.xMatchCnt = 0;
+	xCount.xStopCnt = 1;
+	CHECK_EQUAL( 1, testBuf.scan( isFirstByte, countMatch, &xCount ) );
+}
+
+
+/* Item i of the compression test: text, or random data every third item. */
+static std::size_t fillCodecItem( const std::size_t xItemIdx, uint8_t* pcItem )
+{
+	static const char acText[] = "temperature=21.5C humidity=40% status=ok ";
+
+	const std::size_t xItemSize = 16 + ( ( xItemIdx * 53 ) % 380 );
+	uint32_t ulRand = ( uint32_t )xItemIdx + 1;
+
+	for( std::size_t k = 0; k < xItemSize; ++k )
+	{
+		ulRand = ( ulRand * 1103515245U ) + 12345U;
+
+		if( ( xItemIdx % 3 ) == 0 )
+		{
+			pcItem[ k ] = ( uint8_t )( ulRand >> 16 );
+		}
+		else
+		{
+			pcItem[ k ] = ( uint8_t )acText[ ( k + xItemIdx ) % ( sizeof( acText ) - 1 ) ];
+		}
+	}
+
+	return xItemSize;
+}
+
+TEST( ringbuf, compression )
+{
+	/*
+	* TEST data. 
+	*
+	*/
+
+	constexpr uint32_t mem_pool_size = 1024;
+
+	constexpr std::size_t max_item_size = 300;
+
+	uint8_t memPool[ mem_pool_size ]; 
+
+	ringbuf testBuf( memPool, mem_pool_size );
+
+	alignas( uint32_t ) uint8_t codecBuf[ RB_CODEC_BUF_SIZE( max_item_size ) ];
+
+	uint8_t testItem[ 400 ];
+
+	uint8_t dataBuf[ 400 ];
+
+	rbConstSpan_t axSpans[ 2 ];
+
+	const uint8_t pattern[] = { 'h', 'u', 'm', 'i', 'd', 'i', 't', 'y' };
+
+	std::size_t xCompressedCnt = 0;
+
+	std::size_t xSplitCnt = 0;
+
+	std::size_t xItemIdx = 0;
+
+
+	/*
+	* TEST sequence. 
+	*
+	*/
+
+	/* No room left for the output. */
+	CHECK_FALSE( testBuf.setCompression( codecBuf, RB_CODEC_BUF_SIZE( 0 ) ) );
+	CHECK_TRUE( testBuf.setCompression( codecBuf, sizeof( codecBuf ) ) );
+
+	/* Short items are stored raw. */
+	memset( testItem, 'a', 15 );
+	CHECK_TRUE( testBuf.push( testItem, 15 ) );
+	CHECK_FALSE( testBuf.isCompressed( testBuf.getHead() ) );
+
+	for( xItemIdx = 0; xItemIdx < 300; ++xItemIdx )
+	{
+		const std::size_t xItemSize = fillCodecItem( xItemIdx, testItem );
+
+		CHECK_TRUE( testBuf.push( testItem, xItemSize ) );
+
+		const rbItem_t* pxHead = testBuf.getHead();
+
+		CHECK_EQUAL( xItemSize, testBuf.getHeadSize() );
+		CHECK_EQUAL( xItemSize, testBuf.getDataSize( pxHead ) );
+		CHECK_TRUE( testBuf.peek( pxHead, axSpans ) );
+
+		if( testBuf.isCompressed( pxHead ) )
+		{
+			/* Only text, up to the size the codec buffer allows. */
+			CHECK_TRUE( ( xItemIdx % 3 ) != 0 );
+			CHECK_TRUE( xItemSize <= ( sizeof( codecBuf ) - ( RB_CODEC_HASH_CNT * sizeof( uint32_t ) ) ) );
+			CHECK_TRUE( ( xItemSize < 120 ) || ( ( ( axSpans[ 0 ].xSize + axSpans[ 1 ].xSize ) * 2 ) < xItemSize ) );
+
+			++xCompressedCnt;
+			xSplitCnt += ( axSpans[ 1 ].xSize > 0 ) ? 1 : 0;
+		}
+		else
+		{
+			/* Text shorter than twice its period does not repeat enough. */
+			CHECK_TRUE( ( ( xItemIdx % 3 ) == 0 ) || ( xItemSize > max_item_size ) || ( xItemSize < 80 ) );
+			CHECK_EQUAL( xItemSize, axSpans[ 0 ].xSize + axSpans[ 1 ].xSize );
+		}
+
+		memset( dataBuf, 0, sizeof( dataBuf ) );
+		CHECK_TRUE( testBuf.getData( pxHead, dataBuf ) );
+		MEMCMP_EQUAL( testItem, dataBuf, xItemSize );
+	}
+
+	CHECK_TRUE( xCompressedCnt > 100 );
+	CHECK_TRUE( xSplitCnt > 0 );
+
+	/* Every item retained, compressed or not, and scan() looking into them. */
+	const rbItem_t* pxItem = testBuf.getTail();
+	std::size_t xPatternCnt = 0;
+
+	for( std::size_t i = xItemIdx - testBuf.getItemsCnt(); i < xItemIdx; ++i )
+	{
+		const std::size_t xItemSize = fillCodecItem( i, testItem );
+
+		CHECK_EQUAL( xItemSize, testBuf.getDataSize( pxItem ) );
+		CHECK_TRUE( testBuf.getData( pxItem, dataBuf ) );
+		MEMCMP_EQUAL( testItem, dataBuf, xItemSize );
+
+		xPatternCnt += ( std::search( testItem, testItem + xItemSize, pattern, pattern + sizeof( pattern ) ) != ( testItem + xItemSize ) ) ? 1 : 0;
+		pxItem = testBuf.getNext( pxItem );
+	}
+
+	CHECK_EQUAL( fillCodecItem( xItemIdx - testBuf.getItemsCnt(), testItem ), testBuf.getTailSize() );
+
+	scanCount xCount = { 0, SIZE_MAX, 0 };
+	CHECK_TRUE( xPatternCnt > 0 );
+	CHECK_EQUAL( xPatternCnt, testBuf.scan( pattern, sizeof( pattern ), countMatch, &xCount ) );
+
+#if ( RINGBUF_CFG_ITEM_SEQUENCE == 1 )
+	/* Checked copy of a compressed item. */
+	std::size_t xDataSize = 0;
+
+	do
+	{
+		CHECK_TRUE( testBuf.push( testItem, fillCodecItem( xItemIdx++, testItem ) ) );
+	} while( !testBuf.isCompressed( testBuf.getHead() ) );
+
+	CHECK_FALSE( testBuf.getData( testBuf.getHead(), testBuf.getSeq( testBuf.getHead() ), dataBuf, testBuf.getHeadSize() - 1, &xDataSize ) );
+	CHECK_TRUE( testBuf.getData( testBuf.getHead(), testBuf.getSeq( testBuf.getHead() ), dataBuf, sizeof( dataBuf ), &xDataSize ) );
+	CHECK_EQUAL( testBuf.getHeadSize(), xDataSize );
+	MEMCMP_EQUAL( testItem, dataBuf, xDataSize );
+#endif
+
+	/* New items are stored raw, older ones are still decompressed. */
+	CHECK_TRUE( testBuf.setCompression( nullptr, 0 ) );
+
+	std::size_t xItemSize = fillCodecItem( 1, testItem );
+	CHECK_TRUE( testBuf.push( testItem, xItemSize ) );
+	CHECK_FALSE( testBuf.isCompressed( testBuf.getHead() ) );
+
+	pxItem = testBuf.getPrev( testBuf.getHead() );
+
+	while( !testBuf.isCompressed( pxItem ) )
+	{
+		pxItem = testBuf.getPrev( pxItem );
+	}
+
+	CHECK_TRUE( testBuf.getData( pxItem, dataBuf ) );
+}
+
+
+/* Fields of the samples of the delta test, back to back. */
+static const rbField_t axSampleFields[] = { RB_FIELD_INT64, RB_FIELD_DOUBLE, RB_FIELD_FLOAT, RB_FIELD_INT32, RB_FIELD_INT16, RB_FIELD_INT8 };
+
+static constexpr std::size_t xSampleSize = 27;
+
+static constexpr std::size_t xStatusOff = 24;
+
+/* Sample i of the delta test: a sensor reading close to the previous one. */
+static void fillSample( const std::size_t xSampleIdx, uint8_t* pcSample )
+{
+	int64_t llTime = 1700000000000LL + ( ( int64_t )xSampleIdx * 10 );
+	double dTemperature = 21.5 + ( ( double )( ( xSampleIdx / 4 ) % 7 ) * 0.1 );
+	float fHumidity = 40.0f + ( float )( xSampleIdx % 3 );
+	int32_t lAdc = 2048 + ( int32_t )( ( xSampleIdx * 7919 ) % 21 ) - 10;
+	int16_t sStatus = ( int16_t )( ( xSampleIdx / 50 ) % 2 );
+	int8_t cFlags = ( ( xSampleIdx % 97 ) == 0 ) ? -128 : 1;
+
+	/* Now and then values far from the previous ones. */
+	if( ( xSampleIdx % 61 ) == 0 )
+	{
+		llTime = INT64_MIN + ( int64_t )xSampleIdx;
+		dTemperature = -1.0e300;
+		fHumidity = -0.0f;
+		lAdc = INT32_MAX;
+	}
+
+	memcpy( &pcSample[ 0 ], &llTime, sizeof( llTime ) );
+	memcpy( &pcSample[ 8 ], &dTemperature, sizeof( dTemperature ) );
+	memcpy( &pcSample[ 16 ], &fHumidity, sizeof( fHumidity ) );
+	memcpy( &pcSample[ 20 ], &lAdc, sizeof( lAdc ) );
+	memcpy( &pcSample[ xStatusOff ], &sStatus, sizeof( sStatus ) );
+	memcpy( &pcSample[ 26 ], &cFlags, sizeof( cFlags ) );
+}
+
+/* Scan predicate selecting the samples with a status set. */
+static bool isStatusSet( const rbConstSpan_t* pxSpans, void* pvContext )
+{
+	uint8_t acSample[ xSampleSize ] = { 0 };
+
+	( void )pvContext;
+
+	memcpy( acSample, pxSpans[ 0 ].pcData, std::min( pxSpans[ 0 ].xSize, xSampleSize ) );
+	memcpy( acSample + pxSpans[ 0 ].xSize, pxSpans[ 1 ].pcData, std::min( pxSpans[ 1 ].xSize, xSampleSize - pxSpans[ 0 ].xSize ) );
+
+	return ( acSample[ xStatusOff ] != 0 );
+}
+
+TEST( ringbuf, delta_samples )
+{
+	/*
+	* TEST data. 
+	*
+	*/
+
+	constexpr uint32_t mem_pool_size = 4096;
+
+	constexpr std::size_t fields_cnt = sizeof( axSampleFields ) / sizeof( axSampleFields[ 0 ] );
+
+	constexpr std::size_t key_interval = 8;
+
+	uint8_t memPool[ mem_pool_size ]; 
+
+	ringbuf testBuf( memPool, mem_pool_size );
+
+	uint8_t deltaBuf[ RB_DELTA_BUF_SIZE( fields_cnt ) ];
+
+	const rbField_t badFields[] = { RB_FIELD_INT32, ( rbField_t )( RB_FIELD_DOUBLE + 1 ) };
+
+	uint8_t testItem[ xSampleSize ];
+
+	uint8_t dataBuf[ 400 * xSampleSize ];
+
+	std::size_t xSampleIdx = 0;
+
+	std::size_t xDeltaRun = 0;
+
+
+	/*
+	* TEST sequence. 
+	*
+	*/
+
+	CHECK_FALSE( testBuf.pushDelta( testItem ) );
+
+	CHECK_FALSE( testBuf.setDelta( axSampleFields, 0, key_interval, deltaBuf, sizeof( deltaBuf ) ) );
+	CHECK_FALSE( testBuf.setDelta( axSampleFields, RB_DELTA_FIELDS_MAX + 1, key_interval, deltaBuf, sizeof( deltaBuf ) ) );
+	CHECK_FALSE( testBuf.setDelta( axSampleFields, fields_cnt, 0, deltaBuf, sizeof( deltaBuf ) ) );
+	CHECK_FALSE( testBuf.setDelta( axSampleFields, fields_cnt, key_interval, deltaBuf, xSampleSize ) );
+	CHECK_FALSE( testBuf.setDelta( badFields, 2, key_interval, deltaBuf, sizeof( deltaBuf ) ) );
+	CHECK_TRUE( testBuf.setDelta( axSampleFields, fields_cnt, key_interval, deltaBuf, sizeof( deltaBuf ) ) );
+
+	for( xSampleIdx = 0; xSampleIdx < 400; ++xSampleIdx )
+	{
+		fillSample( xSampleIdx, testItem );
+
+		CHECK_TRUE( testBuf.pushDelta( testItem ) );
+
+		const rbItem_t* pxHead = testBuf.getHead();
+
+		/* A keyframe every interval or after a jump, deltas much smaller than the samples in between. */
+		if( testBuf.isDelta( pxHead ) )
+		{
+			CHECK_TRUE( ++xDeltaRun < key_interval );
+			CHECK_TRUE( ( ( xSampleIdx % 61 ) <= 1 ) || ( pxHead->xItemSize <= ( RB_ITEM_FLAG_DELTA + ( xSampleSize / 2 ) ) ) );
+		}
+		else
+		{
+			CHECK_TRUE( ( xSampleIdx == 0 ) || ( ( xSampleIdx % 61 ) <= 1 ) || ( xDeltaRun == ( key_interval - 1 ) ) );
+			xDeltaRun = 0;
+		}
+
+		CHECK_EQUAL( xSampleSize, testBuf.getHeadSize() );
+
+		memset( dataBuf, 0, xSampleSize );
+		CHECK_TRUE( testBuf.getData( pxHead, dataBuf ) );
+		MEMCMP_EQUAL( testItem, dataBuf, xSampleSize );
+	}
+
+	/* More samples retained than when stored raw. */
+	CHECK_TRUE( testBuf.getItemsCnt() > ( ( mem_pool_size / ( sizeof( rbItem_t ) + xSampleSize ) ) + 10 ) );
+
+	/* Deltas left at the tail lost their keyframe. */
+	const rbItem_t* pxItem = testBuf.getTail();
+	std::size_t xFirstIdx = xSampleIdx - testBuf.getItemsCnt();
+
+	while( testBuf.isDelta( pxItem ) )
+	{
+		CHECK_FALSE( testBuf.getData( pxItem, dataBuf ) );
+		CHECK_EQUAL( 0, testBuf.getSamples( pxItem, 1, dataBuf ) );
+
+		pxItem = testBuf.getNext( pxItem );
+		++xFirstIdx;
+	}
+
+	/* Every sample from the first keyframe on, in one go and one by one from the middle of a run. */
+	CHECK_EQUAL( xSampleIdx - xFirstIdx, testBuf.getSamples( pxItem, SIZE_MAX, dataBuf ) );
+
+	for( std::size_t i = xFirstIdx; i < xSampleIdx; ++i )
+	{
+		fillSample( i, testItem );
+		MEMCMP_EQUAL( testItem, &dataBuf[ ( i - xFirstIdx ) * xSampleSize ], xSampleSize );
+	}
+
+	pxItem = testBuf.getNext( testBuf.getNext( pxItem ) );
+	CHECK_EQUAL( 5, testBuf.getSamples( pxItem, 5, dataBuf ) );
+
+	for( std::size_t i = 0; i < 5; ++i )
+	{
+		fillSample( xFirstIdx + 2 + i, testItem );
+		MEMCMP_EQUAL( testItem, &dataBuf[ i * xSampleSize ], xSampleSize );
+	}
+
+	/* scan() sees the samples decoded. */
+	std::size_t xStatusCnt = 0;
+
+	for( std::size_t i = xFirstIdx; i < xSampleIdx; ++i )
+	{
+		fillSample( i, testItem );
+		xStatusCnt += ( testItem[ xStatusOff ] != 0 ) ? 1 : 0;
+	}
+
+	scanCount xCount = { 0, SIZE_MAX, 0 };
+	CHECK_TRUE( xStatusCnt > 0 );
+	CHECK_EQUAL( xStatusCnt, testBuf.scan( isStatusSet, countMatch, &xCount ) );
+
+#if ( RINGBUF_CFG_ITEM_SEQUENCE == 1 )
+	/* Checked copies do not decode. */
+	std::size_t xDataSize = 0;
+
+	do
+	{
+		fillSample( xSampleIdx++, testItem );
+		CHECK_TRUE( testBuf.pushDelta( testItem ) );
+	} while( !testBuf.isDelta( testBuf.getHead() ) );
+
+	CHECK_FALSE( testBuf.getData( testBuf.getHead(), testBuf.getSeq( testBuf.getHead() ), dataBuf, sizeof( dataBuf ), &xDataSize ) );
+#endif
+
+	/* Any other change of the head starts a new keyframe. */
+	CHECK_TRUE( testBuf.push( testItem, 3 ) );
+	fillSample( xSampleIdx++, testItem );
+	CHECK_TRUE( testBuf.pushDelta( testItem ) );
+	CHECK_FALSE( testBuf.isDelta( testBuf.getHead() ) );
+
+	fillSample( xSampleIdx++, testItem );
+	CHECK_TRUE( testBuf.pushDelta( testItem ) );
+	CHECK_TRUE( testBuf.isDelta( testBuf.getHead() ) );
+	CHECK_TRUE( testBuf.deleteHead() );
+
+	fillSample( xSampleIdx++, testItem );
+	CHECK_TRUE( testBuf.pushDelta( testItem ) );
+	CHECK_FALSE( testBuf.isDelta( testBuf.getHead() ) );
+
+	fillSample( xSampleIdx++, testItem );
+	CHECK_TRUE( testBuf.pushDelta( testItem ) );
+	CHECK_TRUE( testBuf.getData( testBuf.getHead(), dataBuf ) );
+	MEMCMP_EQUAL( testItem, dataBuf, xSampleSize );
+
+	/* The raw item stops the samples. */
+	pxItem = testBuf.getPrev( testBuf.getPrev( testBuf.getHead() ) );
+	CHECK_EQUAL( 3, testBuf.getSamples( pxItem, SIZE_MAX, dataBuf ) );
+	MEMCMP_EQUAL( testItem, &dataBuf[ 2 * xSampleSize ], xSampleSize );
+
+	pxItem = testBuf.getPrev( pxItem );
+	CHECK_EQUAL( 0, testBuf.getSamples( pxItem, SIZE_MAX, dataBuf ) );
+	CHECK_EQUAL( 1, testBuf.getSamples( testBuf.getPrev( pxItem ), SIZE_MAX, dataBuf ) );
+
+	/* Without a layout deltas are not decoded. */
+	CHECK_TRUE( testBuf.setDelta( nullptr, 0, 0, nullptr, 0 ) );
+	CHECK_FALSE( testBuf.pushDelta( testItem ) );
+	CHECK_EQUAL( 0, testBuf.getDataSize( testBuf.getHead() ) );
+	CHECK_FALSE( testBuf.getData( testBuf.getHead(), dataBuf ) );
+}
+
+
+TEST( ringbuf, delta_samples_worst_case )
+{
+	/*
+	* TEST data. 
+	*
+	*/
+
+	constexpr uint32_t mem_pool_size = 16384;
+
+	constexpr std::size_t key_interval = 8;
+
+	constexpr std::size_t sample_size = RB_DELTA_FIELDS_MAX * sizeof( int64_t );
+
+	constexpr std::size_t samples_cnt = 4 * key_interval;
+
+	uint8_t memPool[ mem_pool_size ]; 
+
+	ringbuf testBuf( memPool, mem_pool_size );
+
+	/* Guard bytes right after the buffer. */
+	uint8_t deltaBuf[ RB_DELTA_BUF_SIZE( RB_DELTA_FIELDS_MAX ) + 16 ];
+
+	rbField_t axFields[ RB_DELTA_FIELDS_MAX ];
+
+	int64_t allSamples[ samples_cnt ][ RB_DELTA_FIELDS_MAX ];
+
+	uint8_t dataBuf[ samples_cnt * sample_size ];
+
+	std::size_t xDeltaCnt = 0;
+
+	/* Differences of 2^63, the longest varint: all fields change, then every other one. */
+	for( std::size_t k = 0; k < samples_cnt; ++k )
+	{
+		for( std::size_t i = 0; i < RB_DELTA_FIELDS_MAX; ++i )
+		{
+			const bool isToggled = ( ( k % 2 ) == 1 ) && ( ( k < ( samples_cnt / 2 ) ) || ( ( i % 2 ) == 0 ) );
+
+			axFields[ i ] = RB_FIELD_INT64;
+			allSamples[ k ][ i ] = isToggled ? INT64_MIN : 0;
+		}
+	}
+
+	memset( deltaBuf, 0xA5, sizeof( deltaBuf ) );
+
+
+	/*
+	* TEST sequence. 
+	*
+	*/
+
+	CHECK_TRUE( testBuf.setDelta( axFields, RB_DELTA_FIELDS_MAX, key_interval, deltaBuf, RB_DELTA_BUF_SIZE( RB_DELTA_FIELDS_MAX ) ) );
+
+	for( std::size_t k = 0; k < samples_cnt; ++k )
+	{
+		CHECK_TRUE( testBuf.pushDelta( allSamples[ k ] ) );
+
+		xDeltaCnt += testBuf.isDelta( testBuf.getHead() ) ? 1 : 0;
+	}
+
+	/* Deltas of every field larger than the samples are stored raw. */
+	CHECK_TRUE( xDeltaCnt > 0 );
+	CHECK_TRUE( xDeltaCnt < ( samples_cnt / 2 ) );
+
+	for( std::size_t i = RB_DELTA_BUF_SIZE( RB_DELTA_FIELDS_MAX ); i < sizeof( deltaBuf ); ++i )
+	{
+		CHECK_EQUAL( 0xA5, deltaBuf[ i ] );
+	}
+
+	CHECK_EQUAL( samples_cnt, testBuf.getItemsCnt() );
+	CHECK_EQUAL( samples_cnt, testBuf.getSamples( testBuf.getTail(), SIZE_MAX, dataBuf ) );
+	MEMCMP_EQUAL( allSamples, dataBuf, sizeof( dataBuf ) );
+}
+
+
+/* Checks getItem() against the items reached through the links. */
+static void checkItemIndex( ringbuf& xBuf )
+{
+	const rbItem_t* pxItem = xBuf.getTail();
+
+	for( std::size_t i = 0; i < xBuf.getItemsCnt(); ++i )
+	{
+		CHECK_TRUE( xBuf.getItem( i ) == pxItem );
+
+		pxItem = xBuf.getNext( pxItem );
+	}
+
+	CHECK_TRUE( xBuf.getItem( xBuf.getItemsCnt() ) == nullptr );
+}
+
+TEST( ringbuf, item_index )
+{
+	/*
+	* TEST data. 
+	*
+	*/
+
+	constexpr uint32_t mem_pool_size = 20 * ( sizeof( rbItem_t ) + 8 );
+
+	uint8_t memPool[ mem_pool_size ]; 
+
+	ringbuf testBuf( memPool, mem_pool_size );
+
+	uint32_t aulIndex[ 32 ];
+
+	uint32_t aulSmallIndex[ 4 ];
+
+	uint8_t testItem[ 24 ] = { 0 };
+
+	rbConstSpan_t axItems[ 3 ] = { { testItem, 8 }, { testItem, 16 }, { testItem, 24 } };
+
+	uint8_t drainBuf[ 64 ];
+
+	uint8_t* pcDrainDst = drainBuf;
+
+
+	/*
+	* TEST sequence. 
+	*
+	*/
+
+	/* Without index items are reached through the links. */
+	CHECK_TRUE( testBuf.getItem( 0 ) == nullptr );
+
+	for( uint8_t i = 0; i < 5; ++i )
+	{
+		CHECK_TRUE( testBuf.push( testItem, 8 + ( i % 3 ) * 8 ) );
+	}
+
+	checkItemIndex( testBuf );
+
+	/* Entries shall be a power of two. */
+	CHECK_FALSE( testBuf.setIndex( aulIndex, 24 ) );
+
+	/* Items already present are indexed. */
+	CHECK_TRUE( testBuf.setIndex( aulIndex, 32 ) );
+	checkItemIndex( testBuf );
+
+	/* Insertions wrap around the pool and evict the oldest items. */
+	for( uint8_t i = 0; i < 60; ++i )
+	{
+		CHECK_TRUE( testBuf.push( testItem, 1 + ( i % 24 ) ) );
+		checkItemIndex( testBuf );
+	}
+
+	CHECK_TRUE( testBuf.getStats().xEvictedItems > 0 );
+
+	CHECK_TRUE( testBuf.pushBatch( axItems, 3 ) );
+	checkItemIndex( testBuf );
+
+	/* Newest items. */
+	CHECK_TRUE( testBuf.getItem( testBuf.getItemsCnt() - 1 ) == testBuf.getHead() );
+	CHECK_EQUAL( 16, testBuf.getItem( testBuf.getItemsCnt() - 2 )->xItemSize );
+
+	CHECK_TRUE( testBuf.deleteHead() );
+	CHECK_TRUE( testBuf.deleteTail() );
+	checkItemIndex( testBuf );
+
+	CHECK_EQUAL( 2, testBuf.drain( drainToBuffer, &pcDrainDst, 2, SIZE_MAX ) );
+	checkItemIndex( testBuf );
+
+	/* Fewer entries than items: only the newest ones are indexed. */
+	CHECK_TRUE( testBuf.setIndex( aulSmallIndex, 4 ) );
+	CHECK_TRUE( testBuf.getItemsCnt() > 4 );
+
+	CHECK_TRUE( testBuf.push( testItem, 8 ) );
+	checkItemIndex( testBuf );
+
+	/* The entry of the deleted head overwrote an older one. */
+	CHECK_TRUE( testBuf.deleteHead() );
+	checkItemIndex( testBuf );
+
+	/* Drop the index. */
+	CHECK_TRUE( testBuf.setIndex( nullptr, 0 ) );
+	checkItemIndex( testBuf );
+
+	testBuf.flush();
+	CHECK_TRUE( testBuf.getItem( 0 ) == nullptr );
+}
+
+
+#if ( RINGBUF_CFG_ITEM_SEQUENCE == 1 )
+
+TEST( ringbuf, item_sequence )
+{
+	/*
+	* TEST data. 
+	*
+	*/
+
+	constexpr uint32_t mem_pool_size = 4 * ( sizeof( rbItem_t ) + 16 ) + 8;
+
+	uint8_t memPool[ mem_pool_size ]; 
+
+	ringbuf testBuf( memPool, mem_pool_size );
+
+	uint8_t testItem[ 16 ] = { 0 };
+
+	rbConstSpan_t axItems[ 2 ] = { { testItem, sizeof( testItem ) }, { testItem, sizeof( testItem ) } };
+
+
+	/*
+	* TEST sequence. 
+	*
+	*/
+
+	/* Empty: tail sequence is the next one. */
+	CHECK_EQUAL( 0, testBuf.getNextSeq() );
+	CHECK_EQUAL( 0, testBuf.getTailSeq() );
+
+	CHECK_TRUE( testBuf.push( testItem, sizeof( testItem ) ) );
+	CHECK_EQUAL( 0, testBuf.getSeq( testBuf.getHead() ) );
+
+	CHECK_TRUE( testBuf.pushBatch( axItems, 2 ) );
+	CHECK_EQUAL( 2, testBuf.getSeq( testBuf.getHead() ) );
+	CHECK_EQUAL( 1, testBuf.getSeq( testBuf.getPrev( testBuf.getHead() ) ) );
+	CHECK_EQUAL( 3, testBuf.getNextSeq() );
+	CHECK_EQUAL( 0, testBuf.getTailSeq() );
+
+	/* Sequence numbers of deleted items are never reused. */
+	CHECK_TRUE( testBuf.deleteHead() );
+	CHECK_TRUE( testBuf.push( testItem, sizeof( testItem ) ) );
+	CHECK_EQUAL( 3, testBuf.getSeq( testBuf.getHead() ) );
+
+	CHECK_TRUE( testBuf.deleteTail() );
+	CHECK_EQUAL( 1, testBuf.getTailSeq() );
+	CHECK_EQUAL( 1, testBuf.getSeq( testBuf.getTail() ) );
+
+	/* Flush: nothing left to read. */
+	testBuf.flush();
+	CHECK_EQUAL( 4, testBuf.getNextSeq() );
+	CHECK_EQUAL( 4, testBuf.getTailSeq() );
+}
+
+
+TEST( ringbuf, item_sequence_lapped_reader )
+{
+	/*
+	* TEST data. 
+	*
+	*/
+
+	constexpr uint32_t mem_pool_size = 3 * ( sizeof( rbItem_t ) + 16 ) + 8;
+
+	uint8_t memPool[ mem_pool_size ]; 
+
+	ringbuf testBuf( memPool, mem_pool_size );
+
+	uint8_t testItem[ 16 ] = { 0 };
+
+	uint8_t dataBuf[ 16 ] = { 0 };
+
+	std::size_t xItemSize = 0;
+
+
+	/*
+	* TEST sequence. 
+	*
+	*/
+
+	for( uint8_t i = 0; i < 3; ++i )
+	{
+		testItem[ 0 ] = i;
+		CHECK_TRUE( testBuf.push( testItem, sizeof( testItem ) ) );
+	}
+
+	/* Reader keeps the oldest item. */
+	const rbItem_t* pxItem = testBuf.getTail();
+	uint64_t ullSeq = testBuf.getSeq( pxItem );
+
+	CHECK_TRUE( testBuf.getData( pxItem, ullSeq, dataBuf, sizeof( dataBuf ), &xItemSize ) );
+	CHECK_EQUAL( sizeof( testItem ), xItemSize );
+	CHECK_EQUAL( 0, dataBuf[ 0 ] );
+
+	/* Destination too small. */
+	CHECK_FALSE( testBuf.getData( pxItem, ullSeq, dataBuf, sizeof( dataBuf ) - 1, &xItemSize ) );
+	CHECK_EQUAL( 0, xItemSize );
+
+	/* Writer laps the reader: the item is overwritten. */
+	testItem[ 0 ] = 3;
+	CHECK_TRUE( testBuf.push( testItem, sizeof( testItem ) ) );
+
+	CHECK_FALSE( testBuf.getData( pxItem, ullSeq, dataBuf, sizeof( dataBuf ), &xItemSize ) );
+	CHECK_EQUAL( 0, xItemSize );
+
+	/* Resume from the oldest valid item. */
+	CHECK_EQUAL( 1, testBuf.getTailSeq() );
+
+	pxItem = testBuf.getTail();
+	ullSeq = testBuf.getSeq( pxItem );
+
+	CHECK_EQUAL( 1, ullSeq );
+	CHECK_TRUE( testBuf.getData( pxItem, ullSeq, dataBuf, sizeof( dataBuf ), &xItemSize ) );
+	CHECK_EQUAL( 1, dataBuf[ 0 ] );
+
+	/* Item deleted from the head is invalid too. */
+	pxItem = testBuf.getHead();
+	ullSeq = testBuf.getSeq( pxItem );
+
+	CHECK_TRUE( testBuf.deleteHead() );
+	CHECK_FALSE( testBuf.getData( pxItem, ullSeq, dataBuf, sizeof( dataBuf ), &xItemSize ) );
+}
+
+
+TEST( ringbuf, item_sequence_reset_reader )
+{
+	/*
+	* TEST data. 
+	*
+	*/
+
+	/* Data of the 3rd item rolls-over onto the start of the pool. */
+	constexpr uint32_t item_size = 32U;
+	constexpr uint32_t mem_pool_size = 3 * sizeof( rbItem_t ) + 2 * item_size + ( item_size / 2 );
+	constexpr uint32_t rounds = 3000000U;
+
+	uint8_t memPool[ mem_pool_size ]; 
+
+	ringbuf testBuf( memPool, mem_pool_size );
+
+	const rbItem_t* pxLastItem = ( const rbItem_t* )( memPool + 2 * ( sizeof( rbItem_t ) + item_size ) );
+
+	uint8_t testItem[ item_size ];
+
+	uint8_t dataBuf[ item_size ] = { 0 };
+
+	std::size_t xItemSize = 0;
+
+	std::atomic<bool> isWriting( true );
+
+	bool isDataConsistent = true;
+
+
+	/*
+	* TEST sequence. 
+	*
+	*/
+
+	/* Item rolling-over, then deleted as the last one. */
+	for( uint8_t i = 0; i < 3; ++i )
+	{
+		std::memset( testItem, i, sizeof( testItem ) );
+		CHECK_TRUE( testBuf.push( testItem, sizeof( testItem ) ) );
+
+		if( i == 1 )
+		{
+			CHECK_TRUE( testBuf.deleteTail() );
+		}
+	}
+
+	CHECK_TRUE( testBuf.deleteTail() );
+	CHECK_TRUE( testBuf.getTail() == pxLastItem );
+	CHECK_EQUAL( 2, testBuf.getSeq( pxLastItem ) );
+	CHECK_TRUE( testBuf.getData( pxLastItem, 2, dataBuf, sizeof( dataBuf ), &xItemSize ) );
+	CHECK_EQUAL( 2, dataBuf[ sizeof( dataBuf ) - 1 ] );
+
+	CHECK_TRUE( testBuf.deleteTail() );
+	CHECK_TRUE( testBuf.isEmpty() );
+	CHECK_FALSE( testBuf.getData( pxLastItem, 2, dataBuf, sizeof( dataBuf ), &xItemSize ) );
+
+	/* Reader copying the last item while the empty header overwrites its
+	   data never gets a copy reported as consistent. */
+	std::thread reader( [ & ]()
+	{
+		uint8_t acData[ item_size ];
+		std::size_t xSize = 0;
+
+		while( isWriting.load() )
+		{
+			const uint64_t ullSeq = testBuf.getNextSeq() - 1;
+
+			if(    testBuf.getData( pxLastItem, ullSeq, acData, sizeof( acData ), &xSize ) \
+			    && ( std::count( acData, acData + sizeof( acData ), ( uint8_t )ullSeq ) != sizeof( acData ) )    )
+			{
+				isDataConsistent = false;
+			}
+		}
+	} );
+
+	for( uint32_t r = 0; r < rounds; ++r )
+	{
+		for( uint8_t i = 0; i < 3; ++i )
+		{
+			std::memset( testItem, ( uint8_t )testBuf.getNextSeq(), sizeof( testItem ) );
+			testBuf.push( testItem, sizeof( testItem ) );
+
+			if( i > 0 )
+			{
+				testBuf.deleteTail();
+			}
+		}
+
+		testBuf.deleteTail();
+	}
+
+	isWriting.store( false );
+	reader.join();
+
+	CHECK_TRUE( isDataConsistent );
+}
+
+
+TEST( ringbuf, item_index_seq )
+{
+	/*
+	* TEST data. 
+	*
+	*/
+
+	constexpr uint32_t mem_pool_size = 16 * ( sizeof( rbItem_t ) + 8 );
+
+	uint8_t memPool[ mem_pool_size ]; 
+
+	ringbuf testBuf( memPool, mem_pool_size );
+
+	uint32_t aulIndex[ 16 ];
+
+	uint8_t testItem[ 8 ] = { 0 };
+
+
+	/*
+	* TEST sequence. 
+	*
+	*/
+
+	CHECK_TRUE( testBuf.setIndex( aulIndex, 16 ) );
+	CHECK_TRUE( testBuf.getItemBySeq( 0 ) == nullptr );
+
+	for( uint8_t i = 0; i < 30; ++i )
+	{
+		CHECK_TRUE( testBuf.push( testItem, sizeof( testItem ) ) );
+	}
+
+	/* Evicted and future items are not present. */
+	CHECK_TRUE( testBuf.getItemBySeq( testBuf.getTailSeq() - 1 ) == nullptr );
+	CHECK_TRUE( testBuf.getItemBySeq( testBuf.getNextSeq() ) == nullptr );
+
+	for( uint64_t ullSeq = testBuf.getTailSeq(); ullSeq < testBuf.getNextSeq(); ++ullSeq )
+	{
+		CHECK_EQUAL( ullSeq, testBuf.getSeq( testBuf.getItemBySeq( ullSeq ) ) );
+	}
+
+	/* Sequence numbers of items deleted from the head leave gaps. */
+	CHECK_TRUE( testBuf.deleteHead() );
+	CHECK_TRUE( testBuf.deleteHead() );
+	CHECK_TRUE( testBuf.push( testItem, sizeof( testItem ) ) );
+	CHECK_TRUE( testBuf.push( testItem, sizeof( testItem ) ) );
+
+	CHECK_TRUE( testBuf.getItemBySeq( testBuf.getNextSeq() - 3 ) == nullptr );
+	CHECK_TRUE( testBuf.getItemBySeq( testBuf.getNextSeq() - 1 ) == testBuf.getHead() );
+	CHECK_TRUE( testBuf.getItemBySeq( testBuf.getTailSeq() ) == testBuf.getTail() );
+	CHECK_EQUAL( testBuf.getNextSeq() - 5, testBuf.getSeq( testBuf.getItemBySeq( testBuf.getNextSeq() - 5 ) ) );
+}
+
+#endif
+
+
+#if ( RINGBUF_CFG_ITEM_TIMESTAMP == 1 )
+
+/* Test clock, advanced by the test. */
+static uint64_t ullTestTime = 0;
+
+static uint64_t getTestTime( void )
+{
+	return ullTestTime;
+}
+
+/* Checks findByTime() and rangeByTime() against a walk of the items. */
+static void checkTimeRange( ringbuf& xBuf, const uint64_t ullStart, const uint64_t ullEnd )
+{
+	const rbItem_t* pxFirst = nullptr;
+	std::size_t xCnt = 0;
+	rbItemRange_t xRange;
+
+	const rbItem_t* pxItem = xBuf.getTail();
+
+	for( std::size_t i = 0; i < xBuf.getItemsCnt(); ++i )
+	{
+		if( ( xBuf.getTime( pxItem ) >= ullStart ) && ( xBuf.getTime( pxItem ) <= ullEnd ) )
+		{
+			pxFirst = ( pxFirst == nullptr ) ? pxItem : pxFirst;
+			++xCnt;
+		}
+
+		pxItem = xBuf.getNext( pxItem );
+	}
+
+	CHECK_EQUAL( ( xCnt > 0 ), xBuf.rangeByTime( ullStart, ullEnd, &xRange ) );
+	CHECK_TRUE( xRange.pxFirst == pxFirst );
+	CHECK_EQUAL( xCnt, xRange.xItemsCnt );
+}
+
+TEST( ringbuf, item_timestamp )
+{
+	/*
+	* TEST data. 
+	*
+	*/
+
+	constexpr uint32_t mem_pool_size = 16 * ( sizeof( rbItem_t ) + 8 );
+
+	uint8_t memPool[ mem_pool_size ]; 
+
+	ringbuf testBuf( memPool, mem_pool_size );
+
+	uint32_t aulIndex[ 16 ];
+
+	uint32_t aulSmallIndex[ 4 ];
+
+	uint8_t testItem[ 8 ] = { 0 };
+
+	rbConstSpan_t axItems[ 3 ] = { { testItem, 8 }, { testItem, 8 }, { testItem, 8 } };
+
+	rbItemRange_t xRange;
+
+
+	/*
+	* TEST sequence. 
+	*
+	*/
+
+	/* Default clock never goes back. */
+	CHECK_TRUE( testBuf.push( testItem, sizeof( testItem ) ) );
+	CHECK_TRUE( testBuf.push( testItem, sizeof( testItem ) ) );
+	CHECK_TRUE( testBuf.getTime( testBuf.getHead() ) >= testBuf.getTime( testBuf.getTail() ) );
+
+	testBuf.flush();
+	testBuf.setClock( getTestTime );
+
+	CHECK_TRUE( testBuf.findByTime( 0 ) == nullptr );
+	CHECK_FALSE( testBuf.rangeByTime( 0, UINT64_MAX, &xRange ) );
+	CHECK_EQUAL( 0, xRange.xItemsCnt );
+
+	/* Times 10, 20, 20, 30 ... with two items at each even time. */
+	for( uint8_t i = 0; i < 30; ++i )
+	{
+		ullTestTime = 10 * ( 1 + i - ( i / 2 ) );
+		CHECK_TRUE( testBuf.push( testItem, sizeof( testItem ) ) );
+	}
+
+	/* A batch gets a single time. */
+	ullTestTime += 5;
+	CHECK_TRUE( testBuf.pushBatch( axItems, 3 ) );
+	CHECK_EQUAL( ullTestTime, testBuf.getTime( testBuf.getHead() ) );
+	CHECK_EQUAL( ullTestTime, testBuf.getTime( testBuf.getPrev( testBuf.getPrev( testBuf.getHead() ) ) ) );
+
+	/* Search without index, with a partial index and with a full one. */
+	for( uint8_t i = 0; i < 3; ++i )
+	{
+		CHECK_TRUE( testBuf.findByTime( 0 ) == testBuf.getTail() );
+		CHECK_TRUE( testBuf.findByTime( ullTestTime ) == testBuf.getItem( testBuf.getItemsCnt() - 3 ) );
+		CHECK_TRUE( testBuf.findByTime( ullTestTime + 1 ) == nullptr );
+
+		for( uint64_t ullStart = 0; ullStart <= ullTestTime + 10; ullStart += 5 )
+		{
+			checkTimeRange( testBuf, ullStart, ullStart );
+			checkTimeRange( testBuf, ullStart, ullStart + 20 );
+			checkTimeRange( testBuf, ullStart, UINT64_MAX );
+		}
+
+		CHECK_FALSE( testBuf.rangeByTime( 30, 20, &xRange ) );
+
+		CHECK_TRUE( testBuf.setIndex( ( i == 0 ) ? aulSmallIndex : aulIndex, ( i == 0 ) ? 4 : 16 ) );
+	}
+
+	/* Items deleted from the head. */
+	CHECK_TRUE( testBuf.deleteHead() );
+	CHECK_TRUE( testBuf.deleteHead() );
+	CHECK_TRUE( testBuf.deleteHead() );
+	CHECK_TRUE( testBuf.findByTime( ullTestTime ) == nullptr );
+	checkTimeRange( testBuf, 0, UINT64_MAX );
+}
+
+#endif
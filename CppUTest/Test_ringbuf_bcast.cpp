@@ -0,0 +1,409 @@
+#include "CppUTest/TestHarness.h"
+
+#include <iostream>
+#include <atomic>
+#include <cstring>
+#include <thread>
+#include <vector>
+
+extern "C"
+{
+	/*
+	 * Add your c-only include files here
+	 */
+}
+
+#include "ringbuf_bcast.hpp"
+
+TEST_GROUP( ringbuf_bcast )
+{
+    void setup()
+    {
+		//MemoryLeakWarningPlugin::saveAndDisableNewDeleteOverloads();
+    }
+
+    void teardown()
+    {
+		//MemoryLeakWarningPlugin::restoreNewDeleteOverloads();
+    }
+};
+
+
+
+TEST( ringbuf_bcast, declaration )
+{
+	/*
+	* TEST data.
+	*
+	*/
+
+	constexpr uint32_t mem_pool_size = 128U;
+
+	uint8_t memPool[ mem_pool_size ];
+
+	ringbuf_bcast testBuf( memPool, mem_pool_size );
+
+	rbBcastReader_t xReader;
+
+	uint8_t dataBuf[ 10 ] = { 0 };
+	size_t xItemSize = 1;
+
+
+	/*
+	* TEST sequence.
+	*
+	*/
+
+	CHECK_TRUE( testBuf.addReader( &xReader ) );
+
+	/* Nothing to read. */
+	CHECK_TRUE( testBuf.isEmpty( &xReader ) );
+	CHECK_FALSE( testBuf.read( &xReader, dataBuf, sizeof( dataBuf ), &xItemSize ) );
+	CHECK_EQUAL( 0, xItemSize );
+	CHECK_EQUAL( 0, testBuf.getLostItems( &xReader ) );
+
+	/* Writer cannot wait for readers. */
+	CHECK_FALSE( testBuf.setOverflowPolicy( RB_OVERFLOW_BLOCK ) );
+}
+
+
+TEST( ringbuf_bcast, every_reader_gets_all_items )
+{
+	/*
+	* TEST data.
+	*
+	*/
+
+	constexpr uint32_t mem_pool_size = 128U;
+
+	uint8_t memPool[ mem_pool_size ];
+
+	ringbuf_bcast testBuf( memPool, mem_pool_size );
+
+	rbBcastReader_t xReader1;
+	rbBcastReader_t xReader2;
+
+	uint8_t  testItem1[ ] = { 1, 2, 3, 4, 5 };
+	uint16_t testItem2[ ] = { 101, 102, 103 };
+
+	uint8_t dataBuf[ 10 ] = { 0 };
+	size_t xItemSize = 0;
+
+
+	/*
+	* TEST sequence.
+	*
+	*/
+
+	CHECK_TRUE( testBuf.addReader( &xReader1 ) );
+	CHECK_TRUE( testBuf.addReader( &xReader2 ) );
+
+	CHECK_TRUE( testBuf.push( testItem1, sizeof( testItem1 ) ) );
+	CHECK_TRUE( testBuf.push( testItem2, sizeof( testItem2 ) ) );
+
+	/* Reader 1 reads everything. */
+	CHECK_TRUE( testBuf.read( &xReader1, dataBuf, sizeof( dataBuf ), &xItemSize ) );
+	CHECK_EQUAL( sizeof( testItem1 ), xItemSize );
+	CHECK_EQUAL( 0, memcmp( testItem1, dataBuf, sizeof( testItem1 ) ) );
+
+	CHECK_TRUE( testBuf.read( &xReader1, dataBuf, sizeof( dataBuf ), &xItemSize ) );
+	CHECK_EQUAL( sizeof( testItem2 ), xItemSize );
+	CHECK_EQUAL( 0, memcmp( testItem2, dataBuf, sizeof( testItem2 ) ) );
+
+	CHECK_TRUE( testBuf.isEmpty( &xReader1 ) );
+
+	/* Items are still there for reader 2. */
+	CHECK_FALSE( testBuf.isEmpty( &xReader2 ) );
+	CHECK_TRUE( testBuf.read( &xReader2, dataBuf, sizeof( dataBuf ), &xItemSize ) );
+	CHECK_EQUAL( 0, memcmp( testItem1, dataBuf, sizeof( testItem1 ) ) );
+
+	/* Destination buffer too small: the item is kept. */
+	CHECK_FALSE( testBuf.read( &xReader2, dataBuf, 4, &xItemSize ) );
+	CHECK_EQUAL( sizeof( testItem2 ), xItemSize );
+
+	CHECK_TRUE( testBuf.read( &xReader2, dataBuf, sizeof( dataBuf ), &xItemSize ) );
+	CHECK_EQUAL( 0, memcmp( testItem2, dataBuf, sizeof( testItem2 ) ) );
+
+	testBuf.removeReader( &xReader1 );
+	testBuf.removeReader( &xReader2 );
+}
+
+
+TEST( ringbuf_bcast, overwrite_lapped_reader )
+{
+	/*
+	* TEST data.
+	*
+	*/
+
+	constexpr uint32_t mem_pool_size = 64U;
+
+	uint8_t memPool[ mem_pool_size ];
+
+	ringbuf_bcast testBuf( memPool, mem_pool_size );
+
+	rbBcastReader_t xReader;
+
+	uint8_t testItem[ 16 ] = { 0 };
+
+	uint8_t dataBuf[ 16 ] = { 0 };
+	size_t xItemSize = 0;
+
+
+	/*
+	* TEST sequence.
+	*
+	*/
+
+	CHECK_TRUE( testBuf.addReader( &xReader ) );
+
+	/* Each item takes 32 [byte]: the buffer holds 2 items. */
+	CHECK_TRUE( testBuf.push( testItem, sizeof( testItem ) ) );
+	CHECK_TRUE( testBuf.read( &xReader, dataBuf, sizeof( dataBuf ), &xItemSize ) );
+
+	/* Writer never waits: items 1 and 2 are overwritten before being read. */
+	for( uint8_t i = 1; i < 5; ++i )
+	{
+		testItem[ 0 ] = i;
+		CHECK_TRUE( testBuf.push( testItem, sizeof( testItem ) ) );
+	}
+
+	CHECK_EQUAL( 2, testBuf.getStats().xEvictedItems );
+	CHECK_EQUAL( 2 * sizeof( testItem ), testBuf.getStats().xEvictedBytes );
+
+	/* Reader skips to the oldest item retained. */
+	CHECK_TRUE( testBuf.read( &xReader, dataBuf, sizeof( dataBuf ), &xItemSize ) );
+	CHECK_EQUAL( 3, dataBuf[ 0 ] );
+	CHECK_EQUAL( 2, testBuf.getLostItems( &xReader ) );
+
+	CHECK_TRUE( testBuf.read( &xReader, dataBuf, sizeof( dataBuf ), &xItemSize ) );
+	CHECK_EQUAL( 4, dataBuf[ 0 ] );
+	CHECK_TRUE( testBuf.isEmpty( &xReader ) );
+}
+
+
+TEST( ringbuf_bcast, reject_waits_slowest_reader )
+{
+	/*
+	* TEST data.
+	*
+	*/
+
+	constexpr uint32_t mem_pool_size = 64U;
+
+	uint8_t memPool[ mem_pool_size ];
+
+	ringbuf_bcast testBuf( memPool, mem_pool_size );
+
+	rbBcastReader_t xFastReader;
+	rbBcastReader_t xSlowReader;
+
+	uint8_t testItem[ 16 ] = { 0 };
+
+	uint8_t dataBuf[ 16 ] = { 0 };
+	size_t xItemSize = 0;
+
+
+	/*
+	* TEST sequence.
+	*
+	*/
+
+	CHECK_TRUE( testBuf.setOverflowPolicy( RB_OVERFLOW_REJECT ) );
+	CHECK_TRUE( testBuf.addReader( &xFastReader ) );
+	CHECK_TRUE( testBuf.addReader( &xSlowReader ) );
+
+	CHECK_TRUE( testBuf.push( testItem, sizeof( testItem ) ) );
+	CHECK_TRUE( testBuf.push( testItem, sizeof( testItem ) ) );
+
+	CHECK_TRUE( testBuf.read( &xFastReader, dataBuf, sizeof( dataBuf ), &xItemSize ) );
+	CHECK_TRUE( testBuf.read( &xFastReader, dataBuf, sizeof( dataBuf ), &xItemSize ) );
+
+	/* Slow reader holds the space. */
+	CHECK_FALSE( testBuf.push( testItem, sizeof( testItem ) ) );
+	CHECK_EQUAL( 1, testBuf.getStats().xRejectedItems );
+
+	CHECK_TRUE( testBuf.read( &xSlowReader, dataBuf, sizeof( dataBuf ), &xItemSize ) );
+	CHECK_TRUE( testBuf.push( testItem, sizeof( testItem ) ) );
+
+	/* Removed reader is not waited for anymore. */
+	testBuf.removeReader( &xSlowReader );
+	CHECK_TRUE( testBuf.read( &xFastReader, dataBuf, sizeof( dataBuf ), &xItemSize ) );
+	CHECK_TRUE( testBuf.push( testItem, sizeof( testItem ) ) );
+
+	CHECK_EQUAL( 0, testBuf.getStats().xEvictedItems );
+	CHECK_EQUAL( 0, testBuf.getLostItems( &xFastReader ) );
+}
+
+
+TEST( ringbuf_bcast, writer_readers_threads )
+{
+	/*
+	* TEST data.
+	*
+	*/
+
+	constexpr uint32_t mem_pool_size = 1000U;
+	constexpr uint32_t readers_cnt = 3U;
+	constexpr uint32_t items_cnt = 20000U;
+
+	static uint8_t memPool[ mem_pool_size ];
+
+	static ringbuf_bcast testBuf( memPool, mem_pool_size );
+
+	static rbBcastReader_t axReaders[ readers_cnt ];
+
+	std::vector<std::thread> readers;
+	bool aisSequenceOk[ readers_cnt ];
+
+
+	/*
+	* TEST sequence.
+	*
+	*/
+
+	CHECK_TRUE( testBuf.setOverflowPolicy( RB_OVERFLOW_REJECT ) );
+
+	for( uint32_t r = 0; r < readers_cnt; ++r )
+	{
+		CHECK_TRUE( testBuf.addReader( &axReaders[ r ] ) );
+	}
+
+	/* Every reader checks it gets all items, whole and in order. */
+	for( uint32_t r = 0; r < readers_cnt; ++r )
+	{
+		readers.push_back( std::thread( [ r, &aisSequenceOk ]()
+		{
+			uint32_t rxItem[ 16 ];
+			size_t xSize = 0;
+			bool isSequenceOk = true;
+
+			for( uint32_t i = 0; i < items_cnt; ++i )
+			{
+				while( !testBuf.read( &axReaders[ r ], ( uint8_t* )rxItem, sizeof( rxItem ), &xSize ) )
+				{
+					std::this_thread::yield();
+				}
+
+				isSequenceOk &= ( xSize == ( 1 + ( i % 16 ) ) * sizeof( uint32_t ) );
+				isSequenceOk &= ( rxItem[ 0 ] == i ) && ( rxItem[ xSize / sizeof( uint32_t ) - 1 ] == i );
+			}
+
+			aisSequenceOk[ r ] = isSequenceOk && ( testBuf.getLostItems( &axReaders[ r ] ) == 0 );
+		} ) );
+	}
+
+	/* Writer pushes items of variable size, filled with their index. */
+	uint32_t item[ 16 ];
+
+	for( uint32_t i = 0; i < items_cnt; ++i )
+	{
+		const size_t xCnt = 1 + ( i % 16 );
+
+		for( size_t j = 0; j < xCnt; ++j )
+		{
+			item[ j ] = i;
+		}
+
+		while( !testBuf.push( item, xCnt * sizeof( uint32_t ) ) )
+		{
+			std::this_thread::yield();
+		}
+	}
+
+	for( std::thread& reader : readers )
+	{
+		reader.join();
+	}
+
+	for( uint32_t r = 0; r < readers_cnt; ++r )
+	{
+		CHECK_TRUE( aisSequenceOk[ r ] );
+		CHECK_TRUE( testBuf.isEmpty( &axReaders[ r ] ) );
+	}
+
+	CHECK_EQUAL( 0, testBuf.getStats().xEvictedItems );
+}
+
+
+TEST( ringbuf_bcast, reader_joins_while_writing )
+{
+	/*
+	* TEST data.
+	*
+	*/
+
+	constexpr uint32_t mem_pool_size = 256U;
+	constexpr uint32_t joins_cnt = 2000U;
+	constexpr uint32_t items_cnt = 20U;
+
+	static uint8_t memPool[ mem_pool_size ];
+
+	static ringbuf_bcast testBuf( memPool, mem_pool_size );
+
+	static std::atomic<bool> isWriting;
+
+	rbBcastReader_t xReader;
+	bool isSequenceOk = true;
+
+
+	/*
+	* TEST sequence.
+	*
+	*/
+
+	CHECK_TRUE( testBuf.setOverflowPolicy( RB_OVERFLOW_REJECT ) );
+
+	isWriting.store( true );
+
+	/* Writer keeps the buffer full of items filled with their index. */
+	std::thread writer( []()
+	{
+		uint32_t item[ 8 ];
+
+		for( uint32_t i = 0; isWriting.load(); ++i )
+		{
+			for( size_t j = 0; j < 8; ++j )
+			{
+				item[ j ] = i;
+			}
+
+			while( isWriting.load() && !testBuf.push( item, sizeof( item ) ) )
+			{
+				std::this_thread::yield();
+			}
+		}
+	} );
+
+	/* A reader registered while the writer runs is never lapped. */
+	for( uint32_t n = 0; n < joins_cnt; ++n )
+	{
+		uint32_t rxItem[ 8 ] = { 0 };
+		size_t xSize = 0;
+
+		CHECK_TRUE( testBuf.addReader( &xReader ) );
+
+		for( uint32_t i = 0; i < items_cnt; ++i )
+		{
+			const uint32_t ulPrev = rxItem[ 0 ];
+
+			while( !testBuf.read( &xReader, ( uint8_t* )rxItem, sizeof( rxItem ), &xSize ) )
+			{
+				std::this_thread::yield();
+			}
+
+			isSequenceOk &= ( xSize == sizeof( rxItem ) ) && ( rxItem[ 0 ] == rxItem[ 7 ] );
+			isSequenceOk &= ( i == 0 ) || ( rxItem[ 0 ] == ulPrev + 1 );
+		}
+
+		isSequenceOk &= ( testBuf.getLostItems( &xReader ) == 0 );
+
+		testBuf.removeReader( &xReader );
+	}
+
+	isWriting.store( false );
+	writer.join();
+
+	CHECK_TRUE( isSequenceOk );
+	CHECK_EQUAL( 0, testBuf.getStats().xEvictedItems );
+}
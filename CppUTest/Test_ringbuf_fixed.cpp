@@ -0,0 +1,343 @@
+#include "CppUTest/TestHarness.h"
+
+#include <iostream>
+#include <cstring>
+
+extern "C"
+{
+	/*
+	 * Add your c-only include files here
+	 */
+}
+
+#include "ringbuf_fixed.hpp"
+
+struct sample {
+	uint32_t ulId;
+	uint32_t ulValue;
+};
+
+static bool sumCallback( const rbConstSpan_t* pxSpans, void* pvContext )
+{
+	sample xSample;
+
+	std::memcpy( &xSample, pxSpans[ 0 ].pcData, sizeof( xSample ) );
+
+	*( uint32_t* )pvContext += xSample.ulValue;
+
+	return ( pxSpans[ 1 ].xSize == 0 );
+}
+
+TEST_GROUP( ringbuf_fixed )
+{
+    void setup()
+    {
+		//MemoryLeakWarningPlugin::saveAndDisableNewDeleteOverloads();
+    }
+
+    void teardown()
+    {
+		//MemoryLeakWarningPlugin::restoreNewDeleteOverloads();
+    }
+};
+
+
+
+TEST( ringbuf_fixed, declaration )
+{
+	/*
+	* TEST data.
+	*
+	*/
+
+	alignas( sample ) uint8_t memPool[ 7 * sizeof( sample ) ];
+
+	ringbuf_fixed<sample> testBuf( memPool, sizeof( memPool ) );
+
+	ringbuf_fixed<sample> tinyBuf( memPool, sizeof( sample ) - 1 );
+
+
+	/*
+	* TEST sequence.
+	*
+	*/
+
+	/* Slots are rounded down to a power of two. */
+	CHECK_EQUAL( 4, testBuf.getCapacity() );
+
+	/* Buffer is empty. */
+	CHECK_TRUE( testBuf.isEmpty() );
+	CHECK_EQUAL( 0, testBuf.getItemsCnt() );
+	CHECK_EQUAL( 0, testBuf.getTailSize() );
+	CHECK_EQUAL( 0, testBuf.getHeadSize() );
+	CHECK_FALSE( testBuf.deleteTail() );
+	CHECK_FALSE( testBuf.deleteHead() );
+
+	/* Empty tail holds no data. */
+	uint8_t dataBuf[ sizeof( sample ) ];
+	CHECK_FALSE( testBuf.getData( testBuf.getTail(), dataBuf ) );
+
+	/* A pool smaller than one item has no slots. */
+	CHECK_EQUAL( 0, tinyBuf.getCapacity() );
+	CHECK_FALSE( tinyBuf.push( sample{ 1, 1 } ) );
+}
+
+TEST( ringbuf_fixed, push_get_overwrite )
+{
+	/*
+	* TEST data.
+	*
+	*/
+
+	alignas( sample ) uint8_t memPool[ 4 * sizeof( sample ) ];
+
+	ringbuf_fixed<sample> testBuf( memPool, sizeof( memPool ) );
+
+	sample xOut;
+
+
+	/*
+	* TEST sequence.
+	*
+	*/
+
+	/* Only items of the fixed size are accepted. */
+	CHECK_FALSE( testBuf.push( &xOut, sizeof( sample ) - 1 ) );
+
+	/* Fill the buffer and wrap twice around the slots. */
+	for( uint32_t i = 0; i < 10; ++i )
+	{
+		CHECK_TRUE( testBuf.push( sample{ i, 10 * i } ) );
+	}
+
+	/* Only the last items are retained. */
+	CHECK_EQUAL( 4, testBuf.getItemsCnt() );
+	CHECK_EQUAL( sizeof( sample ), testBuf.getTailSize() );
+
+	rbStats_t xStats = testBuf.getStats();
+	CHECK_EQUAL( 6, xStats.xEvictedItems );
+	CHECK_EQUAL( 6 * sizeof( sample ), xStats.xEvictedBytes );
+	CHECK_EQUAL( 0, xStats.xRejectedItems );
+
+	/* Walk from tail to head. */
+	const sample* pxItem = testBuf.getTail();
+
+	CHECK_TRUE( testBuf.getPrev( pxItem ) == pxItem );
+
+	for( uint32_t i = 6; i < 10; ++i )
+	{
+		CHECK_TRUE( testBuf.getData( pxItem, ( uint8_t* )&xOut ) );
+		CHECK_EQUAL( i, xOut.ulId );
+		CHECK_EQUAL( 10 * i, xOut.ulValue );
+
+		pxItem = testBuf.getNext( pxItem );
+	}
+
+	/* The head is followed by itself. */
+	CHECK_TRUE( pxItem == testBuf.getHead() );
+	CHECK_TRUE( testBuf.getPrev( testBuf.getHead() ) != testBuf.getHead() );
+
+	/* Delete head and tail. */
+	CHECK_TRUE( testBuf.deleteHead() );
+	CHECK_TRUE( testBuf.getData( testBuf.getHead(), ( uint8_t* )&xOut ) );
+	CHECK_EQUAL( 8, xOut.ulId );
+
+	CHECK_TRUE( testBuf.deleteTail() );
+	CHECK_TRUE( testBuf.getData( testBuf.getTail(), ( uint8_t* )&xOut ) );
+	CHECK_EQUAL( 7, xOut.ulId );
+
+	CHECK_EQUAL( 2, testBuf.getItemsCnt() );
+
+	/* A deleted slot holds no data. */
+	CHECK_FALSE( testBuf.getData( testBuf.getNext( testBuf.getHead() ) + 1, ( uint8_t* )&xOut ) );
+
+	testBuf.flush();
+	CHECK_TRUE( testBuf.isEmpty() );
+}
+
+TEST( ringbuf_fixed, overflow_reject_stats )
+{
+	/*
+	* TEST data.
+	*
+	*/
+
+	alignas( sample ) uint8_t memPool[ 2 * sizeof( sample ) ];
+
+	ringbuf_fixed<sample> testBuf( memPool, sizeof( memPool ) );
+
+	const rbConstSpan_t axBatch[ 2 ] = { { memPool, sizeof( sample ) }, { memPool, sizeof( sample ) } };
+
+
+	/*
+	* TEST sequence.
+	*
+	*/
+
+	CHECK_FALSE( testBuf.setOverflowPolicy( RB_OVERFLOW_BLOCK ) );
+	CHECK_TRUE( testBuf.setOverflowPolicy( RB_OVERFLOW_REJECT ) );
+
+	CHECK_TRUE( testBuf.push( sample{ 1, 1 } ) );
+	CHECK_TRUE( testBuf.push( sample{ 2, 2 } ) );
+
+	/* Old items are kept. */
+	CHECK_FALSE( testBuf.push( sample{ 3, 3 } ) );
+	CHECK_FALSE( testBuf.pushBatch( axBatch, 2 ) );
+
+	rbStats_t xStats = testBuf.getStats();
+	CHECK_EQUAL( 0, xStats.xEvictedItems );
+	CHECK_EQUAL( 3, xStats.xRejectedItems );
+	CHECK_EQUAL( 3 * sizeof( sample ), xStats.xRejectedBytes );
+
+	sample xOut;
+	CHECK_TRUE( testBuf.getData( testBuf.getTail(), ( uint8_t* )&xOut ) );
+	CHECK_EQUAL( 1, xOut.ulId );
+}
+
+TEST( ringbuf_fixed, pushBatch )
+{
+	/*
+	* TEST data.
+	*
+	*/
+
+	alignas( sample ) uint8_t memPool[ 4 * sizeof( sample ) ];
+
+	ringbuf_fixed<sample> testBuf( memPool, sizeof( memPool ) );
+
+	const sample axSamples[ 5 ] = { { 0, 0 }, { 1, 10 }, { 2, 20 }, { 3, 30 }, { 4, 40 } };
+
+	rbConstSpan_t axBatch[ 5 ];
+
+	for( uint32_t i = 0; i < 5; ++i )
+	{
+		axBatch[ i ].pcData = ( const uint8_t* )&axSamples[ i ];
+		axBatch[ i ].xSize = sizeof( sample );
+	}
+
+
+	/*
+	* TEST sequence.
+	*
+	*/
+
+	/* More items than slots. */
+	CHECK_FALSE( testBuf.pushBatch( axBatch, 5 ) );
+
+	CHECK_TRUE( testBuf.push( axSamples[ 0 ] ) );
+	CHECK_TRUE( testBuf.push( axSamples[ 0 ] ) );
+
+	/* The two old items make room for the batch. */
+	CHECK_TRUE( testBuf.pushBatch( &axBatch[ 1 ], 4 ) );
+	CHECK_EQUAL( 4, testBuf.getItemsCnt() );
+	CHECK_EQUAL( 2, testBuf.getStats().xEvictedItems );
+
+	sample xOut;
+	CHECK_TRUE( testBuf.getData( testBuf.getTail(), ( uint8_t* )&xOut ) );
+	CHECK_EQUAL( 1, xOut.ulId );
+	CHECK_TRUE( testBuf.getData( testBuf.getHead(), ( uint8_t* )&xOut ) );
+	CHECK_EQUAL( 4, xOut.ulId );
+
+	/* Items of another size are not accepted. */
+	axBatch[ 2 ].xSize = 1;
+	CHECK_FALSE( testBuf.pushBatch( axBatch, 3 ) );
+	CHECK_EQUAL( 4, testBuf.getItemsCnt() );
+}
+
+TEST( ringbuf_fixed, reserve_commit_abort )
+{
+	/*
+	* TEST data.
+	*
+	*/
+
+	alignas( sample ) uint8_t memPool[ 2 * sizeof( sample ) ];
+
+	ringbuf_fixed<sample> testBuf( memPool, sizeof( memPool ) );
+
+	rbSpan_t axSpans[ 2 ];
+
+
+	/*
+	* TEST sequence.
+	*
+	*/
+
+	CHECK_FALSE( testBuf.reserve( sizeof( sample ) + 1, axSpans ) );
+
+	CHECK_TRUE( testBuf.reserve( sizeof( sample ), axSpans ) );
+	CHECK_EQUAL( sizeof( sample ), axSpans[ 0 ].xSize );
+	CHECK_EQUAL( 0, axSpans[ 1 ].xSize );
+
+	/* Buffer cannot be modified until commit. */
+	CHECK_FALSE( testBuf.push( sample{ 9, 9 } ) );
+	CHECK_FALSE( testBuf.reserve( sizeof( sample ), axSpans ) );
+
+	const sample xIn = { 5, 50 };
+	std::memcpy( axSpans[ 0 ].pcData, &xIn, sizeof( xIn ) );
+
+	CHECK_TRUE( testBuf.commit() );
+	CHECK_FALSE( testBuf.commit() );
+	CHECK_EQUAL( 1, testBuf.getItemsCnt() );
+
+	/* Aborted reservation inserts nothing. */
+	CHECK_TRUE( testBuf.reserve( sizeof( sample ), axSpans ) );
+	testBuf.abort();
+	CHECK_FALSE( testBuf.commit() );
+	CHECK_EQUAL( 1, testBuf.getItemsCnt() );
+
+	sample xOut;
+	CHECK_TRUE( testBuf.getData( testBuf.getHead(), ( uint8_t* )&xOut ) );
+	CHECK_EQUAL( 5, xOut.ulId );
+	CHECK_EQUAL( 50, xOut.ulValue );
+}
+
+TEST( ringbuf_fixed, peek_consume_drain )
+{
+	/*
+	* TEST data.
+	*
+	*/
+
+	uint8_t memPool[ 8 * sizeof( sample ) + 1 ];
+
+	/* Pool not aligned for the items. */
+	ringbuf_fixed<sample> testBuf( memPool + 1, 8 * sizeof( sample ) );
+
+	rbConstSpan_t axSpans[ 2 ];
+
+	uint32_t ulSum = 0;
+
+
+	/*
+	* TEST sequence.
+	*
+	*/
+
+	/* The unaligned start is skipped. */
+	CHECK_EQUAL( 4, testBuf.getCapacity() );
+
+	for( uint32_t i = 1; i <= 6; ++i )
+	{
+		CHECK_TRUE( testBuf.push( sample{ i, i } ) );
+	}
+
+	/* Items 3 to 6 are retained. */
+	CHECK_TRUE( testBuf.peek( testBuf.getTail(), axSpans ) );
+	CHECK_EQUAL( sizeof( sample ), axSpans[ 0 ].xSize );
+	CHECK_EQUAL( 0, axSpans[ 1 ].xSize );
+	CHECK_EQUAL( 3, ( ( const sample* )axSpans[ 0 ].pcData )->ulId );
+
+	CHECK_TRUE( testBuf.consume() );
+
+	/* Byte limit stops before the third item. */
+	CHECK_EQUAL( 2, testBuf.drain( sumCallback, &ulSum, 10, 2 * sizeof( sample ) + 1 ) );
+	CHECK_EQUAL( 4 + 5, ulSum );
+
+	CHECK_EQUAL( 1, testBuf.drain( sumCallback, &ulSum, 10, SIZE_MAX ) );
+	CHECK_EQUAL( 4 + 5 + 6, ulSum );
+
+	CHECK_TRUE( testBuf.isEmpty() );
+	CHECK_FALSE( testBuf.consume() );
+	CHECK_FALSE( testBuf.peek( testBuf.getTail(), axSpans ) );
+}
@@ -0,0 +1,349 @@
+#include "CppUTest/TestHarness.h"
+
+#include <atomic>
+#include <iostream>
+#include <cstring>
+#include <thread>
+#include <vector>
+
+extern "C"
+{
+	/*
+	 * Add your c-only include files here
+	 */
+}
+
+#include "ringbuf_mpmc.hpp"
+
+TEST_GROUP( ringbuf_mpmc )
+{
+    void setup()
+    {
+		//MemoryLeakWarningPlugin::saveAndDisableNewDeleteOverloads();
+    }
+
+    void teardown()
+    {
+		//MemoryLeakWarningPlugin::restoreNewDeleteOverloads();
+    }
+};
+
+
+
+TEST( ringbuf_mpmc, declaration )
+{
+	/*
+	* TEST data.
+	*
+	*/
+
+	constexpr uint32_t mem_pool_size = 128U;
+
+	alignas( std::size_t ) uint8_t memPool[ mem_pool_size ];
+
+	ringbuf_mpmc testBuf( memPool, mem_pool_size );
+
+	rbMpmcClaim_t xClaim;
+
+
+	/*
+	* TEST sequence.
+	*
+	*/
+
+	/* Buffer is empty. */
+	CHECK_TRUE( testBuf.isEmpty() );
+
+	/* No item to claim. */
+	CHECK_FALSE( testBuf.claimItem( &xClaim ) );
+}
+
+
+TEST( ringbuf_mpmc, push_claim_release )
+{
+	/*
+	* TEST data.
+	*
+	*/
+
+	constexpr uint32_t mem_pool_size = 128U;
+
+	alignas( std::size_t ) uint8_t memPool[ mem_pool_size ];
+
+	ringbuf_mpmc testBuf( memPool, mem_pool_size );
+
+	uint8_t  testItem1[ ] = { 1, 2, 3, 4, 5 };
+	uint16_t testItem2[ ] = { 101, 102, 103 };
+
+	uint8_t dataBuf[ 10 ] = { 0 };
+
+	rbMpmcClaim_t xClaim1;
+	rbMpmcClaim_t xClaim2;
+
+
+	/*
+	* TEST sequence.
+	*
+	*/
+
+	CHECK_TRUE( testBuf.push( testItem1, sizeof( testItem1 ) ) );
+	CHECK_TRUE( testBuf.push( testItem2, sizeof( testItem2 ) ) );
+
+	CHECK_FALSE( testBuf.isEmpty() );
+
+	/* Items are claimed oldest first. */
+	CHECK_TRUE( testBuf.claimItem( &xClaim1 ) );
+	CHECK_TRUE( testBuf.claimItem( &xClaim2 ) );
+
+	/* Claimed items are not available anymore. */
+	CHECK_TRUE( testBuf.isEmpty() );
+	CHECK_FALSE( testBuf.claimItem( &xClaim1 ) );
+
+	CHECK_EQUAL( sizeof( testItem1 ), xClaim1.xItemSize );
+	testBuf.getData( &xClaim1, dataBuf );
+	CHECK_EQUAL( 0, memcmp( testItem1, dataBuf, sizeof( testItem1 ) ) );
+
+	CHECK_EQUAL( sizeof( testItem2 ), xClaim2.xItemSize );
+	testBuf.getData( &xClaim2, dataBuf );
+	CHECK_EQUAL( 0, memcmp( testItem2, dataBuf, sizeof( testItem2 ) ) );
+
+	testBuf.releaseItem( &xClaim1 );
+	testBuf.releaseItem( &xClaim2 );
+
+	CHECK_TRUE( testBuf.isEmpty() );
+}
+
+
+TEST( ringbuf_mpmc, unaligned_pool )
+{
+	/*
+	* TEST data.
+	*
+	*/
+
+	constexpr uint32_t mem_pool_size = 72U;
+
+	alignas( std::size_t ) uint8_t memPool[ mem_pool_size ];
+
+	/* Start of the pool not aligned for the item headers. */
+	ringbuf_mpmc testBuf( memPool + 1, mem_pool_size - 1 );
+
+	uint8_t testItem[ 64 - sizeof( std::size_t ) ];
+
+	uint8_t dataBuf[ sizeof( testItem ) ] = { 0 };
+
+	rbMpmcClaim_t xClaim;
+
+	for( uint8_t i = 0; i < sizeof( testItem ); ++i )
+	{
+		testItem[ i ] = i;
+	}
+
+
+	/*
+	* TEST sequence.
+	*
+	*/
+
+	/* Aligned part of the pool holds a single item. */
+	CHECK_TRUE( testBuf.push( testItem, sizeof( testItem ) ) );
+	CHECK_FALSE( testBuf.push( testItem, 1 ) );
+
+	CHECK_TRUE( testBuf.claimItem( &xClaim ) );
+	testBuf.getData( &xClaim, dataBuf );
+	CHECK_EQUAL( 0, memcmp( testItem, dataBuf, sizeof( testItem ) ) );
+
+	testBuf.releaseItem( &xClaim );
+	CHECK_TRUE( testBuf.isEmpty() );
+}
+
+
+TEST( ringbuf_mpmc, release_out_of_order )
+{
+	/*
+	* TEST data.
+	*
+	*/
+
+	constexpr uint32_t mem_pool_size = 64U;
+
+	alignas( std::size_t ) uint8_t memPool[ mem_pool_size ];
+
+	ringbuf_mpmc testBuf( memPool, mem_pool_size );
+
+	uint8_t testItem[ 24 ] = { 0 };
+
+	rbMpmcClaim_t xClaim1;
+	rbMpmcClaim_t xClaim2;
+
+
+	/*
+	* TEST sequence.
+	*
+	*/
+
+	/* Each item takes 32 [byte]: the buffer is full. */
+	CHECK_TRUE( testBuf.push( testItem, sizeof( testItem ) ) );
+	CHECK_TRUE( testBuf.push( testItem, sizeof( testItem ) ) );
+	CHECK_FALSE( testBuf.push( testItem, sizeof( testItem ) ) );
+
+	CHECK_TRUE( testBuf.claimItem( &xClaim1 ) );
+	CHECK_TRUE( testBuf.claimItem( &xClaim2 ) );
+
+	/* Newest item released first: its space is not reclaimed yet. */
+	testBuf.releaseItem( &xClaim2 );
+	CHECK_FALSE( testBuf.push( testItem, sizeof( testItem ) ) );
+
+	/* Oldest item released: space of both items is reclaimed. */
+	testBuf.releaseItem( &xClaim1 );
+	CHECK_TRUE( testBuf.push( testItem, sizeof( testItem ) ) );
+	CHECK_TRUE( testBuf.push( testItem, sizeof( testItem ) ) );
+
+	CHECK_EQUAL( 2, testBuf.getStats().xRejectedItems );
+	CHECK_EQUAL( 2 * sizeof( testItem ), testBuf.getStats().xRejectedBytes );
+}
+
+
+TEST( ringbuf_mpmc, claim_rollover )
+{
+	/*
+	* TEST data.
+	*
+	*/
+
+	constexpr uint32_t mem_pool_size = 64U;
+
+	alignas( std::size_t ) uint8_t memPool[ mem_pool_size ];
+
+	ringbuf_mpmc testBuf( memPool, mem_pool_size );
+
+	uint8_t testItem1[ 40 ] = { 0 };
+	uint8_t testItem2[ ] = { 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12 };
+
+	rbMpmcClaim_t xClaim;
+
+
+	/*
+	* TEST sequence.
+	*
+	*/
+
+	/* Move head and tail close to the end of the buffer. */
+	CHECK_TRUE( testBuf.push( testItem1, sizeof( testItem1 ) ) );
+	CHECK_TRUE( testBuf.claimItem( &xClaim ) );
+	testBuf.releaseItem( &xClaim );
+
+	/* Data of the item rolls over. */
+	CHECK_TRUE( testBuf.push( testItem2, sizeof( testItem2 ) ) );
+	CHECK_TRUE( testBuf.claimItem( &xClaim ) );
+
+	CHECK_EQUAL( 8, xClaim.axSpans[ 0 ].xSize );
+	CHECK_EQUAL( 4, xClaim.axSpans[ 1 ].xSize );
+	CHECK_EQUAL( 0, memcmp( testItem2, xClaim.axSpans[ 0 ].pcData, xClaim.axSpans[ 0 ].xSize ) );
+	CHECK_EQUAL( 0, memcmp( testItem2 + 8, xClaim.axSpans[ 1 ].pcData, xClaim.axSpans[ 1 ].xSize ) );
+
+	testBuf.releaseItem( &xClaim );
+	CHECK_TRUE( testBuf.isEmpty() );
+}
+
+
+TEST( ringbuf_mpmc, producers_consumers_threads )
+{
+	/*
+	* TEST data.
+	*
+	*/
+
+	constexpr uint32_t mem_pool_size = 1000U;
+	constexpr uint32_t producers_cnt = 2U;
+	constexpr uint32_t consumers_cnt = 3U;
+	constexpr uint32_t items_cnt = 20000U;
+
+	alignas( std::size_t ) static uint8_t memPool[ mem_pool_size ];
+
+	static ringbuf_mpmc testBuf( memPool, mem_pool_size );
+
+	std::vector<std::thread> threads;
+
+	std::atomic<uint32_t> xReceivedCnt( 0 );
+	std::atomic<uint64_t> xReceivedSum( 0 );
+	std::atomic<bool> isItemOk( true );
+
+
+	/*
+	* TEST sequence.
+	*
+	*/
+
+	/* Each producer pushes items of variable size, filled with the item index. */
+	for( uint32_t p = 0; p < producers_cnt; ++p )
+	{
+		threads.push_back( std::thread( []()
+		{
+			uint32_t item[ 16 ];
+
+			for( uint32_t i = 0; i < items_cnt; ++i )
+			{
+				const size_t xCnt = 1 + ( i % 16 );
+
+				for( size_t j = 0; j < xCnt; ++j )
+				{
+					item[ j ] = i;
+				}
+
+				while( !testBuf.push( item, xCnt * sizeof( uint32_t ) ) )
+				{
+					std::this_thread::yield();
+				}
+			}
+		} ) );
+	}
+
+	/* Consumers check items come out whole, and share all of them. */
+	for( uint32_t c = 0; c < consumers_cnt; ++c )
+	{
+		threads.push_back( std::thread( [ & ]()
+		{
+			uint32_t rxItem[ 16 ];
+			rbMpmcClaim_t xClaim;
+
+			while( xReceivedCnt.load() < ( producers_cnt * items_cnt ) )
+			{
+				if( testBuf.claimItem( &xClaim ) )
+				{
+					testBuf.getData( &xClaim, ( uint8_t* )rxItem );
+					testBuf.releaseItem( &xClaim );
+
+					const size_t xCnt = xClaim.xItemSize / sizeof( uint32_t );
+
+					if(    ( xCnt != ( 1 + ( rxItem[ 0 ] % 16 ) ) ) \
+						|| ( rxItem[ xCnt - 1 ] != rxItem[ 0 ] )    )
+					{
+						isItemOk = false;
+					}
+
+					xReceivedSum += rxItem[ 0 ];
+					++xReceivedCnt;
+				}
+				else
+				{
+					std::this_thread::yield();
+				}
+			}
+		} ) );
+	}
+
+	for( std::thread& thread : threads )
+	{
+		thread.join();
+	}
+
+	CHECK_TRUE( isItemOk );
+	CHECK_EQUAL( producers_cnt * items_cnt, xReceivedCnt.load() );
+	CHECK_EQUAL( ( uint64_t )producers_cnt * items_cnt * ( items_cnt - 1 ) / 2, xReceivedSum.load() );
+	CHECK_TRUE( testBuf.isEmpty() );
+
+	/* All the space is reclaimed. */
+	uint8_t testItem[ mem_pool_size - 8 ];
+	CHECK_TRUE( testBuf.push( testItem, sizeof( testItem ) ) );
+}
@@ -0,0 +1,379 @@
+#include "CppUTest/TestHarness.h"
+
+#include <iostream>
+#include <cstring>
+#include <thread>
+#include <vector>
+
+extern "C"
+{
+	/*
+	 * Add your c-only include files here
+	 */
+}
+
+#include "ringbuf_mpsc.hpp"
+
+TEST_GROUP( ringbuf_mpsc )
+{
+    void setup()
+    {
+		//MemoryLeakWarningPlugin::saveAndDisableNewDeleteOverloads();
+    }
+
+    void teardown()
+    {
+		//MemoryLeakWarningPlugin::restoreNewDeleteOverloads();
+    }
+};
+
+
+
+TEST( ringbuf_mpsc, declaration )
+{
+	/*
+	* TEST data.
+	*
+	*/
+
+	constexpr uint32_t mem_pool_size = 128U;
+
+	alignas( std::size_t ) uint8_t memPool[ mem_pool_size ];
+
+	ringbuf_mpsc testBuf( memPool, mem_pool_size );
+
+
+	/*
+	* TEST sequence.
+	*
+	*/
+
+	/* Buffer is empty. */
+	CHECK_TRUE( testBuf.isEmpty() );
+
+	/* Tail cannot be deleted. */
+	CHECK_FALSE( testBuf.deleteTail() );
+
+	/* No items present. */
+	CHECK_EQUAL( 0, testBuf.getItemsCnt() );
+
+	/* Tail size is zero. */
+	CHECK_EQUAL( 0, testBuf.getTailSize() );
+}
+
+
+TEST( ringbuf_mpsc, push_get_delete )
+{
+	/*
+	* TEST data.
+	*
+	*/
+
+	constexpr uint32_t mem_pool_size = 128U;
+
+	alignas( std::size_t ) uint8_t memPool[ mem_pool_size ];
+
+	ringbuf_mpsc testBuf( memPool, mem_pool_size );
+
+	uint8_t  testItem1[ ] = { 1, 2, 3, 4, 5 };
+	uint16_t testItem2[ ] = { 101, 102, 103 };
+
+	uint8_t dataBuf[ 10 ] = { 0 };
+
+
+	/*
+	* TEST sequence.
+	*
+	*/
+
+	CHECK( testBuf.push( testItem1, sizeof( testItem1 ) ) );
+	CHECK( testBuf.push( testItem2, sizeof( testItem2 ) ) );
+
+	CHECK_FALSE( testBuf.isEmpty() );
+	CHECK_EQUAL( 2, testBuf.getItemsCnt() );
+
+	/* Tail is the oldest item. */
+	CHECK_EQUAL( sizeof( testItem1 ), testBuf.getTailSize() );
+	CHECK_TRUE( testBuf.getData( dataBuf ) );
+	CHECK_EQUAL( 0, memcmp( testItem1, dataBuf, sizeof( testItem1 ) ) );
+
+	CHECK_TRUE( testBuf.deleteTail() );
+
+	CHECK_EQUAL( sizeof( testItem2 ), testBuf.getTailSize() );
+	CHECK_TRUE( testBuf.getData( dataBuf ) );
+	CHECK_EQUAL( 0, memcmp( testItem2, dataBuf, sizeof( testItem2 ) ) );
+
+	CHECK_TRUE( testBuf.deleteTail() );
+
+	CHECK_TRUE( testBuf.isEmpty() );
+	CHECK_EQUAL( 0, testBuf.getItemsCnt() );
+}
+
+
+TEST( ringbuf_mpsc, unaligned_pool )
+{
+	/*
+	* TEST data.
+	*
+	*/
+
+	constexpr uint32_t mem_pool_size = 72U;
+
+	alignas( std::size_t ) uint8_t memPool[ mem_pool_size ];
+
+	/* Start of the pool not aligned for the item headers. */
+	ringbuf_mpsc testBuf( memPool + 1, mem_pool_size - 1 );
+
+	uint8_t testItem[ 64 - sizeof( std::size_t ) ];
+
+	uint8_t dataBuf[ sizeof( testItem ) ] = { 0 };
+
+	for( uint8_t i = 0; i < sizeof( testItem ); ++i )
+	{
+		testItem[ i ] = i;
+	}
+
+
+	/*
+	* TEST sequence.
+	*
+	*/
+
+	/* Aligned part of the pool holds a single item. */
+	CHECK_TRUE( testBuf.push( testItem, sizeof( testItem ) ) );
+	CHECK_FALSE( testBuf.push( testItem, 1 ) );
+
+	CHECK_TRUE( testBuf.getData( dataBuf ) );
+	CHECK_EQUAL( 0, memcmp( testItem, dataBuf, sizeof( testItem ) ) );
+
+	CHECK_TRUE( testBuf.deleteTail() );
+	CHECK_TRUE( testBuf.isEmpty() );
+}
+
+
+TEST( ringbuf_mpsc, full_rejects_push )
+{
+	/*
+	* TEST data.
+	*
+	*/
+
+	constexpr uint32_t mem_pool_size = 64U;
+
+	alignas( std::size_t ) uint8_t memPool[ mem_pool_size ];
+
+	ringbuf_mpsc testBuf( memPool, mem_pool_size );
+
+	uint8_t testItem[ 24 ] = { 0 };
+
+
+	/*
+	* TEST sequence.
+	*
+	*/
+
+	/* Item bigger than the buffer. */
+	CHECK_FALSE( testBuf.push( testItem, mem_pool_size ) );
+
+	/* Each item takes 32 [byte]: the buffer can be filled up completely. */
+	CHECK_TRUE( testBuf.push( testItem, sizeof( testItem ) ) );
+	CHECK_TRUE( testBuf.push( testItem, sizeof( testItem ) ) );
+	CHECK_FALSE( testBuf.push( testItem, sizeof( testItem ) ) );
+
+	/* Oldest items are retained. */
+	CHECK_EQUAL( 2, testBuf.getItemsCnt() );
+
+	CHECK_EQUAL( 1, testBuf.getStats().xRejectedItems );
+	CHECK_EQUAL( sizeof( testItem ), testBuf.getStats().xRejectedBytes );
+
+	/* Room is given back by the consumer. */
+	CHECK_TRUE( testBuf.deleteTail() );
+	CHECK_TRUE( testBuf.push( testItem, sizeof( testItem ) ) );
+	CHECK_EQUAL( 2, testBuf.getItemsCnt() );
+
+	testBuf.flush();
+	CHECK_TRUE( testBuf.isEmpty() );
+}
+
+
+TEST( ringbuf_mpsc, peek_consume_rollover )
+{
+	/*
+	* TEST data.
+	*
+	*/
+
+	constexpr uint32_t mem_pool_size = 64U;
+
+	alignas( std::size_t ) uint8_t memPool[ mem_pool_size ];
+
+	ringbuf_mpsc testBuf( memPool, mem_pool_size );
+
+	uint8_t testItem1[ 40 ] = { 0 };
+	uint8_t testItem2[ ] = { 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12 };
+
+	rbConstSpan_t axSpans[ 2 ];
+
+
+	/*
+	* TEST sequence.
+	*
+	*/
+
+	/* Empty ring buf. */
+	CHECK_FALSE( testBuf.peek( axSpans ) );
+
+	/* Move head and tail close to the end of the buffer. */
+	CHECK_TRUE( testBuf.push( testItem1, sizeof( testItem1 ) ) );
+	CHECK_TRUE( testBuf.consume() );
+
+	/* Data of the item rolls over. */
+	CHECK_TRUE( testBuf.push( testItem2, sizeof( testItem2 ) ) );
+	CHECK_TRUE( testBuf.peek( axSpans ) );
+
+	CHECK_EQUAL( 8, axSpans[ 0 ].xSize );
+	CHECK_EQUAL( 4, axSpans[ 1 ].xSize );
+	CHECK_EQUAL( 0, memcmp( testItem2, axSpans[ 0 ].pcData, axSpans[ 0 ].xSize ) );
+	CHECK_EQUAL( 0, memcmp( testItem2 + 8, axSpans[ 1 ].pcData, axSpans[ 1 ].xSize ) );
+
+	CHECK_TRUE( testBuf.consume() );
+	CHECK_TRUE( testBuf.isEmpty() );
+}
+
+
+TEST( ringbuf_mpsc, drain )
+{
+	/*
+	* TEST data.
+	*
+	*/
+
+	constexpr uint32_t mem_pool_size = 64U;
+
+	alignas( std::size_t ) uint8_t memPool[ mem_pool_size ];
+
+	ringbuf_mpsc testBuf( memPool, mem_pool_size );
+
+	uint8_t testItem[ 8 ] = { 0 };
+
+	size_t xDrainedSize = 0;
+
+	rbDrainCallback_t pxCallback = []( const rbConstSpan_t* pxSpans, void* pvContext )
+	{
+		*( size_t* )pvContext += pxSpans[ 0 ].xSize + pxSpans[ 1 ].xSize;
+
+		return true;
+	};
+
+
+	/*
+	* TEST sequence.
+	*
+	*/
+
+	CHECK_EQUAL( 0, testBuf.drain( pxCallback, &xDrainedSize, 10, 100 ) );
+
+	/* Full buffer: 4 items of 16 [byte]. */
+	for( uint8_t i = 0; i < 4; ++i )
+	{
+		CHECK_TRUE( testBuf.push( testItem, sizeof( testItem ) ) );
+	}
+
+	CHECK_EQUAL( 4, testBuf.getItemsCnt() );
+
+	/* Byte limit. */
+	CHECK_EQUAL( 1, testBuf.drain( pxCallback, &xDrainedSize, 10, 15 ) );
+	CHECK_EQUAL( 3, testBuf.getItemsCnt() );
+
+	/* Whole buffer, even when full again. */
+	CHECK_TRUE( testBuf.push( testItem, sizeof( testItem ) ) );
+	CHECK_EQUAL( 4, testBuf.drain( pxCallback, &xDrainedSize, 10, 100 ) );
+
+	CHECK_EQUAL( 5 * sizeof( testItem ), xDrainedSize );
+	CHECK_TRUE( testBuf.isEmpty() );
+}
+
+
+TEST( ringbuf_mpsc, producers_consumer_threads )
+{
+	/*
+	* TEST data.
+	*
+	*/
+
+	constexpr uint32_t mem_pool_size = 1000U;
+	constexpr uint32_t producers_cnt = 4U;
+	constexpr uint32_t items_cnt = 20000U;
+
+	alignas( std::size_t ) static uint8_t memPool[ mem_pool_size ];
+
+	static ringbuf_mpsc testBuf( memPool, mem_pool_size );
+
+	std::vector<std::thread> producers;
+	uint32_t axNextItem[ producers_cnt ] = { 0 };
+
+	bool isSequenceOk = true;
+
+
+	/*
+	* TEST sequence.
+	*
+	*/
+
+	/* Each producer pushes items of variable size: producer index, then item index. */
+	for( uint32_t p = 0; p < producers_cnt; ++p )
+	{
+		producers.push_back( std::thread( [ p ]()
+		{
+			uint32_t item[ 16 ];
+
+			for( uint32_t i = 0; i < items_cnt; ++i )
+			{
+				const size_t xCnt = 2 + ( i % 14 );
+
+				item[ 0 ] = p;
+
+				for( size_t j = 1; j < xCnt; ++j )
+				{
+					item[ j ] = i;
+				}
+
+				while( !testBuf.push( item, xCnt * sizeof( uint32_t ) ) )
+				{
+					std::this_thread::yield();
+				}
+			}
+		} ) );
+	}
+
+	/* Consumer checks items come out whole and in order for each producer. */
+	uint32_t rxItem[ 16 ];
+
+	for( uint32_t i = 0; i < ( producers_cnt * items_cnt ); ++i )
+	{
+		while( testBuf.isEmpty() )
+		{
+			std::this_thread::yield();
+		}
+
+		const size_t xSize = testBuf.getTailSize();
+
+		testBuf.getData( ( uint8_t* )rxItem );
+		testBuf.deleteTail();
+
+		const uint32_t p = rxItem[ 0 ] % producers_cnt;
+		const uint32_t xIdx = axNextItem[ p ]++;
+
+		isSequenceOk &= ( xSize == ( 2 + ( xIdx % 14 ) ) * sizeof( uint32_t ) );
+		isSequenceOk &= ( rxItem[ 1 ] == xIdx ) && ( rxItem[ xSize / sizeof( uint32_t ) - 1 ] == xIdx );
+	}
+
+	for( std::thread& producer : producers )
+	{
+		producer.join();
+	}
+
+	CHECK_TRUE( isSequenceOk );
+	CHECK_TRUE( testBuf.isEmpty() );
+	CHECK_EQUAL( 0, testBuf.getItemsCnt() );
+}
@@ -0,0 +1,326 @@
+#include "CppUTest/TestHarness.h"
+
+#include <iostream>
+#include <cstring>
+#include <string>
+
+#if defined( __linux__ )
+#include <sys/wait.h>
+#include <unistd.h>
+#endif
+
+extern "C"
+{
+	/*
+	 * Add your c-only include files here
+	 */
+}
+
+#include "ringbuf_shm.hpp"
+
+TEST_GROUP( ringbuf_shm )
+{
+    void setup()
+    {	
+		//MemoryLeakWarningPlugin::saveAndDisableNewDeleteOverloads();
+    }
+
+    void teardown()
+    {
+		//MemoryLeakWarningPlugin::restoreNewDeleteOverloads();
+    }
+};
+
+
+
+TEST( ringbuf_shm, create_attach )
+{
+	/*
+	* TEST data.
+	*
+	*/
+
+	alignas( RINGBUF_CACHE_LINE_SIZE ) static uint8_t memRegion[ sizeof( rbShmCtrl_t ) + 128U ];
+
+	uint32_t testItem[ 5 ] = { 1, 2, 3, 4, 5 };
+	uint32_t dataBuf[ 5 ] = { 0 };
+
+
+	/*
+	* TEST sequence.
+	*
+	*/
+
+	/* Nothing to attach to yet. */
+	std::memset( memRegion, 0xA5, sizeof( memRegion ) );
+
+	ringbuf_shm noBuf( memRegion, sizeof( memRegion ), RB_SHM_ATTACH );
+
+	CHECK_FALSE( noBuf.isAttached() );
+	CHECK_TRUE( noBuf.isEmpty() );
+	CHECK_FALSE( noBuf.push( testItem, sizeof( testItem ) ) );
+	CHECK_FALSE( noBuf.waitForData( 0 ) );
+	CHECK_EQUAL( 0, noBuf.getItemsCnt() );
+
+	/* Region too small or misaligned. */
+	ringbuf_shm smallBuf( memRegion, sizeof( rbShmCtrl_t ), RB_SHM_CREATE );
+	ringbuf_shm misalignedBuf( memRegion + 1, sizeof( memRegion ) - 1, RB_SHM_CREATE );
+
+	CHECK_FALSE( smallBuf.isAttached() );
+	CHECK_FALSE( misalignedBuf.isAttached() );
+
+	/* Producer creates, consumer attaches. */
+	ringbuf_shm producer( memRegion, sizeof( memRegion ), RB_SHM_CREATE );
+	ringbuf_shm consumer( memRegion, sizeof( memRegion ), RB_SHM_ATTACH );
+
+	CHECK_TRUE( producer.isAttached() );
+	CHECK_TRUE( consumer.isAttached() );
+	CHECK_TRUE( consumer.isEmpty() );
+
+	CHECK_TRUE( producer.push( testItem, sizeof( testItem ) ) );
+	CHECK_TRUE( producer.push( testItem, sizeof( testItem ) ) );
+
+	/* Region smaller than the ring buffer created in it. */
+	ringbuf_shm truncatedBuf( memRegion, sizeof( memRegion ) - 8U, RB_SHM_ATTACH );
+
+	CHECK_FALSE( truncatedBuf.isAttached() );
+
+	/* Attaching does not reset the content. */
+	ringbuf_shm lateConsumer( memRegion, sizeof( memRegion ), RB_SHM_ATTACH );
+
+	CHECK_EQUAL( 2, lateConsumer.getItemsCnt() );
+
+	CHECK_TRUE( consumer.waitForData( 0 ) );
+	CHECK_EQUAL( sizeof( testItem ), consumer.getTailSize() );
+	CHECK_TRUE( consumer.getData( ( uint8_t* )dataBuf ) );
+	CHECK_EQUAL( 0, memcmp( testItem, dataBuf, sizeof( testItem ) ) );
+	CHECK_TRUE( consumer.deleteTail() );
+
+	consumer.flush();
+
+	CHECK_TRUE( consumer.isEmpty() );
+	CHECK_EQUAL( 0, producer.getItemsCnt() );
+}
+
+
+static bool drainNothing( const rbConstSpan_t* pxSpans, void* pvContext )
+{
+	( void )pxSpans;
+	( void )pvContext;
+
+	return true;
+}
+
+
+TEST( ringbuf_shm, corrupted_region )
+{
+	/*
+	* TEST data.
+	*
+	*/
+
+	alignas( RINGBUF_CACHE_LINE_SIZE ) static uint8_t memRegion[ sizeof( rbShmCtrl_t ) + 128U ];
+
+	rbShmCtrl_t* pxCtrl = ( rbShmCtrl_t* )memRegion;
+	rbShmItem_t* pxTailItem = ( rbShmItem_t* )( memRegion + sizeof( rbShmCtrl_t ) );
+
+	uint32_t testItem[ 5 ] = { 1, 2, 3, 4, 5 };
+	uint32_t dataBuf[ 5 ] = { 0 };
+	rbConstSpan_t axSpans[ 2 ];
+
+
+	/*
+	* TEST sequence.
+	*
+	*/
+
+	ringbuf_shm producer( memRegion, sizeof( memRegion ), RB_SHM_CREATE );
+
+	CHECK_TRUE( producer.push( testItem, sizeof( testItem ) ) );
+
+	/* Offsets outside the buffer or not on an item header. */
+	pxCtrl->xSpscCtrl.xHead.store( pxCtrl->xBufSize );
+
+	ringbuf_shm headOutBuf( memRegion, sizeof( memRegion ), RB_SHM_ATTACH );
+
+	pxCtrl->xSpscCtrl.xHead.store( sizeof( rbShmItem_t ) + 1U );
+
+	ringbuf_shm headMisalignedBuf( memRegion, sizeof( memRegion ), RB_SHM_ATTACH );
+
+	pxCtrl->xSpscCtrl.xHead.store( sizeof( rbShmItem_t ) + sizeof( testItem ) + 4U );
+	pxCtrl->xSpscCtrl.xTail.store( pxCtrl->xBufSize + sizeof( rbShmItem_t ) );
+
+	ringbuf_shm tailOutBuf( memRegion, sizeof( memRegion ), RB_SHM_ATTACH );
+
+	pxCtrl->xSpscCtrl.xTail.store( 2U );
+
+	ringbuf_shm tailMisalignedBuf( memRegion, sizeof( memRegion ), RB_SHM_ATTACH );
+
+	CHECK_FALSE( headOutBuf.isAttached() );
+	CHECK_FALSE( headMisalignedBuf.isAttached() );
+	CHECK_FALSE( tailOutBuf.isAttached() );
+	CHECK_FALSE( tailMisalignedBuf.isAttached() );
+
+	pxCtrl->xSpscCtrl.xTail.store( 0 );
+
+	/* Item size that push() could not have stored. */
+	ringbuf_shm consumer( memRegion, sizeof( memRegion ), RB_SHM_ATTACH );
+
+	CHECK_TRUE( consumer.isAttached() );
+
+	pxTailItem->xItemSize = pxCtrl->xBufSize;
+
+	CHECK_FALSE( consumer.isEmpty() );
+	CHECK_EQUAL( 0, consumer.getTailSize() );
+	CHECK_FALSE( consumer.peek( axSpans ) );
+	CHECK_FALSE( consumer.getData( ( uint8_t* )dataBuf ) );
+	CHECK_EQUAL( 0, consumer.drain( drainNothing, nullptr, SIZE_MAX, SIZE_MAX ) );
+	CHECK_FALSE( consumer.deleteTail() );
+	CHECK_EQUAL( 1, consumer.getItemsCnt() );
+
+	/* Restored header. */
+	pxTailItem->xItemSize = sizeof( testItem );
+
+	CHECK_TRUE( consumer.getData( ( uint8_t* )dataBuf ) );
+	CHECK_EQUAL( 0, memcmp( testItem, dataBuf, sizeof( testItem ) ) );
+	CHECK_EQUAL( 1, consumer.drain( drainNothing, nullptr, SIZE_MAX, SIZE_MAX ) );
+	CHECK_TRUE( consumer.isEmpty() );
+}
+
+
+#if defined( __linux__ )
+
+TEST( ringbuf_shm, named_region_two_mappings )
+{
+	/*
+	* TEST data.
+	*
+	*/
+
+	const std::string regionName = "/ringbuf_shm_test_" + std::to_string( getpid() );
+
+	std::size_t xRegionSize = 4096U;
+	std::size_t xAttachedSize = 0;
+
+	uint8_t testItem[ 100 ];
+	uint8_t dataBuf[ 100 ];
+
+
+	/*
+	* TEST sequence.
+	*
+	*/
+
+	/* Missing region. */
+	CHECK_TRUE( nullptr == ringbuf_shm::mapRegion( regionName.c_str(), &xAttachedSize ) );
+
+	uint8_t* pcProducerRegion = ringbuf_shm::mapRegion( regionName.c_str(), &xRegionSize );
+
+	CHECK_TRUE( pcProducerRegion != nullptr );
+
+	/* Same memory at a different address, size taken from the region. */
+	uint8_t* pcConsumerRegion = ringbuf_shm::mapRegion( regionName.c_str(), &xAttachedSize );
+
+	CHECK_TRUE( pcConsumerRegion != nullptr );
+	CHECK_TRUE( pcConsumerRegion != pcProducerRegion );
+	CHECK_EQUAL( xRegionSize, xAttachedSize );
+
+	ringbuf_shm producer( pcProducerRegion, xRegionSize, RB_SHM_CREATE );
+	ringbuf_shm consumer( pcConsumerRegion, xAttachedSize, RB_SHM_ATTACH );
+
+	CHECK_TRUE( consumer.isAttached() );
+
+	/* Several laps of the buffer. */
+	for( uint32_t i = 0; i < 1000U; ++i )
+	{
+		std::memset( testItem, ( int )i, sizeof( testItem ) );
+
+		CHECK_TRUE( producer.push( testItem, 1 + ( i % sizeof( testItem ) ) ) );
+
+		CHECK_EQUAL( 1 + ( i % sizeof( testItem ) ), consumer.getTailSize() );
+		CHECK_TRUE( consumer.getData( dataBuf ) );
+		CHECK_EQUAL( 0, memcmp( testItem, dataBuf, 1 + ( i % sizeof( testItem ) ) ) );
+		CHECK_TRUE( consumer.consume() );
+	}
+
+	CHECK_TRUE( ringbuf_shm::unlinkRegion( regionName.c_str() ) );
+	CHECK_FALSE( ringbuf_shm::unlinkRegion( regionName.c_str() ) );
+
+	ringbuf_shm::unmapRegion( pcConsumerRegion, xAttachedSize );
+	ringbuf_shm::unmapRegion( pcProducerRegion, xRegionSize );
+}
+
+
+TEST( ringbuf_shm, producer_process )
+{
+	/*
+	* TEST data.
+	*
+	*/
+
+	constexpr uint32_t items_cnt = 10000U;
+
+	std::size_t xRegionSize = 4096U;
+
+	uint8_t* pcRegion = ringbuf_shm::mapRegion( nullptr, &xRegionSize );
+
+	CHECK_TRUE( pcRegion != nullptr );
+
+	ringbuf_shm consumer( pcRegion, xRegionSize, RB_SHM_CREATE );
+
+	uint32_t rxItem[ 16 ];
+
+	bool isSequenceOk = true;
+
+	int iStatus = -1;
+
+
+	/*
+	* TEST sequence.
+	*
+	*/
+
+	const pid_t xPid = fork();
+
+	if( xPid == 0 )
+	{
+		/* Child process: producer. */
+		ringbuf_shm producer( pcRegion, xRegionSize, RB_SHM_ATTACH );
+
+		uint32_t testItem[ 16 ] = { 0 };
+		bool isPushOk = producer.isAttached();
+
+		for( uint32_t i = 0; i < items_cnt; ++i )
+		{
+			testItem[ 0 ] = i;
+
+			isPushOk = isPushOk && producer.waitForSpace( sizeof( uint32_t ) * ( 1 + ( i % 16U ) ), 10000000U );
+			isPushOk = isPushOk && producer.push( testItem, sizeof( uint32_t ) * ( 1 + ( i % 16U ) ) );
+		}
+
+		_exit( isPushOk ? 0 : 1 );
+	}
+
+	CHECK_TRUE( xPid > 0 );
+
+	for( uint32_t i = 0; i < items_cnt; ++i )
+	{
+		isSequenceOk = isSequenceOk && consumer.waitForData( 10000000U );
+		isSequenceOk = isSequenceOk && ( consumer.getTailSize() == sizeof( uint32_t ) * ( 1 + ( i % 16U ) ) );
+		isSequenceOk = isSequenceOk && consumer.getData( ( uint8_t* )rxItem );
+		isSequenceOk = isSequenceOk && ( rxItem[ 0 ] == i );
+		isSequenceOk = isSequenceOk && consumer.deleteTail();
+	}
+
+	waitpid( xPid, &iStatus, 0 );
+
+	CHECK_TRUE( isSequenceOk );
+	CHECK_TRUE( WIFEXITED( iStatus ) );
+	CHECK_EQUAL( 0, WEXITSTATUS( iStatus ) );
+	CHECK_TRUE( consumer.isEmpty() );
+	CHECK_EQUAL( 0, consumer.getStats().xRejectedItems );
+
+	ringbuf_shm::unmapRegion( pcRegion, xRegionSize );
+}
+
+#endif
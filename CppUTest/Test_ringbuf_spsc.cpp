@@ -0,0 +1,592 @@
+#include "CppUTest/TestHarness.h"
+
+#include <iostream>
+#include <cstring>
+#include <thread>
+
+extern "C"
+{
+	/*
+	 * Add your c-only include files here
+	 */
+}
+
+#include "ringbuf_spsc.hpp"
+
+TEST_GROUP( ringbuf_spsc )
+{
+    void setup()
+    {
+		//MemoryLeakWarningPlugin::saveAndDisableNewDeleteOverloads();
+    }
+
+    void teardown()
+    {
+		//MemoryLeakWarningPlugin::restoreNewDeleteOverloads();
+    }
+};
+
+
+
+TEST( ringbuf_spsc, declaration )
+{
+	/*
+	* TEST data.
+	*
+	*/
+
+	constexpr uint32_t mem_pool_size = 128U;
+
+	uint8_t memPool[ mem_pool_size ];
+
+	ringbuf_spsc testBuf( memPool, mem_pool_size );
+
+
+	/*
+	* TEST sequence.
+	*
+	*/
+
+	/* Buffer is empty. */
+	CHECK_TRUE( testBuf.isEmpty() );
+
+	/* Tail cannot be deleted. */
+	CHECK_FALSE( testBuf.deleteTail() );
+
+	/* No items present. */
+	CHECK_EQUAL( 0, testBuf.getItemsCnt() );
+
+	/* Tail size is zero. */
+	CHECK_EQUAL( 0, testBuf.getTailSize() );
+}
+
+
+TEST( ringbuf_spsc, push_get_delete )
+{
+	/*
+	* TEST data.
+	*
+	*/
+
+	constexpr uint32_t mem_pool_size = 128U;
+
+	uint8_t memPool[ mem_pool_size ];
+
+	ringbuf_spsc testBuf( memPool, mem_pool_size );
+
+	uint8_t  testItem1[ ] = { 1, 2, 3, 4, 5 };
+	uint16_t testItem2[ ] = { 101, 102, 103 };
+
+	uint8_t dataBuf[ 10 ] = { 0 };
+
+
+	/*
+	* TEST sequence.
+	*
+	*/
+
+	CHECK( testBuf.push( testItem1, sizeof( testItem1 ) ) );
+	CHECK( testBuf.push( testItem2, sizeof( testItem2 ) ) );
+
+	CHECK_FALSE( testBuf.isEmpty() );
+	CHECK_EQUAL( 2, testBuf.getItemsCnt() );
+
+	/* Tail is the oldest item. */
+	CHECK_EQUAL( sizeof( testItem1 ), testBuf.getTailSize() );
+	CHECK_TRUE( testBuf.getData( dataBuf ) );
+	CHECK_EQUAL( 0, memcmp( testItem1, dataBuf, sizeof( testItem1 ) ) );
+
+	CHECK_TRUE( testBuf.deleteTail() );
+
+	CHECK_EQUAL( sizeof( testItem2 ), testBuf.getTailSize() );
+	CHECK_TRUE( testBuf.getData( dataBuf ) );
+	CHECK_EQUAL( 0, memcmp( testItem2, dataBuf, sizeof( testItem2 ) ) );
+
+	CHECK_TRUE( testBuf.deleteTail() );
+
+	CHECK_TRUE( testBuf.isEmpty() );
+	CHECK_EQUAL( 0, testBuf.getItemsCnt() );
+}
+
+
+TEST( ringbuf_spsc, full_rejects_push )
+{
+	/*
+	* TEST data.
+	*
+	*/
+
+	constexpr uint32_t mem_pool_size = 64U;
+
+	uint8_t memPool[ mem_pool_size ];
+
+	ringbuf_spsc testBuf( memPool, mem_pool_size );
+
+	uint8_t testItem[ 20 ] = { 0 };
+
+
+	/*
+	* TEST sequence.
+	*
+	*/
+
+	/* Item bigger than the buffer. */
+	CHECK_FALSE( testBuf.push( testItem, mem_pool_size ) );
+
+	/* Each item takes 32 [byte], the second one does not fit. */
+	CHECK_TRUE( testBuf.push( testItem, sizeof( testItem ) ) );
+	CHECK_FALSE( testBuf.push( testItem, sizeof( testItem ) ) );
+
+	/* Oldest item is retained. */
+	CHECK_EQUAL( 1, testBuf.getItemsCnt() );
+
+	/* Room is given back by the consumer. */
+	CHECK_TRUE( testBuf.deleteTail() );
+	CHECK_TRUE( testBuf.push( testItem, sizeof( testItem ) ) );
+}
+
+
+TEST( ringbuf_spsc, getData_rollover )
+{
+	/*
+	* TEST data.
+	*
+	*/
+
+	constexpr uint32_t mem_pool_size = 64U;
+
+	uint8_t memPool[ mem_pool_size ];
+
+	ringbuf_spsc testBuf( memPool, mem_pool_size );
+
+	uint8_t testItem1[ 24 ] = { 0 };
+	uint8_t testItem2[ 20 ];
+
+	uint8_t dataBuf[ 20 ] = { 0 };
+
+	for( uint8_t i = 0; i < sizeof( testItem2 ); ++i )
+	{
+		testItem2[ i ] = i + 1;
+	}
+
+
+	/*
+	* TEST sequence.
+	*
+	*/
+
+	/* Move head and tail close to the end of the buffer. */
+	CHECK_TRUE( testBuf.push( testItem1, sizeof( testItem1 ) ) );
+	CHECK_TRUE( testBuf.deleteTail() );
+
+	/* Data of the item rolls over. */
+	CHECK_TRUE( testBuf.push( testItem2, sizeof( testItem2 ) ) );
+	CHECK_TRUE( testBuf.getData( dataBuf ) );
+
+	CHECK_EQUAL( 0, memcmp( testItem2, dataBuf, sizeof( testItem2 ) ) );
+}
+
+
+TEST( ringbuf_spsc, producer_consumer_threads )
+{
+	/*
+	* TEST data.
+	*
+	*/
+
+	constexpr uint32_t mem_pool_size = 1000U;
+	constexpr uint32_t items_cnt = 100000U;
+
+	static uint8_t memPool[ mem_pool_size ];
+
+	static ringbuf_spsc testBuf( memPool, mem_pool_size );
+
+	bool isSequenceOk = true;
+
+
+	/*
+	* TEST sequence.
+	*
+	*/
+
+	/* Producer pushes items of variable size, filled with their index. */
+	std::thread producer( [ & ]()
+	{
+		uint32_t item[ 16 ];
+
+		for( uint32_t i = 0; i < items_cnt; ++i )
+		{
+			const size_t xCnt = 1 + ( i % 16 );
+
+			for( size_t j = 0; j < xCnt; ++j )
+			{
+				item[ j ] = i;
+			}
+
+			while( !testBuf.push( item, xCnt * sizeof( uint32_t ) ) )
+			{
+				std::this_thread::yield();
+			}
+		}
+	} );
+
+	/* Consumer checks items come out whole and in order. */
+	uint32_t rxItem[ 16 ];
+
+	for( uint32_t i = 0; i < items_cnt; ++i )
+	{
+		while( testBuf.isEmpty() )
+		{
+			std::this_thread::yield();
+		}
+
+		const size_t xSize = testBuf.getTailSize();
+
+		testBuf.getData( ( uint8_t* )rxItem );
+		testBuf.deleteTail();
+
+		isSequenceOk &= ( xSize == ( 1 + ( i % 16 ) ) * sizeof( uint32_t ) );
+		isSequenceOk &= ( rxItem[ 0 ] == i ) && ( rxItem[ xSize / sizeof( uint32_t ) - 1 ] == i );
+	}
+
+	producer.join();
+
+	CHECK_TRUE( isSequenceOk );
+	CHECK_TRUE( testBuf.isEmpty() );
+}
+
+
+TEST( ringbuf_spsc, peek_consume )
+{
+	/*
+	* TEST data.
+	*
+	*/
+
+	constexpr uint32_t mem_pool_size = 64U;
+
+	uint8_t memPool[ mem_pool_size ];
+
+	ringbuf_spsc testBuf( memPool, mem_pool_size );
+
+	uint8_t testItem1[ 40 ] = { 0 };
+	uint8_t testItem2[ ] = { 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12 };
+
+	rbConstSpan_t axSpans[ 2 ];
+
+
+	/*
+	* TEST sequence.
+	*
+	*/
+
+	/* Empty ring buf. */
+	CHECK_FALSE( testBuf.peek( axSpans ) );
+
+	/* Move head and tail close to the end of the buffer. */
+	CHECK_TRUE( testBuf.push( testItem1, sizeof( testItem1 ) ) );
+	CHECK_TRUE( testBuf.consume() );
+
+	/* Data of the item rolls over. */
+	CHECK_TRUE( testBuf.push( testItem2, sizeof( testItem2 ) ) );
+	CHECK_TRUE( testBuf.peek( axSpans ) );
+
+	CHECK_EQUAL( 8, axSpans[ 0 ].xSize );
+	CHECK_EQUAL( 4, axSpans[ 1 ].xSize );
+	CHECK_EQUAL( 0, memcmp( testItem2, axSpans[ 0 ].pcData, axSpans[ 0 ].xSize ) );
+	CHECK_EQUAL( 0, memcmp( testItem2 + 8, axSpans[ 1 ].pcData, axSpans[ 1 ].xSize ) );
+
+	CHECK_TRUE( testBuf.consume() );
+	CHECK_TRUE( testBuf.isEmpty() );
+}
+
+
+TEST( ringbuf_spsc, drain )
+{
+	/*
+	* TEST data.
+	*
+	*/
+
+	constexpr uint32_t mem_pool_size = 64U;
+
+	uint8_t memPool[ mem_pool_size ];
+
+	ringbuf_spsc testBuf( memPool, mem_pool_size );
+
+	uint8_t testItem1[ ] = { 1, 2, 3, 4, 5 };
+	uint8_t testItem2[ ] = { 6, 7, 8 };
+	uint8_t testItem3[ ] = { 9 };
+
+	uint8_t dataBuf[ 10 ] = { 0 };
+	size_t xCopied = 0;
+
+	/* Copies data of all items one after the other. */
+	struct drainCtx
+	{
+		uint8_t* pcDst;
+		size_t*  pxCopied;
+	} xCtx = { dataBuf, &xCopied };
+
+	rbDrainCallback_t pxCallback = []( const rbConstSpan_t* pxSpans, void* pvContext )
+	{
+		drainCtx* pxCtx = ( drainCtx* )pvContext;
+
+		memcpy( pxCtx->pcDst + *pxCtx->pxCopied, pxSpans[ 0 ].pcData, pxSpans[ 0 ].xSize );
+		*pxCtx->pxCopied += pxSpans[ 0 ].xSize;
+		memcpy( pxCtx->pcDst + *pxCtx->pxCopied, pxSpans[ 1 ].pcData, pxSpans[ 1 ].xSize );
+		*pxCtx->pxCopied += pxSpans[ 1 ].xSize;
+
+		return true;
+	};
+
+
+	/*
+	* TEST sequence.
+	*
+	*/
+
+	CHECK_EQUAL( 0, testBuf.drain( pxCallback, &xCtx, 10, 100 ) );
+
+	CHECK_TRUE( testBuf.push( testItem1, sizeof( testItem1 ) ) );
+	CHECK_TRUE( testBuf.push( testItem2, sizeof( testItem2 ) ) );
+	CHECK_TRUE( testBuf.push( testItem3, sizeof( testItem3 ) ) );
+
+	/* Item limit. */
+	CHECK_EQUAL( 2, testBuf.drain( pxCallback, &xCtx, 2, 100 ) );
+	CHECK_EQUAL( 1, testBuf.getItemsCnt() );
+
+	/* Space is given back: a new item fits. */
+	CHECK_TRUE( testBuf.push( testItem1, sizeof( testItem1 ) ) );
+
+	/* Byte limit. */
+	CHECK_EQUAL( 1, testBuf.drain( pxCallback, &xCtx, 10, 5 ) );
+	CHECK_EQUAL( sizeof( testItem1 ), testBuf.getTailSize() );
+
+	CHECK_EQUAL( 9, xCopied );
+	CHECK_EQUAL( 0, memcmp( testItem1, dataBuf, sizeof( testItem1 ) ) );
+	CHECK_EQUAL( 0, memcmp( testItem2, dataBuf + 5, sizeof( testItem2 ) ) );
+	CHECK_EQUAL( 9, dataBuf[ 8 ] );
+}
+
+
+TEST( ringbuf_spsc, overflow_reject_stats )
+{
+	/*
+	* TEST data.
+	*
+	*/
+
+	constexpr uint32_t mem_pool_size = 64U;
+
+	uint8_t memPool[ mem_pool_size ];
+
+	ringbuf_spsc testBuf( memPool, mem_pool_size );
+
+	uint8_t testItem[ 20 ] = { 0 };
+
+
+	/*
+	* TEST sequence.
+	*
+	*/
+
+	/* Producer cannot delete old items. */
+	CHECK_FALSE( testBuf.setOverflowPolicy( RB_OVERFLOW_OVERWRITE ) );
+
+	CHECK_TRUE( testBuf.push( testItem, sizeof( testItem ) ) );
+	CHECK_FALSE( testBuf.push( testItem, sizeof( testItem ) ) );
+	CHECK_FALSE( testBuf.push( testItem, 24 ) );
+
+	CHECK_EQUAL( 0, testBuf.getStats().xEvictedItems );
+	CHECK_EQUAL( 2, testBuf.getStats().xRejectedItems );
+	CHECK_EQUAL( sizeof( testItem ) + 24, testBuf.getStats().xRejectedBytes );
+}
+
+
+TEST( ringbuf_spsc, overflow_block )
+{
+	/*
+	* TEST data.
+	*
+	*/
+
+	constexpr uint32_t mem_pool_size = 64U;
+	constexpr uint32_t items_cnt = 1000U;
+
+	static uint8_t memPool[ mem_pool_size ];
+
+	static ringbuf_spsc testBuf( memPool, mem_pool_size );
+
+	uint32_t testItem[ 5 ] = { 0 };
+
+	bool isSequenceOk = true;
+	bool isPushOk = true;
+
+
+	/*
+	* TEST sequence.
+	*
+	*/
+
+	CHECK_TRUE( testBuf.setOverflowPolicy( RB_OVERFLOW_BLOCK, 10000U ) );
+
+	/* Nobody consumes: push gives up after the timeout. */
+	CHECK_TRUE( testBuf.push( testItem, sizeof( testItem ) ) );
+	CHECK_FALSE( testBuf.push( testItem, sizeof( testItem ) ) );
+	CHECK_EQUAL( 1, testBuf.getStats().xRejectedItems );
+
+	testBuf.flush();
+
+	/* Slow consumer: every push waits for room instead of failing. */
+	CHECK_TRUE( testBuf.setOverflowPolicy( RB_OVERFLOW_BLOCK, 1000000U ) );
+
+	std::thread consumer( [ & ]()
+	{
+		uint32_t rxItem[ 5 ];
+
+		for( uint32_t i = 0; i < items_cnt; ++i )
+		{
+			while( !testBuf.getData( ( uint8_t* )rxItem ) )
+			{
+				std::this_thread::yield();
+			}
+
+			testBuf.deleteTail();
+
+			isSequenceOk &= ( rxItem[ 0 ] == i );
+		}
+	} );
+
+	for( uint32_t i = 0; i < items_cnt; ++i )
+	{
+		testItem[ 0 ] = i;
+		isPushOk &= testBuf.push( testItem, sizeof( testItem ) );
+	}
+
+	consumer.join();
+
+	CHECK_TRUE( isPushOk );
+	CHECK_TRUE( isSequenceOk );
+	CHECK_TRUE( testBuf.isEmpty() );
+	CHECK_EQUAL( 1, testBuf.getStats().xRejectedItems );
+}
+
+
+TEST( ringbuf_spsc, wait_for_data )
+{
+	/*
+	* TEST data.
+	*
+	*/
+
+	constexpr uint32_t mem_pool_size = 64U;
+	constexpr uint32_t items_cnt = 1000U;
+
+	static uint8_t memPool[ mem_pool_size ];
+
+	static ringbuf_spsc testBuf( memPool, mem_pool_size );
+
+	uint32_t testItem[ 5 ] = { 0 };
+
+	bool isSequenceOk = true;
+	bool isPushOk = true;
+
+
+	/*
+	* TEST sequence.
+	*
+	*/
+
+	/* Nobody produces: the wait gives up after the timeout. */
+	CHECK_FALSE( testBuf.waitForData( 1000U ) );
+
+	CHECK_TRUE( testBuf.push( testItem, sizeof( testItem ) ) );
+	CHECK_TRUE( testBuf.waitForData( 0 ) );
+	CHECK_TRUE( testBuf.deleteTail() );
+
+	/* Consumer sleeps until every item is pushed, producer until there is room. */
+	std::thread consumer( [ & ]()
+	{
+		uint32_t rxItem[ 5 ];
+
+		for( uint32_t i = 0; i < items_cnt; ++i )
+		{
+			isSequenceOk &= testBuf.waitForData( 1000000U );
+			isSequenceOk &= testBuf.getData( ( uint8_t* )rxItem );
+			isSequenceOk &= testBuf.deleteTail();
+			isSequenceOk &= ( rxItem[ 0 ] == i );
+
+			if( ( i % 100U ) == 0 )
+			{
+				std::this_thread::sleep_for( std::chrono::microseconds( 100 ) );
+			}
+		}
+	} );
+
+	for( uint32_t i = 0; i < items_cnt; ++i )
+	{
+		testItem[ 0 ] = i;
+		isPushOk &= testBuf.waitForSpace( sizeof( testItem ), 1000000U );
+		isPushOk &= testBuf.push( testItem, sizeof( testItem ) );
+
+		if( ( i % 100U ) == 50U )
+		{
+			std::this_thread::sleep_for( std::chrono::microseconds( 100 ) );
+		}
+	}
+
+	consumer.join();
+
+	CHECK_TRUE( isPushOk );
+	CHECK_TRUE( isSequenceOk );
+	CHECK_TRUE( testBuf.isEmpty() );
+	CHECK_EQUAL( 0, testBuf.getStats().xRejectedItems );
+}
+
+
+TEST( ringbuf_spsc, wait_for_space )
+{
+	/*
+	* TEST data.
+	*
+	*/
+
+	constexpr uint32_t mem_pool_size = 64U;
+
+	static uint8_t memPool[ mem_pool_size ];
+
+	static ringbuf_spsc testBuf( memPool, mem_pool_size );
+
+	uint32_t testItem[ 5 ] = { 0 };
+
+
+	/*
+	* TEST sequence.
+	*
+	*/
+
+	/* Item never fits. */
+	CHECK_FALSE( testBuf.waitForSpace( 0, 0 ) );
+	CHECK_FALSE( testBuf.waitForSpace( mem_pool_size, 0 ) );
+
+	CHECK_TRUE( testBuf.waitForSpace( sizeof( testItem ), 0 ) );
+	CHECK_TRUE( testBuf.push( testItem, sizeof( testItem ) ) );
+
+	/* Nobody consumes: the wait gives up after the timeout. */
+	CHECK_FALSE( testBuf.waitForSpace( sizeof( testItem ), 1000U ) );
+
+	/* Producer wakes up as soon as the tail is deleted. */
+	std::thread consumer( [ & ]()
+	{
+		std::this_thread::sleep_for( std::chrono::milliseconds( 10 ) );
+
+		testBuf.deleteTail();
+	} );
+
+	CHECK_TRUE( testBuf.waitForSpace( sizeof( testItem ), 10000000U ) );
+
+	consumer.join();
+
+	CHECK_TRUE( testBuf.push( testItem, sizeof( testItem ) ) );
+}
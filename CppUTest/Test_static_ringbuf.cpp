@@ -0,0 +1,210 @@
+#include "CppUTest/TestHarness.h"
+
+#include <iostream>
+#include <cstring>
+
+extern "C"
+{
+	/*
+	 * Add your c-only include files here
+	 */
+}
+
+#include "static_ringbuf.hpp"
+
+/* Initialized at compile time. */
+static static_ringbuf<256> staticBuf;
+
+static_assert( static_ringbuf<256>::getCapacity() == 256, "Capacity is a compile-time constant." );
+
+static bool countCallback( const rbConstSpan_t* pxSpans, void* pvContext )
+{
+	*( std::size_t* )pvContext += pxSpans[ 0 ].xSize + pxSpans[ 1 ].xSize;
+
+	return true;
+}
+
+TEST_GROUP( static_ringbuf )
+{
+    void setup()
+    {
+		//MemoryLeakWarningPlugin::saveAndDisableNewDeleteOverloads();
+    }
+
+    void teardown()
+    {
+		//MemoryLeakWarningPlugin::restoreNewDeleteOverloads();
+    }
+};
+
+
+
+TEST( static_ringbuf, declaration )
+{
+	/*
+	* TEST data.
+	*
+	*/
+
+	constexpr static_ringbuf<64> constBuf;
+
+	uint8_t dataBuf[ 256 ];
+
+
+	/*
+	* TEST sequence.
+	*
+	*/
+
+	( void )constBuf;
+
+	/* Buffer is empty. */
+	CHECK_TRUE( staticBuf.isEmpty() );
+	CHECK_EQUAL( 0, staticBuf.getItemsCnt() );
+	CHECK_EQUAL( 0, staticBuf.getTailSize() );
+	CHECK_EQUAL( 0, staticBuf.getHeadSize() );
+	CHECK_FALSE( staticBuf.deleteTail() );
+	CHECK_FALSE( staticBuf.getData( dataBuf ) );
+
+	/* Header plus data shall fit in the storage. */
+	CHECK_FALSE( staticBuf.push( dataBuf, 0 ) );
+	CHECK_FALSE( staticBuf.push( dataBuf, 256 - sizeof( std::size_t ) + 1 ) );
+
+	CHECK_TRUE( staticBuf.push( dataBuf, 256 - sizeof( std::size_t ) ) );
+	CHECK_EQUAL( 1, staticBuf.getItemsCnt() );
+
+	staticBuf.flush();
+	CHECK_TRUE( staticBuf.isEmpty() );
+}
+
+TEST( static_ringbuf, push_get_rollover )
+{
+	/*
+	* TEST data.
+	*
+	*/
+
+	/* Size not a power of two. */
+	static_ringbuf<5 * sizeof( std::size_t )> testBuf;
+
+	const uint8_t item[ 12 ] = { 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12 };
+
+	uint8_t dataBuf[ 12 ];
+
+
+	/*
+	* TEST sequence.
+	*
+	*/
+
+	/* Items wrap around the end of the storage many times. */
+	for( std::size_t i = 1; i <= 20; ++i )
+	{
+		const std::size_t xItemSize = 1 + ( i % 12 );
+
+		CHECK_TRUE( testBuf.push( item, xItemSize ) );
+		CHECK_EQUAL( xItemSize, testBuf.getHeadSize() );
+
+		CHECK_EQUAL( xItemSize, testBuf.getTailSize() );
+		CHECK_TRUE( testBuf.getData( dataBuf ) );
+		MEMCMP_EQUAL( item, dataBuf, xItemSize );
+		CHECK_TRUE( testBuf.deleteTail() );
+	}
+
+	CHECK_TRUE( testBuf.isEmpty() );
+	CHECK_EQUAL( 0, testBuf.getStats().xEvictedItems );
+}
+
+TEST( static_ringbuf, overwrite_reject_stats )
+{
+	/*
+	* TEST data.
+	*
+	*/
+
+	static_ringbuf<64> testBuf;
+
+	uint8_t item[ 16 ];
+
+	uint8_t dataBuf[ 16 ];
+
+
+	/*
+	* TEST sequence.
+	*
+	*/
+
+	/* Each item takes a header plus 16 bytes. */
+	for( uint8_t i = 0; i < 5; ++i )
+	{
+		std::memset( item, i, sizeof( item ) );
+		CHECK_TRUE( testBuf.push( item, sizeof( item ) ) );
+	}
+
+	/* Oldest items are deleted to make room. */
+	CHECK_EQUAL( 64 / ( sizeof( std::size_t ) + 16 ), testBuf.getItemsCnt() );
+
+	rbStats_t xStats = testBuf.getStats();
+	CHECK_EQUAL( 5 - testBuf.getItemsCnt(), xStats.xEvictedItems );
+	CHECK_EQUAL( 16 * xStats.xEvictedItems, xStats.xEvictedBytes );
+
+	CHECK_TRUE( testBuf.getData( dataBuf ) );
+	CHECK_EQUAL( 5 - testBuf.getItemsCnt(), dataBuf[ 0 ] );
+
+	/* Old items are kept. */
+	CHECK_FALSE( testBuf.setOverflowPolicy( RB_OVERFLOW_BLOCK ) );
+	CHECK_TRUE( testBuf.setOverflowPolicy( RB_OVERFLOW_REJECT ) );
+
+	CHECK_FALSE( testBuf.push( item, sizeof( item ) ) );
+	CHECK_EQUAL( 1, testBuf.getStats().xRejectedItems );
+	CHECK_EQUAL( 16, testBuf.getStats().xRejectedBytes );
+}
+
+TEST( static_ringbuf, peek_consume_drain )
+{
+	/*
+	* TEST data.
+	*
+	*/
+
+	static_ringbuf<64> testBuf;
+
+	const uint8_t item[ 20 ] = { 0 };
+
+	rbConstSpan_t axSpans[ 2 ];
+
+	std::size_t xDrainedSize = 0;
+
+
+	/*
+	* TEST sequence.
+	*
+	*/
+
+	CHECK_FALSE( testBuf.peek( axSpans ) );
+
+	/* Move the offsets so that the third item rolls over. */
+	CHECK_TRUE( testBuf.push( item, 20 ) );
+	CHECK_TRUE( testBuf.push( item, 8 ) );
+	CHECK_TRUE( testBuf.consume() );
+	CHECK_TRUE( testBuf.push( item, 20 ) );
+	CHECK_TRUE( testBuf.push( item, 1 ) );
+
+	CHECK_TRUE( testBuf.peek( axSpans ) );
+	CHECK_EQUAL( 8, axSpans[ 0 ].xSize + axSpans[ 1 ].xSize );
+	CHECK_TRUE( testBuf.consume() );
+
+	CHECK_TRUE( testBuf.peek( axSpans ) );
+	CHECK_EQUAL( 20, axSpans[ 0 ].xSize + axSpans[ 1 ].xSize );
+	CHECK_TRUE( axSpans[ 1 ].xSize > 0 );
+
+	/* Byte limit stops before the last item. */
+	CHECK_EQUAL( 1, testBuf.drain( countCallback, &xDrainedSize, 10, 20 ) );
+	CHECK_EQUAL( 20, xDrainedSize );
+
+	CHECK_EQUAL( 1, testBuf.drain( countCallback, &xDrainedSize, 10, SIZE_MAX ) );
+	CHECK_EQUAL( 21, xDrainedSize );
+
+	CHECK_TRUE( testBuf.isEmpty() );
+	CHECK_EQUAL( 0, testBuf.getHeadSize() );
+}
@@ -34,457 +34,3814 @@
 
 
 /* Standard includes. */
+#include <algorithm>
+#include <chrono>
 #include <cstring>
 
+#if defined( __linux__ )
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+#if defined( __AVX2__ ) && defined( __GNUC__ )
+#include <immintrin.h>
+#elif defined( __SSE2__ ) && defined( __GNUC__ )
+#include <emmintrin.h>
+#endif
+
 /* Include API header. */
 #include "ringbuf.hpp"
 
-/*-----------------------------------------------------------*/
+#if ( RINGBUF_CFG_ITEM_SEQUENCE == 1 )
+/**
+ * @brief Sequence number of an item deleted from the head, whose
+ *        space is going to be reused.
+ */
+
+static constexpr std::uint64_t ullSeqInvalid = UINT64_MAX;
+#endif
 
+#if ( RINGBUF_CFG_ITEM_TIMESTAMP == 1 )
 /**
- * @brief Main to compile under visual studio code.
+ * @brief Default clock stamping the items.
  *
- * @note Define the symbol VISUALS>TUDIO_CODE to enable its compilation.
+ * @note steady_clock is CLOCK_MONOTONIC on Linux.
+ *
+ * @param[out] Time [ns] since an unspecified start, e.g. the boot.
  */
 
-// #ifdef VISUAL_STUDIO_CODE
-// #include <iostream>
-// #include <vector>
-// int main() {
-//     std::vector<std::string> msg {"Hello ringBuffer!"};
+static std::uint64_t getMonotonicTime( void )
+{
+    return ( std::uint64_t )std::chrono::duration_cast<std::chrono::nanoseconds>( std::chrono::steady_clock::now().time_since_epoch() ).count();
+}
+#endif
 
-//     for (const std::string& word : msg)
-//     {
-//         std::cout << word << " ";
-//     }
-    
-//     std::cout << std::endl;
-// }
-// #endif
+/**
+ * @brief Build options of this ring buffer stored in an image, items of
+ *        an image built with other options cannot be recovered.
+ */
 
-/*--------------------- Private methods ---------------------*/
+static constexpr std::uint32_t ulImageFlags = ( ( RINGBUF_CFG_COMPACT_HEADER == 1 ) ? RB_IMAGE_FLAG_COMPACT : 0U )
+                                            | ( ( RINGBUF_CFG_ITEM_SEQUENCE == 1 ) ? RB_IMAGE_FLAG_SEQUENCE : 0U )
+                                            | ( ( RINGBUF_CFG_ITEM_TIMESTAMP == 1 ) ? RB_IMAGE_FLAG_TIMESTAMP : 0U );
 
 /**
- * @brief Resets the ring buffer.
- * 
- * @note Private method.
- * 
+ * @brief Gets the part of a memory pool the item links can address.
+ *
+ * @note Built with RINGBUF_CFG_COMPACT_HEADER the links are 32-bit offsets,
+ *       so a larger pool is only used up to 4 GB.
+ *
+ * @param[in] xPoolSize Size of the memory pool.
+ * @param[out] Size [byte] of the memory pool used.
  */
 
-void ringbuf::reset( void ) 
+static std::size_t getAddressableSize( const std::size_t xPoolSize )
 {
-    /* pHead and pTail init. */
-    pxHead = ( rbItem_t* )pcBuf;
+    std::size_t xUsedSize = xPoolSize;
 
-    pxHead->pxNext = pxHead;
-    pxHead->pxPrev = pxHead;
-    pxHead->xItemSize = 0;
+#if ( RINGBUF_CFG_COMPACT_HEADER == 1 )
+    if( ( std::uint64_t )xPoolSize > UINT32_MAX )
+    {
+        xUsedSize = UINT32_MAX;
+    }
+#endif
 
-    xTotItemCnt = 0;
+    return xUsedSize;
+}
 
-    pxTail = pxHead;
+#if ( defined( __AVX2__ ) || defined( __SSE2__ ) ) && defined( __GNUC__ )
+/**
+ * @brief Gets the positions of a 64 byte block where the first and the last
+ *        byte of a pattern match.
+ *
+ * @note Built for AVX2 the block is compared 32 bytes at a time, built for
+ *       SSE2 16 bytes at a time.
+ *
+ * @param[in] pcBlock Pointer to the block, xLastOff bytes past its end must
+ *                    be readable.
+ * @param[in] pcPattern Pointer to the pattern.
+ * @param[in] xLastOff Offset of the last byte of the pattern.
+ * @param[out] Bit i is set when position i is a candidate.
+ */
+
+static inline std::uint64_t getCandidates( const std::uint8_t* pcBlock, 
+                                           const std::uint8_t* pcPattern, 
+                                           const std::size_t xLastOff )
+{
+    std::uint64_t ullCandidates = 0;
+
+#if defined( __AVX2__ )
+    const __m256i xFirstByte = _mm256_set1_epi8( ( char )pcPattern[ 0 ] );
+    const __m256i xLastByte = _mm256_set1_epi8( ( char )pcPattern[ xLastOff ] );
+
+    for( std::size_t i = 0; i < 64; i += 32 )
+    {
+        const __m256i xFirst = _mm256_loadu_si256( ( const __m256i* )( pcBlock + i ) );
+        const __m256i xLast = _mm256_loadu_si256( ( const __m256i* )( pcBlock + i + xLastOff ) );
+
+        ullCandidates |= ( std::uint64_t )( std::uint32_t )_mm256_movemask_epi8( _mm256_and_si256( _mm256_cmpeq_epi8( xFirst, xFirstByte ),
+                                                                                                   _mm256_cmpeq_epi8( xLast, xLastByte ) ) ) << i;
+    }
+#else
+    const __m128i xFirstByte = _mm_set1_epi8( ( char )pcPattern[ 0 ] );
+    const __m128i xLastByte = _mm_set1_epi8( ( char )pcPattern[ xLastOff ] );
+
+    for( std::size_t i = 0; i < 64; i += 16 )
+    {
+        const __m128i xFirst = _mm_loadu_si128( ( const __m128i* )( pcBlock + i ) );
+        const __m128i xLast = _mm_loadu_si128( ( const __m128i* )( pcBlock + i + xLastOff ) );
+
+        ullCandidates |= ( std::uint64_t )( std::uint32_t )_mm_movemask_epi8( _mm_and_si128( _mm_cmpeq_epi8( xFirst, xFirstByte ),
+                                                                                             _mm_cmpeq_epi8( xLast, xLastByte ) ) ) << i;
+    }
+#endif
+
+    return ullCandidates;
 }
+#endif
 
 /**
- * @brief Identifies the position in the ring buffer
- *        where the new item header shall be inserted.
- * 
- * @note Private method.
- * 
- * @param[in] xItemSize Size [byte] of the item to insert.
- * @param[out] Pointer to the postion.
+ * @brief Checks whether a pattern occurs in a contiguous block of data.
+ *
+ * @note Built for AVX2 or SSE2, 64 positions at a time are filtered by
+ *       comparing the first and the last byte of the pattern, and only the
+ *       few candidates left are compared in full. The positions left, or all
+ *       of them on other targets, are checked from the occurrences of the first
+ *       byte found by memchr().
  *
+ * @param[in] pcData Pointer to the data.
+ * @param[in] xDataSize Size [byte] of the data.
+ * @param[in] pcPattern Pointer to the pattern.
+ * @param[in] xPatternSize Size [byte] of the pattern, not zero.
+ * @param[out] True when the pattern is found.
  */
 
-std::uint8_t* ringbuf::getNextPtr( const std::size_t xItemSize ) 
+static bool containsPattern( const std::uint8_t* pcData, 
+                             const std::size_t xDataSize, 
+                             const std::uint8_t* pcPattern, 
+                             const std::size_t xPatternSize )
 {
-    std::size_t topFreeSpace = 0;
-    std::size_t bottomFreeSpace = 0;
-    std::uint8_t* ptrNext = nullptr;
-    std::uint8_t* pHeader = nullptr;
+    bool isFound = false;
+    std::size_t xPos = 0;
 
-    if ( xTotItemCnt == 0 )
+#if ( defined( __AVX2__ ) || defined( __SSE2__ ) ) && defined( __GNUC__ )
+    const std::size_t xLastOff = xPatternSize - 1;
+
+    while( !isFound && ( ( xPos + xLastOff + 64 ) <= xDataSize ) )
     {
-        /* Empty buffer. */
-        pHeader = pcBuf;
-        topFreeSpace = xBufSize;
+        std::uint64_t ullCandidates = 0;
+
+        /* Keep the block loop free of calls, candidates are rare. */
+        while( ( ullCandidates == 0 ) && ( ( xPos + xLastOff + 64 ) <= xDataSize ) )
+        {
+            ullCandidates = getCandidates( pcData + xPos, pcPattern, xLastOff );
+            xPos += 64;
+        }
+
+        while( !isFound && ( ullCandidates != 0 ) )
+        {
+            isFound = ( std::memcmp( pcData + xPos - 64 + __builtin_ctzll( ullCandidates ), pcPattern, xPatternSize ) == 0 );
+
+            ullCandidates &= ullCandidates - 1;
+        }
     }
-    else
+#endif
+
+    while( !isFound && ( ( xPos + xPatternSize ) <= xDataSize ) )
     {
-        /* Determine position of next item. */
-        ptrNext = ( std::uint8_t* )pxHead + sizeof( rbItem_t ) + pxHead->xItemSize;
-   
-        /* Buffer roll-over check. */
-        if( ptrNext > &pcBuf[ xBufSize - 1 ] )
+        const std::uint8_t* pcCandidate = ( const std::uint8_t* )std::memchr( pcData + xPos, pcPattern[ 0 ], xDataSize - xPatternSize - xPos + 1 );
+
+        if( pcCandidate == nullptr )
+        {
+            xPos = xDataSize;
+        }
+        else
         {
-            ptrNext = pcBuf + ( ptrNext - &pcBuf[ xBufSize - 1 ] - 1 );
+            isFound = ( std::memcmp( pcCandidate, pcPattern, xPatternSize ) == 0 );
+
+            xPos = ( std::size_t )( pcCandidate - pcData ) + 1;
         }
+    }
 
-        if ( ptrNext > ( std::uint8_t* )pxTail )
+    return isFound;
+}
+
+/**
+ * @brief Checks whether a pattern occurs in item data split in two parts,
+ *        including the occurrences across the end of the first part.
+ *
+ * @param[in] pxSpans Array of two spans holding the item data.
+ * @param[in] pcPattern Pointer to the pattern.
+ * @param[in] xPatternSize Size [byte] of the pattern, not zero.
+ * @param[out] True when the pattern is found.
+ */
+
+static bool containsPattern( const rbConstSpan_t* pxSpans, 
+                             const std::uint8_t* pcPattern, 
+                             const std::size_t xPatternSize )
+{
+    bool isFound =    containsPattern( pxSpans[ 0 ].pcData, pxSpans[ 0 ].xSize, pcPattern, xPatternSize ) \
+                   || containsPattern( pxSpans[ 1 ].pcData, pxSpans[ 1 ].xSize, pcPattern, xPatternSize );
+
+    /* Occurrences starting in the last bytes of the first part. */
+    std::size_t xTopSize = std::min( xPatternSize - 1, pxSpans[ 0 ].xSize );
+
+    while( !isFound && ( xTopSize > 0 ) )
+    {
+        isFound =    ( ( xPatternSize - xTopSize ) <= pxSpans[ 1 ].xSize ) \
+                  && ( std::memcmp( pxSpans[ 0 ].pcData + pxSpans[ 0 ].xSize - xTopSize, pcPattern, xTopSize ) == 0 ) \
+                  && ( std::memcmp( pxSpans[ 1 ].pcData, pcPattern + xTopSize, xPatternSize - xTopSize ) == 0 );
+
+        --xTopSize;
+    }
+
+    return isFound;
+}
+
+/**
+ * @brief Smallest item [byte] worth compressing.
+ */
+
+static constexpr std::size_t xCodecMinSize = 16;
+
+/**
+ * @brief Size [byte] of the data size stored in front of compressed data.
+ */
+
+static constexpr std::size_t xCodecHeaderSize = sizeof( std::uint32_t );
+
+/**
+ * @brief Gets the size of the data stored in an item.
+ *
+ * @param[in] xItemSize Size field of the item header.
+ * @param[out] Size [byte] without RB_ITEM_FLAG_COMPRESSED and RB_ITEM_FLAG_DELTA.
+ */
+
+static inline std::size_t getStoredSize( const rbSize_t xItemSize )
+{
+    return ( std::size_t )( xItemSize & ~( RB_ITEM_FLAG_COMPRESSED | RB_ITEM_FLAG_DELTA ) );
+}
+
+/**
+ * @brief Reads 4 bytes at any alignment.
+ *
+ * @param[in] pcData Pointer to the bytes.
+ * @param[out] The bytes in host order.
+ */
+
+static inline std::uint32_t readWord( const std::uint8_t* pcData )
+{
+    std::uint32_t ulWord;
+
+    std::memcpy( &ulWord, pcData, sizeof( ulWord ) );
+
+    return ulWord;
+}
+
+/**
+ * @brief Writes the part of a literals or match length exceeding the
+ *        token, as bytes of 255 and a last byte lower than 255.
+ *
+ * @param[in] pcDst Where to write.
+ * @param[in] xLength Length left after the token.
+ * @param[out] Pointer past the last byte written.
+ */
+
+static inline std::uint8_t* writeLength( std::uint8_t* pcDst, 
+                                         std::size_t xLength )
+{
+    while( xLength >= 255 )
+    {
+        *pcDst++ = 255;
+        xLength -= 255;
+    }
+
+    *pcDst++ = ( std::uint8_t )xLength;
+
+    return pcDst;
+}
+
+/**
+ * @brief Compresses an item with a fast LZ77 coder.
+ *
+ * @note The data is written as LZ4 sequences (token, literals, 16-bit
+ *       offset, match length) after its size, and the last sequence only
+ *       holds literals. Matches are found through a hash table of the
+ *       4-byte words seen, sized after the item to keep clearing it cheap.
+ *
+ * @param[in] pcSrc Pointer to the item.
+ * @param[in] xSrcSize Size [byte] of the item.
+ * @param[in] pcDst Pointer to the output.
+ * @param[in] xDstSize Size [byte] of the output, the compressed data
+ *            shall fit in it.
+ * @param[in] pulHash Hash table of RB_CODEC_HASH_CNT entries.
+ * @param[out] Size [byte] of the compressed data, zero when it does not fit.
+ */
+
+static std::size_t compressItem( const std::uint8_t* pcSrc, 
+                                 const std::size_t xSrcSize, 
+                                 std::uint8_t* pcDst, 
+                                 const std::size_t xDstSize, 
+                                 std::uint32_t* pulHash )
+{
+    /* LZ4 limits: matches start 12 bytes and end 5 bytes before the end. */
+    const std::size_t xMatchLimit = ( xSrcSize > 12 ) ? ( xSrcSize - 12 ) : 0;
+    const std::size_t xMatchEnd = ( xSrcSize > 5 ) ? ( xSrcSize - 5 ) : 0;
+    const std::uint8_t* pcDstEnd = pcDst + xDstSize;
+
+    std::uint8_t* pcOut = pcDst + xCodecHeaderSize;
+    bool isFitting = ( xDstSize > xCodecHeaderSize ) && ( xSrcSize <= UINT32_MAX );
+    std::size_t xHashBits = 8;
+    std::size_t xPos = 0;
+    std::size_t xAnchor = 0;
+    std::size_t xMisses = 0;
+
+    while( ( ( ( std::size_t )1 << xHashBits ) < RB_CODEC_HASH_CNT ) && ( ( ( std::size_t )1 << xHashBits ) < xSrcSize ) )
+    {
+        ++xHashBits;
+    }
+
+    std::memset( pulHash, 0, sizeof( std::uint32_t ) << xHashBits );
+
+    while( isFitting && ( xPos < xMatchLimit ) )
+    {
+        const std::uint32_t ulWord = readWord( pcSrc + xPos );
+        const std::size_t xHash = ( std::uint32_t )( ulWord * 2654435761U ) >> ( 32 - xHashBits );
+        std::size_t xCand = pulHash[ xHash ];
+
+        pulHash[ xHash ] = ( std::uint32_t )xPos;
+
+        if(    ( xCand < xPos ) \
+            && ( ( xPos - xCand ) <= 0xFFFF ) \
+            && ( readWord( pcSrc + xCand ) == ulWord )    )
         {
-            /* pxHead > pxTail. */ 
-            topFreeSpace = ( std::size_t )( &pcBuf[ xBufSize - 1 ] - ptrNext ) + 1;
+            std::size_t xMatchLen = 4;
+            bool isMatching = true;
 
-            bottomFreeSpace = ( std::size_t )( ( std::uint8_t* )pxTail - pcBuf );
+#if defined( __GNUC__ ) && ( __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__ )
+            /* Compare 8 bytes at a time, the lowest different byte ends the match. */
+            while( isMatching && ( ( xPos + xMatchLen + 8 ) <= xMatchEnd ) )
+            {
+                std::uint64_t ullCand;
+                std::uint64_t ullData;
 
-            if( topFreeSpace >= sizeof( rbItem_t ) )
+                std::memcpy( &ullCand, pcSrc + xCand + xMatchLen, sizeof( ullCand ) );
+                std::memcpy( &ullData, pcSrc + xPos + xMatchLen, sizeof( ullData ) );
+
+                if( ullCand == ullData )
+                {
+                    xMatchLen += 8;
+                }
+                else
+                {
+                    xMatchLen += ( std::size_t )__builtin_ctzll( ullCand ^ ullData ) / 8;
+                    isMatching = false;
+                }
+            }
+#endif
+
+            while( isMatching && ( ( xPos + xMatchLen ) < xMatchEnd ) && ( pcSrc[ xCand + xMatchLen ] == pcSrc[ xPos + xMatchLen ] ) )
             {
-                /* Fit header on top part. */
-                pHeader = ptrNext; 
+                ++xMatchLen;
+            }
 
-                topFreeSpace -= sizeof( rbItem_t );
+            /* Take back the literals that are part of the match. */
+            while( ( xPos > xAnchor ) && ( xCand > 0 ) && ( pcSrc[ xPos - 1 ] == pcSrc[ xCand - 1 ] ) )
+            {
+                --xPos;
+                --xCand;
+                ++xMatchLen;
             }
-            else
+
+            const std::size_t xLitLen = xPos - xAnchor;
+            const std::size_t xSeqSize = 1 + ( xLitLen / 255 ) + 1 + xLitLen + 2 + ( ( xMatchLen - 4 ) / 255 ) + 1;
+
+            isFitting = ( xSeqSize <= ( std::size_t )( pcDstEnd - pcOut ) );
+
+            if( isFitting )
             {
-                /* Top free space not usable. */
-                topFreeSpace = 0;
-                
-                if( bottomFreeSpace >= sizeof( rbItem_t ) )
+                const std::size_t xOffset = xPos - xCand;
+                std::uint8_t* pcToken = pcOut++;
+
+                *pcToken = ( std::uint8_t )( ( std::min( xLitLen, ( std::size_t )15 ) << 4 ) | std::min( xMatchLen - 4, ( std::size_t )15 ) );
+
+                if( xLitLen >= 15 )
                 {
-                    /* Fit header on bottom part. */
-                    pHeader = pcBuf;
+                    pcOut = writeLength( pcOut, xLitLen - 15 );
+                }
+
+                std::memcpy( pcOut, pcSrc + xAnchor, xLitLen );
+                pcOut += xLitLen;
+
+                *pcOut++ = ( std::uint8_t )xOffset;
+                *pcOut++ = ( std::uint8_t )( xOffset >> 8 );
+
+                if( ( xMatchLen - 4 ) >= 15 )
+                {
+                    pcOut = writeLength( pcOut, xMatchLen - 4 - 15 );
+                }
+
+                xPos += xMatchLen;
+                xAnchor = xPos;
+                xMisses = 0;
+            }
+        }
+        else
+        {
+            /* Skip faster through data that does not compress. */
+            xPos += 1 + ( xMisses++ >> 6 );
+        }
+    }
+
+    if( isFitting )
+    {
+        /* Last literals. */
+        const std::size_t xLitLen = xSrcSize - xAnchor;
+        const std::size_t xSeqSize = 1 + ( xLitLen / 255 ) + 1 + xLitLen;
+
+        isFitting = ( xSeqSize <= ( std::size_t )( pcDstEnd - pcOut ) );
+
+        if( isFitting )
+        {
+            const std::uint32_t ulSrcSize = ( std::uint32_t )xSrcSize;
+
+            *pcOut++ = ( std::uint8_t )( std::min( xLitLen, ( std::size_t )15 ) << 4 );
+
+            if( xLitLen >= 15 )
+            {
+                pcOut = writeLength( pcOut, xLitLen - 15 );
+            }
+
+            std::memcpy( pcOut, pcSrc + xAnchor, xLitLen );
+            pcOut += xLitLen;
+
+            std::memcpy( pcDst, &ulSrcSize, sizeof( ulSrcSize ) );
+        }
+    }
+
+    return isFitting ? ( std::size_t )( pcOut - pcDst ) : 0;
+}
+
+/**
+ * @brief Copies bytes of item data held by two spans.
+ *
+ * @param[in] pxSpans Array of two spans holding the data.
+ * @param[in] xOffset Offset [byte] of the first byte in the data.
+ * @param[in] pcDst Destination of the bytes.
+ * @param[in] xSize Number of bytes to copy.
+ * @param[out] True when the bytes are within the data.
+ */
+
+static inline bool readSpans( const rbConstSpan_t* pxSpans, 
+                              const std::size_t xOffset, 
+                              std::uint8_t* pcDst, 
+                              const std::size_t xSize )
+{
+    const std::size_t xDataSize = pxSpans[ 0 ].xSize + pxSpans[ 1 ].xSize;
+    const bool isRead = ( xOffset <= xDataSize ) && ( xSize <= ( xDataSize - xOffset ) );
+
+    if( isRead && ( xSize > 0 ) )
+    {
+        const std::size_t xTopSize = ( xOffset < pxSpans[ 0 ].xSize ) ? std::min( xSize, pxSpans[ 0 ].xSize - xOffset ) : 0;
+
+        if( xTopSize > 0 )
+        {
+            std::memcpy( pcDst, pxSpans[ 0 ].pcData + xOffset, xTopSize );
+        }
+
+        if( xTopSize < xSize )
+        {
+            std::memcpy( pcDst + xTopSize, pxSpans[ 1 ].pcData + xOffset + xTopSize - pxSpans[ 0 ].xSize, xSize - xTopSize );
+        }
+    }
+
+    return isRead;
+}
+
+/**
+ * @brief Read position in compressed data held by two spans.
+ */
+
+typedef struct {
+    const std::uint8_t* pcPos;      /**< Next byte to read. */
+    const std::uint8_t* pcEnd;      /**< End of the span being read. */
+    const rbConstSpan_t* pxNext;    /**< Span read next, nullptr when none. */
+} rbCodecReader_t;
+
+/**
+ * @brief Moves the read position to the next span when the current one
+ *        is over.
+ *
+ * @param[in] pxReader Read position.
+ * @param[out] True when there are bytes left to read.
+ */
+
+static inline bool hasBytes( rbCodecReader_t* pxReader )
+{
+    if( ( pxReader->pcPos == pxReader->pcEnd ) && ( pxReader->pxNext != nullptr ) )
+    {
+        pxReader->pcPos = pxReader->pxNext->pcData;
+        pxReader->pcEnd = pxReader->pxNext->pcData + pxReader->pxNext->xSize;
+        pxReader->pxNext = nullptr;
+    }
+
+    return ( pxReader->pcPos != pxReader->pcEnd );
+}
+
+/**
+ * @brief Reads compressed data.
+ *
+ * @param[in] pxReader Read position, moved past the bytes read.
+ * @param[in] pcDst Destination of the bytes.
+ * @param[in] xSize Number of bytes to read.
+ * @param[out] True when all the bytes were there.
+ */
+
+static inline bool readBytes( rbCodecReader_t* pxReader, 
+                              std::uint8_t* pcDst, 
+                              std::size_t xSize )
+{
+    bool isRead = true;
+
+    while( isRead && ( xSize > 0 ) )
+    {
+        isRead = hasBytes( pxReader );
+
+        if( isRead )
+        {
+            const std::size_t xPartSize = std::min( xSize, ( std::size_t )( pxReader->pcEnd - pxReader->pcPos ) );
+
+            std::memcpy( pcDst, pxReader->pcPos, xPartSize );
+
+            pxReader->pcPos += xPartSize;
+            pcDst += xPartSize;
+            xSize -= xPartSize;
+        }
+    }
+
+    return isRead;
+}
+
+/**
+ * @brief Reads the part of a literals or match length exceeding the token.
+ *
+ * @param[in] pxReader Read position.
+ * @param[in] pxLength Length, increased by the bytes read.
+ * @param[out] True when the bytes were there.
+ */
+
+static inline bool readLength( rbCodecReader_t* pxReader, 
+                               std::size_t* pxLength )
+{
+    bool isRead = true;
+    std::uint8_t cByte = 255;
+
+    while( isRead && ( cByte == 255 ) )
+    {
+        isRead = hasBytes( pxReader );
+
+        if( isRead )
+        {
+            cByte = *pxReader->pcPos++;
+            *pxLength += cByte;
+        }
+    }
+
+    return isRead;
+}
+
+/**
+ * @brief Decompresses an item written by compressItem().
+ *
+ * @note Every length and offset is checked, so data overwritten while
+ *       being read, or corrupted in an image, cannot write out of bounds.
+ *
+ * @param[in] pxSpans Array of two spans holding the compressed data.
+ * @param[in] pcDst Destination of the item data.
+ * @param[in] xDstSize Size [byte] of the destination.
+ * @param[in] pxDataSize Filled with the size [byte] of the item data.
+ * @param[out] True when the data is valid and fits the destination.
+ */
+
+static bool decompressItem( const rbConstSpan_t* pxSpans, 
+                            std::uint8_t* pcDst, 
+                            const std::size_t xDstSize, 
+                            std::size_t* pxDataSize )
+{
+    rbCodecReader_t xReader = { pxSpans[ 0 ].pcData, pxSpans[ 0 ].pcData + pxSpans[ 0 ].xSize, &pxSpans[ 1 ] };
+
+    std::uint32_t ulDataSize = 0;
+    bool isValid = readBytes( &xReader, ( std::uint8_t* )&ulDataSize, sizeof( ulDataSize ) ) && ( ulDataSize <= xDstSize );
+    std::size_t xOut = 0;
+
+    while( isValid && hasBytes( &xReader ) )
+    {
+        const std::uint8_t cToken = *xReader.pcPos++;
+        std::size_t xLitLen = cToken >> 4;
+
+        if( xLitLen == 15 )
+        {
+            isValid = readLength( &xReader, &xLitLen );
+        }
+
+        isValid = isValid && ( xLitLen <= ( ulDataSize - xOut ) );
+
+        if(    isValid \
+            && ( ( xLitLen + 16 ) <= ( std::size_t )( xReader.pcEnd - xReader.pcPos ) ) \
+            && ( ( xLitLen + 16 ) <= ( ulDataSize - xOut ) )    )
+        {
+            /* Copy by blocks, overwriting bytes not decoded yet. */
+            for( std::size_t i = 0; i < xLitLen; i += 16 )
+            {
+                std::memcpy( pcDst + xOut + i, xReader.pcPos + i, 16 );
+            }
+
+            xReader.pcPos += xLitLen;
+        }
+        else
+        {
+            isValid = isValid && readBytes( &xReader, pcDst + xOut, xLitLen );
+        }
+
+        xOut += xLitLen;
+
+        /* A match follows, but in the last sequence. */
+        if( isValid && hasBytes( &xReader ) )
+        {
+            std::uint8_t acOffset[ 2 ] = { 0, 0 };
+
+            isValid = readBytes( &xReader, acOffset, sizeof( acOffset ) );
+
+            const std::size_t xOffset = ( std::size_t )acOffset[ 0 ] | ( ( std::size_t )acOffset[ 1 ] << 8 );
+            std::size_t xMatchLen = cToken & 0xF;
+
+            if( isValid && ( xMatchLen == 15 ) )
+            {
+                isValid = readLength( &xReader, &xMatchLen );
+            }
+
+            xMatchLen += 4;
+
+            isValid =    isValid \
+                      && ( xOffset > 0 ) \
+                      && ( xOffset <= xOut ) \
+                      && ( xMatchLen <= ( ulDataSize - xOut ) );
+
+            if( isValid )
+            {
+                if( ( xOffset >= 16 ) && ( ( xMatchLen + 16 ) <= ( ulDataSize - xOut ) ) )
+                {
+                    for( std::size_t i = 0; i < xMatchLen; i += 16 )
+                    {
+                        std::memcpy( pcDst + xOut + i, pcDst + xOut + i - xOffset, 16 );
+                    }
+                }
+                else if( xOffset >= xMatchLen )
+                {
+                    std::memcpy( pcDst + xOut, pcDst + xOut - xOffset, xMatchLen );
+                }
+                else
+                {
+                    /* The match repeats its own output. */
+                    for( std::size_t i = 0; i < xMatchLen; ++i )
+                    {
+                        pcDst[ xOut + i ] = pcDst[ xOut + i - xOffset ];
+                    }
+                }
+
+                xOut += xMatchLen;
+            }
+        }
+    }
+
+    isValid = isValid && ( xOut == ulDataSize );
+
+    *pxDataSize = isValid ? xOut : 0;
+
+    return isValid;
+}
+
+/**
+ * @brief Size [byte] of each type of sample field, by rbField_t.
+ */
+
+static constexpr std::uint8_t acFieldSize[] = { 1, 2, 4, 8, 4, 8 };
+
+/**
+ * @brief XOR window of a float field that has none yet.
+ */
+
+static constexpr std::uint8_t cWindowNone = 0xFF;
+
+/**
+ * @brief Write position in a stream of bits, most significant bit first.
+ */
+
+typedef struct {
+    std::uint8_t* pcPos;        /**< Next byte to write. */
+    std::uint64_t ullBits;      /**< Bits not written yet, in the low part. */
+    std::size_t xBitsCnt;       /**< Number of bits not written yet, less than 8 between calls. */
+} rbBitWriter_t;
+
+/**
+ * @brief Read position in a stream of bits held by two spans.
+ */
+
+typedef struct {
+    rbCodecReader_t xBytes;     /**< Read position of the bytes. */
+    std::uint64_t ullBits;      /**< Bits of the bytes read not consumed yet, in the low part. */
+    std::size_t xBitsCnt;       /**< Number of bits not consumed yet, less than 8 between calls. */
+    bool isValid;               /**< False once reading past the end of the data. */
+} rbBitReader_t;
+
+/**
+ * @brief Writes the low bits of a value.
+ *
+ * @param[in] pxWriter Write position.
+ * @param[in] ullValue Value to write.
+ * @param[in] xBitsCnt Number of bits to write, up to 64.
+ */
+
+static inline void writeBits( rbBitWriter_t* pxWriter, 
+                              const std::uint64_t ullValue, 
+                              const std::size_t xBitsCnt )
+{
+    std::size_t xLowCnt = xBitsCnt;
+
+    if( xBitsCnt > 32 )
+    {
+        writeBits( pxWriter, ullValue >> 32, xBitsCnt - 32 );
+
+        xLowCnt = 32;
+    }
+
+    pxWriter->ullBits = ( pxWriter->ullBits << xLowCnt ) | ( ullValue & ( ( 1ULL << xLowCnt ) - 1U ) );
+    pxWriter->xBitsCnt += xLowCnt;
+
+    while( pxWriter->xBitsCnt >= 8 )
+    {
+        pxWriter->xBitsCnt -= 8;
+        *pxWriter->pcPos++ = ( std::uint8_t )( pxWriter->ullBits >> pxWriter->xBitsCnt );
+    }
+}
+
+/**
+ * @brief Reads bits into the low part of a value.
+ *
+ * @note Reading past the end of the data gives zeros and clears isValid.
+ *
+ * @param[in] pxReader Read position.
+ * @param[in] xBitsCnt Number of bits to read, up to 64.
+ * @param[out] The bits read.
+ */
+
+static inline std::uint64_t readBits( rbBitReader_t* pxReader, 
+                                      const std::size_t xBitsCnt )
+{
+    std::uint64_t ullValue = 0;
+    std::size_t xLowCnt = xBitsCnt;
+
+    if( xBitsCnt > 32 )
+    {
+        ullValue = readBits( pxReader, xBitsCnt - 32 ) << 32;
+
+        xLowCnt = 32;
+    }
+
+    while( pxReader->xBitsCnt < xLowCnt )
+    {
+        pxReader->isValid = pxReader->isValid && hasBytes( &pxReader->xBytes );
+        pxReader->ullBits = ( pxReader->ullBits << 8 ) | ( pxReader->isValid ? *pxReader->xBytes.pcPos++ : 0U );
+        pxReader->xBitsCnt += 8;
+    }
+
+    pxReader->xBitsCnt -= xLowCnt;
+
+    return ullValue | ( ( pxReader->ullBits >> pxReader->xBitsCnt ) & ( ( 1ULL << xLowCnt ) - 1U ) );
+}
+
+/**
+ * @brief Reads a field of a sample, at any alignment.
+ *
+ * @param[in] pcField Pointer to the field.
+ * @param[in] eField Type of the field.
+ * @param[out] The field bits, zero-extended.
+ */
+
+static inline std::uint64_t loadField( const std::uint8_t* pcField, 
+                                       const rbField_t eField )
+{
+    std::uint64_t ullValue = 0;
+
+    switch( acFieldSize[ eField ] )
+    {
+        case 1:
+            ullValue = *pcField;
+            break;
+
+        case 2:
+        {
+            std::uint16_t usValue;
+            std::memcpy( &usValue, pcField, sizeof( usValue ) );
+            ullValue = usValue;
+            break;
+        }
+
+        case 4:
+        {
+            std::uint32_t ulValue;
+            std::memcpy( &ulValue, pcField, sizeof( ulValue ) );
+            ullValue = ulValue;
+            break;
+        }
+
+        default:
+            std::memcpy( &ullValue, pcField, sizeof( ullValue ) );
+            break;
+    }
+
+    return ullValue;
+}
+
+/**
+ * @brief Writes a field of a sample, at any alignment.
+ *
+ * @param[in] pcField Pointer to the field.
+ * @param[in] eField Type of the field.
+ * @param[in] ullValue The field bits, only the low ones are written.
+ */
+
+static inline void storeField( std::uint8_t* pcField, 
+                               const rbField_t eField, 
+                               const std::uint64_t ullValue )
+{
+    switch( acFieldSize[ eField ] )
+    {
+        case 1:
+            *pcField = ( std::uint8_t )ullValue;
+            break;
+
+        case 2:
+        {
+            const std::uint16_t usValue = ( std::uint16_t )ullValue;
+            std::memcpy( pcField, &usValue, sizeof( usValue ) );
+            break;
+        }
+
+        case 4:
+        {
+            const std::uint32_t ulValue = ( std::uint32_t )ullValue;
+            std::memcpy( pcField, &ulValue, sizeof( ulValue ) );
+            break;
+        }
+
+        default:
+            std::memcpy( pcField, &ullValue, sizeof( ullValue ) );
+            break;
+    }
+}
+
+/**
+ * @brief Encodes a sample as the delta from the previous one: integer
+ *        fields as zigzag varints of their difference, float fields as
+ *        the meaningful bits of their XOR (as Gorilla), an unchanged
+ *        field as a single bit.
+ *
+ * @param[in] pcSample Sample to encode.
+ * @param[in] pcPrev Previous sample.
+ * @param[in] pxFields Fields of the samples.
+ * @param[in] xFieldsCnt Number of fields.
+ * @param[in] pcWindow Leading and trailing zeros of the XOR window of
+ *            each float field, updated.
+ * @param[in] pcDst Destination, RB_DELTA_FIELD_DELTA_MAX bytes per field.
+ * @param[out] Size [byte] of the delta.
+ */
+
+static std::size_t encodeDelta( const std::uint8_t* pcSample, 
+                                const std::uint8_t* pcPrev, 
+                                const rbField_t* pxFields, 
+                                const std::size_t xFieldsCnt, 
+                                std::uint8_t* pcWindow, 
+                                std::uint8_t* pcDst )
+{
+    rbBitWriter_t xWriter = { pcDst, 0, 0 };
+    std::size_t xFieldOff = 0;
+
+    for( std::size_t i = 0; i < xFieldsCnt; ++i )
+    {
+        const std::size_t xFieldBits = acFieldSize[ pxFields[ i ] ] * 8U;
+        const std::uint64_t ullValue = loadField( &pcSample[ xFieldOff ], pxFields[ i ] );
+        const std::uint64_t ullPrev = loadField( &pcPrev[ xFieldOff ], pxFields[ i ] );
+
+        if( ullValue == ullPrev )
+        {
+            writeBits( &xWriter, 0, 1 );
+        }
+        else if( pxFields[ i ] < RB_FIELD_FLOAT )
+        {
+            /* Difference in the width of the field, zigzag maps small ones of either sign to small numbers. */
+            const std::size_t xExtShift = 64U - xFieldBits;
+            const std::int64_t llDelta = ( std::int64_t )( ( ullValue - ullPrev ) << xExtShift ) >> xExtShift;
+            std::uint64_t ullZigzag = ( ( std::uint64_t )llDelta << 1 ) ^ ( std::uint64_t )( llDelta >> 63 );
+
+            writeBits( &xWriter, 1, 1 );
+
+            while( ullZigzag >= 0x80 )
+            {
+                writeBits( &xWriter, 0x80 | ( ullZigzag & 0x7F ), 8 );
+                ullZigzag >>= 7;
+            }
+
+            writeBits( &xWriter, ullZigzag, 8 );
+        }
+        else
+        {
+            const std::uint64_t ullXor = ullValue ^ ullPrev;
+            const std::size_t xLead = std::min( ( std::size_t )__builtin_clzll( ullXor ) - ( 64U - xFieldBits ), ( std::size_t )31 );
+            const std::size_t xTrail = ( std::size_t )__builtin_ctzll( ullXor );
+
+            std::uint8_t* pcLead = &pcWindow[ 2 * i ];
+            std::uint8_t* pcTrail = &pcWindow[ ( 2 * i ) + 1 ];
+
+            if(    ( *pcLead != cWindowNone ) \
+                && ( xLead >= *pcLead ) \
+                && ( xTrail >= *pcTrail )    )
+            {
+                /* Meaningful bits within the window of the previous XOR. */
+                writeBits( &xWriter, 2, 2 );
+                writeBits( &xWriter, ullXor >> *pcTrail, xFieldBits - *pcLead - *pcTrail );
+            }
+            else
+            {
+                /* New window: leading zeros and length, a full length written as zero. */
+                const std::size_t xLength = xFieldBits - xLead - xTrail;
+
+                writeBits( &xWriter, 3, 2 );
+                writeBits( &xWriter, xLead, 5 );
+                writeBits( &xWriter, xLength & ( xFieldBits - 1U ), ( xFieldBits == 64U ) ? 6 : 5 );
+                writeBits( &xWriter, ullXor >> xTrail, xLength );
+
+                *pcLead = ( std::uint8_t )xLead;
+                *pcTrail = ( std::uint8_t )xTrail;
+            }
+        }
+
+        xFieldOff += acFieldSize[ pxFields[ i ] ];
+    }
+
+    /* Pad the last byte with zeros. */
+    if( xWriter.xBitsCnt > 0 )
+    {
+        writeBits( &xWriter, 0, 8U - xWriter.xBitsCnt );
+    }
+
+    return ( std::size_t )( xWriter.pcPos - pcDst );
+}
+
+/**
+ * @brief Applies a delta written by encodeDelta() to the previous sample.
+ *
+ * @note Every length is checked, so a delta corrupted in an image gives
+ *       a wrong sample at worst.
+ *
+ * @param[in] pxSpans Array of two spans holding the delta.
+ * @param[in] pxFields Fields of the samples.
+ * @param[in] xFieldsCnt Number of fields.
+ * @param[in] pcSample Previous sample, turned into the decoded one.
+ * @param[in] pcWindow XOR window of each float field, updated.
+ * @param[out] True when the delta is valid.
+ */
+
+static bool decodeDelta( const rbConstSpan_t* pxSpans, 
+                         const rbField_t* pxFields, 
+                         const std::size_t xFieldsCnt, 
+                         std::uint8_t* pcSample, 
+                         std::uint8_t* pcWindow )
+{
+    rbBitReader_t xReader = { { pxSpans[ 0 ].pcData, pxSpans[ 0 ].pcData + pxSpans[ 0 ].xSize, &pxSpans[ 1 ] }, 0, 0, true };
+    std::size_t xFieldOff = 0;
+
+    for( std::size_t i = 0; ( i < xFieldsCnt ) && xReader.isValid; ++i )
+    {
+        const std::size_t xFieldBits = acFieldSize[ pxFields[ i ] ] * 8U;
+        std::uint64_t ullValue = loadField( &pcSample[ xFieldOff ], pxFields[ i ] );
+
+        if( readBits( &xReader, 1 ) == 0 )
+        {
+            /* Unchanged. */
+        }
+        else if( pxFields[ i ] < RB_FIELD_FLOAT )
+        {
+            std::uint64_t ullZigzag = 0;
+            std::uint64_t ullGroup = 0x80;
+
+            for( std::size_t xShift = 0; ( xShift < 64 ) && ( ( ullGroup & 0x80 ) != 0 ); xShift += 7 )
+            {
+                ullGroup = readBits( &xReader, 8 );
+                ullZigzag |= ( ullGroup & 0x7F ) << xShift;
+            }
+
+            xReader.isValid = xReader.isValid && ( ( ullGroup & 0x80 ) == 0 );
+
+            ullValue += ( ullZigzag >> 1 ) ^ ( 0U - ( ullZigzag & 1U ) );
+        }
+        else
+        {
+            std::uint8_t* pcLead = &pcWindow[ 2 * i ];
+            std::uint8_t* pcTrail = &pcWindow[ ( 2 * i ) + 1 ];
+
+            if( readBits( &xReader, 1 ) == 0 )
+            {
+                /* Window of the previous XOR. */
+                xReader.isValid = xReader.isValid && ( *pcLead != cWindowNone );
+            }
+            else
+            {
+                const std::size_t xLead = ( std::size_t )readBits( &xReader, 5 );
+                std::size_t xLength = ( std::size_t )readBits( &xReader, ( xFieldBits == 64U ) ? 6 : 5 );
+
+                xLength = ( xLength == 0 ) ? xFieldBits : xLength;
+
+                xReader.isValid = xReader.isValid && ( ( xLead + xLength ) <= xFieldBits );
+
+                *pcLead = ( std::uint8_t )xLead;
+                *pcTrail = ( std::uint8_t )( xFieldBits - xLead - xLength );
+            }
+
+            if( xReader.isValid )
+            {
+                ullValue ^= readBits( &xReader, xFieldBits - *pcLead - *pcTrail ) << *pcTrail;
+            }
+        }
+
+        storeField( &pcSample[ xFieldOff ], pxFields[ i ], ullValue );
+
+        xFieldOff += acFieldSize[ pxFields[ i ] ];
+    }
+
+    return xReader.isValid;
+}
+
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief Main to compile under visual studio code.
+ *
+ * @note Define the symbol VISUALS>TUDIO_CODE to enable its compilation.
+ */
+
+// #ifdef VISUAL_STUDIO_CODE
+// #include <iostream>
+// #include <vector>
+// int main() {
+//     std::vector<std::string> msg {"Hello ringBuffer!"};
+
+//     for (const std::string& word : msg)
+//     {
+//         std::cout << word << " ";
+//     }
+    
+//     std::cout << std::endl;
+// }
+// #endif
+
+/*--------------------- Private methods ---------------------*/
+
+/**
+ * @brief Resets the ring buffer.
+ * 
+ * @note Private method. The buffer is published empty before the empty
+ *       head is written, which may overwrite data of the last item
+ *       rolling-over to the start of the pool while a reader copies it.
+ * 
+ */
+
+void ringbuf::reset( void ) 
+{
+    empty();
+
+    /* Empty head at the start of the pool. */
+    setNext( pxHead, pxHead );
+    setPrev( pxHead, pxHead );
+    pxHead->xItemSize = 0;
+}
+
+/**
+ * @brief Marks the ring buffer as empty without writing to the memory pool,
+ *        so that the data of the items just removed stays readable.
+ * 
+ * @note Private method. The first item inserted next takes the start of the
+ *       pool and writes its header there.
+ * 
+ */
+
+void ringbuf::empty( void ) 
+{
+    /* pHead and pTail init. */
+    pxHead = ( rbItem_t* )pcBuf;
+
+    xTotItemCnt = 0;
+
+    pxTail = pxHead;
+
+    xIndexBase = 0;
+    xIndexFloor = 0;
+
+    /* Drop pending reservation. */
+    pcReserved = nullptr;
+
+    /* Next sample of pushDelta() starts from a keyframe. */
+    pxDeltaHead = nullptr;
+
+#if ( RINGBUF_CFG_ITEM_SEQUENCE == 1 )
+    publishTailSeq();
+#endif
+
+    updateImage();
+}
+
+#if ( RINGBUF_CFG_ITEM_SEQUENCE == 1 )
+/**
+ * @brief Publishes the sequence number of the oldest item retained,
+ *        after items are deleted from the tail.
+ * 
+ * @note Private method. The fence makes the new value visible before
+ *       the space of the deleted items is reused, so a reader copying
+ *       one of them can tell whether the copy can be trusted.
+ * 
+ */
+
+void ringbuf::publishTailSeq( void ) 
+{
+    const std::uint64_t ullSeq = ( xTotItemCnt > 0 ) ? pxTail->ullSeq : ullNextSeq.load( std::memory_order_relaxed );
+
+    ullTailSeq.store( ullSeq, std::memory_order_relaxed );
+
+    /* Pairs with the fence of getData( pxItem, ullSeq, ... ). */
+    std::atomic_thread_fence( std::memory_order_release );
+}
+#endif
+
+/**
+ * @brief Links an item to the next one.
+ * 
+ * @note Private method.
+ * 
+ * @param[in] pxItem Item to update.
+ * @param[in] pxNextItem Next item.
+ *
+ */
+
+void ringbuf::setNext( rbItem_t* pxItem, 
+                       const rbItem_t* pxNextItem ) 
+{
+#if ( RINGBUF_CFG_COMPACT_HEADER == 1 )
+    pxItem->ulNext = ( std::uint32_t )( ( const std::uint8_t* )pxNextItem - pcBuf );
+#else
+    pxItem->pxNext = ( rbItem_t* )pxNextItem;
+#endif
+}
+
+/**
+ * @brief Links an item to the previous one.
+ * 
+ * @note Private method.
+ * 
+ * @param[in] pxItem Item to update.
+ * @param[in] pxPrevItem Previous item.
+ *
+ */
+
+void ringbuf::setPrev( rbItem_t* pxItem, 
+                       const rbItem_t* pxPrevItem ) 
+{
+#if ( RINGBUF_CFG_COMPACT_HEADER == 1 )
+    pxItem->ulPrev = ( std::uint32_t )( ( const std::uint8_t* )pxPrevItem - pcBuf );
+#else
+    pxItem->pxPrev = ( rbItem_t* )pxPrevItem;
+#endif
+}
+
+/**
+ * @brief Identifies the position in the ring buffer
+ *        right after the head item.
+ * 
+ * @note Private method.
+ * 
+ * @param[out] Pointer to the postion.
+ *
+ */
+
+std::uint8_t* ringbuf::getHeadEnd( void ) 
+{
+    std::uint8_t* ptrNext = ( std::uint8_t* )pxHead + sizeof( rbItem_t ) + getStoredSize( pxHead->xItemSize );
+
+    /* Buffer roll-over check. */
+    if( ptrNext > &pcBuf[ xBufSize - 1 ] )
+    {
+        ptrNext = pcBuf + ( ptrNext - &pcBuf[ xBufSize - 1 ] - 1 );
+    }
+
+    return ptrNext;
+}
+
+/**
+ * @brief Computes the free space between the head and the tail.
+ * 
+ * @note Private method. Space wasted at the end of the pool by
+ *       the item layout is counted as free.
+ * 
+ * @param[out] Free space [byte].
+ *
+ */
+
+std::size_t ringbuf::getFreeSpace( void ) 
+{
+    std::size_t xFreeSpace = xBufSize;
+
+    if ( xTotItemCnt > 0 )
+    {
+        std::uint8_t* ptrNext = getHeadEnd();
+
+        if ( ptrNext > ( std::uint8_t* )pxTail )
+        {
+            /* pxHead > pxTail. */ 
+            xFreeSpace = ( std::size_t )( &pcBuf[ xBufSize - 1 ] - ptrNext ) + 1 
+                       + ( std::size_t )( ( std::uint8_t* )pxTail - pcBuf );
+        }
+        else
+        {
+            /* pxTail > pxHead. */
+            xFreeSpace = ( std::size_t )( ( std::uint8_t* )pxTail - ptrNext );
+        }
+    }
+
+    return xFreeSpace;
+}
+
+/**
+ * @brief Identifies the position in the ring buffer
+ *        where the new item header shall be inserted.
+ * 
+ * @note Private method.
+ * 
+ * @param[in] xItemSize Size [byte] of the item to insert.
+ * @param[out] Pointer to the postion.
+ *
+ */
+
+std::uint8_t* ringbuf::getNextPtr( const std::size_t xItemSize ) 
+{
+    std::size_t topFreeSpace = 0;
+    std::size_t bottomFreeSpace = 0;
+    std::uint8_t* ptrNext = nullptr;
+    std::uint8_t* pHeader = nullptr;
+
+    if ( xTotItemCnt == 0 )
+    {
+        /* Empty buffer. */
+        pHeader = pcBuf;
+        topFreeSpace = xBufSize;
+    }
+    else
+    {
+        /* Determine position of next item. */
+        ptrNext = getHeadEnd();
+
+        if ( ptrNext > ( std::uint8_t* )pxTail )
+        {
+            /* pxHead > pxTail. */ 
+            topFreeSpace = ( std::size_t )( &pcBuf[ xBufSize - 1 ] - ptrNext ) + 1;
+
+            bottomFreeSpace = ( std::size_t )( ( std::uint8_t* )pxTail - pcBuf );
+
+            if( eLayout == RB_LAYOUT_MIRRORED )
+            {
+                /* Header and data may cross the end of the pool, its mirror follows. */
+                if( ( topFreeSpace + bottomFreeSpace ) >= ( sizeof( rbItem_t ) + xItemSize ) )
+                {
+                    pHeader = ptrNext;
+                }
+            }
+            else if( eLayout == RB_LAYOUT_CONTIGUOUS )
+            {
+                /* Header and data shall fit in the same part. */
+                if( topFreeSpace >= ( sizeof( rbItem_t ) + xItemSize ) )
+                {
+                    pHeader = ptrNext;
+                }
+                else if( bottomFreeSpace >= ( sizeof( rbItem_t ) + xItemSize ) )
+                {
+                    /* Skip the top part, the head pxNext jumps over it. */
+                    pHeader = pcBuf;
+                }
+            }
+            else if( topFreeSpace >= sizeof( rbItem_t ) )
+            {
+                /* Fit header on top part. */
+                pHeader = ptrNext; 
+
+                topFreeSpace -= sizeof( rbItem_t );
+            }
+            else
+            {
+                /* Top free space not usable. */
+                topFreeSpace = 0;
+                
+                if( bottomFreeSpace >= sizeof( rbItem_t ) )
+                {
+                    /* Fit header on bottom part. */
+                    pHeader = pcBuf;
+
+                    bottomFreeSpace -= sizeof( rbItem_t ); 
+                }
+            }
+        }
+        else
+        {
+            /* pxTail > pxHead. */
+            topFreeSpace = ( std::size_t )( ( std::uint8_t* )pxTail - ptrNext );
+
+            if( topFreeSpace >= ( sizeof( rbItem_t ) + xItemSize ) )
+            {
+                pHeader = ptrNext;
+            }
+        }
+
+        /* Free space for new item check. */
+        if( xItemSize > ( topFreeSpace + bottomFreeSpace ) )
+        {
+            pHeader = nullptr;
+        }
+    }
+
+    return pHeader;
+}
+
+/**
+ * @brief Deletes the tail to make room for a new item,
+ *        keeping track of the data lost.
+ * 
+ * @note Private method.
+ * 
+ */
+
+void ringbuf::evictTail( void ) 
+{
+    ++xStats.xEvictedItems;
+    xStats.xEvictedBytes += getStoredSize( pxTail->xItemSize );
+
+    deleteTail();
+}
+
+/**
+ * @brief Identifies the position where the new item header shall be
+ *        inserted, deleting old items until there is enough space
+ *        when the overflow policy allows it.
+ * 
+ * @note Private method.
+ * 
+ * @param[in] xItemSize Size [byte] of the item to insert.
+ * @param[out] Pointer to the postion, nullptr when the item is rejected.
+ *
+ */
+
+std::uint8_t* ringbuf::getFreePtr( const std::size_t xItemSize ) 
+{
+    std::uint8_t* pHeader = getNextPtr( xItemSize );
+
+    if( eOverflow == RB_OVERFLOW_OVERWRITE )
+    {
+        /* Remove old items if space is not enough. */
+        while( pHeader == nullptr )
+        {
+            evictTail();
+
+            pHeader = getNextPtr( xItemSize );
+        }
+    }
+    else if( pHeader == nullptr )
+    {
+        ++xStats.xRejectedItems;
+        xStats.xRejectedBytes += xItemSize;
+    }
+
+    return pHeader;
+}
+
+/**
+ * @brief Identifies the parts of the memory pool holding
+ *        the data of an item.
+ * 
+ * @note Private method. The second part is used only when
+ *       data rolls over the end of the memory pool, and never
+ *       with a mirrored pool.
+ * 
+ * @param[in] pxHeader Item position in the ring buffer.
+ * @param[in] xItemSize Size [byte] of the item data.
+ * @param[in] pxSpans Array of two spans filled with the data parts.
+ *
+ */
+
+void ringbuf::getSpans( const void* pxHeader, 
+                        const std::size_t xItemSize, 
+                        rbSpan_t* pxSpans ) 
+{
+    /* Data follows the item header. */
+    std::uint8_t* pData = ( std::uint8_t* )pxHeader + sizeof( rbItem_t );
+
+    /* Buffer roll-over check. */
+    if( pData > &pcBuf[ xBufSize - 1 ] )
+    {
+        pData -= xBufSize;
+    }
+
+    const std::size_t topPartSize = ( std::size_t )( &pcBuf[ xBufSize - 1 ] - pData ) + 1;
+
+    pxSpans[ 0 ].pcData = pData;
+    pxSpans[ 1 ].pcData = pcBuf;
+
+    if( ( xItemSize > topPartSize ) && ( eLayout != RB_LAYOUT_MIRRORED ) )
+    {
+        /* Data rolls over, a mirrored pool instead continues past its end. */
+        pxSpans[ 0 ].xSize = topPartSize;
+        pxSpans[ 1 ].xSize = xItemSize - topPartSize;
+    }
+    else
+    {
+        pxSpans[ 0 ].xSize = xItemSize;
+        pxSpans[ 1 ].xSize = 0;
+    }
+}
+
+/**
+ * @brief Records the position of an item in the index, if any.
+ * 
+ * @note Private method.
+ * 
+ * @param[in] pxHeader Item position in the ring buffer.
+ * @param[in] xItemIdx Position of the item counted from the tail.
+ *
+ */
+
+void ringbuf::indexItem( const void* pxHeader, 
+                         const std::size_t xItemIdx ) 
+{
+    if( pulIndex != nullptr )
+    {
+        const std::size_t xIndexPos = xIndexBase + xItemIdx;
+
+        pulIndex[ xIndexPos & xIndexMask ] = ( std::uint32_t )( ( const std::uint8_t* )pxHeader - pcBuf );
+
+        /* The entry of an older item may be overwritten. */
+        if( ( xIndexPos - xIndexFloor ) > xIndexMask )
+        {
+            xIndexFloor = xIndexPos - xIndexMask;
+        }
+    }
+}
+
+#if ( RINGBUF_CFG_ITEM_TIMESTAMP == 1 )
+/**
+ * @brief Finds the oldest item inserted at or after the given time.
+ * 
+ * @note Private method. Items held by the index are searched by bisection,
+ *       the older ones (or all of them without index) from the tail on.
+ * 
+ * @param[in] ullTime Time to look for.
+ * @param[in] pxItemPos Filled with the position of the item counted from
+ *            the tail, getItemsCnt() when not found.
+ * @param[out] Pointer to the item, nullptr when all items are older.
+ *
+ */
+
+const rbItem_t* ringbuf::findTime( const std::uint64_t ullTime, 
+                                   std::size_t* pxItemPos ) 
+{
+    const rbItem_t* pxItem = nullptr;
+    std::size_t xLow = 0;
+    std::size_t xHigh = xTotItemCnt;
+    bool isBisecting = false;
+
+    if( pulIndex != nullptr )
+    {
+        /* Oldest item held by the index. */
+        const std::size_t xIndexedPos = ( xIndexFloor > xIndexBase ) ? ( xIndexFloor - xIndexBase ) : 0;
+
+        if( xIndexedPos == 0 )
+        {
+            isBisecting = true;
+        }
+        else if( xIndexedPos < xTotItemCnt )
+        {
+            isBisecting = ( getItem( xIndexedPos )->ullTime < ullTime );
+
+            if( isBisecting )
+            {
+                xLow = xIndexedPos + 1;
+            }
+            else
+            {
+                xHigh = xIndexedPos;
+            }
+        }
+    }
+
+    if( isBisecting )
+    {
+        while( xLow < xHigh )
+        {
+            const std::size_t xMid = xLow + ( ( xHigh - xLow ) / 2 );
+
+            if( getItem( xMid )->ullTime < ullTime )
+            {
+                xLow = xMid + 1;
+            }
+            else
+            {
+                xHigh = xMid;
+            }
+        }
+
+        pxItem = getItem( xLow );
+    }
+    else
+    {
+        pxItem = pxTail;
+
+        while( ( xLow < xHigh ) && ( pxItem->ullTime < ullTime ) )
+        {
+            ++xLow;
+            pxItem = getNext( pxItem );
+        }
+    }
+
+    if( xLow >= xTotItemCnt )
+    {
+        pxItem = nullptr;
+    }
+
+    *pxItemPos = xLow;
+
+    return pxItem;
+}
+#endif
+
+/**
+ * @brief Writes the header of a new item, whose data is already
+ *        in place, and makes it the head of the ring buffer.
+ * 
+ * @note Private method.
+ * 
+ * @param[in] pxHeader New item position in the ring buffer.
+ * @param[in] xItemSize Size [byte] of the item data.
+ * @param[in] xItemFlags RB_ITEM_FLAG_COMPRESSED or RB_ITEM_FLAG_DELTA
+ *            describing how the data is stored, zero when raw.
+ *
+ */
+
+void ringbuf::linkItem( const void* pxHeader, 
+                        const std::size_t xItemSize, 
+                        const rbSize_t xItemFlags ) 
+{
+    rbItem_t xNewItem;
+
+    /* Copy item header. */
+    setNext( &xNewItem, ( const rbItem_t* )pxHeader );
+    setPrev( &xNewItem, pxHead );
+    xNewItem.xItemSize = ( rbSize_t )xItemSize | xItemFlags;
+#if ( RINGBUF_CFG_ITEM_SEQUENCE == 1 )
+    xNewItem.ullSeq = ullNextSeq.load( std::memory_order_relaxed );
+#endif
+#if ( RINGBUF_CFG_ITEM_TIMESTAMP == 1 )
+    xNewItem.ullTime = pxClock();
+#endif
+
+    std::memcpy( ( void* )pxHeader, &xNewItem, sizeof( rbItem_t ) );
+
+    /* Update Head*/
+    setNext( pxHead, ( const rbItem_t* )pxHeader );
+    pxHead = ( rbItem_t* )pxHeader;
+    pxDeltaHead = nullptr;
+
+    indexItem( pxHeader, xTotItemCnt );
+
+    ++xTotItemCnt;
+
+#if ( RINGBUF_CFG_ITEM_SEQUENCE == 1 )
+    ullNextSeq.store( xNewItem.ullSeq + 1, std::memory_order_release );
+#endif
+
+    updateImage();
+}
+
+/**
+ * @brief Inserts a new item in the ring buffer 
+ *        at a specific location.
+ * 
+ * @note Private method.
+ * 
+ * @param[in] pxHeader New item position in the ring buffer.
+ * @param[in] pxItem Item to insert.
+ * @param[in] xItemSize Size [byte] of the item to insert.
+ * @param[in] xItemFlags RB_ITEM_FLAG_COMPRESSED or RB_ITEM_FLAG_DELTA
+ *            describing how the item is stored, zero when raw.
+ *
+ */
+
+void ringbuf::pushItem( const void* pxHeader, 
+                        const void* pxItem, 
+                        const std::size_t xItemSize, 
+                        const rbSize_t xItemFlags ) 
+{
+    rbSpan_t axSpans[ 2 ];
+
+    getSpans( pxHeader, xItemSize, axSpans );
+
+    /* Copy first part of data. */
+    std::memcpy( axSpans[ 0 ].pcData, pxItem, axSpans[ 0 ].xSize );
+
+    /* Copy second part of data. */
+    std::memcpy( axSpans[ 1 ].pcData, ( const std::uint8_t* )pxItem + axSpans[ 0 ].xSize, axSpans[ 1 ].xSize );
+
+    linkItem( pxHeader, xItemSize, xItemFlags );
+}
+
+/**
+ * @brief Tells whether an item holds a whole sample of pushDelta(),
+ *        stored raw, from which the following deltas are decoded.
+ * 
+ * @note Private method.
+ * 
+ * @param[in] pxItem Pointer to the item.
+ * @param[out] True when the item is a keyframe.
+ *
+ */
+
+bool ringbuf::isSample( const rbItem_t* pxItem ) 
+{
+    return ( xDeltaSampleSize > 0 ) && ( pxItem->xItemSize == ( rbSize_t )xDeltaSampleSize );
+}
+
+/**
+ * @brief Decodes the sample of an item, walking back to the keyframe
+ *        it depends on and applying the deltas from there on.
+ * 
+ * @note Private method. Takes up to the keyframe interval of setDelta()
+ *       steps. A delta whose keyframe was deleted cannot be decoded.
+ * 
+ * @param[in] pxItem Pointer to the item, a keyframe or a delta.
+ * @param[in] pcSample Destination of the sample.
+ * @param[in] pcWindow Filled with the XOR window of each float field,
+ *            to decode the items following this one.
+ * @param[out] True when the sample is decoded.
+ *
+ */
+
+bool ringbuf::decodeSample( const rbItem_t* pxItem, 
+                            std::uint8_t* pcSample, 
+                            std::uint8_t* pcWindow ) 
+{
+    bool isDecoded = false;
+
+    if( ( pxDeltaFields != nullptr ) && ( pxItem != nullptr ) )
+    {
+        const rbItem_t* pxKeyItem = pxItem;
+        std::size_t xStepsCnt = 0;
+
+        /* The tail is preceded by itself. */
+        while( isDelta( pxKeyItem ) && ( pxKeyItem != pxTail ) && ( xStepsCnt < xTotItemCnt ) )
+        {
+            pxKeyItem = getPrev( pxKeyItem );
+            ++xStepsCnt;
+        }
+
+        rbConstSpan_t axSpans[ 2 ];
+
+        if( isSample( pxKeyItem ) && peek( pxKeyItem, axSpans ) )
+        {
+            std::memcpy( pcSample, axSpans[ 0 ].pcData, axSpans[ 0 ].xSize );
+            std::memcpy( ( pcSample + axSpans[ 0 ].xSize ), axSpans[ 1 ].pcData, axSpans[ 1 ].xSize );
+            std::memset( pcWindow, cWindowNone, 2 * xDeltaFieldsCnt );
+
+            isDecoded = true;
+
+            while( isDecoded && ( pxKeyItem != pxItem ) )
+            {
+                pxKeyItem = getNext( pxKeyItem );
+
+                isDecoded =    peek( pxKeyItem, axSpans ) \
+                            && decodeDelta( axSpans, pxDeltaFields, xDeltaFieldsCnt, pcSample, pcWindow );
+            }
+        }
+    }
+
+    return isDecoded;
+}
+
+/**
+ * @brief Gets the spans of the data of an item as it was inserted.
+ * 
+ * @note Private method. Compressed data is decompressed into the
+ *       compressor output, a delta into the encoder output of
+ *       setDelta(), both valid until the next insertion.
+ * 
+ * @param[in] pxItem Pointer to the item.
+ * @param[in] pxSpans Array of two spans filled with the data parts.
+ * @param[out] True when the item holds data that can be read.
+ *
+ */
+
+bool ringbuf::getPlainSpans( const rbItem_t* pxItem, 
+                             rbConstSpan_t* pxSpans ) 
+{
+    bool isDataValid = peek( pxItem, pxSpans );
+
+    if( isDataValid && isCompressed( pxItem ) )
+    {
+        std::size_t xDataSize = 0;
+
+        isDataValid =    ( pcCodecOut != nullptr ) \
+                      && decompressItem( pxSpans, pcCodecOut, xCodecOutSize, &xDataSize );
+
+        pxSpans[ 0 ].pcData = pcCodecOut;
+        pxSpans[ 0 ].xSize = xDataSize;
+        pxSpans[ 1 ].pcData = pcCodecOut;
+        pxSpans[ 1 ].xSize = 0;
+    }
+    else if( isDataValid && isDelta( pxItem ) )
+    {
+        /* Following the item decoded last, one delta is applied. */
+        if(    ( pxDeltaDecoded != nullptr ) \
+            && ( pxItem != pxTail ) \
+            && ( getPrev( pxItem ) == pxDeltaDecoded )    )
+        {
+            isDataValid = decodeDelta( pxSpans, pxDeltaFields, xDeltaFieldsCnt, pcDeltaOut, pcDeltaScanWindow );
+        }
+        else
+        {
+            isDataValid = decodeSample( pxItem, pcDeltaOut, pcDeltaScanWindow );
+        }
+
+        pxDeltaDecoded = isDataValid ? pxItem : nullptr;
+
+        pxSpans[ 0 ].pcData = pcDeltaOut;
+        pxSpans[ 0 ].xSize = isDataValid ? xDeltaSampleSize : 0;
+        pxSpans[ 1 ].pcData = pcDeltaOut;
+        pxSpans[ 1 ].xSize = 0;
+    }
+
+    return isDataValid;
+}
+
+/**
+ * @brief Records head, tail and items count in the image header.
+ * 
+ * @note Private method, called once items are linked or unlinked. Only
+ *       the compiler is kept from moving the stores before the ones to
+ *       the items: a process crashing leaves its writes in the image.
+ * 
+ */
+
+void ringbuf::updateImage( void ) 
+{
+    if( pxImage != nullptr )
+    {
+        std::atomic_signal_fence( std::memory_order_release );
+
+        pxImage->ullHeadOff = ( std::uint64_t )( ( std::uint8_t* )pxHead - pcBuf );
+        pxImage->ullTailOff = ( std::uint64_t )( ( std::uint8_t* )pxTail - pcBuf );
+        pxImage->ullItemsCnt = xTotItemCnt;
+#if ( RINGBUF_CFG_ITEM_SEQUENCE == 1 )
+        pxImage->ullNextSeq = ullNextSeq.load( std::memory_order_relaxed );
+#endif
+    }
+}
+
+/**
+ * @brief Finds the items of the image left by a previous run.
+ * 
+ * @note Private method. Items are walked from the tail recorded in the
+ *       image header following their links, which are rewritten when
+ *       the pool is now mapped at another address. Every item shall start
+ *       where the previous one ends and link back to it, or to itself
+ *       when the run stopped while deleting the items before it: it is
+ *       then the new tail. The item linking forward to itself is the
+ *       head. So an item inserted or deleted at the time of the crash
+ *       is either kept whole or dropped.
+ * 
+ * @param[out] True when a consistent chain of items was found.
+ *
+ */
+
+bool ringbuf::recoverImage( void ) 
+{
+    bool isChainValid = false;
+    bool isWalking = true;
+
+    const std::size_t xMaxOff = xBufSize - sizeof( rbItem_t );
+    const std::size_t xMaxSteps = xBufSize / sizeof( rbItem_t );
+#if ( RINGBUF_CFG_COMPACT_HEADER == 0 )
+    const std::uintptr_t xBaseAddr = ( std::uintptr_t )pxImage->ullBaseAddr;
+#endif
+
+    std::size_t xTailOff = ( std::size_t )pxImage->ullTailOff;
+    std::size_t xItemOff = xTailOff;
+    std::size_t xPrevOff = xTailOff;
+    std::size_t xPrevEndOff = xTailOff;
+    std::size_t xItemsCnt = 0;
+    std::size_t xSteps = 0;
+
+    while( isWalking && ( xItemOff <= xMaxOff ) && ( xSteps < xMaxSteps ) )
+    {
+        rbItem_t xItem;
+
+        std::memcpy( &xItem, &pcBuf[ xItemOff ], sizeof( rbItem_t ) );
+
+#if ( RINGBUF_CFG_COMPACT_HEADER == 1 )
+        const std::size_t xNextOff = xItem.ulNext;
+        const std::size_t xPrevLinkOff = xItem.ulPrev;
+#else
+        const std::size_t xNextOff = ( std::size_t )( ( std::uintptr_t )xItem.pxNext - xBaseAddr );
+        const std::size_t xPrevLinkOff = ( std::size_t )( ( std::uintptr_t )xItem.pxPrev - xBaseAddr );
+#endif
+
+        const std::size_t xItemSize = getStoredSize( xItem.xItemSize );
+
+        /* Items follow each other, skipping the top of the pool when it
+           cannot hold the header (split) or the whole item (contiguous). */
+        const bool isAdjacent =    ( xItemOff == xPrevEndOff ) \
+                                || (    ( xItemOff == 0 ) \
+                                     && ( xPrevEndOff > xPrevOff ) \
+                                     && ( ( xBufSize - xPrevEndOff ) < ( ( eLayout == RB_LAYOUT_CONTIGUOUS ) ? ( sizeof( rbItem_t ) + xItemSize ) : sizeof( rbItem_t ) ) )    );
+
+        if( ( xSteps++ == 0 ) && ( ( xItemSize == 0 ) || ( pxImage->ullItemsCnt == 0 ) ) )
+        {
+            /* Empty buffer, drain() leaves the last items in place. */
+            isChainValid = true;
+            isWalking = false;
+        }
+        else if(    ( xItemSize == 0 ) \
+                 || ( xItemSize >= xMaxOff ) \
+                 || ( xNextOff > xMaxOff ) \
+                 || !isAdjacent \
+                 || ( ( eLayout == RB_LAYOUT_CONTIGUOUS ) && ( ( xItemOff + sizeof( rbItem_t ) + xItemSize ) > xBufSize ) ) \
+                 || ( ( xPrevLinkOff != xItemOff ) && ( ( xItemsCnt == 0 ) || ( xPrevLinkOff != xPrevOff ) ) )    )
+        {
+            /* Corrupted item. */
+            isWalking = false;
+        }
+        else
+        {
+            if( xPrevLinkOff == xItemOff )
+            {
+                /* Tail, previous items were being deleted. */
+                xTailOff = xItemOff;
+                xItemsCnt = 0;
+            }
+
+            /* Links valid at the current address of the pool. */
+            setNext( ( rbItem_t* )&pcBuf[ xItemOff ], ( const rbItem_t* )&pcBuf[ xNextOff ] );
+            setPrev( ( rbItem_t* )&pcBuf[ xItemOff ], ( const rbItem_t* )&pcBuf[ xPrevLinkOff ] );
+
+            ++xItemsCnt;
+
+            if( xNextOff == xItemOff )
+            {
+                /* Head reached. */
+                isChainValid = true;
+                isWalking = false;
+            }
+
+            xPrevOff = xItemOff;
+            xPrevEndOff = ( xItemOff + sizeof( rbItem_t ) + xItemSize ) % xBufSize;
+            xItemOff = xNextOff;
+        }
+    }
+
+    if( isChainValid )
+    {
+        pxImage->ullBaseAddr = ( std::uint64_t )( std::uintptr_t )pcBuf;
+
+#if ( RINGBUF_CFG_ITEM_SEQUENCE == 1 )
+        ullNextSeq.store( pxImage->ullNextSeq, std::memory_order_relaxed );
+#endif
+
+        if( xItemsCnt == 0 )
+        {
+            reset();
+        }
+        else
+        {
+            pxTail = ( rbItem_t* )&pcBuf[ xTailOff ];
+            pxHead = ( rbItem_t* )&pcBuf[ xItemOff ];
+            xTotItemCnt = xItemsCnt;
+
+#if ( RINGBUF_CFG_ITEM_SEQUENCE == 1 )
+            /* The head may be newer than the image header. */
+            if( ( pxHead->ullSeq != ullSeqInvalid ) && ( pxHead->ullSeq >= pxImage->ullNextSeq ) )
+            {
+                ullNextSeq.store( pxHead->ullSeq + 1, std::memory_order_relaxed );
+            }
+
+            publishTailSeq();
+#endif
+
+            updateImage();
+        }
+    }
+
+    return isChainValid;
+}
+
+/**
+ * @brief Checks whether an image header describes a memory pool this
+ *        ring buffer can use.
+ * 
+ * @note Private method.
+ * 
+ * @param[in] pcImage Pointer to the image.
+ * @param[in] xImageSize Size of the image.
+ * @param[out] True when the header is valid.
+ *
+ */
+
+bool ringbuf::isImageValid( const std::uint8_t* pcImage, 
+                            const std::size_t xImageSize ) 
+{
+    bool isValid = false;
+
+    if( xImageSize > sizeof( rbImage_t ) )
+    {
+        const rbImage_t* pxHeader = ( const rbImage_t* )pcImage;
+
+        isValid =    ( pxHeader->ulMagic == RB_IMAGE_MAGIC ) \
+                  && ( pxHeader->ulVersion == RB_IMAGE_VERSION ) \
+                  && ( pxHeader->ulHeaderSize == sizeof( rbImage_t ) ) \
+                  && ( pxHeader->ulItemHeaderSize == sizeof( rbItem_t ) ) \
+                  && ( pxHeader->ulFlags == ulImageFlags ) \
+                  && ( ( pxHeader->ulLayout == RB_LAYOUT_SPLIT ) || ( pxHeader->ulLayout == RB_LAYOUT_CONTIGUOUS ) ) \
+                  && ( pxHeader->ullPoolSize > sizeof( rbItem_t ) ) \
+                  && ( pxHeader->ullPoolSize <= getAddressableSize( xImageSize - sizeof( rbImage_t ) ) );
+    }
+
+    return isValid;
+}
+
+/**
+ * @brief Computes the size of the memory pool of an image.
+ * 
+ * @note Private method.
+ * 
+ * @param[in] pcImage Pointer to the image.
+ * @param[in] xImageSize Size of the image.
+ * @param[in] eOpen How the image is taken.
+ * @param[out] Size recorded in a valid image to recover, otherwise
+ *             all the image but its header (up to 4 GB with compact
+ *             headers); zero when the image cannot hold more than an
+ *             item header.
+ *
+ */
+
+std::size_t ringbuf::getImagePoolSize( const std::uint8_t* pcImage, 
+                                       const std::size_t xImageSize, 
+                                       const rbImageOpen_t eOpen ) 
+{
+    std::size_t xPoolSize = 0;
+
+    if( xImageSize > ( sizeof( rbImage_t ) + sizeof( rbItem_t ) ) )
+    {
+        xPoolSize = getAddressableSize( xImageSize - sizeof( rbImage_t ) );
+    }
+
+    if( ( eOpen == RB_IMAGE_RECOVER ) && isImageValid( pcImage, xImageSize ) )
+    {
+        xPoolSize = ( std::size_t )( ( const rbImage_t* )pcImage )->ullPoolSize;
+    }
+
+    return xPoolSize;
+}
+
+/**
+ * @brief Selects the layout of item data of an image.
+ * 
+ * @note Private method.
+ * 
+ * @param[in] pcImage Pointer to the image.
+ * @param[in] xImageSize Size of the image.
+ * @param[in] eOpen How the image is taken.
+ * @param[in] eItemLayout Layout requested for a new image.
+ * @param[out] Layout recorded in a valid image to recover, otherwise the
+ *             one requested, as long as it does not need a mirrored pool.
+ *
+ */
+
+rbLayout_t ringbuf::getImageLayout( const std::uint8_t* pcImage, 
+                                    const std::size_t xImageSize, 
+                                    const rbImageOpen_t eOpen, 
+                                    const rbLayout_t eItemLayout ) 
+{
+    rbLayout_t eImageLayout = ( eItemLayout == RB_LAYOUT_MIRRORED ) ? RB_LAYOUT_SPLIT : eItemLayout;
+
+    if( ( eOpen == RB_IMAGE_RECOVER ) && isImageValid( pcImage, xImageSize ) )
+    {
+        eImageLayout = ( rbLayout_t )( ( const rbImage_t* )pcImage )->ulLayout;
+    }
+
+    return eImageLayout;
+}
+
+/*--------------------- Public methods ---------------------*/
+
+/**
+ * @brief Ring buffer constructor.
+ *
+ * @note Built with RINGBUF_CFG_COMPACT_HEADER only the first 4 GB of a
+ *       larger memory pool are used, with RB_LAYOUT_SPLIT instead of
+ *       RB_LAYOUT_MIRRORED since the mirror no longer follows them.
+ *
+ * @param[in] pcPool Pointer to the memery pool used by this ringBuf instance.
+ * @param[in] ulPoolSize Size of the memory pool.
+ * @param[in] eItemLayout Layout of item data in the memory pool.
+ *
+ */
+
+ringbuf::ringbuf( std::uint8_t* pcPool, 
+                  const std::size_t xPoolSize,
+                  const rbLayout_t eItemLayout ) : 
+                  pcBuf( pcPool ), 
+                  xBufSize( getAddressableSize( xPoolSize ) ),
+                  eLayout( ( ( eItemLayout == RB_LAYOUT_MIRRORED ) && ( xBufSize < xPoolSize ) ) ? RB_LAYOUT_SPLIT : eItemLayout ),
+                  eOverflow( RB_OVERFLOW_OVERWRITE ),
+                  xStats(),
+                  pcReserved( nullptr ),
+                  xReservedSize( 0 )
+#if ( RINGBUF_CFG_ITEM_SEQUENCE == 1 )
+                , ullNextSeq( 0 ),
+                  ullTailSeq( 0 )
+#endif
+                , pxImage( nullptr ),
+                  isImageRecovered( false ),
+                  pulIndex( nullptr ),
+                  xIndexMask( 0 ),
+                  xIndexBase( 0 ),
+                  xIndexFloor( 0 )
+#if ( RINGBUF_CFG_ITEM_TIMESTAMP == 1 )
+                , pxClock( getMonotonicTime )
+#endif
+                , pulCodecHash( nullptr ),
+                  pcCodecOut( nullptr ),
+                  xCodecOutSize( 0 ),
+                  pxDeltaFields( nullptr ),
+                  xDeltaFieldsCnt( 0 ),
+                  xDeltaSampleSize( 0 ),
+                  xDeltaInterval( 0 ),
+                  xDeltaRun( 0 ),
+                  pxDeltaHead( nullptr ),
+                  pcDeltaPrev( nullptr ),
+                  pcDeltaWindow( nullptr ),
+                  pcDeltaOut( nullptr ),
+                  pcDeltaScanWindow( nullptr ),
+                  pxDeltaDecoded( nullptr )
+{ 
+    /* Reset buffer. */
+    std::memset( ( void* )pcBuf, 0, xBufSize );
+
+    reset();
+} 
+
+/**
+ * @brief Ring buffer constructor, with the memory pool in an image that
+ *        survives the process (e.g. a file mapped by mapImage()).
+ *
+ * @note The image header is kept up to date at every insertion and
+ *       deletion, so that the items can be recovered after a crash.
+ *       RB_LAYOUT_MIRRORED is not supported and replaced by RB_LAYOUT_SPLIT.
+ *       An image not larger than the rbImage_t and rbItem_t headers is
+ *       left untouched: the ring buffer stays empty and every insertion fails.
+ *
+ * @param[in] pcImage Pointer to the image, aligned as rbImage_t.
+ * @param[in] xImageSize Size of the image, the memory pool takes all
+ *            of it but the rbImage_t header, up to 4 GB with
+ *            RINGBUF_CFG_COMPACT_HEADER.
+ * @param[in] eOpen RB_IMAGE_CREATE to start empty, RB_IMAGE_RECOVER to
+ *            keep the items found in the image (see isRecovered()).
+ * @param[in] eItemLayout Layout of item data of a new image; a recovered
+ *            image keeps its own.
+ *
+ */
+
+ringbuf::ringbuf( std::uint8_t* pcImage, 
+                  const std::size_t xImageSize,
+                  const rbImageOpen_t eOpen,
+                  const rbLayout_t eItemLayout ) : 
+                  pcBuf( pcImage + sizeof( rbImage_t ) ), 
+                  xBufSize( getImagePoolSize( pcImage, xImageSize, eOpen ) ),
+                  eLayout( getImageLayout( pcImage, xImageSize, eOpen, eItemLayout ) ),
+                  eOverflow( RB_OVERFLOW_OVERWRITE ),
+                  xStats(),
+                  pcReserved( nullptr ),
+                  xReservedSize( 0 )
+#if ( RINGBUF_CFG_ITEM_SEQUENCE == 1 )
+                , ullNextSeq( 0 ),
+                  ullTailSeq( 0 )
+#endif
+                , pxImage( ( rbImage_t* )pcImage ),
+                  isImageRecovered( false ),
+                  pulIndex( nullptr ),
+                  xIndexMask( 0 ),
+                  xIndexBase( 0 ),
+                  xIndexFloor( 0 )
+#if ( RINGBUF_CFG_ITEM_TIMESTAMP == 1 )
+                , pxClock( getMonotonicTime )
+#endif
+                , pulCodecHash( nullptr ),
+                  pcCodecOut( nullptr ),
+                  xCodecOutSize( 0 ),
+                  pxDeltaFields( nullptr ),
+                  xDeltaFieldsCnt( 0 ),
+                  xDeltaSampleSize( 0 ),
+                  xDeltaInterval( 0 ),
+                  xDeltaRun( 0 ),
+                  pxDeltaHead( nullptr ),
+                  pcDeltaPrev( nullptr ),
+                  pcDeltaWindow( nullptr ),
+                  pcDeltaOut( nullptr ),
+                  pcDeltaScanWindow( nullptr ),
+                  pxDeltaDecoded( nullptr )
+{ 
+    if( xBufSize == 0 )
+    {
+        /* Image too small, not written. */
+        pxImage = nullptr;
+
+        empty();
+    }
+    else if( ( eOpen == RB_IMAGE_RECOVER ) && isImageValid( pcImage, xImageSize ) )
+    {
+        isImageRecovered = recoverImage();
+    }
+
+    if( !isImageRecovered && ( pxImage != nullptr ) )
+    {
+        /* Reset image. */
+        std::memset( ( void* )pcImage, 0, sizeof( rbImage_t ) + xBufSize );
+
+        pxImage->ulVersion = RB_IMAGE_VERSION;
+        pxImage->ulHeaderSize = ( std::uint32_t )sizeof( rbImage_t );
+        pxImage->ulItemHeaderSize = ( std::uint32_t )sizeof( rbItem_t );
+        pxImage->ulFlags = ulImageFlags;
+        pxImage->ulLayout = ( std::uint32_t )eLayout;
+        pxImage->ullPoolSize = xBufSize;
+        pxImage->ullBaseAddr = ( std::uint64_t )( std::uintptr_t )pcBuf;
+
+        reset();
+
+        /* Mark the image as valid last. */
+        std::atomic_signal_fence( std::memory_order_release );
+        pxImage->ulMagic = RB_IMAGE_MAGIC;
+    }
+} 
+
+/**
+ * @brief Discards all data in the ring buffer.
+ *
+ */
+
+void ringbuf::flush( void )
+{
+    reset();
+}
+
+ /**
+ * @brief Inserts a new item in the ring buffer.
+ *
+ * @note With setCompression() the item is stored compressed
+ *       when this makes it smaller.
+ *
+ * @param[in] pxItem Pointer to the item to insert.
+ * @param[in] xItemSize Size of the item to insert.
+ * @param[out] True when item successfully insertion.
+ *
+ */
+
+bool ringbuf::push( const void* pxItem, 
+                    const std::size_t xItemSize ) 
+{
+    bool isItemPushed = false;
+    bool isCompressed = false;
+
+    const void* pxData = pxItem;
+    std::size_t xDataSize = xItemSize;
+
+    if(    ( pcCodecOut != nullptr ) \
+        && ( xItemSize >= xCodecMinSize ) \
+        && ( xItemSize <= xCodecOutSize )    )
+    {
+        /* Raw data is stored when compression saves nothing. */
+        const std::size_t xCompressedSize = compressItem( ( const std::uint8_t* )pxItem, xItemSize, pcCodecOut, xItemSize - 1, pulCodecHash );
+
+        if( xCompressedSize > 0 )
+        {
+            pxData = pcCodecOut;
+            xDataSize = xCompressedSize;
+            isCompressed = true;
+        }
+    }
+
+    if(    ( xDataSize > 0 ) \
+        && ( ( xDataSize + sizeof( rbItem_t ) ) < xBufSize ) \
+        && ( xDataSize < RB_ITEM_FLAG_DELTA ) \
+        && ( pcReserved == nullptr )    )
+
+    {        
+        std::uint8_t* pHeader = getFreePtr( xDataSize );
+
+        if( pHeader != nullptr )
+        {
+            pushItem( pHeader, pxData, xDataSize, isCompressed ? RB_ITEM_FLAG_COMPRESSED : 0 );
+
+            isItemPushed = true;
+        }
+    }
+
+    return isItemPushed;
+}
+
+/**
+ * @brief Inserts several new items in the ring buffer at once.
+ *
+ * @note Space is checked, and old items deleted, once for the whole
+ *       batch; items are then laid out in one pass and become visible
+ *       with a single head update. Either all items are inserted or none.
+ *       Space possibly skipped at the end of the pool is reserved up
+ *       front, so one old item more than with push() may be deleted.
+ *       A batch larger than the pool is counted in getStats() as rejected.
+ *
+ * @param[in] pxItems Array of spans pointing to the items to insert, in order.
+ * @param[in] xItemsCnt Number of items to insert.
+ * @param[out] True when all items successfully inserted.
+ *
+ */
+
+bool ringbuf::pushBatch( const rbConstSpan_t* pxItems, 
+                         const std::size_t xItemsCnt ) 
+{
+    bool isBatchPushed = false;
+    bool isBatchValid = ( xItemsCnt > 0 ) && ( pcReserved == nullptr );
+
+    std::size_t xTotSize = 0;
+    std::size_t xWasteSize = 0;
+
+    /* Space needed by the whole batch. */
+    for( std::size_t i = 0; ( i < xItemsCnt ) && isBatchValid; ++i )
+    {
+        const std::size_t xItemSpace = sizeof( rbItem_t ) + pxItems[ i ].xSize;
+
+        isBatchValid =    ( pxItems[ i ].xSize > 0 ) \
+                       && ( ( pxItems[ i ].xSize + sizeof( rbItem_t ) ) < xBufSize ) \
+                       && ( pxItems[ i ].xSize < RB_ITEM_FLAG_DELTA );
+
+        xTotSize += xItemSpace;
+
+        /* Space possibly skipped at the end of the pool. */
+        if( ( eLayout == RB_LAYOUT_CONTIGUOUS ) && ( xItemSpace > xWasteSize ) )
+        {
+            xWasteSize = xItemSpace;
+        }
+    }
+
+    if( eLayout == RB_LAYOUT_SPLIT )
+    {
+        xWasteSize = sizeof( rbItem_t );
+    }
+
+    if(    isBatchValid \
+        && (    ( xTotSize > xBufSize ) \
+             || (    ( eOverflow == RB_OVERFLOW_REJECT ) \
+                  && ( xTotItemCnt > 0 ) \
+                  && ( getFreeSpace() < ( xTotSize + xWasteSize ) ) ) )    )
+    {
+        /* Batch larger than the pool, or old items shall not be removed. */
+        isBatchValid = false;
+
+        xStats.xRejectedItems += xItemsCnt;
+        xStats.xRejectedBytes += xTotSize - ( xItemsCnt * sizeof( rbItem_t ) );
+    }
+
+    if( isBatchValid )
+    {
+        /* Remove old items if space is not enough, an empty buffer always fits the batch. */
+        while( ( xTotItemCnt > 0 ) && ( getFreeSpace() < ( xTotSize + xWasteSize ) ) )
+        {
+            evictTail();
+        }
+
+        std::uint8_t* ptrNext = ( xTotItemCnt == 0 ) ? pcBuf : getHeadEnd();
+        rbItem_t* pxPrevItem = pxHead;
+
+#if ( RINGBUF_CFG_ITEM_TIMESTAMP == 1 )
+        /* The whole batch is inserted at the same time. */
+        const std::uint64_t ullBatchTime = pxClock();
+#endif
+
+        for( std::size_t i = 0; i < xItemsCnt; ++i )
+        {
+            const std::size_t topFreeSpace = ( std::size_t )( &pcBuf[ xBufSize - 1 ] - ptrNext ) + 1;
+            std::uint8_t* pHeader = ptrNext;
+            rbItem_t xNewItem;
+            rbSpan_t axSpans[ 2 ];
+
+            /* Same placement as getNextPtr(), space is already granted. */
+            if(    ( ( eLayout == RB_LAYOUT_SPLIT ) && ( topFreeSpace < sizeof( rbItem_t ) ) ) \
+                || ( ( eLayout == RB_LAYOUT_CONTIGUOUS ) && ( topFreeSpace < ( sizeof( rbItem_t ) + pxItems[ i ].xSize ) ) )    )
+            {
+                pHeader = pcBuf;
+            }
+
+            getSpans( pHeader, pxItems[ i ].xSize, axSpans );
+
+            std::memcpy( axSpans[ 0 ].pcData, pxItems[ i ].pcData, axSpans[ 0 ].xSize );
+            std::memcpy( axSpans[ 1 ].pcData, pxItems[ i ].pcData + axSpans[ 0 ].xSize, axSpans[ 1 ].xSize );
+
+            /* Copy item header. */
+            setNext( &xNewItem, ( const rbItem_t* )pHeader );
+            setPrev( &xNewItem, pxPrevItem );
+            xNewItem.xItemSize = ( rbSize_t )pxItems[ i ].xSize;
+#if ( RINGBUF_CFG_ITEM_SEQUENCE == 1 )
+            xNewItem.ullSeq = ullNextSeq.load( std::memory_order_relaxed ) + i;
+#endif
+#if ( RINGBUF_CFG_ITEM_TIMESTAMP == 1 )
+            xNewItem.ullTime = ullBatchTime;
+#endif
+
+            std::memcpy( ( void* )pHeader, &xNewItem, sizeof( rbItem_t ) );
+
+            setNext( pxPrevItem, ( const rbItem_t* )pHeader );
+
+            indexItem( pHeader, xTotItemCnt + i );
+
+            pxPrevItem = ( rbItem_t* )pHeader;
+
+            /* Position of next item. */
+            ptrNext = pHeader + sizeof( rbItem_t ) + pxItems[ i ].xSize;
+
+            if( ptrNext > &pcBuf[ xBufSize - 1 ] )
+            {
+                ptrNext -= xBufSize;
+            }
+        }
+
+        /* Update Head once. */
+        pxHead = pxPrevItem;
+        pxDeltaHead = nullptr;
+        xTotItemCnt += xItemsCnt;
+
+#if ( RINGBUF_CFG_ITEM_SEQUENCE == 1 )
+        ullNextSeq.store( ullNextSeq.load( std::memory_order_relaxed ) + xItemsCnt, std::memory_order_release );
+#endif
+
+        updateImage();
+
+        isBatchPushed = true;
+    }
+
+    return isBatchPushed;
+}
+
+/**
+ * @brief Inserts a sample of the layout set by setDelta(), stored as
+ *        the delta from the previous sample when possible.
+ *
+ * @note A keyframe, the sample stored raw, is inserted every key
+ *       interval, when the delta would not be smaller, and whenever the
+ *       head is not the previous sample, e.g. after push() or
+ *       deleteHead(). getData() and getSamples() decode the samples,
+ *       peek(), drain() and consume() hand out the data as stored.
+ *
+ * @param[in] pxSample Pointer to the sample to insert.
+ * @param[out] True when the sample is successfully inserted.
+ *
+ */
+
+bool ringbuf::pushDelta( const void* pxSample ) 
+{
+    bool isItemPushed = false;
+
+    if(    ( pxDeltaFields != nullptr ) \
+        && ( ( xDeltaSampleSize + sizeof( rbItem_t ) ) < xBufSize ) \
+        && ( pcReserved == nullptr )    )
+    {
+        bool isKeyframe = ( pxDeltaHead == nullptr ) || ( pxDeltaHead != pxHead ) || ( xDeltaRun >= xDeltaInterval );
+        std::uint8_t acWindow[ RB_DELTA_FIELD_WINDOW_SIZE * RB_DELTA_FIELDS_MAX ];
+        std::size_t xDataSize = xDeltaSampleSize;
+
+        if( !isKeyframe )
+        {
+            /* The windows are kept only once the delta is inserted. */
+            std::memcpy( acWindow, pcDeltaWindow, 2 * xDeltaFieldsCnt );
+
+            xDataSize = encodeDelta( ( const std::uint8_t* )pxSample, pcDeltaPrev, pxDeltaFields, xDeltaFieldsCnt, acWindow, pcDeltaOut );
+
+            /* A sample far from the previous one is stored raw. */
+            isKeyframe = ( xDataSize >= xDeltaSampleSize );
+            xDataSize = isKeyframe ? xDeltaSampleSize : xDataSize;
+        }
+
+        std::uint8_t* pHeader = getFreePtr( xDataSize );
+
+        if( !isKeyframe && ( pHeader != nullptr ) && ( pxDeltaHead == nullptr ) )
+        {
+            /* All old items were deleted, the previous sample too. */
+            isKeyframe = true;
+            xDataSize = xDeltaSampleSize;
+
+            pHeader = getFreePtr( xDataSize );
+        }
+
+        if( pHeader != nullptr )
+        {
+            if( isKeyframe )
+            {
+                pushItem( pHeader, pxSample, xDataSize, 0 );
+
+                std::memset( pcDeltaWindow, cWindowNone, 2 * xDeltaFieldsCnt );
+                xDeltaRun = 1;
+            }
+            else
+            {
+                pushItem( pHeader, pcDeltaOut, xDataSize, RB_ITEM_FLAG_DELTA );
+
+                std::memcpy( pcDeltaWindow, acWindow, 2 * xDeltaFieldsCnt );
+                ++xDeltaRun;
+            }
+
+            std::memcpy( pcDeltaPrev, pxSample, xDeltaSampleSize );
+
+            pxDeltaHead = pxHead;
+            pxDeltaDecoded = nullptr;
+
+            isItemPushed = true;
+        }
+    }
+
+    return isItemPushed;
+}
+
+/**
+ * @brief Reserves space for a new item, so that its data can be
+ *        written in place instead of being copied by push().
+ *
+ * @note Old items are deleted if space is not enough and the overflow
+ *       policy allows it, even if the reservation is aborted later. Until commit() or abort() the
+ *       ring buffer shall not be modified and push() fails.
+ *
+ * @param[in] xItemSize Size of the item to reserve.
+ * @param[in] pxSpans Array of two spans filled with the writable parts
+ *            of the item data; the second part has size zero unless
+ *            data rolls over the end of the memory pool.
+ * @param[out] True when space successfully reserved.
+ *
+ */
+
+bool ringbuf::reserve( const std::size_t xItemSize, 
+                       rbSpan_t* pxSpans ) 
+{
+    bool isItemReserved = false;
+
+    if(    ( xItemSize > 0 ) \
+        && ( ( xItemSize + sizeof( rbItem_t ) ) < xBufSize ) \
+        && ( xItemSize < RB_ITEM_FLAG_DELTA ) \
+        && ( pcReserved == nullptr )    )
+    {
+        pcReserved = getFreePtr( xItemSize );
+        xReservedSize = xItemSize;
+
+        if( pcReserved != nullptr )
+        {
+            getSpans( pcReserved, xItemSize, pxSpans );
+
+            isItemReserved = true;
+        }
+    }
+
+    return isItemReserved;
+}
+
+/**
+ * @brief Inserts the reserved item in the ring buffer as new head.
+ *
+ * @param[out] True when an item was reserved and is now inserted.
+ *
+ */
+
+bool ringbuf::commit( void ) 
+{
+    bool isItemCommitted = false;
+
+    if( pcReserved != nullptr )
+    {
+        linkItem( pcReserved, xReservedSize, 0 );
+
+        pcReserved = nullptr;
+
+        isItemCommitted = true;
+    }
+
+    return isItemCommitted;
+}
+
+/**
+ * @brief Discards the reserved item.
+ *
+ */
+
+void ringbuf::abort( void ) 
+{
+    pcReserved = nullptr;
+}
+
+/**
+ * @brief Selects what push() does when there is not enough space.
+ *
+ * @note RB_OVERFLOW_BLOCK needs a concurrent consumer and is not
+ *       supported by this class.
+ *
+ * @param[in] eOverflowPolicy RB_OVERFLOW_OVERWRITE (default) to delete
+ *            the oldest items, RB_OVERFLOW_REJECT to fail the insertion.
+ * @param[out] True when the policy is supported.
+ *
+ */
+
+bool ringbuf::setOverflowPolicy( const rbOverflow_t eOverflowPolicy ) 
+{
+    bool isPolicySet = false;
+
+    if( eOverflowPolicy != RB_OVERFLOW_BLOCK )
+    {
+        eOverflow = eOverflowPolicy;
+
+        isPolicySet = true;
+    }
+
+    return isPolicySet;
+}
+
+/**
+ * @brief Gets the number of items and bytes lost because of lack of space.
+ *
+ * @param[out] Counters since the ring buffer was created.
+ *
+ */
+
+rbStats_t ringbuf::getStats( void ) 
+{
+    return xStats;
+}
+
+/**
+ * @brief Stores the items inserted by push() compressed, when this makes
+ *        them smaller, with a fast LZ77 coder (LZ4 sequences).
+ *
+ * @note Text-like records shrink 2-4 times when large enough to repeat
+ *       themselves, e.g. a few log lines; random data stays raw. Items of
+ *       pushBatch() and reserve() are stored raw. getData() decompresses,
+ *       peek(), drain() and consume() hand out the data as stored.
+ *
+ * @param[in] pcCodecBuf Buffer of RB_CODEC_BUF_SIZE( largest item to
+ *            compress ) bytes, owned by the ring buffer until replaced;
+ *            nullptr to store new items raw.
+ * @param[in] xCodecBufSize Size [byte] of the buffer.
+ * @param[out] True when set, false when the buffer is too small.
+ *
+ */
+
+bool ringbuf::setCompression( std::uint8_t* pcCodecBuf, 
+                              const std::size_t xCodecBufSize )
+{
+    bool isCodecSet = false;
+
+    /* The hash table is aligned to its entries. */
+    const std::size_t xAlignPad = ( alignof( std::uint32_t ) - ( ( std::uintptr_t )pcCodecBuf % alignof( std::uint32_t ) ) ) % alignof( std::uint32_t );
+    const std::size_t xHashSize = RB_CODEC_HASH_CNT * sizeof( std::uint32_t );
+
+    if( pcCodecBuf == nullptr )
+    {
+        pulCodecHash = nullptr;
+        pcCodecOut = nullptr;
+        xCodecOutSize = 0;
+
+        isCodecSet = true;
+    }
+    else if( xCodecBufSize >= ( xAlignPad + xHashSize + xCodecMinSize ) )
+    {
+        pulCodecHash = ( std::uint32_t* )( pcCodecBuf + xAlignPad );
+        pcCodecOut = pcCodecBuf + xAlignPad + xHashSize;
+        xCodecOutSize = xCodecBufSize - xAlignPad - xHashSize;
+
+        isCodecSet = true;
+    }
+
+    return isCodecSet;
+}
+
+/**
+ * @brief Sets the layout of the samples inserted by pushDelta(), each
+ *        one stored as the delta from the previous one.
+ *
+ * @note A sample is made of the fields back to back, without padding.
+ *       The next sample inserted is a keyframe. Deltas inserted with
+ *       another layout are not decoded correctly.
+ *
+ * @param[in] pxFields Array of the types of the fields, in order, owned
+ *            by the ring buffer until replaced; nullptr to stop.
+ * @param[in] xFieldsCnt Number of fields, up to RB_DELTA_FIELDS_MAX.
+ * @param[in] xKeyInterval Samples from a keyframe, stored raw, to the
+ *            next one; reading a sample decodes up to as many items.
+ * @param[in] pcDeltaBuf Buffer of RB_DELTA_BUF_SIZE( xFieldsCnt ) bytes,
+ *            owned by the ring buffer until replaced.
+ * @param[in] xDeltaBufSize Size [byte] of the buffer.
+ * @param[out] True when set, false when a parameter is not valid.
+ *
+ */
+
+bool ringbuf::setDelta( const rbField_t* pxFields, 
+                        const std::size_t xFieldsCnt, 
+                        const std::size_t xKeyInterval, 
+                        std::uint8_t* pcDeltaBuf, 
+                        const std::size_t xDeltaBufSize )
+{
+    bool isDeltaSet = false;
+    bool isLayoutValid =    ( xFieldsCnt > 0 ) \
+                         && ( xFieldsCnt <= RB_DELTA_FIELDS_MAX ) \
+                         && ( xKeyInterval > 0 ) \
+                         && ( pcDeltaBuf != nullptr );
+
+    std::size_t xSampleSize = 0;
+
+    for( std::size_t i = 0; ( pxFields != nullptr ) && ( i < xFieldsCnt ) && isLayoutValid; ++i )
+    {
+        isLayoutValid = ( pxFields[ i ] >= RB_FIELD_INT8 ) && ( pxFields[ i ] <= RB_FIELD_DOUBLE );
+
+        xSampleSize += isLayoutValid ? acFieldSize[ pxFields[ i ] ] : 0;
+    }
+
+    if( pxFields == nullptr )
+    {
+        pxDeltaFields = nullptr;
+        xDeltaFieldsCnt = 0;
+        xDeltaSampleSize = 0;
+
+        isDeltaSet = true;
+    }
+    else if(    isLayoutValid \
+             && ( xDeltaBufSize >= ( xSampleSize + ( ( ( 2U * RB_DELTA_FIELD_WINDOW_SIZE ) + RB_DELTA_FIELD_DELTA_MAX ) * xFieldsCnt ) ) )    )
+    {
+        /* Previous sample, XOR windows of the encoder, encoder output, XOR windows of scan(). */
+        pxDeltaFields = pxFields;
+        xDeltaFieldsCnt = xFieldsCnt;
+        xDeltaSampleSize = xSampleSize;
+        xDeltaInterval = xKeyInterval;
+        pcDeltaPrev = pcDeltaBuf;
+        pcDeltaWindow = pcDeltaPrev + xSampleSize;
+        pcDeltaOut = pcDeltaWindow + ( RB_DELTA_FIELD_WINDOW_SIZE * xFieldsCnt );
+        pcDeltaScanWindow = pcDeltaOut + ( RB_DELTA_FIELD_DELTA_MAX * xFieldsCnt );
+
+        isDeltaSet = true;
+    }
+
+    if( isDeltaSet )
+    {
+        pxDeltaHead = nullptr;
+        pxDeltaDecoded = nullptr;
+    }
+
+    return isDeltaSet;
+}
+
+/**
+ * @brief Checks whether the ring buffer is empty.
+ *
+ * @param[out] True when empty.
+ *
+ */
+
+bool ringbuf::isEmpty( void ) 
+{
+    return ( xTotItemCnt == 0 );
+}
+
+/**
+ * @brief Deletes the head (most recent item) of the ring buffer.
+ *
+ * @param[out] True when the head is successfully deleted.
+ *
+ */
+
+bool ringbuf::deleteHead( void ) 
+{
+    bool isHeadDeleted = false;
+
+    if( xTotItemCnt > 0 )
+    {
+#if ( RINGBUF_CFG_ITEM_SEQUENCE == 1 )
+        /* The space of the head is reused by the next insertion. */
+        pxHead->ullSeq = ullSeqInvalid;
+        std::atomic_thread_fence( std::memory_order_release );
+#endif
+
+        pxHead = ( rbItem_t* )getPrev( pxHead );
+        setNext( pxHead, pxHead );
+        pxDeltaHead = nullptr;
+
+        if( --xTotItemCnt == 0 )
+        {
+            reset();
+        }
+        else
+        {
+            updateImage();
+        }
+
+        isHeadDeleted = true;
+    }
+
+    return isHeadDeleted;
+}
+
+/**
+ * @brief Deletes the tail (oldest item) of the ring buffer.
+ *
+ * @param[out] True when the tail is successfully deleted.
+ *
+ */
+
+bool ringbuf::deleteTail( void )
+{
+    bool isTailDeleted = false;
+
+    if( xTotItemCnt > 0 )
+    {
+        pxTail = ( rbItem_t* )getNext( pxTail );
+        setPrev( pxTail, pxTail );
+
+        ++xIndexBase;
+
+        if( --xTotItemCnt == 0 )
+        {
+            reset();
+        }
+        else
+        {
+#if ( RINGBUF_CFG_ITEM_SEQUENCE == 1 )
+            publishTailSeq();
+#endif
+            updateImage();
+        }
+        
+        isTailDeleted = true;
+    }
+
+    return isTailDeleted;
+}
+
+/**
+ * @brief Copies data of the specified item into the destination buffer.
+ *
+ * @note Compressed data is decompressed, a delta of pushDelta() decoded
+ *       from its keyframe.
+ *
+ * @param[in] pxItem Pointer to the item to retrieve.
+ * @param[in] pcDstBuf Destination buffer where data is copied,
+ *            at least getDataSize() [byte].
+ * @param[out] True when data successfully copied.
+ *
+ */
+
+bool ringbuf::getData( const rbItem_t* pxItem, 
+                       std::uint8_t* pcDstBuf )
+{
+    bool isDataCopied = false;
+
+    rbConstSpan_t axSpans[ 2 ];
+
+    if( peek( pxItem, axSpans ) )
+    { 
+        if( isCompressed( pxItem ) )
+        {
+            std::size_t xDataSize = 0;
+
+            isDataCopied = decompressItem( axSpans, pcDstBuf, SIZE_MAX, &xDataSize );
+        }
+        else if( isDelta( pxItem ) )
+        {
+            std::uint8_t acWindow[ RB_DELTA_FIELD_WINDOW_SIZE * RB_DELTA_FIELDS_MAX ];
+
+            isDataCopied = decodeSample( pxItem, pcDstBuf, acWindow );
+        }
+        else
+        {
+            std::memcpy( pcDstBuf, axSpans[ 0 ].pcData, axSpans[ 0 ].xSize );
+            std::memcpy( ( pcDstBuf + axSpans[ 0 ].xSize ), axSpans[ 1 ].pcData, axSpans[ 1 ].xSize );
+
+            isDataCopied = true;
+        }
+    }
+
+    return isDataCopied;
+}
+
+/**
+ * @brief Gets the size of the data getData() copies from an item.
+ *
+ * @param[in] pxItem Pointer to the item.
+ * @param[out] Size [byte] of the item data, once decompressed or decoded.
+ *
+ */
+
+const std::size_t ringbuf::getDataSize( const rbItem_t* pxItem )
+{
+    std::size_t xDataSize = 0;
+
+    if( ( pxItem != nullptr ) && ( xTotItemCnt > 0 ) )
+    {
+        xDataSize = getStoredSize( pxItem->xItemSize );
+
+        rbConstSpan_t axSpans[ 2 ];
+        std::uint32_t ulDataSize = 0;
+
+        if(    isCompressed( pxItem ) \
+            && peek( pxItem, axSpans ) \
+            && readSpans( axSpans, 0, ( std::uint8_t* )&ulDataSize, sizeof( ulDataSize ) )    )
+        {
+            xDataSize = ulDataSize;
+        }
+        else if( isDelta( pxItem ) )
+        {
+            xDataSize = xDeltaSampleSize;
+        }
+    }
+
+    return xDataSize;
+}
+
+/**
+ * @brief Tells whether an item is stored compressed.
+ *
+ * @note peek(), drain() and consume() hand out the data as stored.
+ *
+ * @param[in] pxItem Pointer to the item.
+ * @param[out] True when the item data is compressed.
+ *
+ */
+
+bool ringbuf::isCompressed( const rbItem_t* pxItem )
+{
+    return ( pxItem != nullptr ) && ( xTotItemCnt > 0 ) && ( ( pxItem->xItemSize & RB_ITEM_FLAG_COMPRESSED ) != 0 );
+}
+
+/**
+ * @brief Tells whether an item is stored as a delta by pushDelta().
+ *
+ * @param[in] pxItem Pointer to the item.
+ * @param[out] True when the item data is a delta.
+ *
+ */
+
+bool ringbuf::isDelta( const rbItem_t* pxItem )
+{
+    return ( pxItem != nullptr ) && ( xTotItemCnt > 0 ) && ( ( pxItem->xItemSize & RB_ITEM_FLAG_DELTA ) != 0 );
+}
+
+/**
+ * @brief Copies the samples of consecutive items, decoding each delta
+ *        from the sample before it.
+ *
+ * @note Only the first item, when a delta, is decoded from its keyframe.
+ *       Stops at the head or at an item that is not a sample of setDelta(),
+ *       e.g. a delta whose keyframe was deleted.
+ *
+ * @param[in] pxFirst Pointer to the first item, e.g. of rangeByTime().
+ * @param[in] xItemsCnt Maximum number of items to copy.
+ * @param[in] pcDstBuf Destination of the samples, back to back.
+ * @param[out] Number of samples copied.
+ *
+ */
+
+std::size_t ringbuf::getSamples( const rbItem_t* pxFirst, 
+                                 const std::size_t xItemsCnt, 
+                                 std::uint8_t* pcDstBuf )
+{
+    std::size_t xSamplesCnt = 0;
+    bool isDecoding = ( pxFirst != nullptr ) && ( xTotItemCnt > 0 );
+
+    const rbItem_t* pxItem = pxFirst;
+    std::uint8_t acWindow[ RB_DELTA_FIELD_WINDOW_SIZE * RB_DELTA_FIELDS_MAX ];
+    rbConstSpan_t axSpans[ 2 ];
+
+    while( isDecoding && ( xSamplesCnt < xItemsCnt ) )
+    {
+        std::uint8_t* pcSample = pcDstBuf + ( xSamplesCnt * xDeltaSampleSize );
+
+        if( isSample( pxItem ) && peek( pxItem, axSpans ) )
+        {
+            std::memcpy( pcSample, axSpans[ 0 ].pcData, axSpans[ 0 ].xSize );
+            std::memcpy( ( pcSample + axSpans[ 0 ].xSize ), axSpans[ 1 ].pcData, axSpans[ 1 ].xSize );
+            std::memset( acWindow, cWindowNone, 2 * xDeltaFieldsCnt );
+        }
+        else if( ( xSamplesCnt > 0 ) && isDelta( pxItem ) && peek( pxItem, axSpans ) )
+        {
+            std::memcpy( pcSample, pcSample - xDeltaSampleSize, xDeltaSampleSize );
+
+            isDecoding = decodeDelta( axSpans, pxDeltaFields, xDeltaFieldsCnt, pcSample, acWindow );
+        }
+        else
+        {
+            isDecoding = ( xSamplesCnt == 0 ) && decodeSample( pxItem, pcSample, acWindow );
+        }
+
+        if( isDecoding )
+        {
+            ++xSamplesCnt;
+
+            /* The head is followed by itself. */
+            isDecoding = ( pxItem != pxHead );
+            pxItem = getNext( pxItem );
+        }
+    }
+
+    return xSamplesCnt;
+}
+
+/**
+ * @brief Gets the parts of the memory pool holding data of the specified item,
+ *        so that it can be accessed in place instead of being copied.
+ *
+ * @note Spans stay valid until the item is deleted or overwritten.
+ *
+ * @param[in] pxItem Pointer to the item to access.
+ * @param[in] pxSpans Array of two spans filled with the read-only parts of
+ *            the item data; the second part has size zero unless data rolls
+ *            over the end of the memory pool.
+ * @param[out] True when the item holds data.
+ *
+ */
+
+bool ringbuf::peek( const rbItem_t* pxItem, 
+                    rbConstSpan_t* pxSpans )
+{
+    bool isDataPeeked = false;
+
+    if( ( pxItem != nullptr ) && ( xTotItemCnt > 0 ) && ( pxItem->xItemSize > 0 ) )
+    { 
+        rbSpan_t axSpans[ 2 ];
+
+        getSpans( pxItem, getStoredSize( pxItem->xItemSize ), axSpans );
+
+        pxSpans[ 0 ].pcData = axSpans[ 0 ].pcData;
+        pxSpans[ 0 ].xSize  = axSpans[ 0 ].xSize;
+        pxSpans[ 1 ].pcData = axSpans[ 1 ].pcData;
+        pxSpans[ 1 ].xSize  = axSpans[ 1 ].xSize;
+
+        isDataPeeked = true;
+    }
+
+    return isDataPeeked;
+}
+
+/**
+ * @brief Releases the tail (oldest item) of the ring buffer
+ *        once its data, accessed by peek(), is not needed anymore.
+ *
+ * @param[out] True when the tail is successfully released.
+ *
+ */
+
+bool ringbuf::consume( void )
+{
+    return deleteTail();
+}
+
+/**
+ * @brief Hands the data of the oldest items to a callback and then removes
+ *        all of them with a single tail update.
+ *
+ * @note Data of the removed items stays readable until the next insertion,
+ *       so the callback may just collect spans (e.g. into an iovec).
+ *
+ * @param[in] pxCallback Function called for each item, from the tail on.
+ * @param[in] pvContext User context passed to the callback.
+ * @param[in] xMaxItems Maximum number of items to remove.
+ * @param[in] xMaxBytes Maximum amount of data [byte] to remove; the item
+ *            that would exceed it is not handed out.
+ * @param[out] Number of items removed.
+ *
+ */
+
+std::size_t ringbuf::drain( rbDrainCallback_t pxCallback, 
+                            void* pvContext, 
+                            const std::size_t xMaxItems, 
+                            const std::size_t xMaxBytes )
+{
+    std::size_t xDrainedCnt = 0;
+    std::size_t xDrainedSize = 0;
+    bool isDraining = true;
+
+    const rbItem_t* pxItem = pxTail;
+    rbConstSpan_t axSpans[ 2 ];
+
+    while( isDraining && ( xDrainedCnt < xTotItemCnt ) && ( xDrainedCnt < xMaxItems ) )
+    {
+        isDraining =    ( ( xDrainedSize + getStoredSize( pxItem->xItemSize ) ) <= xMaxBytes ) \
+                     && peek( pxItem, axSpans ) \
+                     && pxCallback( axSpans, pvContext );
+
+        if( isDraining )
+        {
+            ++xDrainedCnt;
+            xDrainedSize += getStoredSize( pxItem->xItemSize );
+
+            pxItem = getNext( pxItem );
+        }
+    }
+
+    /* Remove all drained items at once. */
+    if( xDrainedCnt > 0 )
+    {
+        if( xDrainedCnt == xTotItemCnt )
+        {
+            /* The spans handed out stay valid. */
+            empty();
+        }
+        else
+        {
+            pxTail = ( rbItem_t* )pxItem;
+            setPrev( pxTail, pxTail );
+
+            xTotItemCnt -= xDrainedCnt;
+            xIndexBase += xDrainedCnt;
+
+#if ( RINGBUF_CFG_ITEM_SEQUENCE == 1 )
+            publishTailSeq();
+#endif
+
+            updateImage();
+        }
+    }
+
+    return xDrainedCnt;
+}
+
+/**
+ * @brief Looks for a byte pattern in the data of each item, from the tail on,
+ *        in place and without copying it.
+ *
+ * @note Occurrences across the end of the memory pool, where item data is
+ *       split in two parts, are found too. Blocks of data are searched with
+ *       AVX2 or SSE2 when the build targets them (e.g. -mavx2). Compressed
+ *       items are decompressed into the buffer of setCompression() first,
+ *       deltas decoded into the buffer of setDelta().
+ *
+ * @param[in] pxPattern Pointer to the pattern.
+ * @param[in] xPatternSize Size [byte] of the pattern, not zero.
+ * @param[in] pxCallback Function called with each item holding the pattern.
+ * @param[in] pvContext User context passed to the callback.
+ * @param[out] Number of items handed to the callback.
+ *
+ */
+
+std::size_t ringbuf::scan( const void* pxPattern, 
+                           const std::size_t xPatternSize, 
+                           rbScanCallback_t pxCallback, 
+                           void* pvContext )
+{
+    std::size_t xMatchCnt = 0;
+    bool isScanning = ( xPatternSize > 0 );
+
+    const rbItem_t* pxItem = pxTail;
+    rbConstSpan_t axSpans[ 2 ];
+
+    pxDeltaDecoded = nullptr;
+
+    for( std::size_t i = 0; isScanning && ( i < xTotItemCnt ); ++i )
+    {
+        if(    getPlainSpans( pxItem, axSpans ) \
+            && containsPattern( axSpans, ( const std::uint8_t* )pxPattern, xPatternSize )    )
+        {
+            ++xMatchCnt;
+
+            isScanning = pxCallback( pxItem, pvContext );
+        }
+
+        pxItem = getNext( pxItem );
+    }
+
+    return xMatchCnt;
+}
+
+/**
+ * @brief Hands the data of each item, from the tail on, to a predicate and
+ *        reports the items it selects, e.g. by the value of a field.
+ *
+ * @note Compressed items are decompressed into the buffer of setCompression(),
+ *       deltas decoded into the buffer of setDelta().
+ *
+ * @param[in] pxPredicate Function called with the data of each item.
+ * @param[in] pxCallback Function called with each item selected.
+ * @param[in] pvContext User context passed to both functions.
+ * @param[out] Number of items handed to the callback.
+ *
+ */
+
+std::size_t ringbuf::scan( rbScanPredicate_t pxPredicate, 
+                           rbScanCallback_t pxCallback, 
+                           void* pvContext )
+{
+    std::size_t xMatchCnt = 0;
+    bool isScanning = true;
+
+    const rbItem_t* pxItem = pxTail;
+    rbConstSpan_t axSpans[ 2 ];
+
+    pxDeltaDecoded = nullptr;
+
+    for( std::size_t i = 0; isScanning && ( i < xTotItemCnt ); ++i )
+    {
+        if( getPlainSpans( pxItem, axSpans ) && pxPredicate( axSpans, pvContext ) )
+        {
+            ++xMatchCnt;
+
+            isScanning = pxCallback( pxItem, pvContext );
+        }
+
+        pxItem = getNext( pxItem );
+    }
+
+    return xMatchCnt;
+}
+
+/**
+ * @brief Gets the size of data in the head of the ring buffer.
+ *
+ * @param[out] Head size.
+ *
+ */
+
+const std::size_t ringbuf::getHeadSize( void ) 
+{
+    return getDataSize( pxHead );
+}
+
+/**
+ * @brief Gets the size of data in the tail of the ring buffer.
+ *
+ * @param[out] Tail data size.
+ *
+ */
+
+const std::size_t ringbuf::getTailSize( void ) 
+{
+    return getDataSize( pxTail );
+}
+
+/**
+ * @brief Gets the number of items present in the ring buffer.
+ *
+ * @param[out] Items count.
+ *
+ */
+
+const std::size_t ringbuf::getItemsCnt( void ) 
+{
+    return xTotItemCnt;
+}
+
+/**
+ * @brief Returns a pointer to the head of the ring buffer.
+ *
+ * @param[out] pointer to head
+ *
+ */
+
+const rbItem_t* ringbuf::getHead( void ) 
+{
+    return pxHead;
+}
+
+/**
+ * @brief Returns a pointer to the tail of the ring buffer.
+ *
+ * @param[out] pointer to head
+ *
+ */
+
+const rbItem_t* ringbuf::getTail( void ) 
+{
+    return pxTail;
+}
+
+/**
+ * @brief Returns a pointer to the item following the specified one.
+ *
+ * @note The head is followed by itself.
+ *
+ * @param[in] pxItem Pointer to an item of this ring buffer.
+ * @param[out] Pointer to the next item.
+ *
+ */
+
+const rbItem_t* ringbuf::getNext( const rbItem_t* pxItem ) 
+{
+#if ( RINGBUF_CFG_COMPACT_HEADER == 1 )
+    return ( const rbItem_t* )( pcBuf + pxItem->ulNext );
+#else
+    return pxItem->pxNext;
+#endif
+}
+
+/**
+ * @brief Returns a pointer to the item preceding the specified one.
+ *
+ * @note The tail is preceded by itself.
+ *
+ * @param[in] pxItem Pointer to an item of this ring buffer.
+ * @param[out] Pointer to the previous item.
+ *
+ */
+
+const rbItem_t* ringbuf::getPrev( const rbItem_t* pxItem ) 
+{
+#if ( RINGBUF_CFG_COMPACT_HEADER == 1 )
+    return ( const rbItem_t* )( pcBuf + pxItem->ulPrev );
+#else
+    return pxItem->pxPrev;
+#endif
+}
+
+/**
+ * @brief Sets the memory where the position of each item is recorded,
+ *        so that getItem() reaches any item in constant time.
+ *
+ * @note The index is a ring of 32-bit offsets from the start of the memory
+ *       pool, updated by insertions and deletions. Items already present are
+ *       indexed here. When there are more items than entries, only the newest
+ *       ones are indexed and the older ones are reached through the links.
+ *
+ * @param[in] pulIndexBuf Memory for the index entries, nullptr to drop the index.
+ * @param[in] xIndexCnt Number of entries, a power of two; no more than
+ *            getItemsCnt() can ever reach is needed.
+ * @param[out] True when the index is set, false when the count is not a power
+ *             of two or the memory pool is larger than 4 GB.
+ *
+ */
+
+bool ringbuf::setIndex( std::uint32_t* pulIndexBuf, 
+                        const std::size_t xIndexCnt ) 
+{
+    bool isIndexSet = false;
+
+    if( pulIndexBuf == nullptr )
+    {
+        pulIndex = nullptr;
+        xIndexMask = 0;
+
+        isIndexSet = true;
+    }
+    else if(    ( xIndexCnt > 0 ) \
+             && ( ( xIndexCnt & ( xIndexCnt - 1 ) ) == 0 ) \
+             && ( ( std::uint64_t )xBufSize <= ( ( std::uint64_t )UINT32_MAX + 1 ) )    )
+    {
+        pulIndex = pulIndexBuf;
+        xIndexMask = xIndexCnt - 1;
+        xIndexFloor = xIndexBase;
+
+        /* Index the items already present. */
+        const rbItem_t* pxItem = pxTail;
+
+        for( std::size_t i = 0; i < xTotItemCnt; ++i )
+        {
+            indexItem( pxItem, i );
+
+            pxItem = getNext( pxItem );
+        }
+
+        isIndexSet = true;
+    }
+
+    return isIndexSet;
+}
+
+/**
+ * @brief Returns a pointer to the item at the given position.
+ *
+ * @note Constant time for the items held by the index (see setIndex()),
+ *       otherwise the links are followed from the nearest end.
+ *       The newest N items are getItem( getItemsCnt() - N ) and the
+ *       items following it.
+ *
+ * @param[in] xItemIdx Position of the item counted from the tail,
+ *            getItemsCnt() - 1 for the head.
+ * @param[out] Pointer to the item, nullptr when there is no such item.
+ *
+ */
 
-                    bottomFreeSpace -= sizeof( rbItem_t ); 
-                }
-            }
+const rbItem_t* ringbuf::getItem( const std::size_t xItemIdx ) 
+{
+    const rbItem_t* pxItem = nullptr;
+
+    if( xItemIdx < xTotItemCnt )
+    {
+        if( ( pulIndex != nullptr ) && ( ( xIndexBase + xItemIdx ) >= xIndexFloor ) )
+        {
+            pxItem = ( const rbItem_t* )( pcBuf + pulIndex[ ( xIndexBase + xItemIdx ) & xIndexMask ] );
         }
-        else
+        else if( xItemIdx < ( xTotItemCnt / 2 ) )
         {
-            /* pxTail > pxHead. */
-            topFreeSpace = ( std::size_t )( ( std::uint8_t* )pxTail - ptrNext );
+            pxItem = pxTail;
 
-            if( topFreeSpace >= ( sizeof( rbItem_t ) + xItemSize ) )
+            for( std::size_t i = 0; i < xItemIdx; ++i )
             {
-                pHeader = ptrNext;
+                pxItem = getNext( pxItem );
             }
         }
-
-        /* Free space for new item check. */
-        if( xItemSize > ( topFreeSpace + bottomFreeSpace ) )
+        else
         {
-            pHeader = nullptr;
+            pxItem = pxHead;
+
+            for( std::size_t i = xItemIdx + 1; i < xTotItemCnt; ++i )
+            {
+                pxItem = getPrev( pxItem );
+            }
         }
     }
 
-    return pHeader;
+    return pxItem;
 }
 
+#if ( RINGBUF_CFG_ITEM_SEQUENCE == 1 )
 /**
- * @brief Inserts a new item in the ring buffer 
- *        at a specific location.
- * 
- * @note Private method.
- * 
- * @param[in] pxHeader New item position in the ring buffer.
- * @param[in] pxItem Item to insert.
- * @param[in] xItemSize Size [byte] of the item to insert.
- * @param[out] True when item successfully insertion.
+ * @brief Returns a pointer to the item with the given sequence number.
+ *
+ * @note Sequence numbers follow the item positions unless deleteHead() was
+ *       used, so the first look-up with getItem() normally finds the item;
+ *       otherwise the positions are searched with a bisection.
+ *
+ * @param[in] ullSeq Sequence number of the item.
+ * @param[out] Pointer to the item, nullptr when not present.
  *
  */
 
-void ringbuf::pushItem( const void* pxHeader, 
-                        const void* pxItem, 
-                        const std::size_t xItemSize ) 
+const rbItem_t* ringbuf::getItemBySeq( const std::uint64_t ullSeq ) 
 {
-    rbItem_t xNewItem;
-    std::size_t topPartSize = 0;
-    std::size_t bottomPartSize = 0;
-
-    /* Determine where new item shall be copied. */
-    const std::uint8_t* pDataDst = ( const std::uint8_t* )pxHeader + sizeof( rbItem_t );
-
-    /* Buffer roll-over check. */
-    if( pDataDst > &pcBuf[ xBufSize - 1 ] )
-    {
-        pDataDst = pcBuf;
-    }
+    const rbItem_t* pxItem = nullptr;
 
-    if ( pDataDst >= ( std::uint8_t* )pxTail )
+    if(    ( xTotItemCnt > 0 ) \
+        && ( ullSeq >= pxTail->ullSeq ) \
+        && ( ullSeq <= pxHead->ullSeq )    )
     {
-        /* Write on top part of the buffer. */
-        topPartSize = ( std::size_t )( &pcBuf[ xBufSize - 1 ] - pDataDst ) + 1;
+        /* Gaps only make the item nearer to the tail. */
+        std::size_t xLow = 0;
+        std::size_t xHigh = ( std::size_t )std::min<std::uint64_t>( ullSeq - pxTail->ullSeq, xTotItemCnt - 1 );
+        std::size_t xProbe = xHigh;
+        bool isSearching = true;
 
-        /* Buffer roll-over check. */
-        if( xItemSize > topPartSize )          
+        while( isSearching )
         {
-            bottomPartSize = xItemSize - topPartSize;
-        }
-    }
-    else
-    {
-        topPartSize = 0;
-        bottomPartSize = xItemSize;
-    }
-
-    /* Copy first part of data. */
-    std::memcpy( ( void* )pDataDst, pxItem, topPartSize );
+            const rbItem_t* pxProbe = getItem( xProbe );
 
-    pDataDst += topPartSize;
+            if( pxProbe->ullSeq == ullSeq )
+            {
+                pxItem = pxProbe;
+            }
+            else if( pxProbe->ullSeq > ullSeq )
+            {
+                xHigh = xProbe - 1;
+            }
+            else
+            {
+                xLow = xProbe + 1;
+            }
 
-    /* Buffer roll-over. */
-    if( pDataDst == &pcBuf[ xBufSize ] )
-    {
-        pDataDst = pcBuf;
+            isSearching = ( pxItem == nullptr ) && ( xLow <= xHigh );
+            xProbe = xLow + ( ( xHigh - xLow ) / 2 );
+        }
     }
 
-    /* Copy second part of data. */
-    std::memcpy( ( void* )pDataDst, ( std::uint8_t* )pxItem + topPartSize , bottomPartSize );
-
-    /* Copy item header. */
-    xNewItem.pxNext = ( rbItem_t* )pxHeader;
-    xNewItem.pxPrev = pxHead;
-    xNewItem.xItemSize = xItemSize;
-
-    std::memcpy( ( void* )pxHeader, &xNewItem, sizeof( rbItem_t ) );
+    return pxItem;
+}
 
-    /* Update Head*/
-    pxHead->pxNext = ( rbItem_t* )pxHeader;
-    pxHead = ( rbItem_t* )pxHeader;
+/**
+ * @brief Gets the sequence number of an item.
+ *
+ * @param[in] pxItem Pointer to an item of this ring buffer.
+ * @param[out] Sequence number, UINT64_MAX for an item deleted from the head.
+ *
+ */
 
-    ++xTotItemCnt;
+const std::uint64_t ringbuf::getSeq( const rbItem_t* pxItem ) 
+{
+    return pxItem->ullSeq;
 }
 
-/*--------------------- Public methods ---------------------*/
-
 /**
- * @brief Ring buffer constructor.
+ * @brief Gets the sequence number of the tail (oldest item retained).
  *
- * @param[in] pcPool Pointer to the memery pool used by this ringBuf instance.
- * @param[in] ulPoolSize Size of the memory pool.
+ * @note Readers that lost track of the items resume from here, with
+ *       getTail(). Equal to getNextSeq() when the buffer is empty.
+ *
+ * @param[out] Tail sequence number.
  *
  */
 
-ringbuf::ringbuf( std::uint8_t* pcPool, 
-                  const std::size_t xPoolSize ) : 
-                  pcBuf( pcPool ), 
-                  xBufSize( xPoolSize ) 
-{ 
-    /* Reset buffer. */
-    std::memset( ( void* )pcBuf, 0, xBufSize );
-
-    reset();
-} 
+const std::uint64_t ringbuf::getTailSeq( void ) 
+{
+    return ullTailSeq.load( std::memory_order_acquire );
+}
 
 /**
- * @brief Discards all data in the ring buffer.
+ * @brief Gets the sequence number the next item inserted will get.
+ *
+ * @param[out] Next sequence number.
  *
  */
 
-void ringbuf::flush( void )
+const std::uint64_t ringbuf::getNextSeq( void ) 
 {
-    reset();
+    return ullNextSeq.load( std::memory_order_acquire );
 }
 
- /**
- * @brief Inserts a new item in the ring buffer.
+/**
+ * @brief Copies data of the specified item into the destination buffer,
+ *        only if it is still the item with the given sequence number.
  *
- * @param[in] pxItem Pointer to the item to insert.
- * @param[in] xItemSize Size of the item to insert.
- * @param[out] True when item successfully insertion.
+ * @note The check is done before and after copying (as a seqlock), so
+ *       it also detects an item deleted or overwritten while being copied.
+ *       On failure the reader can resume from getTailSeq(). Compressed data
+ *       is decompressed. Deltas of pushDelta() depend on older items and
+ *       are not copied: getData() or getSamples() read them.
+ *
+ * @param[in] pxItem Pointer to the item to retrieve.
+ * @param[in] ullSeq Sequence number the item had when the pointer was taken.
+ * @param[in] pcDstBuf Destination buffer where data is copied.
+ * @param[in] xDstBufSize Size [byte] of the destination buffer.
+ * @param[in] pxItemSize Filled with the size [byte] of the item data.
+ * @param[out] True when data of the item was copied and is consistent.
  *
  */
 
-bool ringbuf::push( const void* pxItem, 
-                    const std::size_t xItemSize ) 
+bool ringbuf::getData( const rbItem_t* pxItem, 
+                       const std::uint64_t ullSeq, 
+                       std::uint8_t* pcDstBuf, 
+                       const std::size_t xDstBufSize, 
+                       std::size_t* pxItemSize )
 {
-    bool isItemPushed = false;
-    std::uint8_t* pHeader = nullptr;
+    bool isDataCopied = false;
 
-    if(    ( xItemSize > 0 ) \
-        && ( xItemSize < ( xBufSize - sizeof( rbItem_t ) ) )    )
+    *pxItemSize = 0;
 
-    {        
-        pHeader = getNextPtr( xItemSize );
+    if( ( pxItem != nullptr ) && ( ullSeq >= ullTailSeq.load( std::memory_order_acquire ) ) )
+    {
+        rbItem_t xItem;
 
-        /* Remove old items if space is not enough. */
-        while( pHeader == nullptr )
+        std::memcpy( &xItem, pxItem, sizeof( rbItem_t ) );
+
+        const std::size_t xStoredSize = getStoredSize( xItem.xItemSize );
+        const bool isItemCompressed = ( ( xItem.xItemSize & RB_ITEM_FLAG_COMPRESSED ) != 0 );
+
+        /* The header may be overwritten: keep the copy inside the buffers. */
+        if(    ( xItem.ullSeq == ullSeq ) \
+            && ( ( xItem.xItemSize & RB_ITEM_FLAG_DELTA ) == 0 ) \
+            && ( isItemCompressed || ( xStoredSize <= xDstBufSize ) ) \
+            && ( xStoredSize < xBufSize )    )
         {
-            deleteTail();
+            rbSpan_t axSpans[ 2 ];
+            std::size_t xDataSize = xStoredSize;
+            bool isDataValid = true;
 
-            pHeader = getNextPtr( xItemSize );
-        }
+            getSpans( pxItem, xStoredSize, axSpans );
+
+            if( isItemCompressed )
+            {
+                /* Data being overwritten fails the checks of the decoder. */
+                const rbConstSpan_t axDataSpans[ 2 ] = { { axSpans[ 0 ].pcData, axSpans[ 0 ].xSize },
+                                                         { axSpans[ 1 ].pcData, axSpans[ 1 ].xSize } };
+
+                isDataValid = decompressItem( axDataSpans, pcDstBuf, xDstBufSize, &xDataSize );
+            }
+            else
+            {
+                std::memcpy( pcDstBuf, axSpans[ 0 ].pcData, axSpans[ 0 ].xSize );
+                std::memcpy( ( pcDstBuf + axSpans[ 0 ].xSize ), axSpans[ 1 ].pcData, axSpans[ 1 ].xSize );
+            }
+
+            /* Pairs with the fences of publishTailSeq() and deleteHead(). */
+            std::atomic_thread_fence( std::memory_order_acquire );
+
+            std::memcpy( &xItem, pxItem, sizeof( rbItem_t ) );
 
-        pushItem( pHeader, pxItem,xItemSize );
+            isDataCopied =    isDataValid \
+                           && ( xItem.ullSeq == ullSeq ) \
+                           && ( ullSeq >= ullTailSeq.load( std::memory_order_relaxed ) );
 
-        isItemPushed = true;
+            *pxItemSize = isDataCopied ? xDataSize : 0;
+        }
     }
 
-    return isItemPushed;
+    return isDataCopied;
+}
+#endif
+
+#if ( RINGBUF_CFG_ITEM_TIMESTAMP == 1 )
+/**
+ * @brief Sets the clock stamping the new items, e.g. reading the TSC.
+ *
+ * @note Times shall never decrease, also across an image recovery.
+ *
+ * @param[in] pxItemClock Clock function, nullptr for CLOCK_MONOTONIC [ns].
+ *
+ */
+
+void ringbuf::setClock( rbClock_t pxItemClock ) 
+{
+    pxClock = ( pxItemClock != nullptr ) ? pxItemClock : getMonotonicTime;
 }
 
+/**
+ * @brief Gets the time an item was inserted at.
+ *
+ * @param[in] pxItem Pointer to an item of this ring buffer.
+ * @param[out] Time read from the clock at insertion.
+ *
+ */
+
+const std::uint64_t ringbuf::getTime( const rbItem_t* pxItem ) 
+{
+    return pxItem->ullTime;
+}
 
 /**
- * @brief Checks whether the ring buffer is empty.
+ * @brief Finds the oldest item inserted at or after the given time.
  *
- * @param[out] True when empty.
+ * @note Logarithmic time for the items held by the index (see setIndex()).
+ *
+ * @param[in] ullTime Time to look for.
+ * @param[out] Pointer to the item, nullptr when all items are older.
  *
  */
 
-bool ringbuf::isEmpty( void ) 
+const rbItem_t* ringbuf::findByTime( const std::uint64_t ullTime ) 
 {
-    return ( xTotItemCnt == 0 );
+    std::size_t xItemPos = 0;
+
+    return findTime( ullTime, &xItemPos );
 }
 
 /**
- * @brief Deletes the head (most recent item) of the ring buffer.
+ * @brief Finds the items inserted within a time range, without copying them.
  *
- * @param[out] True when the head is successfully deleted.
+ * @note Logarithmic time for the items held by the index (see setIndex()).
+ *       The range stays valid until items are inserted or deleted.
+ *
+ * @param[in] ullStartTime Start of the range, included.
+ * @param[in] ullEndTime End of the range, included.
+ * @param[in] pxRange Filled with the oldest item of the range and the number
+ *            of items, to be walked with getNext().
+ * @param[out] True when at least one item is in the range.
  *
  */
 
-bool ringbuf::deleteHead( void ) 
+bool ringbuf::rangeByTime( const std::uint64_t ullStartTime, 
+                           const std::uint64_t ullEndTime, 
+                           rbItemRange_t* pxRange ) 
 {
-    bool isHeadDeleted = false;
+    bool isRangeFound = false;
 
-    if( xTotItemCnt > 0 )
+    std::size_t xStartPos = 0;
+    std::size_t xEndPos = xTotItemCnt;
+
+    pxRange->pxFirst = nullptr;
+    pxRange->xItemsCnt = 0;
+
+    if( ullStartTime <= ullEndTime )
     {
-        pxHead = pxHead->pxPrev;
-        pxHead->pxNext = pxHead;
+        const rbItem_t* pxFirst = findTime( ullStartTime, &xStartPos );
 
-        if( --xTotItemCnt == 0 )
+        if( ullEndTime < UINT64_MAX )
         {
-            reset();
+            /* Position of the first item after the range. */
+            findTime( ullEndTime + 1, &xEndPos );
         }
 
-        isHeadDeleted = true;
+        if( ( pxFirst != nullptr ) && ( xEndPos > xStartPos ) )
+        {
+            pxRange->pxFirst = pxFirst;
+            pxRange->xItemsCnt = xEndPos - xStartPos;
+
+            isRangeFound = true;
+        }
     }
 
-    return isHeadDeleted;
+    return isRangeFound;
 }
+#endif
 
 /**
- * @brief Deletes the tail (oldest item) of the ring buffer.
+ * @brief Checks whether items of a previous run were found in the image
+ *        at construction.
  *
- * @param[out] True when the tail is successfully deleted.
+ * @param[out] True when the image was recovered, false when it was
+ *             created or not valid.
  *
  */
 
-bool ringbuf::deleteTail( void )
+bool ringbuf::isRecovered( void ) 
 {
-    bool isTailDeleted = false;
+    return isImageRecovered;
+}
 
-    if( xTotItemCnt > 0 )
-    {
-        pxTail = pxTail->pxNext;
-        pxTail->pxPrev = pxTail;
+/**
+ * @brief Writes the image back to its file, so that it also survives
+ *        a crash of the system.
+ *
+ * @note Not needed against a crash of the process: the file is updated by
+ *       the system anyway. Linux only, the image shall start at a page.
+ *
+ * @param[out] True when the image was written.
+ *
+ */
 
-        if( --xTotItemCnt == 0 )
-        {
-            reset();
-        }
-        
-        isTailDeleted = true;
+bool ringbuf::syncImage( void ) 
+{
+    bool isImageSynced = false;
+
+#if defined( __linux__ )
+    if( pxImage != nullptr )
+    {
+        isImageSynced = ( msync( ( void* )pxImage, sizeof( rbImage_t ) + xBufSize, MS_SYNC ) == 0 );
     }
+#endif
 
-    return isTailDeleted;
+    return isImageSynced;
 }
 
 /**
- * @brief Copies data of the specified item into the destination buffer.
+ * @brief Maps a file holding a ring buffer image.
  *
- * @param[in] pxItem Pointer to the item to retrieve.
- * @param[in] pcDstBuf Destination buffer where data is copied.
- * @param[out] True when data successfully copied.
+ * @note Linux only. The file is shared: changes to the image go to the file.
+ *
+ * @param[in] pcPath Path of the file, created when missing.
+ * @param[in] pxImageSize Size of the image, zero to map an existing file with
+ *            its current size. Updated with the size actually mapped.
+ * @param[out] Pointer to the image, nullptr on failure.
  *
  */
 
-bool ringbuf::getData( const rbItem_t* pxItem, 
-                       std::uint8_t* pcDstBuf )
+std::uint8_t* ringbuf::mapImage( const char* pcPath, 
+                                 std::size_t* pxImageSize )
 {
-    bool isDataCopied = false;
+    std::uint8_t* pcImage = nullptr;
 
-    std::size_t size = 0;
-    std::size_t rolloversize = 0;
-
-    if( ( pxItem != nullptr) && ( pxItem->xItemSize > 0 ) )
-    { 
-        const std::uint8_t* pItemData = ( const std::uint8_t* )pxItem + sizeof( rbItem_t );
+#if defined( __linux__ )
+    const int iFd = open( pcPath, ( *pxImageSize > 0 ) ? ( O_RDWR | O_CREAT ) : O_RDWR, 0644 );
 
-        /* Buffer roll-over. */
-        if( pItemData > &pcBuf[ xBufSize - 1 ] )
-        {
-            pItemData = pcBuf;
-            size = pxItem->xItemSize;
-        }
+    if( iFd >= 0 )
+    {
+        std::size_t xImageSize = *pxImageSize;
+        bool isSized = false;
 
-        if( ( pItemData + pxItem->xItemSize  ) <= &pcBuf[ xBufSize - 1 ]  )
+        if( xImageSize > 0 )
         {
-            size = pxItem->xItemSize;
+            isSized = ( ftruncate( iFd, ( off_t )xImageSize ) == 0 );
         }
         else
         {
-            size = ( std::size_t )( &pcBuf[ xBufSize - 1 ] - pItemData ) + 1;
+            struct stat xStat;
 
-            rolloversize = pxItem->xItemSize - size;
+            isSized = ( fstat( iFd, &xStat ) == 0 ) && ( xStat.st_size > 0 );
+            xImageSize = isSized ? ( std::size_t )xStat.st_size : 0;
         }
 
-        memcpy( pcDstBuf, pItemData, size );
-        memcpy( (pcDstBuf + size), pcBuf, rolloversize );
+        if( isSized )
+        {
+            void* pvImage = mmap( nullptr, xImageSize, PROT_READ | PROT_WRITE, MAP_SHARED, iFd, 0 );
+
+            if( pvImage != MAP_FAILED )
+            {
+                pcImage = ( std::uint8_t* )pvImage;
+
+                *pxImageSize = xImageSize;
+            }
+        }
 
-        isDataCopied = true;
+        /* The mapping keeps the file open. */
+        close( iFd );
     }
+#else
+    ( void )pcPath;
+    ( void )pxImageSize;
+#endif
 
-    return isDataCopied;
+    return pcImage;
 }
 
 /**
- * @brief Gets the size of data in the head of the ring buffer.
+ * @brief Releases an image mapped by mapImage().
  *
- * @param[out] Head size.
+ * @param[in] pcImage Pointer to the image.
+ * @param[in] xImageSize Size of the image returned by mapImage().
  *
  */
 
-const std::size_t ringbuf::getHeadSize( void ) 
+void ringbuf::unmapImage( std::uint8_t* pcImage, 
+                          const std::size_t xImageSize )
 {
-    return pxHead->xItemSize;
+#if defined( __linux__ )
+    if( pcImage != nullptr )
+    {
+        munmap( pcImage, xImageSize );
+    }
+#else
+    ( void )pcImage;
+    ( void )xImageSize;
+#endif
 }
 
 /**
- * @brief Gets the size of data in the tail of the ring buffer.
+ * @brief Creates a memory pool mapped twice in consecutive virtual
+ *        addresses, to be used with the RB_LAYOUT_MIRRORED layout.
  *
- * @param[out] Tail data size.
+ * @note Linux only. Bytes past the end of the pool alias its start,
+ *       so items rolling over are read and written in one part.
+ *
+ * @param[in] pxPoolSize Requested size of the memory pool, updated with
+ *            the size actually mapped, rounded up to a page multiple.
+ * @param[out] Pointer to the memory pool, nullptr on failure.
  *
  */
 
-const std::size_t ringbuf::getTailSize( void ) 
+std::uint8_t* ringbuf::mapMirroredPool( std::size_t* pxPoolSize )
 {
-    return pxTail->xItemSize;
-}
+    std::uint8_t* pcPool = nullptr;
 
-/**
- * @brief Gets the number of items present in the ring buffer.
- *
- * @param[out] Items count.
- *
- */
+#if defined( __linux__ )
+    const std::size_t xPageSize = ( std::size_t )sysconf( _SC_PAGESIZE );
+    const std::size_t xPoolSize = ( ( *pxPoolSize + xPageSize - 1 ) / xPageSize ) * xPageSize;
 
-const std::size_t ringbuf::getItemsCnt( void ) 
-{
-    return xTotItemCnt;
-}
+    const int iFd = memfd_create( "ringbuf", MFD_CLOEXEC );
 
-/**
- * @brief Returns a pointer to the head of the ring buffer.
- *
- * @param[out] pointer to head
- *
- */
+    if( ( iFd >= 0 ) && ( xPoolSize > 0 ) && ( ftruncate( iFd, ( off_t )xPoolSize ) == 0 ) )
+    {
+        /* Reserve the address range for both mappings. */
+        void* pvBase = mmap( nullptr, 2 * xPoolSize, PROT_NONE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0 );
 
-const rbItem_t* ringbuf::getHead( void ) 
-{
-    return pxHead;
+        if( pvBase != MAP_FAILED )
+        {
+            std::uint8_t* pcBase = ( std::uint8_t* )pvBase;
+
+            /* Map the same pages twice, back to back. */
+            if(    ( mmap( pcBase, xPoolSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_FIXED, iFd, 0 ) != MAP_FAILED ) \
+                && ( mmap( pcBase + xPoolSize, xPoolSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_FIXED, iFd, 0 ) != MAP_FAILED )    )
+            {
+                pcPool = pcBase;
+
+                *pxPoolSize = xPoolSize;
+            }
+            else
+            {
+                munmap( pvBase, 2 * xPoolSize );
+            }
+        }
+    }
+
+    if( iFd >= 0 )
+    {
+        /* Mappings keep the memory alive. */
+        close( iFd );
+    }
+#endif
+
+    return pcPool;
 }
 
 /**
- * @brief Returns a pointer to the tail of the ring buffer.
+ * @brief Releases a memory pool created by mapMirroredPool().
  *
- * @param[out] pointer to head
+ * @param[in] pcPool Pointer to the memory pool.
+ * @param[in] xPoolSize Size of the memory pool returned by mapMirroredPool().
  *
  */
 
-const rbItem_t* ringbuf::getTail( void ) 
+void ringbuf::unmapMirroredPool( std::uint8_t* pcPool,
+                                 const std::size_t xPoolSize )
 {
-    return pxTail;
+#if defined( __linux__ )
+    if( pcPool != nullptr )
+    {
+        munmap( pcPool, 2 * xPoolSize );
+    }
+#endif
 }
 
 /*---------------------------------------------------------------------------*/
@@ -36,25 +36,301 @@
 #define C_RING_BUF_HPP
 
 
+#include <atomic>
 #include <cstdint>
+#include <cstddef>
+
+/**
+ * @brief Size [byte] of a cache line on the target.
+ *
+ * @note Used to keep indices written by different threads
+ *       on separate cache lines. Override it from the build
+ *       when the target has a different line size.
+ */
+
+#ifndef RINGBUF_CACHE_LINE_SIZE
+#define RINGBUF_CACHE_LINE_SIZE     64U
+#endif
+
+/**
+ * @brief Set to 1 to store item links as 32-bit offsets from the start
+ *        of the memory pool instead of pointers.
+ *
+ * @note It halves the item header on 64-bit targets, but limits the
+ *       memory pool to 4 GB (the rest of a larger pool is not used) and
+ *       removes pxNext/pxPrev from rbItem_t: use ringbuf::getNext() and
+ *       ringbuf::getPrev() to iterate.
+ */
+
+#ifndef RINGBUF_CFG_COMPACT_HEADER
+#define RINGBUF_CFG_COMPACT_HEADER  0
+#endif
+
+/**
+ * @brief Set to 1 to store a 64-bit sequence number in every item.
+ *
+ * @note Sequence numbers grow by one at each insertion and are never
+ *       reused: a reader holding an item pointer can check whether the
+ *       item was deleted or overwritten in the meantime, see
+ *       ringbuf::getData( pxItem, ullSeq, ... ).
+ */
+
+#ifndef RINGBUF_CFG_ITEM_SEQUENCE
+#define RINGBUF_CFG_ITEM_SEQUENCE   0
+#endif
+
+/**
+ * @brief Set to 1 to store in every item the 64-bit time of its insertion.
+ *
+ * @note Times come from CLOCK_MONOTONIC [ns] unless another clock is set
+ *       with ringbuf::setClock(). Items are in time order, so the items of
+ *       a time range are found by bisection, see ringbuf::rangeByTime().
+ */
+
+#ifndef RINGBUF_CFG_ITEM_TIMESTAMP
+#define RINGBUF_CFG_ITEM_TIMESTAMP  0
+#endif
 
 #ifdef __cplusplus
 extern "C" {
 #endif
 
+#if ( RINGBUF_CFG_COMPACT_HEADER == 1 )
+typedef std::uint32_t rbSize_t;     /**< Type of the item data size. */
+#else
+typedef std::size_t rbSize_t;       /**< Type of the item data size. */
+#endif
+
 /**
  * @ingroup ringbuf_struct_types
  * @brief Struct holding pointers and data size.
  */
 
 struct rbItem {
+#if ( RINGBUF_CFG_COMPACT_HEADER == 1 )
+    std::uint32_t ulNext;   /**< Offset of next element from the start of the memory pool. */
+    std::uint32_t ulPrev;   /**< Offset of previous element from the start of the memory pool. */
+#else
     struct rbItem *pxNext;  /**< Pointer to next element of the buffer. */
     struct rbItem *pxPrev;  /**< Pointer to previsous element of the buffer. */
-    std::size_t xItemSize;
+#endif
+    rbSize_t xItemSize;     /**< Size of the data stored, with RB_ITEM_FLAG_COMPRESSED or RB_ITEM_FLAG_DELTA. */
+#if ( RINGBUF_CFG_ITEM_SEQUENCE == 1 )
+    std::uint64_t ullSeq;   /**< Sequence number of the item. */
+#endif
+#if ( RINGBUF_CFG_ITEM_TIMESTAMP == 1 )
+    std::uint64_t ullTime;  /**< Time the item was inserted at. */
+#endif
   };
 
 typedef struct rbItem rbItem_t;
 
+#define RB_ITEM_FLAG_COMPRESSED     ( ( rbSize_t )1U << ( ( sizeof( rbSize_t ) * 8U ) - 1U ) )  /**< Item data stored compressed. */
+#define RB_ITEM_FLAG_DELTA          ( ( rbSize_t )1U << ( ( sizeof( rbSize_t ) * 8U ) - 2U ) )  /**< Item data stored as a delta from the previous item. */
+
+#define RB_CODEC_HASH_CNT           4096U           /**< Entries of the compressor hash table. */
+
+/**
+ * @brief Size [byte] of the buffer given to ringbuf::setCompression()
+ *        to compress the items up to xMaxItemSize bytes.
+ */
+
+#define RB_CODEC_BUF_SIZE( xMaxItemSize )   ( ( RB_CODEC_HASH_CNT * sizeof( std::uint32_t ) ) + sizeof( std::uint32_t ) + ( xMaxItemSize ) )
+
+#define RB_DELTA_FIELDS_MAX         32U             /**< Maximum number of fields of a sample of pushDelta(). */
+#define RB_DELTA_FIELD_SIZE_MAX     8U              /**< Largest field [byte], a 64-bit integer or a double. */
+#define RB_DELTA_FIELD_DELTA_MAX    11U             /**< Largest delta of a field [byte], 81 bits of a 64-bit integer. */
+#define RB_DELTA_FIELD_WINDOW_SIZE  2U              /**< XOR window of a field [byte], its leading and trailing zeros. */
+
+/**
+ * @brief Size [byte] of the buffer given to ringbuf::setDelta()
+ *        for samples of xFieldsCnt fields: the previous sample, the
+ *        XOR windows of the encoder, its output and the XOR windows
+ *        of scan().
+ */
+
+#define RB_DELTA_BUF_SIZE( xFieldsCnt )     ( ( xFieldsCnt ) * ( RB_DELTA_FIELD_SIZE_MAX + ( 2U * RB_DELTA_FIELD_WINDOW_SIZE ) + RB_DELTA_FIELD_DELTA_MAX ) )
+
+/**
+ * @ingroup ringbuf_struct_types
+ * @brief Type of a field of the samples inserted by pushDelta().
+ *
+ * @note Integers are signed or unsigned, in the byte order of the host.
+ */
+
+typedef enum {
+    RB_FIELD_INT8,          /**< 8-bit integer, stored as a zigzag varint delta. */
+    RB_FIELD_INT16,         /**< 16-bit integer, stored as a zigzag varint delta. */
+    RB_FIELD_INT32,         /**< 32-bit integer, stored as a zigzag varint delta. */
+    RB_FIELD_INT64,         /**< 64-bit integer, stored as a zigzag varint delta. */
+    RB_FIELD_FLOAT,         /**< float, stored XORed with the previous value (as Gorilla). */
+    RB_FIELD_DOUBLE         /**< double, stored XORed with the previous value (as Gorilla). */
+  } rbField_t;
+
+/**
+ * @ingroup ringbuf_struct_types
+ * @brief Struct describing a contiguous part of the memory pool.
+ *
+ * @note Item data rolling over the end of the pool is described by two spans.
+ */
+
+struct rbSpan {
+    std::uint8_t* pcData;   /**< Pointer to the first byte of the part. */
+    std::size_t xSize;      /**< Size of the part in [byte], zero when unused. */
+  };
+
+typedef struct rbSpan rbSpan_t;
+
+/**
+ * @ingroup ringbuf_struct_types
+ * @brief Struct describing a read-only contiguous part of the memory pool.
+ */
+
+struct rbConstSpan {
+    const std::uint8_t* pcData; /**< Pointer to the first byte of the part. */
+    std::size_t xSize;          /**< Size of the part in [byte], zero when unused. */
+  };
+
+typedef struct rbConstSpan rbConstSpan_t;
+
+/**
+ * @ingroup ringbuf_struct_types
+ * @brief Callback receiving the data of each item removed by drain().
+ *
+ * @param[in] pxSpans Array of two read-only spans holding the item data;
+ *            the second part has size zero unless data rolls over.
+ * @param[in] pvContext User context passed to drain().
+ * @param[out] True to remove the item and go on, false to keep it and stop.
+ */
+
+typedef bool ( *rbDrainCallback_t )( const rbConstSpan_t* pxSpans, void* pvContext );
+
+/**
+ * @ingroup ringbuf_struct_types
+ * @brief Clock stamping the items with RINGBUF_CFG_ITEM_TIMESTAMP.
+ *
+ * @param[out] Current time, never lower than a time returned before.
+ */
+
+typedef std::uint64_t ( *rbClock_t )( void );
+
+/**
+ * @ingroup ringbuf_struct_types
+ * @brief Consecutive items of a ring buffer, accessed in place.
+ *
+ * @note The items following the first one are reached with ringbuf::getNext().
+ */
+
+struct rbItemRange {
+    const rbItem_t* pxFirst;    /**< Oldest item of the range, nullptr when empty. */
+    std::size_t xItemsCnt;      /**< Number of items of the range. */
+  };
+
+typedef struct rbItemRange rbItemRange_t;
+
+/**
+ * @ingroup ringbuf_struct_types
+ * @brief Predicate selecting the items reported by scan().
+ *
+ * @param[in] pxSpans Array of two read-only spans holding the item data;
+ *            the second part has size zero unless data rolls over.
+ * @param[in] pvContext User context passed to scan().
+ * @param[out] True when the item matches.
+ */
+
+typedef bool ( *rbScanPredicate_t )( const rbConstSpan_t* pxSpans, void* pvContext );
+
+/**
+ * @ingroup ringbuf_struct_types
+ * @brief Callback receiving each item matched by scan().
+ *
+ * @param[in] pxItem Pointer to the matching item, valid until it is deleted.
+ * @param[in] pvContext User context passed to scan().
+ * @param[out] True to go on scanning, false to stop.
+ */
+
+typedef bool ( *rbScanCallback_t )( const rbItem_t* pxItem, void* pvContext );
+
+/**
+ * @ingroup ringbuf_struct_types
+ * @brief Layout of item data in the memory pool.
+ */
+
+typedef enum {
+    RB_LAYOUT_SPLIT,        /**< Data rolling over the end of the pool is split in two parts. */
+    RB_LAYOUT_CONTIGUOUS,   /**< Data never rolls over: an item not fitting before the end of
+                                 the pool is placed at its start, skipping the space left. */
+    RB_LAYOUT_MIRRORED      /**< The pool is mapped twice back to back (see mapMirroredPool()),
+                                 items rolling over are accessed past its end in one part. */
+  } rbLayout_t;
+
+/**
+ * @ingroup ringbuf_struct_types
+ * @brief What push() does when there is not enough space for a new item.
+ */
+
+typedef enum {
+    RB_OVERFLOW_OVERWRITE,  /**< Delete the oldest items until the new one fits. */
+    RB_OVERFLOW_REJECT,     /**< Keep the old items and fail the insertion. */
+    RB_OVERFLOW_BLOCK       /**< Wait, up to a timeout, for a consumer to free space. */
+  } rbOverflow_t;
+
+/**
+ * @ingroup ringbuf_struct_types
+ * @brief Counters of data lost because of lack of space.
+ */
+
+struct rbStats {
+    std::size_t xEvictedItems;  /**< Old items deleted to make room for new ones. */
+    std::size_t xEvictedBytes;  /**< Data [byte] of the old items deleted. */
+    std::size_t xRejectedItems; /**< New items not inserted. */
+    std::size_t xRejectedBytes; /**< Data [byte] of the new items not inserted. */
+  };
+
+typedef struct rbStats rbStats_t;
+
+/**
+ * @ingroup ringbuf_struct_types
+ * @brief Header at the start of a ring buffer image (e.g. a memory-mapped
+ *        file), followed by the memory pool.
+ *
+ * @note Describes the pool well enough to find its items again after the
+ *       process using it crashed. Offsets are from the start of the pool.
+ */
+
+struct rbImage {
+    std::uint32_t ulMagic;          /**< Marker of an initialized image. */
+    std::uint32_t ulVersion;        /**< Layout version of the image. */
+    std::uint32_t ulHeaderSize;     /**< Size of this header [byte]. */
+    std::uint32_t ulItemHeaderSize; /**< Size of rbItem_t [byte]. */
+    std::uint32_t ulFlags;          /**< Build options changing rbItem_t (RB_IMAGE_FLAG_...). */
+    std::uint32_t ulLayout;         /**< Layout of item data, rbLayout_t. */
+    std::uint64_t ullPoolSize;      /**< Size of the memory pool [byte]. */
+    std::uint64_t ullBaseAddr;      /**< Address of the memory pool when item links were written. */
+    std::uint64_t ullHeadOff;       /**< Offset of the head (most recent item). */
+    std::uint64_t ullTailOff;       /**< Offset of the tail (oldest item). */
+    std::uint64_t ullItemsCnt;      /**< Number of items. */
+    std::uint64_t ullNextSeq;       /**< Sequence number of the next item inserted. */
+  };
+
+typedef struct rbImage rbImage_t;
+
+#define RB_IMAGE_MAGIC              0x46425252U     /**< "RRBF" in a little-endian image. */
+#define RB_IMAGE_VERSION            1U              /**< Current layout version of rbImage_t. */
+#define RB_IMAGE_FLAG_COMPACT       0x1U            /**< Built with RINGBUF_CFG_COMPACT_HEADER. */
+#define RB_IMAGE_FLAG_SEQUENCE      0x2U            /**< Built with RINGBUF_CFG_ITEM_SEQUENCE. */
+#define RB_IMAGE_FLAG_TIMESTAMP     0x4U            /**< Built with RINGBUF_CFG_ITEM_TIMESTAMP. */
+
+/**
+ * @ingroup ringbuf_struct_types
+ * @brief How a ring buffer takes its image.
+ */
+
+typedef enum {
+    RB_IMAGE_CREATE,        /**< Initialize a new image, discarding its content. */
+    RB_IMAGE_RECOVER        /**< Find the items of an existing image, initialize it when not valid. */
+  } rbImageOpen_t;
+
 /**
  * @class ringBuf 
  *
@@ -70,26 +346,109 @@ class ringbuf {
   private:
     std::uint8_t* pcBuf;          /**< Pointer to the memory where the ringBuf instance is implemented. */
     const std::size_t xBufSize;   /**< Size of the momory in [byte]. */
+    const rbLayout_t eLayout;     /**< Layout of item data in the memory pool. */
+    rbOverflow_t eOverflow;       /**< Behaviour when there is not enough space. */
+    rbStats_t xStats;             /**< Counters of data lost because of lack of space. */
     std::size_t  xTotItemCnt;     /**< Number of element present in the buffer. */
 
     rbItem_t* pxHead;             /**< Head of the buffer i.e. last element inserted. */
     rbItem_t* pxTail;             /**< Tail of the buffer i.e. oldest element retained. */
 
+    std::uint8_t* pcReserved;     /**< Header position of the item reserved and not committed yet. */
+    std::size_t xReservedSize;    /**< Size of the item reserved and not committed yet. */
+
+#if ( RINGBUF_CFG_ITEM_SEQUENCE == 1 )
+    std::atomic<std::uint64_t> ullNextSeq;  /**< Sequence number of the next item inserted. */
+    std::atomic<std::uint64_t> ullTailSeq;  /**< Sequence number of the oldest item retained. */
+#endif
+
+    rbImage_t* pxImage;           /**< Header of the image holding the memory pool, nullptr when none. */
+    bool isImageRecovered;        /**< True when items were found in the image at construction. */
+
+    std::uint32_t* pulIndex;      /**< Ring of item offsets from the start of the pool, nullptr when none. */
+    std::size_t xIndexMask;       /**< Number of index entries minus one. */
+    std::size_t xIndexBase;       /**< Index position of the tail, it only grows until reset. */
+    std::size_t xIndexFloor;      /**< Oldest index position whose entry is not overwritten. */
+
+#if ( RINGBUF_CFG_ITEM_TIMESTAMP == 1 )
+    rbClock_t pxClock;            /**< Clock stamping the new items. */
+#endif
+
+    std::uint32_t* pulCodecHash;  /**< Hash table of the compressor, nullptr when items are stored raw. */
+    std::uint8_t* pcCodecOut;     /**< Output of the compressor, it also holds data decompressed by scan(). */
+    std::size_t xCodecOutSize;    /**< Size of the compressor output [byte], the largest item compressed. */
+
+    const rbField_t* pxDeltaFields; /**< Fields of the samples of pushDelta(), nullptr when not set. */
+    std::size_t xDeltaFieldsCnt;  /**< Number of fields of a sample. */
+    std::size_t xDeltaSampleSize; /**< Size of a sample [byte]. */
+    std::size_t xDeltaInterval;   /**< Items from a keyframe to the next one. */
+    std::size_t xDeltaRun;        /**< Items inserted by pushDelta() since the last keyframe. */
+    const rbItem_t* pxDeltaHead;  /**< Last item inserted by pushDelta(), nullptr once the head changed otherwise. */
+    std::uint8_t* pcDeltaPrev;    /**< Sample of the last item inserted by pushDelta(). */
+    std::uint8_t* pcDeltaWindow;  /**< XOR window of each float field, as left by the encoder. */
+    std::uint8_t* pcDeltaOut;     /**< Output of the encoder, it also holds samples decoded by scan(). */
+    std::uint8_t* pcDeltaScanWindow;  /**< XOR window of each float field, as left by scan(). */
+    const rbItem_t* pxDeltaDecoded;   /**< Item whose sample scan() decoded last, nullptr when none. */
+
     /* Private methods. */
     void reset( void );
+    void empty( void );
+#if ( RINGBUF_CFG_ITEM_SEQUENCE == 1 )
+    void publishTailSeq( void );
+#endif
+    void setNext( rbItem_t* pxItem, const rbItem_t* pxNextItem );
+    void setPrev( rbItem_t* pxItem, const rbItem_t* pxPrevItem );
+    std::uint8_t* getHeadEnd( void );
+    std::size_t getFreeSpace( void );
     std::uint8_t* getNextPtr( const std::size_t xItemSize );
-    void pushItem( const void* pxHeader, const void* pxItem, const std::size_t xItemSize );
+    void evictTail( void );
+    std::uint8_t* getFreePtr( const std::size_t xItemSize );
+    void getSpans( const void* pxHeader, const std::size_t xItemSize, rbSpan_t* pxSpans );
+    void indexItem( const void* pxHeader, const std::size_t xItemIdx );
+#if ( RINGBUF_CFG_ITEM_TIMESTAMP == 1 )
+    const rbItem_t* findTime( const std::uint64_t ullTime, std::size_t* pxItemPos );
+#endif
+    void linkItem( const void* pxHeader, const std::size_t xItemSize, const rbSize_t xItemFlags );
+    void pushItem( const void* pxHeader, const void* pxItem, const std::size_t xItemSize, const rbSize_t xItemFlags );
+    bool isSample( const rbItem_t* pxItem );
+    bool decodeSample( const rbItem_t* pxItem, std::uint8_t* pcSample, std::uint8_t* pcWindow );
+    bool getPlainSpans( const rbItem_t* pxItem, rbConstSpan_t* pxSpans );
+    void updateImage( void );
+    bool recoverImage( void );
+    static bool isImageValid( const std::uint8_t* pcImage, const std::size_t xImageSize );
+    static std::size_t getImagePoolSize( const std::uint8_t* pcImage, const std::size_t xImageSize, const rbImageOpen_t eOpen );
+    static rbLayout_t getImageLayout( const std::uint8_t* pcImage, const std::size_t xImageSize, const rbImageOpen_t eOpen, const rbLayout_t eItemLayout );
 
   public:
 
-    ringbuf( std::uint8_t* pcPool, const std::size_t xPoolSize );
+    ringbuf( std::uint8_t* pcPool, const std::size_t xPoolSize, const rbLayout_t eItemLayout = RB_LAYOUT_SPLIT );
+
+    ringbuf( std::uint8_t* pcImage, const std::size_t xImageSize, const rbImageOpen_t eOpen, const rbLayout_t eItemLayout = RB_LAYOUT_SPLIT );
 
     //~ringbuf() {};
 
     void flush( void );
 
+    bool setOverflowPolicy( const rbOverflow_t eOverflowPolicy );
+
+    rbStats_t getStats( void );
+
+    bool setCompression( std::uint8_t* pcCodecBuf, const std::size_t xCodecBufSize );
+
+    bool setDelta( const rbField_t* pxFields, const std::size_t xFieldsCnt, const std::size_t xKeyInterval, std::uint8_t* pcDeltaBuf, const std::size_t xDeltaBufSize );
+
     bool push( const void* pxItem, const size_t xItemSize );
 
+    bool pushBatch( const rbConstSpan_t* pxItems, const std::size_t xItemsCnt );
+
+    bool pushDelta( const void* pxSample );
+
+    bool reserve( const std::size_t xItemSize, rbSpan_t* pxSpans );
+
+    bool commit( void );
+
+    void abort( void );
+
     bool isEmpty( void );
 
     bool deleteHead( void );
@@ -98,15 +457,75 @@ class ringbuf {
 
     bool getData( const rbItem_t* pxItem, std::uint8_t* pcDstBuf );
 
+    const std::size_t getDataSize( const rbItem_t* pxItem );
+
+    bool isCompressed( const rbItem_t* pxItem );
+
+    bool isDelta( const rbItem_t* pxItem );
+
+    std::size_t getSamples( const rbItem_t* pxFirst, const std::size_t xItemsCnt, std::uint8_t* pcDstBuf );
+
+    bool peek( const rbItem_t* pxItem, rbConstSpan_t* pxSpans );
+
+    bool consume( void );
+
+    std::size_t drain( rbDrainCallback_t pxCallback, void* pvContext, const std::size_t xMaxItems, const std::size_t xMaxBytes );
+
+    std::size_t scan( const void* pxPattern, const std::size_t xPatternSize, rbScanCallback_t pxCallback, void* pvContext );
+
+    std::size_t scan( rbScanPredicate_t pxPredicate, rbScanCallback_t pxCallback, void* pvContext );
+
     const std::size_t getHeadSize( void );
 
     const std::size_t getTailSize( void );
 
     const std::size_t getItemsCnt( void );
 
+    static std::uint8_t* mapMirroredPool( std::size_t* pxPoolSize );
+
+    static void unmapMirroredPool( std::uint8_t* pcPool, const std::size_t xPoolSize );
+
+    bool isRecovered( void );
+
+    bool syncImage( void );
+
+    static std::uint8_t* mapImage( const char* pcPath, std::size_t* pxImageSize );
+
+    static void unmapImage( std::uint8_t* pcImage, const std::size_t xImageSize );
+
     const rbItem_t* getHead( void );
 
     const rbItem_t* getTail( void );
+
+    const rbItem_t* getNext( const rbItem_t* pxItem );
+
+    const rbItem_t* getPrev( const rbItem_t* pxItem );
+
+    bool setIndex( std::uint32_t* pulIndexBuf, const std::size_t xIndexCnt );
+
+    const rbItem_t* getItem( const std::size_t xItemIdx );
+
+#if ( RINGBUF_CFG_ITEM_SEQUENCE == 1 )
+    const rbItem_t* getItemBySeq( const std::uint64_t ullSeq );
+
+    const std::uint64_t getSeq( const rbItem_t* pxItem );
+
+    const std::uint64_t getTailSeq( void );
+
+    const std::uint64_t getNextSeq( void );
+
+    bool getData( const rbItem_t* pxItem, const std::uint64_t ullSeq, std::uint8_t* pcDstBuf, const std::size_t xDstBufSize, std::size_t* pxItemSize );
+#endif
+
+#if ( RINGBUF_CFG_ITEM_TIMESTAMP == 1 )
+    void setClock( rbClock_t pxItemClock );
+
+    const std::uint64_t getTime( const rbItem_t* pxItem );
+
+    const rbItem_t* findByTime( const std::uint64_t ullTime );
+
+    bool rangeByTime( const std::uint64_t ullStartTime, const std::uint64_t ullEndTime, rbItemRange_t* pxRange );
+#endif
 };
 
 
@@ -0,0 +1,506 @@
+/**
+ * \file            ringbuf_bcast.cpp
+ * \brief           Lock-free single-writer/multi-reader broadcast ring buffer.
+ */
+
+/*
+ * Copyright (C) 2021 Giancarlo Marcolin
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without restriction,
+ * including without limitation the rights to use, copy, modify, merge,
+ * publish, distribute, sublicense, and/or sell copies of the Software,
+ * and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE
+ * AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * This file is part of ringbuf - Ring buffer for variable size elements.
+ *
+ * Author:          Giancarlo Marcolin <giancarlo.marcolin@gmail.com>
+ * Version:         v1.0.0
+ */
+
+/* Standard includes. */
+#include <cstring>
+
+/* Include API header. */
+#include "ringbuf_bcast.hpp"
+
+/**
+ * @brief Expected sequence number of a reader that did not read any item yet.
+ */
+
+static constexpr std::uint64_t ullSeqUnknown = UINT64_MAX;
+
+/*--------------------- Private methods ---------------------*/
+
+/**
+ * @brief Computes the space taken in the ring buffer by an item,
+ *        header included.
+ *
+ * @note Private method. Data is padded so that every header
+ *       starts at a multiple of the header size.
+ *
+ * @param[in] xItemSize Size [byte] of the item data.
+ * @param[out] Space [byte] taken by the item.
+ *
+ */
+
+std::size_t ringbuf_bcast::getItemSpan( const std::size_t xItemSize ) const
+{
+    const std::size_t xAlign = sizeof( rbBcastItem_t );
+
+    return sizeof( rbBcastItem_t ) + ( ( xItemSize + xAlign - 1 ) / xAlign ) * xAlign;
+}
+
+/**
+ * @brief Identifies the parts of the memory pool holding
+ *        the data of an item.
+ *
+ * @note Private method.
+ *
+ * @param[in] xPos Position of the item header.
+ * @param[in] xItemSize Size [byte] of the item data.
+ * @param[in] pxSpans Array of two spans filled with the data parts; the
+ *            second part has size zero unless data rolls over.
+ *
+ */
+
+void ringbuf_bcast::getSpans( const std::size_t xPos,
+                             const std::size_t xItemSize,
+                             rbSpan_t* pxSpans ) const
+{
+    const std::size_t xDataPos = ( xPos + sizeof( rbBcastItem_t ) ) % xBufSize;
+    const std::size_t xTopPartSize = xBufSize - xDataPos;
+
+    pxSpans[ 0 ].pcData = &pcBuf[ xDataPos ];
+    pxSpans[ 1 ].pcData = pcBuf;
+
+    if( xItemSize <= xTopPartSize )
+    {
+        pxSpans[ 0 ].xSize = xItemSize;
+        pxSpans[ 1 ].xSize = 0;
+    }
+    else
+    {
+        /* Data rolls over. */
+        pxSpans[ 0 ].xSize = xTopPartSize;
+        pxSpans[ 1 ].xSize = xItemSize - xTopPartSize;
+    }
+}
+
+/**
+ * @brief Gets the position of the reader that is the most behind.
+ *
+ * @note Private method, writer side.
+ *
+ * @param[out] Position of the slowest reader, the head when no reader
+ *             is registered.
+ *
+ */
+
+std::size_t ringbuf_bcast::getSlowestPos( void ) const
+{
+    std::size_t xSlowestPos = xHead.load( std::memory_order_relaxed );
+
+    /* Pairs with addReader(): a reader registered after the fence read
+     * a head not older than xSlowestPos. */
+    std::atomic_thread_fence( std::memory_order_seq_cst );
+
+    for( std::size_t i = 0; i < RINGBUF_CFG_BCAST_READERS; ++i )
+    {
+        const rbBcastReader_t* pxReader = apxReaders[ i ].load( std::memory_order_acquire );
+
+        if( pxReader != nullptr )
+        {
+            const std::size_t xPos = pxReader->xPos.load( std::memory_order_acquire );
+
+            if( xPos < xSlowestPos )
+            {
+                xSlowestPos = xPos;
+            }
+        }
+    }
+
+    return xSlowestPos;
+}
+
+/**
+ * @brief Moves the tail forward to make room for a new item.
+ *
+ * @note Private method, writer side. With RB_OVERFLOW_REJECT the tail
+ *       stops at the slowest reader. The tail is published before the
+ *       space is written: a reader checking it after copying an item
+ *       knows whether the copy can be trusted.
+ *
+ * @param[in] xMinTailPos Tail position needed by the new item.
+ * @param[out] New tail position.
+ *
+ */
+
+std::size_t ringbuf_bcast::reclaim( const std::size_t xMinTailPos )
+{
+    const std::size_t xSlowestPos = getSlowestPos();
+    const std::size_t xTailPos = xTail.load( std::memory_order_relaxed );
+
+    std::size_t xNewTailPos = xTailPos;
+
+    while(    ( xNewTailPos < xMinTailPos ) \
+           && ( ( eOverflow == RB_OVERFLOW_OVERWRITE ) || ( xNewTailPos < xSlowestPos ) )    )
+    {
+        rbBcastItem_t xItem;
+
+        std::memcpy( &xItem, &pcBuf[ xNewTailPos % xBufSize ], sizeof( rbBcastItem_t ) );
+
+        /* Some reader did not get the item. */
+        if( xNewTailPos >= xSlowestPos )
+        {
+            xEvictedItems.store( xEvictedItems.load( std::memory_order_relaxed ) + 1, std::memory_order_relaxed );
+            xEvictedBytes.store( xEvictedBytes.load( std::memory_order_relaxed ) + xItem.xItemSize, std::memory_order_relaxed );
+        }
+
+        xNewTailPos += getItemSpan( xItem.xItemSize );
+    }
+
+    if( xNewTailPos != xTailPos )
+    {
+        xTail.store( xNewTailPos, std::memory_order_relaxed );
+
+        /* Pairs with the fence of read(): the tail is visible before the new data. */
+        std::atomic_thread_fence( std::memory_order_release );
+    }
+
+    return xNewTailPos;
+}
+
+/*--------------------- Public methods ---------------------*/
+
+/**
+ * @brief Ring buffer constructor.
+ *
+ * @param[in] pcPool Pointer to the memory pool used by this ringbuf_bcast instance.
+ * @param[in] xPoolSize Size of the memory pool, rounded down to a multiple of
+ *            the item header size.
+ *
+ */
+
+ringbuf_bcast::ringbuf_bcast( std::uint8_t* pcPool,
+                              const std::size_t xPoolSize ) :
+                              pcBuf( pcPool ),
+                              xBufSize( xPoolSize - ( xPoolSize % sizeof( rbBcastItem_t ) ) ),
+                              xHead( 0 ),
+                              xTail( 0 ),
+                              ullNextSeq( 0 ),
+                              eOverflow( RB_OVERFLOW_OVERWRITE ),
+                              xEvictedItems( 0 ),
+                              xEvictedBytes( 0 ),
+                              xRejectedItems( 0 ),
+                              xRejectedBytes( 0 )
+{
+    for( std::size_t i = 0; i < RINGBUF_CFG_BCAST_READERS; ++i )
+    {
+        apxReaders[ i ].store( nullptr, std::memory_order_relaxed );
+    }
+
+    /* Reset buffer. */
+    std::memset( ( void* )pcBuf, 0, xBufSize );
+}
+
+/**
+ * @brief Selects what push() does when there is not enough space.
+ *
+ * @note Writer side. The writer never waits for the readers,
+ *       so RB_OVERFLOW_BLOCK is not supported.
+ *
+ * @param[in] eOverflowPolicy RB_OVERFLOW_OVERWRITE (default) to reuse the
+ *            space of the oldest items even if some reader did not get them,
+ *            RB_OVERFLOW_REJECT to fail the insertion instead.
+ * @param[out] True when the policy is supported.
+ *
+ */
+
+bool ringbuf_bcast::setOverflowPolicy( const rbOverflow_t eOverflowPolicy )
+{
+    bool isPolicySet = false;
+
+    if( eOverflowPolicy != RB_OVERFLOW_BLOCK )
+    {
+        eOverflow = eOverflowPolicy;
+
+        isPolicySet = true;
+    }
+
+    return isPolicySet;
+}
+
+/**
+ * @brief Inserts a new item in the ring buffer.
+ *
+ * @note Writer side.
+ *
+ * @param[in] pxItem Pointer to the item to insert.
+ * @param[in] xItemSize Size of the item to insert.
+ * @param[out] True when item successfully inserted.
+ *
+ */
+
+bool ringbuf_bcast::push( const void* pxItem,
+                          const std::size_t xItemSize )
+{
+    bool isItemPushed = false;
+
+    if(    ( xItemSize > 0 ) \
+        && ( xItemSize <= ( xBufSize - sizeof( rbBcastItem_t ) ) )    )
+    {
+        const std::size_t xHeadPos = xHead.load( std::memory_order_relaxed );
+        const std::size_t xItemSpan = getItemSpan( xItemSize );
+
+        std::size_t xTailPos = xTail.load( std::memory_order_relaxed );
+
+        if( ( xHeadPos + xItemSpan - xTailPos ) > xBufSize )
+        {
+            xTailPos = reclaim( xHeadPos + xItemSpan - xBufSize );
+        }
+
+        if( ( xHeadPos + xItemSpan - xTailPos ) <= xBufSize )
+        {
+            rbBcastItem_t xNewItem;
+            rbSpan_t axSpans[ 2 ];
+
+            xNewItem.ullSeq = ullNextSeq++;
+            xNewItem.xItemSize = xItemSize;
+
+            /* Copy item header, it never rolls over. */
+            std::memcpy( ( void* )&pcBuf[ xHeadPos % xBufSize ], &xNewItem, sizeof( rbBcastItem_t ) );
+
+            /* Copy data, in two parts on buffer roll-over. */
+            getSpans( xHeadPos, xItemSize, axSpans );
+
+            std::memcpy( axSpans[ 0 ].pcData, pxItem, axSpans[ 0 ].xSize );
+            std::memcpy( axSpans[ 1 ].pcData, ( const std::uint8_t* )pxItem + axSpans[ 0 ].xSize, axSpans[ 1 ].xSize );
+
+            /* Publish the item to the readers. */
+            xHead.store( xHeadPos + xItemSpan, std::memory_order_release );
+
+            isItemPushed = true;
+        }
+        else
+        {
+            xRejectedItems.store( xRejectedItems.load( std::memory_order_relaxed ) + 1, std::memory_order_relaxed );
+            xRejectedBytes.store( xRejectedBytes.load( std::memory_order_relaxed ) + xItemSize, std::memory_order_relaxed );
+        }
+    }
+
+    return isItemPushed;
+}
+
+/**
+ * @brief Registers a reader: from now on it gets every new item.
+ *
+ * @note Reader side. The reader starts from the next item pushed.
+ *       The slot is published with the cursor held at the tail, so the
+ *       writer cannot reclaim past it, and only then is the cursor moved
+ *       to the head: a head read before the slot is visible to the writer
+ *       could already be reclaimed.
+ *
+ * @param[in] pxReader Reader cursor, it must stay valid until removeReader().
+ * @param[out] True when registered, false when RINGBUF_CFG_BCAST_READERS
+ *             readers are registered already.
+ *
+ */
+
+bool ringbuf_bcast::addReader( rbBcastReader_t* pxReader )
+{
+    bool isReaderAdded = false;
+
+    pxReader->xPos.store( xTail.load( std::memory_order_relaxed ), std::memory_order_relaxed );
+    pxReader->ullSeq = ullSeqUnknown;
+    pxReader->ullLostItems = 0;
+
+    for( std::size_t i = 0; ( i < RINGBUF_CFG_BCAST_READERS ) && !isReaderAdded; ++i )
+    {
+        rbBcastReader_t* pxFree = nullptr;
+
+        isReaderAdded = apxReaders[ i ].compare_exchange_strong( pxFree, pxReader, std::memory_order_seq_cst );
+    }
+
+    if( isReaderAdded )
+    {
+        /* The writer sees the slot from now on: the head cannot be reclaimed. */
+        pxReader->xPos.store( xHead.load( std::memory_order_seq_cst ), std::memory_order_release );
+    }
+
+    return isReaderAdded;
+}
+
+/**
+ * @brief Unregisters a reader: the writer does not wait for it anymore.
+ *
+ * @note Reader side.
+ *
+ * @param[in] pxReader Reader cursor registered by addReader().
+ *
+ */
+
+void ringbuf_bcast::removeReader( rbBcastReader_t* pxReader )
+{
+    for( std::size_t i = 0; i < RINGBUF_CFG_BCAST_READERS; ++i )
+    {
+        rbBcastReader_t* pxRegistered = pxReader;
+
+        apxReaders[ i ].compare_exchange_strong( pxRegistered, nullptr, std::memory_order_acq_rel );
+    }
+}
+
+/**
+ * @brief Checks whether a reader got all the items pushed.
+ *
+ * @note Reader side.
+ *
+ * @param[in] pxReader Reader cursor.
+ * @param[out] True when there is no new item for the reader.
+ *
+ */
+
+bool ringbuf_bcast::isEmpty( const rbBcastReader_t* pxReader )
+{
+    return ( pxReader->xPos.load( std::memory_order_relaxed ) == xHead.load( std::memory_order_acquire ) );
+}
+
+/**
+ * @brief Copies the next item of a reader into the destination buffer
+ *        and moves the reader to the following item.
+ *
+ * @note Reader side. When the writer reused the space of the item while
+ *       it was being copied, the reader skips to the oldest item retained
+ *       and tries again; the items skipped are counted as lost.
+ *
+ * @param[in] pxReader Reader cursor.
+ * @param[in] pcDstBuf Destination buffer.
+ * @param[in] xDstBufSize Size [byte] of the destination buffer.
+ * @param[in] pxItemSize Filled with the size [byte] of the item data, zero
+ *            when there is no new item.
+ * @param[out] True when an item is copied, false when there is no new item
+ *             or when it does not fit in the destination buffer.
+ *
+ */
+
+bool ringbuf_bcast::read( rbBcastReader_t* pxReader,
+                          std::uint8_t* pcDstBuf,
+                          const std::size_t xDstBufSize,
+                          std::size_t* pxItemSize )
+{
+    bool isItemRead = false;
+    bool isLapped = true;
+
+    while( isLapped )
+    {
+        const std::size_t xPos = pxReader->xPos.load( std::memory_order_relaxed );
+
+        isLapped = false;
+        *pxItemSize = 0;
+
+        if( xPos != xHead.load( std::memory_order_acquire ) )
+        {
+            rbBcastItem_t xItem;
+            rbSpan_t axSpans[ 2 ];
+
+            std::memcpy( &xItem, &pcBuf[ xPos % xBufSize ], sizeof( rbBcastItem_t ) );
+
+            /* The header may be overwritten: keep the copy inside the buffers. */
+            const bool isItemFitting = ( xItem.xItemSize <= ( xBufSize - sizeof( rbBcastItem_t ) ) ) \
+                                    && ( xItem.xItemSize <= xDstBufSize );
+
+            if( isItemFitting )
+            {
+                getSpans( xPos, xItem.xItemSize, axSpans );
+
+                std::memcpy( pcDstBuf, axSpans[ 0 ].pcData, axSpans[ 0 ].xSize );
+                std::memcpy( pcDstBuf + axSpans[ 0 ].xSize, axSpans[ 1 ].pcData, axSpans[ 1 ].xSize );
+            }
+
+            /* Pairs with the fence of reclaim(): was the item reused while copying? */
+            std::atomic_thread_fence( std::memory_order_acquire );
+
+            const std::size_t xTailPos = xTail.load( std::memory_order_relaxed );
+
+            if( xPos < xTailPos )
+            {
+                pxReader->xPos.store( xTailPos, std::memory_order_release );
+
+                isLapped = true;
+            }
+            else
+            {
+                *pxItemSize = xItem.xItemSize;
+
+                if( isItemFitting )
+                {
+                    if( pxReader->ullSeq != ullSeqUnknown )
+                    {
+                        pxReader->ullLostItems += xItem.ullSeq - pxReader->ullSeq;
+                    }
+
+                    pxReader->ullSeq = xItem.ullSeq + 1;
+                    pxReader->xPos.store( xPos + getItemSpan( xItem.xItemSize ), std::memory_order_release );
+
+                    isItemRead = true;
+                }
+            }
+        }
+    }
+
+    return isItemRead;
+}
+
+/**
+ * @brief Gets the number of items a reader lost because the writer
+ *        reused their space before the reader got them.
+ *
+ * @note Reader side. Items lost before the first one read are not counted.
+ *
+ * @param[in] pxReader Reader cursor.
+ * @param[out] Items lost since the reader was registered.
+ *
+ */
+
+const std::uint64_t ringbuf_bcast::getLostItems( const rbBcastReader_t* pxReader )
+{
+    return pxReader->ullLostItems;
+}
+
+/**
+ * @brief Gets the number of items and bytes lost because of lack of space.
+ *
+ * @note Any side. Items are evicted when reused before every registered
+ *       reader got them, rejected when the writer had to drop them.
+ *
+ * @param[out] Counters since the ring buffer was created.
+ *
+ */
+
+rbStats_t ringbuf_bcast::getStats( void )
+{
+    rbStats_t xStats;
+
+    xStats.xEvictedItems = xEvictedItems.load( std::memory_order_relaxed );
+    xStats.xEvictedBytes = xEvictedBytes.load( std::memory_order_relaxed );
+    xStats.xRejectedItems = xRejectedItems.load( std::memory_order_relaxed );
+    xStats.xRejectedBytes = xRejectedBytes.load( std::memory_order_relaxed );
+
+    return xStats;
+}
+
+/*---------------------------------------------------------------------------*/
@@ -0,0 +1,150 @@
+/**
+ * \file            ringbuf_bcast.hpp
+ * \brief           Lock-free single-writer ring buffer broadcasting data
+ *                  of different size to many readers.
+ */
+
+/*
+ * Copyright (C) 2021 Giancarlo Marcolin
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without restriction,
+ * including without limitation the rights to use, copy, modify, merge,
+ * publish, distribute, sublicense, and/or sell copies of the Software,
+ * and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE
+ * AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * This file is part of ringbuf - Ring buffer for variable size elements.
+ *
+ * Author:          Giancarlo Marcolin <giancarlo.marcolin@gmail.com>
+ * Version:         v1.0.0
+ */
+
+#ifndef C_RING_BUF_BCAST_HPP
+#define C_RING_BUF_BCAST_HPP
+
+
+#include <atomic>
+#include <cstdint>
+#include <cstddef>
+
+#include "ringbuf.hpp"
+
+/**
+ * @brief Maximum number of readers registered at the same time
+ *        to a ringbuf_bcast.
+ */
+
+#ifndef RINGBUF_CFG_BCAST_READERS
+#define RINGBUF_CFG_BCAST_READERS   8U
+#endif
+
+/**
+ * @ingroup ringbuf_struct_types
+ * @brief Header stored in front of every item of a ringbuf_bcast.
+ */
+
+struct rbBcastItem {
+    std::uint64_t ullSeq;   /**< Sequence number of the item, from 0 on. */
+    std::size_t xItemSize;  /**< Size [byte] of the item data. */
+  };
+
+typedef struct rbBcastItem rbBcastItem_t;
+
+/**
+ * @ingroup ringbuf_struct_types
+ * @brief Cursor of a reader of a ringbuf_bcast, owned by the reader thread.
+ */
+
+struct rbBcastReader {
+    alignas( RINGBUF_CACHE_LINE_SIZE )
+    std::atomic<std::size_t> xPos;  /**< Position of the next item to read. */
+    std::uint64_t ullSeq;           /**< Sequence number expected for the next item. */
+    std::uint64_t ullLostItems;     /**< Items overwritten before this reader got them. */
+  };
+
+typedef struct rbBcastReader rbBcastReader_t;
+
+/**
+ * @class ringbuf_bcast
+ *
+ * @brief Ring buffer where one writer thread pushes items and every
+ *        registered reader thread gets all of them, through its own
+ *        cursor, without locks.
+ *
+ * @note With RB_OVERFLOW_REJECT the writer reuses only the space all the
+ *       readers went past, and push() fails otherwise. With
+ *       RB_OVERFLOW_OVERWRITE (default) the writer never waits: a reader
+ *       that is lapped notices it after copying, skips to the oldest item
+ *       retained and counts the items lost through their sequence numbers.
+ *
+ * @note The instance is over-aligned: allocate it statically, on the
+ *       stack or with an aligned allocator.
+ */
+
+class ringbuf_bcast {
+
+  private:
+    std::uint8_t* pcBuf;          /**< Pointer to the memory where the ringbuf_bcast instance is implemented. */
+    const std::size_t xBufSize;   /**< Size of the memory in [byte], multiple of the item header size. */
+
+    /* Writer cache line. */
+    alignas( RINGBUF_CACHE_LINE_SIZE )
+    std::atomic<std::size_t> xHead;             /**< Bytes written so far. */
+    std::atomic<std::size_t> xTail;             /**< Bytes reused so far: position of the oldest item retained. */
+    std::uint64_t ullNextSeq;                   /**< Sequence number of the next item. */
+    rbOverflow_t eOverflow;                     /**< Behaviour when there is not enough space. */
+    std::atomic<std::size_t> xEvictedItems;     /**< Items reused before every reader got them. */
+    std::atomic<std::size_t> xEvictedBytes;     /**< Data [byte] of the items evicted. */
+    std::atomic<std::size_t> xRejectedItems;    /**< New items not inserted. */
+    std::atomic<std::size_t> xRejectedBytes;    /**< Data [byte] of the new items not inserted. */
+
+    /* Readers registry. */
+    alignas( RINGBUF_CACHE_LINE_SIZE )
+    std::atomic<rbBcastReader_t*> apxReaders[ RINGBUF_CFG_BCAST_READERS ];  /**< Registered readers, nullptr when free. */
+
+    /* Private methods. */
+    std::size_t getItemSpan( const std::size_t xItemSize ) const;
+    void getSpans( const std::size_t xPos, const std::size_t xItemSize, rbSpan_t* pxSpans ) const;
+    std::size_t getSlowestPos( void ) const;
+    std::size_t reclaim( const std::size_t xMinTailPos );
+
+  public:
+
+    ringbuf_bcast( std::uint8_t* pcPool, const std::size_t xPoolSize );
+
+    /* Writer side. */
+    bool setOverflowPolicy( const rbOverflow_t eOverflowPolicy );
+
+    bool push( const void* pxItem, const std::size_t xItemSize );
+
+    /* Reader side. */
+    bool addReader( rbBcastReader_t* pxReader );
+
+    void removeReader( rbBcastReader_t* pxReader );
+
+    bool isEmpty( const rbBcastReader_t* pxReader );
+
+    bool read( rbBcastReader_t* pxReader, std::uint8_t* pcDstBuf, const std::size_t xDstBufSize, std::size_t* pxItemSize );
+
+    const std::uint64_t getLostItems( const rbBcastReader_t* pxReader );
+
+    /* Any side. */
+    rbStats_t getStats( void );
+};
+
+
+#endif //C_RING_BUF_BCAST_HPP
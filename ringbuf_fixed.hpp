@@ -0,0 +1,792 @@
+/**
+ * \file            ringbuf_fixed.hpp
+ * \brief           Ring buffer of items of the same compile-time size.
+ */
+
+/*
+ * Copyright (C) 2021 Giancarlo Marcolin
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without restriction,
+ * including without limitation the rights to use, copy, modify, merge,
+ * publish, distribute, sublicense, and/or sell copies of the Software,
+ * and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE
+ * AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * This file is part of ringbuf - Ring buffer for variable size elements.
+ *
+ * Author:          Giancarlo Marcolin <giancarlo.marcolin@gmail.com>
+ * Version:         v1.0.0
+ */
+
+
+#ifndef C_RING_BUF_FIXED_HPP
+#define C_RING_BUF_FIXED_HPP
+
+
+#include <cstdint>
+#include <cstddef>
+#include <cstring>
+#include <type_traits>
+
+#include "ringbuf.hpp"
+
+/**
+ * @class ringbuf_fixed
+ *
+ * @brief Ring buffer storing items of type T, with the same API as ringbuf.
+ *
+ * @note The item size is known at compile time, so no header is stored
+ *       with the items and data is copied by inlined fixed-size copies.
+ *       The number of slots is the largest power of two fitting in the
+ *       memory pool, so the position of an item is found with a mask.
+ *       Items never roll over the end of the pool: the second span of
+ *       peek() and reserve() is always empty.
+ *
+ * @note Pointers to items (getHead(), getNext() ...) point to the slots
+ *       of the memory pool; a slot is reused once its item is deleted.
+ */
+
+template< typename T >
+class ringbuf_fixed {
+
+    static_assert( std::is_trivially_copyable<T>::value, "ringbuf_fixed items shall be trivially copyable." );
+
+  private:
+    T* pxBuf;                     /**< First slot of the memory pool, aligned for T. */
+    std::size_t xSlotsCnt;        /**< Number of slots, a power of two or zero. */
+    std::size_t xMask;            /**< Mask turning an index into a slot position. */
+    rbOverflow_t eOverflow;       /**< Behaviour when there is not enough space. */
+    rbStats_t xStats;             /**< Counters of data lost because of lack of space. */
+
+    std::size_t xHead;            /**< Index of the next item inserted, it only grows. */
+    std::size_t xTail;            /**< Index of the oldest item retained, it only grows. */
+
+    bool isReserved;              /**< True while an item is reserved and not committed yet. */
+
+    std::size_t getIndex( const T* pxItem ) const;
+    bool isItemValid( const T* pxItem ) const;
+    T* getFreeSlot( void );
+
+  public:
+
+    ringbuf_fixed( std::uint8_t* pcPool, const std::size_t xPoolSize );
+
+    void flush( void );
+
+    bool setOverflowPolicy( const rbOverflow_t eOverflowPolicy );
+
+    rbStats_t getStats( void );
+
+    bool push( const void* pxItem, const std::size_t xItemSize );
+
+    bool push( const T& xItem );
+
+    bool pushBatch( const rbConstSpan_t* pxItems, const std::size_t xItemsCnt );
+
+    bool reserve( const std::size_t xItemSize, rbSpan_t* pxSpans );
+
+    bool commit( void );
+
+    void abort( void );
+
+    bool isEmpty( void );
+
+    bool deleteHead( void );
+
+    bool deleteTail( void );
+
+    bool getData( const T* pxItem, std::uint8_t* pcDstBuf );
+
+    bool peek( const T* pxItem, rbConstSpan_t* pxSpans );
+
+    bool consume( void );
+
+    std::size_t drain( rbDrainCallback_t pxCallback, void* pvContext, const std::size_t xMaxItems, const std::size_t xMaxBytes );
+
+    const std::size_t getHeadSize( void );
+
+    const std::size_t getTailSize( void );
+
+    const std::size_t getItemsCnt( void );
+
+    const std::size_t getCapacity( void );
+
+    const T* getHead( void );
+
+    const T* getTail( void );
+
+    const T* getNext( const T* pxItem );
+
+    const T* getPrev( const T* pxItem );
+};
+
+/*--------------------- Private methods ---------------------*/
+
+/**
+ * @brief Gets the index of the item held by a slot.
+ *
+ * @note Private method. The slot shall belong to the memory pool.
+ *
+ * @param[in] pxItem Pointer to a slot of the memory pool.
+ * @param[out] Index of the item, between the tail and the head index.
+ *
+ */
+
+template< typename T >
+std::size_t ringbuf_fixed<T>::getIndex( const T* pxItem ) const
+{
+    return xTail + ( ( ( std::size_t )( pxItem - pxBuf ) - xTail ) & xMask );
+}
+
+/**
+ * @brief Checks that a pointer refers to an item present in the buffer.
+ *
+ * @note Private method.
+ *
+ * @param[in] pxItem Pointer to check.
+ * @param[out] True when the slot pointed holds an item.
+ *
+ */
+
+template< typename T >
+bool ringbuf_fixed<T>::isItemValid( const T* pxItem ) const
+{
+    return    ( pxItem >= pxBuf ) \
+           && ( pxItem < ( pxBuf + xSlotsCnt ) ) \
+           && ( getIndex( pxItem ) < xHead );
+}
+
+/**
+ * @brief Gets the slot where the next item shall be written,
+ *        deleting the oldest item if all slots are in use.
+ *
+ * @note Private method.
+ *
+ * @param[out] Pointer to the slot, nullptr when the item is rejected.
+ *
+ */
+
+template< typename T >
+T* ringbuf_fixed<T>::getFreeSlot( void )
+{
+    T* pxSlot = nullptr;
+
+    if( ( xHead - xTail ) == xSlotsCnt )
+    {
+        if( ( eOverflow == RB_OVERFLOW_OVERWRITE ) && ( xSlotsCnt > 0 ) )
+        {
+            ++xTail;
+
+            ++xStats.xEvictedItems;
+            xStats.xEvictedBytes += sizeof( T );
+        }
+        else
+        {
+            ++xStats.xRejectedItems;
+            xStats.xRejectedBytes += sizeof( T );
+        }
+    }
+
+    if( ( xHead - xTail ) < xSlotsCnt )
+    {
+        pxSlot = &pxBuf[ xHead & xMask ];
+    }
+
+    return pxSlot;
+}
+
+/*--------------------- Public methods ---------------------*/
+
+/**
+ * @brief Creates a ring buffer of items of type T in the memory pool.
+ *
+ * @note The start of the pool is skipped if not aligned for T. The pool
+ *       memory not filling a power of two of slots is not used.
+ *
+ * @param[in] pcPool Pointer to the memory pool.
+ * @param[in] xPoolSize Size [byte] of the memory pool.
+ *
+ */
+
+template< typename T >
+ringbuf_fixed<T>::ringbuf_fixed( std::uint8_t* pcPool, 
+                                 const std::size_t xPoolSize ) : 
+                                 pxBuf( nullptr ), 
+                                 xSlotsCnt( 0 ), 
+                                 xMask( 0 ), 
+                                 eOverflow( RB_OVERFLOW_OVERWRITE ), 
+                                 xStats(), 
+                                 xHead( 0 ), 
+                                 xTail( 0 ), 
+                                 isReserved( false )
+{
+    const std::size_t xPad = ( std::size_t )( -( std::uintptr_t )pcPool ) & ( alignof( T ) - 1 );
+
+    if( ( pcPool != nullptr ) && ( xPoolSize >= ( xPad + sizeof( T ) ) ) )
+    {
+        const std::size_t xFitCnt = ( xPoolSize - xPad ) / sizeof( T );
+
+        pxBuf = ( T* )( pcPool + xPad );
+
+        /* Largest power of two not above the number of slots fitting. */
+        xSlotsCnt = 1;
+
+        while( ( xSlotsCnt << 1 ) <= xFitCnt )
+        {
+            xSlotsCnt <<= 1;
+        }
+
+        xMask = xSlotsCnt - 1;
+    }
+}
+
+/**
+ * @brief Deletes all the elements of the ring buffer.
+ *
+ */
+
+template< typename T >
+void ringbuf_fixed<T>::flush( void ) 
+{
+    xHead = 0;
+    xTail = 0;
+
+    isReserved = false;
+}
+
+/**
+ * @brief Selects what push() does when all slots are in use.
+ *
+ * @note RB_OVERFLOW_BLOCK needs a concurrent consumer and is not
+ *       supported by this class.
+ *
+ * @param[in] eOverflowPolicy RB_OVERFLOW_OVERWRITE (default) to delete
+ *            the oldest item, RB_OVERFLOW_REJECT to fail the insertion.
+ * @param[out] True when the policy is supported.
+ *
+ */
+
+template< typename T >
+bool ringbuf_fixed<T>::setOverflowPolicy( const rbOverflow_t eOverflowPolicy ) 
+{
+    bool isPolicySet = false;
+
+    if( eOverflowPolicy != RB_OVERFLOW_BLOCK )
+    {
+        eOverflow = eOverflowPolicy;
+
+        isPolicySet = true;
+    }
+
+    return isPolicySet;
+}
+
+/**
+ * @brief Gets the number of items and bytes lost because of lack of space.
+ *
+ * @param[out] Counters since the ring buffer was created.
+ *
+ */
+
+template< typename T >
+rbStats_t ringbuf_fixed<T>::getStats( void ) 
+{
+    return xStats;
+}
+
+/**
+ * @brief Inserts a new item in the ring buffer.
+ *
+ * @param[in] pxItem Pointer to the item data.
+ * @param[in] xItemSize Size of the item data, shall be sizeof( T ).
+ * @param[out] True when item successfully inserted.
+ *
+ */
+
+template< typename T >
+bool ringbuf_fixed<T>::push( const void* pxItem, 
+                             const std::size_t xItemSize ) 
+{
+    bool isItemPushed = false;
+
+    if( ( xItemSize == sizeof( T ) ) && ( isReserved == false ) )
+    {
+        T* pxSlot = getFreeSlot();
+
+        if( pxSlot != nullptr )
+        {
+            std::memcpy( pxSlot, pxItem, sizeof( T ) );
+
+            ++xHead;
+
+            isItemPushed = true;
+        }
+    }
+
+    return isItemPushed;
+}
+
+/**
+ * @brief Inserts a new item in the ring buffer.
+ *
+ * @param[in] xItem Item to insert.
+ * @param[out] True when item successfully inserted.
+ *
+ */
+
+template< typename T >
+bool ringbuf_fixed<T>::push( const T& xItem ) 
+{
+    return push( &xItem, sizeof( T ) );
+}
+
+/**
+ * @brief Inserts several new items in the ring buffer at once.
+ *
+ * @note Either all items are inserted or none.
+ *
+ * @param[in] pxItems Array of spans pointing to the items to insert, in order,
+ *            each of sizeof( T ) bytes.
+ * @param[in] xItemsCnt Number of items to insert, not more than the slots.
+ * @param[out] True when all items successfully inserted.
+ *
+ */
+
+template< typename T >
+bool ringbuf_fixed<T>::pushBatch( const rbConstSpan_t* pxItems, 
+                                  const std::size_t xItemsCnt ) 
+{
+    bool isBatchPushed = false;
+    bool isBatchValid =    ( xItemsCnt > 0 ) \
+                        && ( xItemsCnt <= xSlotsCnt ) \
+                        && ( isReserved == false );
+
+    for( std::size_t i = 0; ( i < xItemsCnt ) && isBatchValid; ++i )
+    {
+        isBatchValid = ( pxItems[ i ].xSize == sizeof( T ) );
+    }
+
+    if(    isBatchValid \
+        && ( eOverflow == RB_OVERFLOW_REJECT ) \
+        && ( ( xSlotsCnt - ( xHead - xTail ) ) < xItemsCnt )    )
+    {
+        /* Old items shall not be removed. */
+        isBatchValid = false;
+
+        xStats.xRejectedItems += xItemsCnt;
+        xStats.xRejectedBytes += xItemsCnt * sizeof( T );
+    }
+
+    if( isBatchValid )
+    {
+        /* Remove old items if slots are not enough. */
+        const std::size_t xFreeCnt = xSlotsCnt - ( xHead - xTail );
+
+        if( xFreeCnt < xItemsCnt )
+        {
+            xTail += xItemsCnt - xFreeCnt;
+
+            xStats.xEvictedItems += xItemsCnt - xFreeCnt;
+            xStats.xEvictedBytes += ( xItemsCnt - xFreeCnt ) * sizeof( T );
+        }
+
+        for( std::size_t i = 0; i < xItemsCnt; ++i )
+        {
+            std::memcpy( &pxBuf[ ( xHead + i ) & xMask ], pxItems[ i ].pcData, sizeof( T ) );
+        }
+
+        xHead += xItemsCnt;
+
+        isBatchPushed = true;
+    }
+
+    return isBatchPushed;
+}
+
+/**
+ * @brief Reserves a slot for a new item, so that its data can be
+ *        written in place instead of being copied by push().
+ *
+ * @note The oldest item is deleted if all slots are in use and the overflow
+ *       policy allows it, even if the reservation is aborted later. Until
+ *       commit() or abort() the ring buffer shall not be modified and push() fails.
+ *
+ * @param[in] xItemSize Size of the item to reserve, shall be sizeof( T ).
+ * @param[in] pxSpans Array of two spans filled with the writable parts
+ *            of the item data; the second part has always size zero.
+ * @param[out] True when space successfully reserved.
+ *
+ */
+
+template< typename T >
+bool ringbuf_fixed<T>::reserve( const std::size_t xItemSize, 
+                                rbSpan_t* pxSpans ) 
+{
+    bool isItemReserved = false;
+
+    if( ( xItemSize == sizeof( T ) ) && ( isReserved == false ) )
+    {
+        T* pxSlot = getFreeSlot();
+
+        if( pxSlot != nullptr )
+        {
+            pxSpans[ 0 ].pcData = ( std::uint8_t* )pxSlot;
+            pxSpans[ 0 ].xSize  = sizeof( T );
+            pxSpans[ 1 ].pcData = nullptr;
+            pxSpans[ 1 ].xSize  = 0;
+
+            isReserved = true;
+
+            isItemReserved = true;
+        }
+    }
+
+    return isItemReserved;
+}
+
+/**
+ * @brief Inserts the reserved item in the ring buffer as new head.
+ *
+ * @param[out] True when an item was reserved and is now inserted.
+ *
+ */
+
+template< typename T >
+bool ringbuf_fixed<T>::commit( void ) 
+{
+    bool isItemCommitted = false;
+
+    if( isReserved )
+    {
+        ++xHead;
+
+        isReserved = false;
+
+        isItemCommitted = true;
+    }
+
+    return isItemCommitted;
+}
+
+/**
+ * @brief Discards the reserved item.
+ *
+ */
+
+template< typename T >
+void ringbuf_fixed<T>::abort( void ) 
+{
+    isReserved = false;
+}
+
+/**
+ * @brief Checks whether the ring buffer is empty.
+ *
+ * @param[out] True when empty.
+ *
+ */
+
+template< typename T >
+bool ringbuf_fixed<T>::isEmpty( void ) 
+{
+    return ( xHead == xTail );
+}
+
+/**
+ * @brief Deletes the head (most recent item) of the ring buffer.
+ *
+ * @param[out] True when the head is successfully deleted.
+ *
+ */
+
+template< typename T >
+bool ringbuf_fixed<T>::deleteHead( void ) 
+{
+    bool isHeadDeleted = false;
+
+    if( ( xHead != xTail ) && ( isReserved == false ) )
+    {
+        --xHead;
+
+        isHeadDeleted = true;
+    }
+
+    return isHeadDeleted;
+}
+
+/**
+ * @brief Deletes the tail (oldest item) of the ring buffer.
+ *
+ * @param[out] True when the tail is successfully deleted.
+ *
+ */
+
+template< typename T >
+bool ringbuf_fixed<T>::deleteTail( void ) 
+{
+    bool isTailDeleted = false;
+
+    if( xHead != xTail )
+    {
+        ++xTail;
+
+        isTailDeleted = true;
+    }
+
+    return isTailDeleted;
+}
+
+/**
+ * @brief Copies data of the specified item into the destination buffer.
+ *
+ * @param[in] pxItem Pointer to the item to retrieve.
+ * @param[in] pcDstBuf Destination buffer where data is copied,
+ *            at least sizeof( T ) bytes.
+ * @param[out] True when data successfully copied.
+ *
+ */
+
+template< typename T >
+bool ringbuf_fixed<T>::getData( const T* pxItem, 
+                                std::uint8_t* pcDstBuf )
+{
+    bool isDataCopied = false;
+
+    if( isItemValid( pxItem ) )
+    { 
+        std::memcpy( pcDstBuf, pxItem, sizeof( T ) );
+
+        isDataCopied = true;
+    }
+
+    return isDataCopied;
+}
+
+/**
+ * @brief Gets the part of the memory pool holding data of the specified item,
+ *        so that it can be accessed in place instead of being copied.
+ *
+ * @note Spans stay valid until the item is deleted or overwritten.
+ *
+ * @param[in] pxItem Pointer to the item to access.
+ * @param[in] pxSpans Array of two spans filled with the read-only parts of
+ *            the item data; the second part has always size zero.
+ * @param[out] True when the item holds data.
+ *
+ */
+
+template< typename T >
+bool ringbuf_fixed<T>::peek( const T* pxItem, 
+                             rbConstSpan_t* pxSpans )
+{
+    bool isDataPeeked = false;
+
+    if( isItemValid( pxItem ) )
+    { 
+        pxSpans[ 0 ].pcData = ( const std::uint8_t* )pxItem;
+        pxSpans[ 0 ].xSize  = sizeof( T );
+        pxSpans[ 1 ].pcData = nullptr;
+        pxSpans[ 1 ].xSize  = 0;
+
+        isDataPeeked = true;
+    }
+
+    return isDataPeeked;
+}
+
+/**
+ * @brief Releases the tail (oldest item) of the ring buffer
+ *        once its data, accessed by peek(), is not needed anymore.
+ *
+ * @param[out] True when the tail is successfully released.
+ *
+ */
+
+template< typename T >
+bool ringbuf_fixed<T>::consume( void ) 
+{
+    return deleteTail();
+}
+
+/**
+ * @brief Hands the data of the oldest items to a callback and then removes
+ *        all of them with a single tail update.
+ *
+ * @param[in] pxCallback Function called for each item, from the tail on.
+ * @param[in] pvContext User context passed to the callback.
+ * @param[in] xMaxItems Maximum number of items to remove.
+ * @param[in] xMaxBytes Maximum amount of data [byte] to remove; the item
+ *            that would exceed it is not handed out.
+ * @param[out] Number of items removed.
+ *
+ */
+
+template< typename T >
+std::size_t ringbuf_fixed<T>::drain( rbDrainCallback_t pxCallback, 
+                                     void* pvContext, 
+                                     const std::size_t xMaxItems, 
+                                     const std::size_t xMaxBytes )
+{
+    std::size_t xDrainedCnt = 0;
+    bool isDraining = true;
+
+    rbConstSpan_t axSpans[ 2 ] = { { nullptr, 0 }, { nullptr, 0 } };
+
+    while(    isDraining \
+           && ( xDrainedCnt < ( xHead - xTail ) ) \
+           && ( xDrainedCnt < xMaxItems ) \
+           && ( ( ( xDrainedCnt + 1 ) * sizeof( T ) ) <= xMaxBytes )    )
+    {
+        axSpans[ 0 ].pcData = ( const std::uint8_t* )&pxBuf[ ( xTail + xDrainedCnt ) & xMask ];
+        axSpans[ 0 ].xSize  = sizeof( T );
+
+        isDraining = pxCallback( axSpans, pvContext );
+
+        if( isDraining )
+        {
+            ++xDrainedCnt;
+        }
+    }
+
+    /* Remove all drained items at once. */
+    xTail += xDrainedCnt;
+
+    return xDrainedCnt;
+}
+
+/**
+ * @brief Gets the size of data in the head of the ring buffer.
+ *
+ * @param[out] Head size, zero when empty.
+ *
+ */
+
+template< typename T >
+const std::size_t ringbuf_fixed<T>::getHeadSize( void ) 
+{
+    return ( xHead != xTail ) ? sizeof( T ) : 0;
+}
+
+/**
+ * @brief Gets the size of data in the tail of the ring buffer.
+ *
+ * @param[out] Tail size, zero when empty.
+ *
+ */
+
+template< typename T >
+const std::size_t ringbuf_fixed<T>::getTailSize( void ) 
+{
+    return ( xHead != xTail ) ? sizeof( T ) : 0;
+}
+
+/**
+ * @brief Gets the number of items present in the ring buffer.
+ *
+ * @param[out] Items count.
+ *
+ */
+
+template< typename T >
+const std::size_t ringbuf_fixed<T>::getItemsCnt( void ) 
+{
+    return xHead - xTail;
+}
+
+/**
+ * @brief Gets the number of slots of the ring buffer.
+ *
+ * @param[out] Maximum number of items, a power of two or zero.
+ *
+ */
+
+template< typename T >
+const std::size_t ringbuf_fixed<T>::getCapacity( void ) 
+{
+    return xSlotsCnt;
+}
+
+/**
+ * @brief Returns a pointer to the head of the ring buffer.
+ *
+ * @note When empty it points to a slot not holding an item.
+ *
+ * @param[out] pointer to head
+ *
+ */
+
+template< typename T >
+const T* ringbuf_fixed<T>::getHead( void ) 
+{
+    return &pxBuf[ ( xHead - ( ( xHead != xTail ) ? 1 : 0 ) ) & xMask ];
+}
+
+/**
+ * @brief Returns a pointer to the tail of the ring buffer.
+ *
+ * @note When empty it points to a slot not holding an item.
+ *
+ * @param[out] pointer to tail
+ *
+ */
+
+template< typename T >
+const T* ringbuf_fixed<T>::getTail( void ) 
+{
+    return &pxBuf[ xTail & xMask ];
+}
+
+/**
+ * @brief Returns a pointer to the item following the specified one.
+ *
+ * @note The head is followed by itself.
+ *
+ * @param[in] pxItem Pointer to an item of this ring buffer.
+ * @param[out] Pointer to the next item.
+ *
+ */
+
+template< typename T >
+const T* ringbuf_fixed<T>::getNext( const T* pxItem ) 
+{
+    const std::size_t xIndex = getIndex( pxItem ) + 1;
+
+    return ( xIndex < xHead ) ? &pxBuf[ xIndex & xMask ] : pxItem;
+}
+
+/**
+ * @brief Returns a pointer to the item preceding the specified one.
+ *
+ * @note The tail is preceded by itself.
+ *
+ * @param[in] pxItem Pointer to an item of this ring buffer.
+ * @param[out] Pointer to the previous item.
+ *
+ */
+
+template< typename T >
+const T* ringbuf_fixed<T>::getPrev( const T* pxItem ) 
+{
+    const std::size_t xIndex = getIndex( pxItem );
+
+    return ( xIndex != xTail ) ? &pxBuf[ ( xIndex - 1 ) & xMask ] : pxItem;
+}
+
+/*---------------------------------------------------------------------------*/
+
+
+#endif //C_RING_BUF_FIXED_HPP
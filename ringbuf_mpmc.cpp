@@ -0,0 +1,523 @@
+/**
+ * \file            ringbuf_mpmc.cpp
+ * \brief           Lock-free multi-producer/multi-consumer ring buffer.
+ */
+
+/*
+ * Copyright (C) 2021 Giancarlo Marcolin
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without restriction,
+ * including without limitation the rights to use, copy, modify, merge,
+ * publish, distribute, sublicense, and/or sell copies of the Software,
+ * and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE
+ * AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * This file is part of ringbuf - Ring buffer for variable size elements.
+ *
+ * Author:          Giancarlo Marcolin <giancarlo.marcolin@gmail.com>
+ * Version:         v1.0.0
+ */
+
+/* Standard includes. */
+#include <cstring>
+
+/* Include API header. */
+#include "ringbuf_mpmc.hpp"
+
+static_assert( sizeof( rbMpmcItem_t ) == sizeof( std::size_t ), "Item header must be a single word." );
+
+/**
+ * @brief Computes the bytes skipped at the start of a memory pool
+ *        not aligned for the item headers.
+ *
+ * @param[in] pcPool Pointer to the memory pool.
+ * @param[out] Bytes skipped.
+ *
+ */
+
+static std::size_t getPoolPad( const std::uint8_t* pcPool )
+{
+    return ( std::size_t )( -( std::uintptr_t )pcPool ) & ( alignof( rbMpmcItem_t ) - 1 );
+}
+
+/**
+ * @brief Computes the size of the memory pool used: the aligned part,
+ *        rounded down to a multiple of the item header size.
+ *
+ * @param[in] pcPool Pointer to the memory pool.
+ * @param[in] xPoolSize Size [byte] of the memory pool.
+ * @param[out] Size [byte] used.
+ *
+ */
+
+static std::size_t getPoolSize( const std::uint8_t* pcPool,
+                                const std::size_t xPoolSize )
+{
+    const std::size_t xPad = getPoolPad( pcPool );
+
+    std::size_t xSize = 0;
+
+    if( xPoolSize > xPad )
+    {
+        xSize = ( xPoolSize - xPad ) - ( ( xPoolSize - xPad ) % sizeof( rbMpmcItem_t ) );
+    }
+
+    return xSize;
+}
+
+/**
+ * @brief Flags of the item header state, the data size is stored above them.
+ */
+
+static constexpr std::size_t xStateCommitted = 1U;  /**< Data written, the item can be claimed. */
+static constexpr std::size_t xStateReleased = 2U;   /**< Consumer done, the space can be reclaimed. */
+static constexpr std::size_t xStateFlagsBits = 2U;
+
+/*--------------------- Private methods ---------------------*/
+
+/**
+ * @brief Computes the space taken in the ring buffer by an item,
+ *        header included.
+ *
+ * @note Private method. Data is padded so that every header
+ *       starts at a multiple of the header size.
+ *
+ * @param[in] xItemSize Size [byte] of the item data.
+ * @param[out] Space [byte] taken by the item.
+ *
+ */
+
+std::size_t ringbuf_mpmc::getItemSpan( const std::size_t xItemSize ) const
+{
+    const std::size_t xAlign = sizeof( rbMpmcItem_t );
+
+    return sizeof( rbMpmcItem_t ) + ( ( xItemSize + xAlign - 1 ) / xAlign ) * xAlign;
+}
+
+/**
+ * @brief Gets the header of the item at a given position.
+ *
+ * @note Private method.
+ *
+ * @param[in] xPos Position of the item (byte counter, not rolled over).
+ * @param[out] Pointer to the header, it never rolls over.
+ *
+ */
+
+rbMpmcItem_t* ringbuf_mpmc::getHeader( const std::size_t xPos ) const
+{
+    return ( rbMpmcItem_t* )&pcBuf[ xPos % xBufSize ];
+}
+
+/**
+ * @brief Identifies the parts of the memory pool holding
+ *        the data of an item.
+ *
+ * @note Private method.
+ *
+ * @param[in] xPos Position of the item header.
+ * @param[in] xItemSize Size [byte] of the item data.
+ * @param[in] pxSpans Array of two spans filled with the data parts; the
+ *            second part has size zero unless data rolls over.
+ *
+ */
+
+void ringbuf_mpmc::getSpans( const std::size_t xPos,
+                             const std::size_t xItemSize,
+                             rbSpan_t* pxSpans ) const
+{
+    const std::size_t xDataPos = ( xPos + sizeof( rbMpmcItem_t ) ) % xBufSize;
+    const std::size_t xTopPartSize = xBufSize - xDataPos;
+
+    pxSpans[ 0 ].pcData = &pcBuf[ xDataPos ];
+    pxSpans[ 1 ].pcData = pcBuf;
+
+    if( xItemSize <= xTopPartSize )
+    {
+        pxSpans[ 0 ].xSize = xItemSize;
+        pxSpans[ 1 ].xSize = 0;
+    }
+    else
+    {
+        /* Data rolls over. */
+        pxSpans[ 0 ].xSize = xTopPartSize;
+        pxSpans[ 1 ].xSize = xItemSize - xTopPartSize;
+    }
+}
+
+/**
+ * @brief Checks whether an item fits between head and tail.
+ *
+ * @note Private method. A tail newer than the head means the head was
+ *       read before other items were claimed and released: the room is
+ *       then checked again after the head is re-read.
+ *
+ * @param[in] xHeadPos Head position.
+ * @param[in] xTailPos Tail position.
+ * @param[in] xItemSpan Space [byte] needed by the item.
+ * @param[out] True when the item fits.
+ *
+ */
+
+bool ringbuf_mpmc::hasRoom( const std::size_t xHeadPos,
+                            const std::size_t xTailPos,
+                            const std::size_t xItemSpan ) const
+{
+    const std::size_t xUsedSize = ( xHeadPos > xTailPos ) ? ( xHeadPos - xTailPos ) : 0;
+
+    return ( ( xUsedSize + xItemSpan ) <= xBufSize );
+}
+
+/**
+ * @brief Claims space for a new item at the head.
+ *
+ * @note Private method, producers side. Space is claimed by a
+ *       compare-and-swap rather than a fetch-add: the head never
+ *       moves past space the consumers did not release yet.
+ *
+ * @param[in] xItemSpan Space [byte] needed by the item.
+ * @param[in] pxPos Filled with the position of the space claimed.
+ * @param[out] True when the space is claimed, false when full.
+ *
+ */
+
+bool ringbuf_mpmc::claimSpace( const std::size_t xItemSpan,
+                               std::size_t* pxPos )
+{
+    bool isClaimed = false;
+    bool isFull = false;
+
+    std::size_t xHeadPos = xHead.load( std::memory_order_relaxed );
+
+    while( !isClaimed && !isFull )
+    {
+        std::size_t xTailPos = xTailCache.load( std::memory_order_acquire );
+
+        /* Refresh the tail only when the cached one shows no room. */
+        if( !hasRoom( xHeadPos, xTailPos, xItemSpan ) )
+        {
+            xTailPos = xTail.load( std::memory_order_acquire );
+            xTailCache.store( xTailPos, std::memory_order_release );
+
+            isFull = !hasRoom( xHeadPos, xTailPos, xItemSpan );
+        }
+
+        if( !isFull )
+        {
+            /* Release: consumers seeing the new head also see the space cleared. */
+            isClaimed = xHead.compare_exchange_weak( xHeadPos, xHeadPos + xItemSpan,
+                                                     std::memory_order_acq_rel, std::memory_order_relaxed );
+        }
+    }
+
+    *pxPos = xHeadPos;
+
+    return isClaimed;
+}
+
+/**
+ * @brief Checks whether the item at a given position was released
+ *        by its consumer.
+ *
+ * @note Private method, consumers side.
+ *
+ * @param[in] xTailPos Tail position, first item of the check.
+ * @param[in] xPos Position of the item.
+ * @param[out] True when the item was released.
+ *
+ */
+
+bool ringbuf_mpmc::isReleased( const std::size_t xTailPos,
+                               const std::size_t xPos ) const
+{
+    bool isItemReleased = false;
+
+    /* A full buffer holds exactly xBufSize bytes of items. */
+    if( ( xPos - xTailPos ) < xBufSize )
+    {
+        const std::size_t xState = getHeader( xPos )->xState.load( std::memory_order_seq_cst );
+
+        isItemReleased = ( ( xState & xStateReleased ) != 0 );
+    }
+
+    return isItemReleased;
+}
+
+/**
+ * @brief Moves the tail forward over the items released, handing
+ *        their space back to the producers.
+ *
+ * @note Private method, consumers side. One consumer at a time sweeps,
+ *       the others return at once. Once done, the sweeper checks the
+ *       tail again: an item released while it was sweeping is not missed.
+ *       The space is cleared first, so that old data is never mistaken
+ *       for a committed item header.
+ *
+ */
+
+void ringbuf_mpmc::sweep( void )
+{
+    bool isSweepNeeded = true;
+
+    while( isSweepNeeded && !isSweeping.exchange( true, std::memory_order_seq_cst ) )
+    {
+        const std::size_t xTailPos = xTail.load( std::memory_order_relaxed );
+        std::size_t xNewTailPos = xTailPos;
+
+        while( isReleased( xTailPos, xNewTailPos ) )
+        {
+            rbMpmcItem_t* pxHeader = getHeader( xNewTailPos );
+            const std::size_t xItemSize = pxHeader->xState.load( std::memory_order_relaxed ) >> xStateFlagsBits;
+            rbSpan_t axSpans[ 2 ];
+
+            getSpans( xNewTailPos, xItemSize, axSpans );
+
+            /* Late consumers may still read the header: clear it atomically. */
+            pxHeader->xState.store( 0, std::memory_order_relaxed );
+            std::memset( axSpans[ 0 ].pcData, 0, axSpans[ 0 ].xSize );
+            std::memset( axSpans[ 1 ].pcData, 0, axSpans[ 1 ].xSize );
+
+            xNewTailPos += getItemSpan( xItemSize );
+        }
+
+        if( xNewTailPos != xTailPos )
+        {
+            xTail.store( xNewTailPos, std::memory_order_release );
+        }
+
+        isSweeping.store( false, std::memory_order_seq_cst );
+
+        isSweepNeeded = isReleased( xNewTailPos, xNewTailPos );
+    }
+}
+
+/*--------------------- Public methods ---------------------*/
+
+/**
+ * @brief Ring buffer constructor.
+ *
+ * @note The start of the pool is skipped if not aligned for the item
+ *       headers, which hold an atomic word.
+ *
+ * @param[in] pcPool Pointer to the memory pool used by this ringbuf_mpmc instance.
+ * @param[in] xPoolSize Size of the memory pool, rounded down to a multiple of
+ *            the item header size.
+ *
+ */
+
+ringbuf_mpmc::ringbuf_mpmc( std::uint8_t* pcPool,
+                            const std::size_t xPoolSize ) :
+                            pcBuf( pcPool + getPoolPad( pcPool ) ),
+                            xBufSize( getPoolSize( pcPool, xPoolSize ) ),
+                            xHead( 0 ),
+                            xTailCache( 0 ),
+                            xRejectedItems( 0 ),
+                            xRejectedBytes( 0 ),
+                            xRead( 0 ),
+                            xTail( 0 ),
+                            isSweeping( false )
+{
+    /* Reset buffer: no item is committed. */
+    std::memset( ( void* )pcBuf, 0, xBufSize );
+}
+
+/**
+ * @brief Inserts a new item in the ring buffer.
+ *
+ * @note Producers side. Old items are never removed, the push fails
+ *       when the consumers did not release enough space yet.
+ *
+ * @param[in] pxItem Pointer to the item to insert.
+ * @param[in] xItemSize Size of the item to insert.
+ * @param[out] True when item successfully inserted.
+ *
+ */
+
+bool ringbuf_mpmc::push( const void* pxItem,
+                         const std::size_t xItemSize )
+{
+    bool isItemPushed = false;
+
+    if(    ( xItemSize > 0 ) \
+        && ( xItemSize <= ( xBufSize - sizeof( rbMpmcItem_t ) ) )    )
+    {
+        std::size_t xHeadPos = 0;
+
+        if( claimSpace( getItemSpan( xItemSize ), &xHeadPos ) )
+        {
+            rbSpan_t axSpans[ 2 ];
+
+            getSpans( xHeadPos, xItemSize, axSpans );
+
+            /* Copy data, concurrently with the other producers. */
+            std::memcpy( axSpans[ 0 ].pcData, pxItem, axSpans[ 0 ].xSize );
+            std::memcpy( axSpans[ 1 ].pcData, ( const std::uint8_t* )pxItem + axSpans[ 0 ].xSize, axSpans[ 1 ].xSize );
+
+            /* Commit the item to the consumers. */
+            getHeader( xHeadPos )->xState.store( ( xItemSize << xStateFlagsBits ) | xStateCommitted, std::memory_order_release );
+
+            isItemPushed = true;
+        }
+        else
+        {
+            xRejectedItems.fetch_add( 1, std::memory_order_relaxed );
+            xRejectedBytes.fetch_add( xItemSize, std::memory_order_relaxed );
+        }
+    }
+
+    return isItemPushed;
+}
+
+/**
+ * @brief Checks whether there is an item to claim.
+ *
+ * @note Consumers side. The result may be outdated as soon as it is
+ *       returned; an item claimed but not committed yet is not visible.
+ *
+ * @param[out] True when empty.
+ *
+ */
+
+bool ringbuf_mpmc::isEmpty( void )
+{
+    const std::size_t xReadPos = xRead.load( std::memory_order_acquire );
+
+    return    ( xReadPos == xHead.load( std::memory_order_acquire ) ) \
+           || ( ( getHeader( xReadPos )->xState.load( std::memory_order_acquire ) & xStateCommitted ) == 0 );
+}
+
+/**
+ * @brief Claims the oldest item not claimed yet, so that its data can be
+ *        accessed in place by this consumer only.
+ *
+ * @note Consumers side. Items are claimed in insertion order; the claim
+ *       fails when the oldest item is not committed yet.
+ *
+ * @param[in] pxClaim Filled with the item position and data parts, to be
+ *            passed to releaseItem() once the data is not needed anymore.
+ * @param[out] True when an item is claimed.
+ *
+ */
+
+bool ringbuf_mpmc::claimItem( rbMpmcClaim_t* pxClaim )
+{
+    bool isClaimed = false;
+    bool isAvailable = true;
+
+    std::size_t xReadPos = xRead.load( std::memory_order_relaxed );
+
+    while( !isClaimed && isAvailable )
+    {
+        std::size_t xState = 0;
+
+        /* The head tells whether the header belongs to an item of this round. */
+        isAvailable = ( xReadPos != xHead.load( std::memory_order_acquire ) );
+
+        if( isAvailable )
+        {
+            xState = getHeader( xReadPos )->xState.load( std::memory_order_acquire );
+
+            isAvailable = ( ( xState & xStateCommitted ) != 0 );
+        }
+
+        if( isAvailable )
+        {
+            const std::size_t xItemSize = xState >> xStateFlagsBits;
+
+            /* On failure the current read index is loaded and the item checked again. */
+            isClaimed = xRead.compare_exchange_weak( xReadPos, xReadPos + getItemSpan( xItemSize ),
+                                                     std::memory_order_acquire, std::memory_order_relaxed );
+
+            if( isClaimed )
+            {
+                rbSpan_t axSpans[ 2 ];
+
+                getSpans( xReadPos, xItemSize, axSpans );
+
+                pxClaim->xPos = xReadPos;
+                pxClaim->xItemSize = xItemSize;
+
+                for( std::size_t i = 0; i < 2; ++i )
+                {
+                    pxClaim->axSpans[ i ].pcData = axSpans[ i ].pcData;
+                    pxClaim->axSpans[ i ].xSize = axSpans[ i ].xSize;
+                }
+            }
+        }
+    }
+
+    return isClaimed;
+}
+
+/**
+ * @brief Copies data of a claimed item into the destination buffer.
+ *
+ * @note Consumers side.
+ *
+ * @param[in] pxClaim Item claimed by claimItem() and not released yet.
+ * @param[in] pcDstBuf Destination buffer, at least pxClaim->xItemSize [byte].
+ *
+ */
+
+void ringbuf_mpmc::getData( const rbMpmcClaim_t* pxClaim,
+                            std::uint8_t* pcDstBuf )
+{
+    std::memcpy( pcDstBuf, pxClaim->axSpans[ 0 ].pcData, pxClaim->axSpans[ 0 ].xSize );
+    std::memcpy( pcDstBuf + pxClaim->axSpans[ 0 ].xSize, pxClaim->axSpans[ 1 ].pcData, pxClaim->axSpans[ 1 ].xSize );
+}
+
+/**
+ * @brief Gives back an item claimed by claimItem().
+ *
+ * @note Consumers side. Items can be released in any order: the space
+ *       is handed back to the producers once all the older items are
+ *       released too.
+ *
+ * @param[in] pxClaim Item claimed, its data must not be accessed anymore.
+ *
+ */
+
+void ringbuf_mpmc::releaseItem( const rbMpmcClaim_t* pxClaim )
+{
+    getHeader( pxClaim->xPos )->xState.store(    ( pxClaim->xItemSize << xStateFlagsBits ) \
+                                               | xStateCommitted | xStateReleased, std::memory_order_seq_cst );
+
+    sweep();
+}
+
+/**
+ * @brief Gets the number of items and bytes lost because of lack of space.
+ *
+ * @note Any side. Items are never evicted, only rejected.
+ *
+ * @param[out] Counters since the ring buffer was created.
+ *
+ */
+
+rbStats_t ringbuf_mpmc::getStats( void )
+{
+    rbStats_t xStats;
+
+    xStats.xEvictedItems = 0;
+    xStats.xEvictedBytes = 0;
+    xStats.xRejectedItems = xRejectedItems.load( std::memory_order_relaxed );
+    xStats.xRejectedBytes = xRejectedBytes.load( std::memory_order_relaxed );
+
+    return xStats;
+}
+
+/*---------------------------------------------------------------------------*/
@@ -0,0 +1,143 @@
+/**
+ * \file            ringbuf_mpmc.hpp
+ * \brief           Lock-free multi-producer/multi-consumer ring buffer
+ *                  to distribute data of different size to worker threads.
+ */
+
+/*
+ * Copyright (C) 2021 Giancarlo Marcolin
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without restriction,
+ * including without limitation the rights to use, copy, modify, merge,
+ * publish, distribute, sublicense, and/or sell copies of the Software,
+ * and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE
+ * AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * This file is part of ringbuf - Ring buffer for variable size elements.
+ *
+ * Author:          Giancarlo Marcolin <giancarlo.marcolin@gmail.com>
+ * Version:         v1.0.0
+ */
+
+#ifndef C_RING_BUF_MPMC_HPP
+#define C_RING_BUF_MPMC_HPP
+
+
+#include <atomic>
+#include <cstdint>
+#include <cstddef>
+
+#include "ringbuf.hpp"
+
+/**
+ * @ingroup ringbuf_struct_types
+ * @brief Header stored in front of every item of a ringbuf_mpmc.
+ *
+ * @note The header is written last by the producer: it stays zero
+ *       while the item data is being copied.
+ */
+
+struct rbMpmcItem {
+    std::atomic<std::size_t> xState;    /**< Zero until committed, then ( size << 2 ) | flags. */
+  };
+
+typedef struct rbMpmcItem rbMpmcItem_t;
+
+/**
+ * @ingroup ringbuf_struct_types
+ * @brief Item claimed by a consumer, to be given back with releaseItem().
+ */
+
+struct rbMpmcClaim {
+    std::size_t xPos;               /**< Position of the item in the ring buffer. */
+    std::size_t xItemSize;          /**< Size [byte] of the item data. */
+    rbConstSpan_t axSpans[ 2 ];     /**< Read-only parts of the item data; the second part
+                                         has size zero unless data rolls over. */
+  };
+
+typedef struct rbMpmcClaim rbMpmcClaim_t;
+
+/**
+ * @class ringbuf_mpmc
+ *
+ * @brief Ring buffer safe for any number of producer threads and consumer
+ *        threads running concurrently, without locks.
+ *
+ * @note Producers claim space at the head and commit items as in
+ *       ringbuf_mpsc. Consumers claim the oldest committed item by
+ *       moving the read index forward with an atomic compare-and-swap,
+ *       work on its data in place and release it, in any order.
+ *       Space is handed back to the producers only up to the oldest
+ *       item not released yet.
+ *
+ * @note The instance is over-aligned: allocate it statically, on the
+ *       stack or with an aligned allocator.
+ */
+
+class ringbuf_mpmc {
+
+  private:
+    std::uint8_t* pcBuf;          /**< Pointer to the memory where the ringbuf_mpmc instance is implemented, aligned for the item headers. */
+    const std::size_t xBufSize;   /**< Size of the memory in [byte], multiple of the item header size. */
+
+    /* Producers cache line. */
+    alignas( RINGBUF_CACHE_LINE_SIZE )
+    std::atomic<std::size_t> xHead;             /**< Bytes claimed by the producers so far. */
+    std::atomic<std::size_t> xTailCache;        /**< Last tail seen by any producer. */
+    std::atomic<std::size_t> xRejectedItems;    /**< New items not inserted. */
+    std::atomic<std::size_t> xRejectedBytes;    /**< Data [byte] of the new items not inserted. */
+
+    /* Consumers cache line. */
+    alignas( RINGBUF_CACHE_LINE_SIZE )
+    std::atomic<std::size_t> xRead;             /**< Bytes claimed by the consumers so far. */
+
+    /* Space reclaim cache line. */
+    alignas( RINGBUF_CACHE_LINE_SIZE )
+    std::atomic<std::size_t> xTail;             /**< Bytes handed back to the producers so far. */
+    std::atomic<bool> isSweeping;               /**< Set while a consumer moves the tail forward. */
+
+    /* Private methods. */
+    std::size_t getItemSpan( const std::size_t xItemSize ) const;
+    rbMpmcItem_t* getHeader( const std::size_t xPos ) const;
+    void getSpans( const std::size_t xPos, const std::size_t xItemSize, rbSpan_t* pxSpans ) const;
+    bool hasRoom( const std::size_t xHeadPos, const std::size_t xTailPos, const std::size_t xItemSpan ) const;
+    bool claimSpace( const std::size_t xItemSpan, std::size_t* pxPos );
+    bool isReleased( const std::size_t xTailPos, const std::size_t xPos ) const;
+    void sweep( void );
+
+  public:
+
+    ringbuf_mpmc( std::uint8_t* pcPool, const std::size_t xPoolSize );
+
+    /* Producers side. */
+    bool push( const void* pxItem, const std::size_t xItemSize );
+
+    /* Consumers side. */
+    bool isEmpty( void );
+
+    bool claimItem( rbMpmcClaim_t* pxClaim );
+
+    void getData( const rbMpmcClaim_t* pxClaim, std::uint8_t* pcDstBuf );
+
+    void releaseItem( const rbMpmcClaim_t* pxClaim );
+
+    /* Any side. */
+    rbStats_t getStats( void );
+};
+
+
+#endif //C_RING_BUF_MPMC_HPP
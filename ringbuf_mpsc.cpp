@@ -0,0 +1,630 @@
+/**
+ * \file            ringbuf_mpsc.cpp
+ * \brief           Lock-free multi-producer/single-consumer ring buffer.
+ */
+
+/*
+ * Copyright (C) 2021 Giancarlo Marcolin
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without restriction,
+ * including without limitation the rights to use, copy, modify, merge,
+ * publish, distribute, sublicense, and/or sell copies of the Software,
+ * and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE
+ * AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * This file is part of ringbuf - Ring buffer for variable size elements.
+ *
+ * Author:          Giancarlo Marcolin <giancarlo.marcolin@gmail.com>
+ * Version:         v1.0.0
+ */
+
+/* Standard includes. */
+#include <cstring>
+
+/* Include API header. */
+#include "ringbuf_mpsc.hpp"
+
+static_assert( sizeof( rbMpscItem_t ) == sizeof( std::size_t ), "Item header must be a single word." );
+
+/**
+ * @brief Computes the bytes skipped at the start of a memory pool
+ *        not aligned for the item headers.
+ *
+ * @param[in] pcPool Pointer to the memory pool.
+ * @param[out] Bytes skipped.
+ *
+ */
+
+static std::size_t getPoolPad( const std::uint8_t* pcPool )
+{
+    return ( std::size_t )( -( std::uintptr_t )pcPool ) & ( alignof( rbMpscItem_t ) - 1 );
+}
+
+/**
+ * @brief Computes the size of the memory pool used: the aligned part,
+ *        rounded down to a multiple of the item header size.
+ *
+ * @param[in] pcPool Pointer to the memory pool.
+ * @param[in] xPoolSize Size [byte] of the memory pool.
+ * @param[out] Size [byte] used.
+ *
+ */
+
+static std::size_t getPoolSize( const std::uint8_t* pcPool,
+                                const std::size_t xPoolSize )
+{
+    const std::size_t xPad = getPoolPad( pcPool );
+
+    std::size_t xSize = 0;
+
+    if( xPoolSize > xPad )
+    {
+        xSize = ( xPoolSize - xPad ) - ( ( xPoolSize - xPad ) % sizeof( rbMpscItem_t ) );
+    }
+
+    return xSize;
+}
+
+/*--------------------- Private methods ---------------------*/
+
+/**
+ * @brief Computes the space taken in the ring buffer by an item,
+ *        header included.
+ *
+ * @note Private method. Data is padded so that every header
+ *       starts at a multiple of the header size.
+ *
+ * @param[in] xItemSize Size [byte] of the item data.
+ * @param[out] Space [byte] taken by the item.
+ *
+ */
+
+std::size_t ringbuf_mpsc::getItemSpan( const std::size_t xItemSize ) const
+{
+    const std::size_t xAlign = sizeof( rbMpscItem_t );
+
+    return sizeof( rbMpscItem_t ) + ( ( xItemSize + xAlign - 1 ) / xAlign ) * xAlign;
+}
+
+/**
+ * @brief Gets the header of the item at a given position.
+ *
+ * @note Private method.
+ *
+ * @param[in] xPos Position of the item (byte counter, not rolled over).
+ * @param[out] Pointer to the header, it never rolls over.
+ *
+ */
+
+rbMpscItem_t* ringbuf_mpsc::getHeader( const std::size_t xPos ) const
+{
+    return ( rbMpscItem_t* )&pcBuf[ xPos % xBufSize ];
+}
+
+/**
+ * @brief Checks whether the item at a given position is committed.
+ *
+ * @note Private method, consumer side.
+ *
+ * @param[in] xPos Position of the item.
+ * @param[in] pxItemSize Filled with the size [byte] of the item data.
+ * @param[out] True when the producer committed the item.
+ *
+ */
+
+bool ringbuf_mpsc::loadItem( const std::size_t xPos,
+                             std::size_t* pxItemSize ) const
+{
+    const std::size_t xState = getHeader( xPos )->xState.load( std::memory_order_acquire );
+
+    *pxItemSize = xState >> 1;
+
+    return ( ( xState & 1U ) != 0 );
+}
+
+/**
+ * @brief Identifies the parts of the memory pool holding
+ *        the data of an item.
+ *
+ * @note Private method.
+ *
+ * @param[in] xPos Position of the item header.
+ * @param[in] xItemSize Size [byte] of the item data.
+ * @param[in] pxSpans Array of two spans filled with the data parts; the
+ *            second part has size zero unless data rolls over.
+ *
+ */
+
+void ringbuf_mpsc::getSpans( const std::size_t xPos,
+                             const std::size_t xItemSize,
+                             rbSpan_t* pxSpans ) const
+{
+    const std::size_t xDataPos = ( xPos + sizeof( rbMpscItem_t ) ) % xBufSize;
+    const std::size_t xTopPartSize = xBufSize - xDataPos;
+
+    pxSpans[ 0 ].pcData = &pcBuf[ xDataPos ];
+    pxSpans[ 1 ].pcData = pcBuf;
+
+    if( xItemSize <= xTopPartSize )
+    {
+        pxSpans[ 0 ].xSize = xItemSize;
+        pxSpans[ 1 ].xSize = 0;
+    }
+    else
+    {
+        /* Data rolls over. */
+        pxSpans[ 0 ].xSize = xTopPartSize;
+        pxSpans[ 1 ].xSize = xItemSize - xTopPartSize;
+    }
+}
+
+/**
+ * @brief Checks whether an item fits between head and tail.
+ *
+ * @note Private method. A tail newer than the head means the head was
+ *       read before other items were claimed and released: the room is
+ *       then checked again after the head is re-read.
+ *
+ * @param[in] xHeadPos Head position.
+ * @param[in] xTailPos Tail position.
+ * @param[in] xItemSpan Space [byte] needed by the item.
+ * @param[out] True when the item fits.
+ *
+ */
+
+bool ringbuf_mpsc::hasRoom( const std::size_t xHeadPos,
+                            const std::size_t xTailPos,
+                            const std::size_t xItemSpan ) const
+{
+    const std::size_t xUsedSize = ( xHeadPos > xTailPos ) ? ( xHeadPos - xTailPos ) : 0;
+
+    return ( ( xUsedSize + xItemSpan ) <= xBufSize );
+}
+
+/**
+ * @brief Claims space for a new item at the head.
+ *
+ * @note Private method, producers side. Space is claimed by a
+ *       compare-and-swap rather than a fetch-add: the head never
+ *       moves past space the consumer did not release yet.
+ *
+ * @param[in] xItemSpan Space [byte] needed by the item.
+ * @param[in] pxPos Filled with the position of the space claimed.
+ * @param[out] True when the space is claimed, false when full.
+ *
+ */
+
+bool ringbuf_mpsc::claim( const std::size_t xItemSpan,
+                          std::size_t* pxPos )
+{
+    bool isClaimed = false;
+    bool isFull = false;
+
+    std::size_t xHeadPos = xHead.load( std::memory_order_relaxed );
+
+    while( !isClaimed && !isFull )
+    {
+        std::size_t xTailPos = xTailCache.load( std::memory_order_acquire );
+
+        /* Refresh the tail only when the cached one shows no room. */
+        if( !hasRoom( xHeadPos, xTailPos, xItemSpan ) )
+        {
+            xTailPos = xTail.load( std::memory_order_acquire );
+            xTailCache.store( xTailPos, std::memory_order_release );
+
+            isFull = !hasRoom( xHeadPos, xTailPos, xItemSpan );
+        }
+
+        if( !isFull )
+        {
+            /* On failure the current head is loaded and the room checked again. */
+            isClaimed = xHead.compare_exchange_weak( xHeadPos, xHeadPos + xItemSpan, std::memory_order_relaxed );
+        }
+    }
+
+    *pxPos = xHeadPos;
+
+    return isClaimed;
+}
+
+/**
+ * @brief Hands the space of the oldest items back to the producers.
+ *
+ * @note Private method, consumer side. The space is cleared first, so
+ *       that old data is never mistaken for a committed item header.
+ *
+ * @param[in] xTailPos Current tail position.
+ * @param[in] xNewTailPos Position of the first item retained.
+ *
+ */
+
+void ringbuf_mpsc::release( const std::size_t xTailPos,
+                            const std::size_t xNewTailPos )
+{
+    const std::size_t xSize = xNewTailPos - xTailPos;
+    const std::size_t xOffset = xTailPos % xBufSize;
+    const std::size_t xTopPartSize = xBufSize - xOffset;
+
+    if( xSize <= xTopPartSize )
+    {
+        std::memset( ( void* )&pcBuf[ xOffset ], 0, xSize );
+    }
+    else
+    {
+        std::memset( ( void* )&pcBuf[ xOffset ], 0, xTopPartSize );
+        std::memset( ( void* )pcBuf, 0, xSize - xTopPartSize );
+    }
+
+    xTail.store( xNewTailPos, std::memory_order_release );
+}
+
+/*--------------------- Public methods ---------------------*/
+
+/**
+ * @brief Ring buffer constructor.
+ *
+ * @note The start of the pool is skipped if not aligned for the item
+ *       headers, which hold an atomic word.
+ *
+ * @param[in] pcPool Pointer to the memory pool used by this ringbuf_mpsc instance.
+ * @param[in] xPoolSize Size of the memory pool, rounded down to a multiple of
+ *            the item header size.
+ *
+ */
+
+ringbuf_mpsc::ringbuf_mpsc( std::uint8_t* pcPool,
+                            const std::size_t xPoolSize ) :
+                            pcBuf( pcPool + getPoolPad( pcPool ) ),
+                            xBufSize( getPoolSize( pcPool, xPoolSize ) ),
+                            xHead( 0 ),
+                            xTailCache( 0 ),
+                            xRejectedItems( 0 ),
+                            xRejectedBytes( 0 ),
+                            xTail( 0 )
+{
+    /* Reset buffer: no item is committed. */
+    std::memset( ( void* )pcBuf, 0, xBufSize );
+}
+
+/**
+ * @brief Inserts a new item in the ring buffer.
+ *
+ * @note Producers side. Old items are never removed, the push fails
+ *       when the consumer did not free enough space yet.
+ *
+ * @param[in] pxItem Pointer to the item to insert.
+ * @param[in] xItemSize Size of the item to insert.
+ * @param[out] True when item successfully inserted.
+ *
+ */
+
+bool ringbuf_mpsc::push( const void* pxItem,
+                         const std::size_t xItemSize )
+{
+    bool isItemPushed = false;
+
+    if(    ( xItemSize > 0 ) \
+        && ( xItemSize <= ( xBufSize - sizeof( rbMpscItem_t ) ) )    )
+    {
+        std::size_t xHeadPos = 0;
+
+        if( claim( getItemSpan( xItemSize ), &xHeadPos ) )
+        {
+            rbSpan_t axSpans[ 2 ];
+
+            getSpans( xHeadPos, xItemSize, axSpans );
+
+            /* Copy data, concurrently with the other producers. */
+            std::memcpy( axSpans[ 0 ].pcData, pxItem, axSpans[ 0 ].xSize );
+            std::memcpy( axSpans[ 1 ].pcData, ( const std::uint8_t* )pxItem + axSpans[ 0 ].xSize, axSpans[ 1 ].xSize );
+
+            /* Commit the item to the consumer. */
+            getHeader( xHeadPos )->xState.store( ( xItemSize << 1 ) | 1U, std::memory_order_release );
+
+            isItemPushed = true;
+        }
+        else
+        {
+            xRejectedItems.fetch_add( 1, std::memory_order_relaxed );
+            xRejectedBytes.fetch_add( xItemSize, std::memory_order_relaxed );
+        }
+    }
+
+    return isItemPushed;
+}
+
+/**
+ * @brief Discards all committed data in the ring buffer.
+ *
+ * @note Consumer side. Items pushed concurrently may be retained.
+ *
+ */
+
+void ringbuf_mpsc::flush( void )
+{
+    const std::size_t xTailPos = xTail.load( std::memory_order_relaxed );
+
+    std::size_t xNewTailPos = xTailPos;
+    std::size_t xItemSize = 0;
+
+    /* A full buffer holds exactly xBufSize bytes of items. */
+    while( ( ( xNewTailPos - xTailPos ) < xBufSize ) && loadItem( xNewTailPos, &xItemSize ) )
+    {
+        xNewTailPos += getItemSpan( xItemSize );
+    }
+
+    release( xTailPos, xNewTailPos );
+}
+
+/**
+ * @brief Checks whether the ring buffer is empty.
+ *
+ * @note Consumer side. An item claimed but not committed yet
+ *       is not visible.
+ *
+ * @param[out] True when empty.
+ *
+ */
+
+bool ringbuf_mpsc::isEmpty( void )
+{
+    std::size_t xItemSize = 0;
+
+    return !loadItem( xTail.load( std::memory_order_relaxed ), &xItemSize );
+}
+
+/**
+ * @brief Deletes the tail (oldest item) of the ring buffer.
+ *
+ * @note Consumer side. The space is handed back to the producers.
+ *
+ * @param[out] True when the tail is successfully deleted.
+ *
+ */
+
+bool ringbuf_mpsc::deleteTail( void )
+{
+    bool isTailDeleted = false;
+
+    const std::size_t xTailPos = xTail.load( std::memory_order_relaxed );
+    std::size_t xItemSize = 0;
+
+    if( loadItem( xTailPos, &xItemSize ) )
+    {
+        release( xTailPos, xTailPos + getItemSpan( xItemSize ) );
+
+        isTailDeleted = true;
+    }
+
+    return isTailDeleted;
+}
+
+/**
+ * @brief Copies data of the tail (oldest item) into the destination buffer.
+ *
+ * @note Consumer side. The item is not removed, use deleteTail().
+ *
+ * @param[in] pcDstBuf Destination buffer, at least getTailSize() [byte].
+ * @param[out] True when data successfully copied.
+ *
+ */
+
+bool ringbuf_mpsc::getData( std::uint8_t* pcDstBuf )
+{
+    bool isDataCopied = false;
+
+    rbConstSpan_t axSpans[ 2 ];
+
+    if( peek( axSpans ) )
+    {
+        std::memcpy( pcDstBuf, axSpans[ 0 ].pcData, axSpans[ 0 ].xSize );
+        std::memcpy( pcDstBuf + axSpans[ 0 ].xSize, axSpans[ 1 ].pcData, axSpans[ 1 ].xSize );
+
+        isDataCopied = true;
+    }
+
+    return isDataCopied;
+}
+
+/**
+ * @brief Gets the parts of the memory pool holding data of the tail
+ *        (oldest item), so that it can be accessed in place.
+ *
+ * @note Consumer side. Spans stay valid until the tail is released
+ *       with consume() or deleteTail().
+ *
+ * @param[in] pxSpans Array of two spans filled with the read-only parts of
+ *            the tail data; the second part has size zero unless data rolls
+ *            over the end of the memory pool.
+ * @param[out] True when the ring buffer is not empty.
+ *
+ */
+
+bool ringbuf_mpsc::peek( rbConstSpan_t* pxSpans )
+{
+    bool isDataPeeked = false;
+
+    const std::size_t xTailPos = xTail.load( std::memory_order_relaxed );
+    std::size_t xItemSize = 0;
+    rbSpan_t axSpans[ 2 ];
+
+    if( loadItem( xTailPos, &xItemSize ) )
+    {
+        getSpans( xTailPos, xItemSize, axSpans );
+
+        for( std::size_t i = 0; i < 2; ++i )
+        {
+            pxSpans[ i ].pcData = axSpans[ i ].pcData;
+            pxSpans[ i ].xSize = axSpans[ i ].xSize;
+        }
+
+        isDataPeeked = true;
+    }
+
+    return isDataPeeked;
+}
+
+/**
+ * @brief Releases the tail (oldest item) once its data, accessed by
+ *        peek(), is not needed anymore.
+ *
+ * @note Consumer side.
+ *
+ * @param[out] True when the tail is successfully released.
+ *
+ */
+
+bool ringbuf_mpsc::consume( void )
+{
+    return deleteTail();
+}
+
+/**
+ * @brief Hands the data of the oldest items to a callback and then releases
+ *        all of them to the producers with a single tail update.
+ *
+ * @note Consumer side. Draining stops at the first item not committed yet.
+ *
+ * @param[in] pxCallback Function called for each item, from the tail on.
+ * @param[in] pvContext User context passed to the callback.
+ * @param[in] xMaxItems Maximum number of items to remove.
+ * @param[in] xMaxBytes Maximum amount of data [byte] to remove; the item
+ *            that would exceed it is not handed out.
+ * @param[out] Number of items removed.
+ *
+ */
+
+std::size_t ringbuf_mpsc::drain( rbDrainCallback_t pxCallback,
+                                 void* pvContext,
+                                 const std::size_t xMaxItems,
+                                 const std::size_t xMaxBytes )
+{
+    std::size_t xDrainedCnt = 0;
+    std::size_t xDrainedSize = 0;
+    bool isDraining = true;
+
+    const std::size_t xTailPos = xTail.load( std::memory_order_relaxed );
+    std::size_t xNewTailPos = xTailPos;
+    std::size_t xItemSize = 0;
+    rbSpan_t axSpans[ 2 ];
+    rbConstSpan_t axConstSpans[ 2 ];
+
+    while(    isDraining \
+           && ( xDrainedCnt < xMaxItems ) \
+           && ( ( xNewTailPos - xTailPos ) < xBufSize ) \
+           && loadItem( xNewTailPos, &xItemSize )    )
+    {
+        getSpans( xNewTailPos, xItemSize, axSpans );
+
+        for( std::size_t i = 0; i < 2; ++i )
+        {
+            axConstSpans[ i ].pcData = axSpans[ i ].pcData;
+            axConstSpans[ i ].xSize = axSpans[ i ].xSize;
+        }
+
+        isDraining =    ( ( xDrainedSize + xItemSize ) <= xMaxBytes ) \
+                     && pxCallback( axConstSpans, pvContext );
+
+        if( isDraining )
+        {
+            ++xDrainedCnt;
+            xDrainedSize += xItemSize;
+
+            xNewTailPos += getItemSpan( xItemSize );
+        }
+    }
+
+    if( xDrainedCnt > 0 )
+    {
+        /* Release the space of all drained items to the producers. */
+        release( xTailPos, xNewTailPos );
+    }
+
+    return xDrainedCnt;
+}
+
+/**
+ * @brief Gets the size of data in the tail of the ring buffer.
+ *
+ * @note Consumer side.
+ *
+ * @param[out] Tail data size, zero when empty.
+ *
+ */
+
+const std::size_t ringbuf_mpsc::getTailSize( void )
+{
+    std::size_t xItemSize = 0;
+
+    if( !loadItem( xTail.load( std::memory_order_relaxed ), &xItemSize ) )
+    {
+        xItemSize = 0;
+    }
+
+    return xItemSize;
+}
+
+/**
+ * @brief Gets the number of items that the consumer can read.
+ *
+ * @note Consumer side. Items are counted one by one from the tail up to
+ *       the first one not committed yet: producers share no counter.
+ *
+ * @param[out] Items count.
+ *
+ */
+
+const std::size_t ringbuf_mpsc::getItemsCnt( void )
+{
+    std::size_t xItemsCnt = 0;
+
+    const std::size_t xTailPos = xTail.load( std::memory_order_relaxed );
+    std::size_t xPos = xTailPos;
+    std::size_t xItemSize = 0;
+
+    /* A full buffer holds exactly xBufSize bytes of items. */
+    while( ( ( xPos - xTailPos ) < xBufSize ) && loadItem( xPos, &xItemSize ) )
+    {
+        ++xItemsCnt;
+        xPos += getItemSpan( xItemSize );
+    }
+
+    return xItemsCnt;
+}
+
+/**
+ * @brief Gets the number of items and bytes lost because of lack of space.
+ *
+ * @note Any side. Items are never evicted, only rejected.
+ *
+ * @param[out] Counters since the ring buffer was created.
+ *
+ */
+
+rbStats_t ringbuf_mpsc::getStats( void )
+{
+    rbStats_t xStats;
+
+    xStats.xEvictedItems = 0;
+    xStats.xEvictedBytes = 0;
+    xStats.xRejectedItems = xRejectedItems.load( std::memory_order_relaxed );
+    xStats.xRejectedBytes = xRejectedBytes.load( std::memory_order_relaxed );
+
+    return xStats;
+}
+
+/*---------------------------------------------------------------------------*/
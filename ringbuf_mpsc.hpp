@@ -0,0 +1,139 @@
+/**
+ * \file            ringbuf_mpsc.hpp
+ * \brief           Lock-free multi-producer/single-consumer ring buffer
+ *                  to store data of different size.
+ */
+
+/*
+ * Copyright (C) 2021 Giancarlo Marcolin
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without restriction,
+ * including without limitation the rights to use, copy, modify, merge,
+ * publish, distribute, sublicense, and/or sell copies of the Software,
+ * and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE
+ * AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * This file is part of ringbuf - Ring buffer for variable size elements.
+ *
+ * Author:          Giancarlo Marcolin <giancarlo.marcolin@gmail.com>
+ * Version:         v1.0.0
+ */
+
+#ifndef C_RING_BUF_MPSC_HPP
+#define C_RING_BUF_MPSC_HPP
+
+
+#include <atomic>
+#include <cstdint>
+#include <cstddef>
+
+#include "ringbuf.hpp"
+
+/**
+ * @ingroup ringbuf_struct_types
+ * @brief Header stored in front of every item of a ringbuf_mpsc.
+ *
+ * @note The header is written last by the producer: it stays zero
+ *       while the item data is being copied.
+ */
+
+struct rbMpscItem {
+    std::atomic<std::size_t> xState;    /**< Zero until committed, then ( size << 1 ) | 1. */
+  };
+
+typedef struct rbMpscItem rbMpscItem_t;
+
+/**
+ * @class ringbuf_mpsc
+ *
+ * @brief Ring buffer safe for any number of producer threads and one
+ *        consumer thread running concurrently, without locks.
+ *
+ * @note Producers claim space by moving the head index forward with an
+ *       atomic compare-and-swap, copy their data concurrently and then
+ *       commit the item header. The consumer gets items in claim order:
+ *       an item committed after a slower producer's one waits for it.
+ *       push() never evicts items: it returns false when the buffer is full.
+ *       push() can be called by any thread, every other method
+ *       (except getStats()) by the consumer thread only.
+ *
+ * @note Head and tail are byte counters that only grow, so a producer
+ *       descheduled between reading the head and claiming space cannot
+ *       be fooled by a buffer that rolled over in the meantime.
+ *
+ * @note The instance is over-aligned: allocate it statically, on the
+ *       stack or with an aligned allocator.
+ */
+
+class ringbuf_mpsc {
+
+  private:
+    std::uint8_t* pcBuf;          /**< Pointer to the memory where the ringbuf_mpsc instance is implemented, aligned for the item headers. */
+    const std::size_t xBufSize;   /**< Size of the memory in [byte], multiple of the item header size. */
+
+    /* Producers cache line. */
+    alignas( RINGBUF_CACHE_LINE_SIZE )
+    std::atomic<std::size_t> xHead;             /**< Bytes claimed by the producers so far. */
+    std::atomic<std::size_t> xTailCache;        /**< Last tail seen by any producer. */
+    std::atomic<std::size_t> xRejectedItems;    /**< New items not inserted. */
+    std::atomic<std::size_t> xRejectedBytes;    /**< Data [byte] of the new items not inserted. */
+
+    /* Consumer cache line. */
+    alignas( RINGBUF_CACHE_LINE_SIZE )
+    std::atomic<std::size_t> xTail;             /**< Bytes released by the consumer so far. */
+
+    /* Private methods. */
+    std::size_t getItemSpan( const std::size_t xItemSize ) const;
+    rbMpscItem_t* getHeader( const std::size_t xPos ) const;
+    bool loadItem( const std::size_t xPos, std::size_t* pxItemSize ) const;
+    void getSpans( const std::size_t xPos, const std::size_t xItemSize, rbSpan_t* pxSpans ) const;
+    bool hasRoom( const std::size_t xHeadPos, const std::size_t xTailPos, const std::size_t xItemSpan ) const;
+    bool claim( const std::size_t xItemSpan, std::size_t* pxPos );
+    void release( const std::size_t xTailPos, const std::size_t xNewTailPos );
+
+  public:
+
+    ringbuf_mpsc( std::uint8_t* pcPool, const std::size_t xPoolSize );
+
+    /* Producers side. */
+    bool push( const void* pxItem, const std::size_t xItemSize );
+
+    /* Consumer side. */
+    void flush( void );
+
+    bool isEmpty( void );
+
+    bool deleteTail( void );
+
+    bool getData( std::uint8_t* pcDstBuf );
+
+    bool peek( rbConstSpan_t* pxSpans );
+
+    bool consume( void );
+
+    std::size_t drain( rbDrainCallback_t pxCallback, void* pvContext, const std::size_t xMaxItems, const std::size_t xMaxBytes );
+
+    const std::size_t getTailSize( void );
+
+    const std::size_t getItemsCnt( void );
+
+    /* Any side. */
+    rbStats_t getStats( void );
+};
+
+
+#endif //C_RING_BUF_MPSC_HPP
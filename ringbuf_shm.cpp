@@ -0,0 +1,307 @@
+/**
+ * \file            ringbuf_shm.cpp
+ * \brief           Single-producer/single-consumer ring buffer placed
+ *                  in shared memory.
+ */
+
+/*
+ * Copyright (C) 2021 Giancarlo Marcolin
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without restriction,
+ * including without limitation the rights to use, copy, modify, merge,
+ * publish, distribute, sublicense, and/or sell copies of the Software,
+ * and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE
+ * AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * This file is part of ringbuf - Ring buffer for variable size elements.
+ *
+ * Author:          Giancarlo Marcolin <giancarlo.marcolin@gmail.com>
+ * Version:         v1.0.0
+ */
+
+
+
+
+/* Standard includes. */
+#include <cstring>
+
+#include <new>
+
+#if defined( __linux__ )
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+/* Include API header. */
+#include "ringbuf_shm.hpp"
+
+/**
+ * @brief Value of the magic number of an initialized control block ("RBSH").
+ */
+
+static constexpr std::uint32_t ulShmMagic = 0x52425348U;
+
+/**
+ * @brief Layout version of the control block.
+ */
+
+static constexpr std::uint32_t ulShmVersion = 1U;
+
+/*--------------------- Private methods ---------------------*/
+
+/**
+ * @brief Initializes or checks the control block at the start of a region.
+ *
+ * @note Private method. The region is written by another process, so on
+ *       attach head and tail must point to an item header inside it.
+ *
+ * @param[in] pcRegion Pointer to the shared memory region.
+ * @param[in] xRegionSize Size of the region as mapped by this process.
+ * @param[in] eOpen RB_SHM_CREATE or RB_SHM_ATTACH.
+ * @param[out] Control block, nullptr when the region is not usable.
+ *
+ */
+
+rbShmCtrl_t* ringbuf_shm::openRegion( std::uint8_t* pcRegion,
+                                      const std::size_t xRegionSize,
+                                      const rbShmOpen_t eOpen )
+{
+    rbShmCtrl_t* pxCtrl = nullptr;
+
+    if(    ( pcRegion != nullptr ) \
+        && ( ( ( std::uintptr_t )pcRegion % RINGBUF_CACHE_LINE_SIZE ) == 0 ) \
+        && ( xRegionSize > ( sizeof( rbShmCtrl_t ) + 2 * sizeof( rbShmItem_t ) ) )    )
+    {
+        rbShmCtrl_t* pxRegionCtrl = ( rbShmCtrl_t* )pcRegion;
+        const std::size_t xMaxBufSize = xRegionSize - sizeof( rbShmCtrl_t );
+
+        if( eOpen == RB_SHM_CREATE )
+        {
+            /* Reset region. */
+            std::memset( ( void* )pcRegion, 0, xRegionSize );
+
+            pxRegionCtrl = new ( pcRegion ) rbShmCtrl_t();
+
+            pxRegionCtrl->ulVersion = ulShmVersion;
+            pxRegionCtrl->xCtrlSize = sizeof( rbShmCtrl_t );
+            pxRegionCtrl->xBufSize = xMaxBufSize - ( xMaxBufSize % sizeof( rbShmItem_t ) );
+
+            /* Publish the control block to the attaching process. */
+            pxRegionCtrl->ulMagic.store( ulShmMagic, std::memory_order_release );
+        }
+
+        if(    ( pxRegionCtrl->ulMagic.load( std::memory_order_acquire ) == ulShmMagic ) \
+            && ( pxRegionCtrl->ulVersion == ulShmVersion ) \
+            && ( pxRegionCtrl->xCtrlSize == sizeof( rbShmCtrl_t ) ) \
+            && ( pxRegionCtrl->xBufSize <= xMaxBufSize ) \
+            && ( pxRegionCtrl->xBufSize > ( 2 * sizeof( rbShmItem_t ) ) ) \
+            && ( ( pxRegionCtrl->xBufSize % sizeof( rbShmItem_t ) ) == 0 )    )
+        {
+            /* The other side may be running already. */
+            const std::size_t xTailPos = pxRegionCtrl->xSpscCtrl.xTail.load( std::memory_order_acquire );
+            const std::size_t xHeadPos = pxRegionCtrl->xSpscCtrl.xHead.load( std::memory_order_acquire );
+
+            /* Offsets must point to an item header inside the buffer. */
+            if(    ( xTailPos < pxRegionCtrl->xBufSize ) \
+                && ( ( xTailPos % sizeof( rbShmItem_t ) ) == 0 ) \
+                && ( xHeadPos < pxRegionCtrl->xBufSize ) \
+                && ( ( xHeadPos % sizeof( rbShmItem_t ) ) == 0 )    )
+            {
+                pxCtrl = pxRegionCtrl;
+            }
+        }
+    }
+
+    return pxCtrl;
+}
+
+/**
+ * @brief Ring buffer constructor on a checked control block.
+ *
+ * @note Private method. The items follow the control block.
+ *
+ * @param[in] pxCtrl Control block returned by openRegion().
+ *
+ */
+
+ringbuf_shm::ringbuf_shm( rbShmCtrl_t* pxCtrl ) :
+                          ringbuf_spsc( ( pxCtrl != nullptr ) ? &pxCtrl->xSpscCtrl : nullptr,
+                                        ( pxCtrl != nullptr ) ? ( ( std::uint8_t* )pxCtrl + sizeof( rbShmCtrl_t ) ) : nullptr,
+                                        ( pxCtrl != nullptr ) ? pxCtrl->xBufSize : 0 ),
+                          pxRegionCtrl( pxCtrl )
+{
+}
+
+/*--------------------- Public methods ---------------------*/
+
+/**
+ * @brief Ring buffer constructor.
+ *
+ * @note On failure (region too small or misaligned, or not holding a
+ *       ring buffer with head and tail inside it when attaching) every
+ *       insertion fails and the ring buffer looks empty, see isAttached().
+ *
+ * @param[in] pcRegion Pointer to the shared memory region, aligned to
+ *            RINGBUF_CACHE_LINE_SIZE.
+ * @param[in] xRegionSize Size of the region as mapped by this process.
+ * @param[in] eOpen RB_SHM_CREATE to initialize the control block,
+ *            RB_SHM_ATTACH to use the one initialized by another process.
+ *
+ */
+
+ringbuf_shm::ringbuf_shm( std::uint8_t* pcRegion,
+                          const std::size_t xRegionSize,
+                          const rbShmOpen_t eOpen ) :
+                          ringbuf_shm( openRegion( pcRegion, xRegionSize, eOpen ) )
+{
+}
+
+/**
+ * @brief Checks whether the ring buffer was created or attached.
+ *
+ * @param[out] True when the region holds a usable ring buffer.
+ *
+ */
+
+bool ringbuf_shm::isAttached( void )
+{
+    return ( pxRegionCtrl != nullptr );
+}
+
+/**
+ * @brief Maps a shared memory region for a ringbuf_shm.
+ *
+ * @note Linux only. A named region (POSIX shared memory, e.g. "/capture")
+ *       can be mapped by any process; an unnamed one (memfd) only by this
+ *       process and, through the mapping, by its children after fork().
+ *
+ * @param[in] pcName Name of the region, nullptr for an unnamed one.
+ * @param[in] pxRegionSize Size of the region, rounded up to a page multiple;
+ *            zero to map an existing named region with its current size.
+ *            Updated with the size actually mapped.
+ * @param[out] Pointer to the region, nullptr on failure.
+ *
+ */
+
+std::uint8_t* ringbuf_shm::mapRegion( const char* pcName,
+                                      std::size_t* pxRegionSize )
+{
+    std::uint8_t* pcRegion = nullptr;
+
+#if defined( __linux__ )
+    int iFd = -1;
+
+    if( pcName != nullptr )
+    {
+        iFd = shm_open( pcName, ( *pxRegionSize > 0 ) ? ( O_RDWR | O_CREAT ) : O_RDWR, 0600 );
+    }
+    else if( *pxRegionSize > 0 )
+    {
+        iFd = memfd_create( "ringbuf_shm", MFD_CLOEXEC );
+    }
+
+    if( iFd >= 0 )
+    {
+        std::size_t xRegionSize = 0;
+        bool isSized = false;
+
+        if( *pxRegionSize > 0 )
+        {
+            const std::size_t xPageSize = ( std::size_t )sysconf( _SC_PAGESIZE );
+
+            xRegionSize = ( ( *pxRegionSize + xPageSize - 1 ) / xPageSize ) * xPageSize;
+            isSized = ( ftruncate( iFd, ( off_t )xRegionSize ) == 0 );
+        }
+        else
+        {
+            struct stat xStat;
+
+            isSized = ( fstat( iFd, &xStat ) == 0 ) && ( xStat.st_size > 0 );
+            xRegionSize = isSized ? ( std::size_t )xStat.st_size : 0;
+        }
+
+        if( isSized )
+        {
+            void* pvRegion = mmap( nullptr, xRegionSize, PROT_READ | PROT_WRITE, MAP_SHARED, iFd, 0 );
+
+            if( pvRegion != MAP_FAILED )
+            {
+                pcRegion = ( std::uint8_t* )pvRegion;
+
+                *pxRegionSize = xRegionSize;
+            }
+        }
+
+        /* The mapping keeps the memory alive. */
+        close( iFd );
+    }
+#else
+    ( void )pcName;
+    ( void )pxRegionSize;
+#endif
+
+    return pcRegion;
+}
+
+/**
+ * @brief Releases a region mapped by mapRegion().
+ *
+ * @param[in] pcRegion Pointer to the region.
+ * @param[in] xRegionSize Size of the region returned by mapRegion().
+ *
+ */
+
+void ringbuf_shm::unmapRegion( std::uint8_t* pcRegion,
+                               const std::size_t xRegionSize )
+{
+#if defined( __linux__ )
+    if( pcRegion != nullptr )
+    {
+        munmap( pcRegion, xRegionSize );
+    }
+#else
+    ( void )pcRegion;
+    ( void )xRegionSize;
+#endif
+}
+
+/**
+ * @brief Removes the name of a region mapped by mapRegion().
+ *
+ * @note The memory is released once every process unmapped it.
+ *
+ * @param[in] pcName Name of the region.
+ * @param[out] True when the name is removed.
+ *
+ */
+
+bool ringbuf_shm::unlinkRegion( const char* pcName )
+{
+    bool isUnlinked = false;
+
+#if defined( __linux__ )
+    isUnlinked = ( shm_unlink( pcName ) == 0 );
+#else
+    ( void )pcName;
+#endif
+
+    return isUnlinked;
+}
+
+/*---------------------------------------------------------------------------*/
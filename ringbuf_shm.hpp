@@ -0,0 +1,129 @@
+/**
+ * \file            ringbuf_shm.hpp
+ * \brief           Single-producer/single-consumer ring buffer placed
+ *                  in shared memory, to exchange data of different size
+ *                  between processes.
+ */
+
+/*
+ * Copyright (C) 2021 Giancarlo Marcolin
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without restriction,
+ * including without limitation the rights to use, copy, modify, merge,
+ * publish, distribute, sublicense, and/or sell copies of the Software,
+ * and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE
+ * AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * This file is part of ringbuf - Ring buffer for variable size elements.
+ *
+ * Author:          Giancarlo Marcolin <giancarlo.marcolin@gmail.com>
+ * Version:         v1.0.0
+ */
+
+#ifndef C_RING_BUF_SHM_HPP
+#define C_RING_BUF_SHM_HPP
+
+
+#include <atomic>
+#include <cstdint>
+#include <cstddef>
+
+#include "ringbuf_spsc.hpp"
+
+/**
+ * @ingroup ringbuf_struct_types
+ * @brief Header stored in front of every item of a ringbuf_shm,
+ *        the one of ringbuf_spsc.
+ */
+
+typedef rbSpscItem_t rbShmItem_t;
+
+/**
+ * @ingroup ringbuf_struct_types
+ * @brief Control block of a ringbuf_shm, stored at the start of the
+ *        shared memory region, followed by the items.
+ *
+ * @note Only offsets are stored, so every process can map the region
+ *       at a different address. Processes must be built for the same
+ *       ABI: the size of the control block is checked on attach.
+ */
+
+struct rbShmCtrl {
+    std::atomic<std::uint32_t> ulMagic;     /**< Set last, once the control block is initialized. */
+    std::uint32_t ulVersion;                /**< Layout version of the control block. */
+    std::size_t xCtrlSize;                  /**< Size of the control block [byte]. */
+    std::size_t xBufSize;                   /**< Size of the memory for items [byte], multiple of the item header size. */
+    rbSpscCtrl_t xSpscCtrl;                 /**< Offsets, counters and waiter flags, on their own cache lines. */
+  };
+
+typedef struct rbShmCtrl rbShmCtrl_t;
+
+/**
+ * @ingroup ringbuf_struct_types
+ * @brief How a ringbuf_shm takes the shared memory region.
+ */
+
+typedef enum {
+    RB_SHM_CREATE,      /**< Initialize a new ring buffer, discarding the region content. */
+    RB_SHM_ATTACH       /**< Use the ring buffer already initialized by another process. */
+  } rbShmOpen_t;
+
+/**
+ * @class ringbuf_shm
+ *
+ * @brief Ring buffer shared by one producer and one consumer, running in
+ *        different processes (or threads), without locks.
+ *
+ * @note A ringbuf_spsc with all the shared state in the control block at
+ *       the start of the region. One process creates the ring buffer, the
+ *       other one attaches to it; each one only keeps local copies of the
+ *       offsets of the other side.
+ *       push(), setOverflowPolicy() and waitForSpace() belong to the
+ *       producer, every other method (except getItemsCnt() and getStats())
+ *       to the consumer.
+ *
+ * @note The region must be aligned to RINGBUF_CACHE_LINE_SIZE, as the
+ *       ones returned by mapRegion(). Sleeping sides use shared futexes
+ *       on Linux.
+ */
+
+class ringbuf_shm : public ringbuf_spsc {
+
+  private:
+    rbShmCtrl_t* const pxRegionCtrl;    /**< Control block, nullptr when the region is not usable. */
+
+    /* Private methods. */
+    static rbShmCtrl_t* openRegion( std::uint8_t* pcRegion, const std::size_t xRegionSize, const rbShmOpen_t eOpen );
+
+    ringbuf_shm( rbShmCtrl_t* pxCtrl );
+
+  public:
+
+    ringbuf_shm( std::uint8_t* pcRegion, const std::size_t xRegionSize, const rbShmOpen_t eOpen );
+
+    bool isAttached( void );
+
+    /* Shared memory regions. */
+    static std::uint8_t* mapRegion( const char* pcName, std::size_t* pxRegionSize );
+
+    static void unmapRegion( std::uint8_t* pcRegion, const std::size_t xRegionSize );
+
+    static bool unlinkRegion( const char* pcName );
+};
+
+
+#endif //C_RING_BUF_SHM_HPP
@@ -0,0 +1,855 @@
+/**
+ * \file            ringbuf_spsc.cpp
+ * \brief           Lock-free single-producer/single-consumer ring buffer.
+ */
+
+/*
+ * Copyright (C) 2021 Giancarlo Marcolin
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without restriction,
+ * including without limitation the rights to use, copy, modify, merge,
+ * publish, distribute, sublicense, and/or sell copies of the Software,
+ * and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE
+ * AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * This file is part of ringbuf - Ring buffer for variable size elements.
+ *
+ * Author:          Giancarlo Marcolin <giancarlo.marcolin@gmail.com>
+ * Version:         v1.0.0
+ */
+
+
+
+
+/* Standard includes. */
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <thread>
+
+#if defined( __linux__ )
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#include <ctime>
+#include <unistd.h>
+#endif
+
+/* Include API header. */
+#include "ringbuf_spsc.hpp"
+
+/**
+ * @brief Number of checks of the other side index a waiting side
+ *        makes before sleeping, at the first wait.
+ */
+
+static constexpr std::uint32_t ulSpinCnt = 64U;
+
+/**
+ * @brief Bounds of the number of checks: it doubles when the wait ends
+ *        while spinning and halves when the side has to sleep.
+ */
+
+static constexpr std::uint32_t ulSpinMin = 4U;
+static constexpr std::uint32_t ulSpinMax = 4096U;
+
+/*--------------------- Private methods ---------------------*/
+
+/**
+ * @brief Computes the space taken in the ring buffer by an item,
+ *        header included.
+ *
+ * @note Private method. Data is padded so that every header
+ *       starts at a multiple of the header size.
+ *
+ * @param[in] xItemSize Size [byte] of the item data.
+ * @param[out] Space [byte] taken by the item.
+ *
+ */
+
+std::size_t ringbuf_spsc::getItemSpan( const std::size_t xItemSize ) const
+{
+    const std::size_t xAlign = sizeof( rbSpscItem_t );
+
+    return sizeof( rbSpscItem_t ) + ( ( xItemSize + xAlign - 1 ) / xAlign ) * xAlign;
+}
+
+/**
+ * @brief Computes the free space between head and tail.
+ *
+ * @note Private method. Head and tail are equal only when the
+ *       buffer is empty, so an item fits only when its span is
+ *       strictly smaller than the free space.
+ *
+ * @param[in] xHeadPos Head offset.
+ * @param[in] xTailPos Tail offset.
+ * @param[out] Free space [byte].
+ *
+ */
+
+std::size_t ringbuf_spsc::getFreeSpace( const std::size_t xHeadPos,
+                                        const std::size_t xTailPos ) const
+{
+    std::size_t xFreeSpace = 0;
+
+    if( xTailPos > xHeadPos )
+    {
+        xFreeSpace = xTailPos - xHeadPos;
+    }
+    else
+    {
+        xFreeSpace = xBufSize - xHeadPos + xTailPos;
+    }
+
+    return xFreeSpace;
+}
+
+/**
+ * @brief Moves an offset forward, rolling over at the end of the buffer.
+ *
+ * @note Private method.
+ *
+ * @param[in] xPos Offset to move.
+ * @param[in] xSpan Number of bytes to move forward, not above xBufSize.
+ * @param[out] New offset.
+ *
+ */
+
+std::size_t ringbuf_spsc::advance( const std::size_t xPos,
+                                   const std::size_t xSpan ) const
+{
+    std::size_t xNewPos = xPos + xSpan;
+
+    /* Buffer roll-over check. */
+    if( xNewPos >= xBufSize )
+    {
+        xNewPos -= xBufSize;
+    }
+
+    return xNewPos;
+}
+
+/**
+ * @brief Checks whether an item of the given size can be stored.
+ *
+ * @note Private method. Always false without a memory pool.
+ *
+ * @param[in] xItemSize Size [byte] of the item data.
+ * @param[out] True when the item fits in the empty ring buffer.
+ *
+ */
+
+bool ringbuf_spsc::isItemSizeValid( const std::size_t xItemSize ) const
+{
+    return    ( xItemSize > 0 ) \
+           && ( xItemSize < xBufSize ) \
+           && ( ( xBufSize - xItemSize ) > sizeof( rbSpscItem_t ) );
+}
+
+/**
+ * @brief Reads the data size stored in an item header.
+ *
+ * @note Private method. With ringbuf_shm the header is written by
+ *       another process, so a size push() could not have stored reads
+ *       as zero: the item is neither handed out nor skipped.
+ *
+ * @param[in] xPos Offset of the item header.
+ * @param[out] Size [byte] of the item data, zero when not valid.
+ *
+ */
+
+std::size_t ringbuf_spsc::getItemSize( const std::size_t xPos ) const
+{
+    rbSpscItem_t xItem;
+
+    std::memcpy( &xItem, &pcBuf[ xPos ], sizeof( rbSpscItem_t ) );
+
+    if( !isItemSizeValid( xItem.xItemSize ) )
+    {
+        xItem.xItemSize = 0;
+    }
+
+    return xItem.xItemSize;
+}
+
+/**
+ * @brief Identifies the parts of the memory pool holding
+ *        the data of an item.
+ *
+ * @note Private method.
+ *
+ * @param[in] xPos Offset of the item header.
+ * @param[in] pxSpans Array of two spans filled with the data parts; the
+ *            second part has size zero unless data rolls over.
+ * @param[out] Size [byte] of the item data, zero when not valid.
+ *
+ */
+
+std::size_t ringbuf_spsc::getSpans( const std::size_t xPos,
+                                    rbConstSpan_t* pxSpans ) const
+{
+    const std::size_t xItemSize = getItemSize( xPos );
+    const std::size_t xDataPos = advance( xPos, sizeof( rbSpscItem_t ) );
+    const std::size_t xTopPartSize = xBufSize - xDataPos;
+
+    pxSpans[ 0 ].pcData = &pcBuf[ xDataPos ];
+    pxSpans[ 1 ].pcData = pcBuf;
+
+    if( xItemSize <= xTopPartSize )
+    {
+        pxSpans[ 0 ].xSize = xItemSize;
+        pxSpans[ 1 ].xSize = 0;
+    }
+    else
+    {
+        /* Data rolls over. */
+        pxSpans[ 0 ].xSize = xTopPartSize;
+        pxSpans[ 1 ].xSize = xItemSize - xTopPartSize;
+    }
+
+    return xItemSize;
+}
+
+/**
+ * @brief Checks whether the producer published an item not yet deleted.
+ *
+ * @note Private method, consumer side. The head index is shared with
+ *       the producer, so it is re-read only when the cached copy says
+ *       the buffer is empty.
+ *
+ * @param[out] True when the tail holds an item.
+ *
+ */
+
+bool ringbuf_spsc::loadHead( void )
+{
+    const std::size_t xTailPos = pxCtrl->xTail.load( std::memory_order_relaxed );
+
+    if( xTailPos == xHeadCache )
+    {
+        xHeadCache = pxCtrl->xHead.load( std::memory_order_acquire );
+    }
+
+    return ( xTailPos != xHeadCache );
+}
+
+/**
+ * @brief Checks whether the consumer freed enough space for a new item.
+ *
+ * @note Private method, producer side. The tail index is shared with
+ *       the consumer, so it is re-read only when the cached copy shows
+ *       no room.
+ *
+ * @param[in] xItemSpan Space [byte] needed by the new item.
+ * @param[out] True when the item fits.
+ *
+ */
+
+bool ringbuf_spsc::hasSpace( const std::size_t xItemSpan )
+{
+    const std::size_t xHeadPos = pxCtrl->xHead.load( std::memory_order_relaxed );
+
+    if( xItemSpan >= getFreeSpace( xHeadPos, xTailCache ) )
+    {
+        xTailCache = pxCtrl->xTail.load( std::memory_order_acquire );
+    }
+
+    return ( xItemSpan < getFreeSpace( xHeadPos, xTailCache ) );
+}
+
+/**
+ * @brief Puts the calling side to sleep until the other side wakes it up
+ *        or the timeout expires.
+ *
+ * @note Private method. Returns at once when the other side already
+ *       cleared the waiter flag. Without futexes the CPU is just yielded.
+ *       The futex is shared between processes only with ringbuf_shm.
+ *
+ * @param[in] pulWaiter Waiter flag of the calling side, set to 1.
+ * @param[in] ulWaitUs Maximum sleep [us].
+ *
+ */
+
+void ringbuf_spsc::park( std::atomic<std::uint32_t>* pulWaiter,
+                         const std::uint32_t ulWaitUs )
+{
+#if defined( __linux__ )
+    struct timespec xTimeout;
+
+    xTimeout.tv_sec = ( time_t )( ulWaitUs / 1000000U );
+    xTimeout.tv_nsec = ( long )( ulWaitUs % 1000000U ) * 1000L;
+
+    syscall( SYS_futex, ( std::uint32_t* )pulWaiter, isProcessShared ? FUTEX_WAIT : FUTEX_WAIT_PRIVATE, 1U, &xTimeout, nullptr, 0 );
+#else
+    ( void )pulWaiter;
+    ( void )ulWaitUs;
+
+    std::this_thread::yield();
+#endif
+}
+
+/**
+ * @brief Wakes up the other side if it sleeps waiting for this side.
+ *
+ * @note Private method, called after publishing a new head or tail.
+ *       The fence pairs with the one of the waiting side: either this
+ *       side sees the waiter flag, or the waiting side sees the new
+ *       index and does not sleep. The syscall is made only in the first
+ *       case.
+ *
+ * @param[in] pulWaiter Waiter flag of the other side.
+ *
+ */
+
+void ringbuf_spsc::notify( std::atomic<std::uint32_t>* pulWaiter )
+{
+    std::atomic_thread_fence( std::memory_order_seq_cst );
+
+    if( pulWaiter->load( std::memory_order_relaxed ) != 0 )
+    {
+        pulWaiter->store( 0, std::memory_order_relaxed );
+
+#if defined( __linux__ )
+        syscall( SYS_futex, ( std::uint32_t* )pulWaiter, isProcessShared ? FUTEX_WAKE : FUTEX_WAKE_PRIVATE, 1, nullptr, nullptr, 0 );
+#endif
+    }
+}
+
+/*--------------------- Public methods ---------------------*/
+
+/**
+ * @brief Ring buffer constructor.
+ *
+ * @param[in] pcPool Pointer to the memory pool used by this ringbuf_spsc instance.
+ * @param[in] xPoolSize Size of the memory pool, rounded down to a multiple of
+ *            the item header size.
+ *
+ */
+
+ringbuf_spsc::ringbuf_spsc( std::uint8_t* pcPool,
+                            const std::size_t xPoolSize ) :
+                            ringbuf_spsc( nullptr, pcPool, xPoolSize - ( xPoolSize % sizeof( rbSpscItem_t ) ) )
+{
+    /* Reset buffer. */
+    std::memset( ( void* )pcBuf, 0, xBufSize );
+}
+
+/**
+ * @brief Ring buffer constructor on an existing control block.
+ *
+ * @note Used by ringbuf_shm. The control block and the memory pool are
+ *       not reset: the other side may be running already. Without a
+ *       memory pool every insertion fails and the ring buffer looks empty.
+ *
+ * @param[in] pxSharedCtrl Control block shared between processes, nullptr
+ *            to use the one of this instance.
+ * @param[in] pcPool Pointer to the memory pool, nullptr when not usable.
+ * @param[in] xPoolSize Size of the memory pool, multiple of the item header size.
+ *
+ */
+
+ringbuf_spsc::ringbuf_spsc( rbSpscCtrl_t* pxSharedCtrl,
+                            std::uint8_t* pcPool,
+                            const std::size_t xPoolSize ) :
+                            pxCtrl( ( pxSharedCtrl != nullptr ) ? pxSharedCtrl : &xCtrl ),
+                            pcBuf( pcPool ),
+                            xBufSize( ( pcPool != nullptr ) ? xPoolSize : 0 ),
+                            isProcessShared( pxSharedCtrl != nullptr ),
+                            xTailCache( 0 ),
+                            eOverflow( RB_OVERFLOW_REJECT ),
+                            ulTimeoutUs( 0 ),
+                            ulSpaceSpinCnt( ulSpinCnt ),
+                            xHeadCache( 0 ),
+                            ulDataSpinCnt( ulSpinCnt ),
+                            xCtrl()
+{
+    /* The other side may be running already. */
+    xTailCache = pxCtrl->xTail.load( std::memory_order_acquire );
+    xHeadCache = pxCtrl->xHead.load( std::memory_order_acquire );
+}
+
+/**
+ * @brief Selects what push() does when there is not enough space.
+ *
+ * @note Producer side. Old items can only be removed by the consumer,
+ *       so RB_OVERFLOW_OVERWRITE is not supported.
+ *
+ * @param[in] eOverflowPolicy RB_OVERFLOW_REJECT (default) to fail the
+ *            insertion, RB_OVERFLOW_BLOCK to wait for the consumer.
+ * @param[in] ulWaitUs Maximum wait [us] with RB_OVERFLOW_BLOCK.
+ * @param[out] True when the policy is supported.
+ *
+ */
+
+bool ringbuf_spsc::setOverflowPolicy( const rbOverflow_t eOverflowPolicy,
+                                      const std::uint32_t ulWaitUs )
+{
+    bool isPolicySet = false;
+
+    if( eOverflowPolicy != RB_OVERFLOW_OVERWRITE )
+    {
+        eOverflow = eOverflowPolicy;
+        ulTimeoutUs = ulWaitUs;
+
+        isPolicySet = true;
+    }
+
+    return isPolicySet;
+}
+
+/**
+ * @brief Inserts a new item in the ring buffer.
+ *
+ * @note Producer side. Old items are never removed, the push fails
+ *       when the consumer did not free enough space yet (after waiting
+ *       for it with RB_OVERFLOW_BLOCK).
+ *
+ * @param[in] pxItem Pointer to the item to insert.
+ * @param[in] xItemSize Size of the item to insert.
+ * @param[out] True when item successfully inserted.
+ *
+ */
+
+bool ringbuf_spsc::push( const void* pxItem,
+                         const std::size_t xItemSize )
+{
+    bool isItemPushed = false;
+
+    if( isItemSizeValid( xItemSize ) )
+    {
+        const std::size_t xHeadPos = pxCtrl->xHead.load( std::memory_order_relaxed );
+        const std::size_t xItemSpan = getItemSpan( xItemSize );
+
+        if( !hasSpace( xItemSpan ) && ( eOverflow == RB_OVERFLOW_BLOCK ) )
+        {
+            waitForSpace( xItemSize, ulTimeoutUs );
+        }
+
+        if( xItemSpan < getFreeSpace( xHeadPos, xTailCache ) )
+        {
+            rbSpscItem_t xNewItem;
+
+            xNewItem.xItemSize = xItemSize;
+
+            /* Copy item header, it never rolls over. */
+            std::memcpy( ( void* )&pcBuf[ xHeadPos ], &xNewItem, sizeof( rbSpscItem_t ) );
+
+            /* Copy data, in two parts on buffer roll-over. */
+            const std::size_t xDataPos = advance( xHeadPos, sizeof( rbSpscItem_t ) );
+            const std::size_t xTopPartSize = xBufSize - xDataPos;
+
+            if( xItemSize <= xTopPartSize )
+            {
+                std::memcpy( ( void* )&pcBuf[ xDataPos ], pxItem, xItemSize );
+            }
+            else
+            {
+                std::memcpy( ( void* )&pcBuf[ xDataPos ], pxItem, xTopPartSize );
+                std::memcpy( ( void* )pcBuf, ( const std::uint8_t* )pxItem + xTopPartSize, xItemSize - xTopPartSize );
+            }
+
+            /* Count before publishing, so the count never goes below zero. */
+            pxCtrl->xPushCnt.store( pxCtrl->xPushCnt.load( std::memory_order_relaxed ) + 1, std::memory_order_release );
+
+            /* Publish the item to the consumer. */
+            pxCtrl->xHead.store( advance( xHeadPos, xItemSpan ), std::memory_order_release );
+
+            notify( &pxCtrl->ulDataWaiter );
+
+            isItemPushed = true;
+        }
+        else
+        {
+            pxCtrl->xRejectedItems.store( pxCtrl->xRejectedItems.load( std::memory_order_relaxed ) + 1, std::memory_order_relaxed );
+            pxCtrl->xRejectedBytes.store( pxCtrl->xRejectedBytes.load( std::memory_order_relaxed ) + xItemSize, std::memory_order_relaxed );
+        }
+    }
+
+    return isItemPushed;
+}
+
+/**
+ * @brief Waits until the consumer freed enough space for an item.
+ *
+ * @note Producer side. Spins on the tail index first, for a number of
+ *       checks adapted to how long the previous waits lasted, then sleeps
+ *       until deleteTail(), consume() or drain() wake it up.
+ *
+ * @param[in] xItemSize Size of the item to insert.
+ * @param[in] ulWaitUs Maximum wait [us].
+ * @param[out] True when push() of such an item will not fail.
+ *
+ */
+
+bool ringbuf_spsc::waitForSpace( const std::size_t xItemSize,
+                                 const std::uint32_t ulWaitUs )
+{
+    bool isSpaceReady = false;
+
+    if( isItemSizeValid( xItemSize ) )
+    {
+        const std::size_t xItemSpan = getItemSpan( xItemSize );
+        const std::chrono::steady_clock::time_point xDeadline = std::chrono::steady_clock::now()
+                                                              + std::chrono::microseconds( ulWaitUs );
+        std::chrono::steady_clock::time_point xNow;
+        std::uint32_t ulCheckCnt = 0;
+
+        isSpaceReady = hasSpace( xItemSpan );
+
+        if( !isSpaceReady )
+        {
+            while( !isSpaceReady && ( ulCheckCnt < ulSpaceSpinCnt ) )
+            {
+                ++ulCheckCnt;
+                isSpaceReady = hasSpace( xItemSpan );
+            }
+
+            ulSpaceSpinCnt = isSpaceReady ? std::min( ( ulSpaceSpinCnt * 2U ), ulSpinMax ) 
+                                          : std::max( ( ulSpaceSpinCnt / 2U ), ulSpinMin );
+        }
+
+        while( !isSpaceReady && ( ( xNow = std::chrono::steady_clock::now() ) < xDeadline ) )
+        {
+            pxCtrl->ulSpaceWaiter.store( 1U, std::memory_order_relaxed );
+
+            /* Pairs with the fence of notify(). */
+            std::atomic_thread_fence( std::memory_order_seq_cst );
+
+            isSpaceReady = hasSpace( xItemSpan );
+
+            if( !isSpaceReady )
+            {
+                park( &pxCtrl->ulSpaceWaiter, ( std::uint32_t )std::chrono::duration_cast<std::chrono::microseconds>( xDeadline - xNow ).count() + 1U );
+
+                isSpaceReady = hasSpace( xItemSpan );
+            }
+
+            pxCtrl->ulSpaceWaiter.store( 0, std::memory_order_relaxed );
+        }
+    }
+
+    return isSpaceReady;
+}
+
+/**
+ * @brief Discards all data in the ring buffer.
+ *
+ * @note Consumer side. Items pushed concurrently may be retained.
+ *
+ */
+
+void ringbuf_spsc::flush( void )
+{
+    while( deleteTail() )
+    {
+    }
+}
+
+/**
+ * @brief Checks whether the ring buffer is empty.
+ *
+ * @note Consumer side.
+ *
+ * @param[out] True when empty.
+ *
+ */
+
+bool ringbuf_spsc::isEmpty( void )
+{
+    return !loadHead();
+}
+
+/**
+ * @brief Waits until the ring buffer is not empty.
+ *
+ * @note Consumer side. Spins on the head index first, for a number of
+ *       checks adapted to how long the previous waits lasted, then sleeps
+ *       until push() wakes it up.
+ *
+ * @param[in] ulWaitUs Maximum wait [us].
+ * @param[out] True when the tail holds an item.
+ *
+ */
+
+bool ringbuf_spsc::waitForData( const std::uint32_t ulWaitUs )
+{
+    const std::chrono::steady_clock::time_point xDeadline = std::chrono::steady_clock::now()
+                                                          + std::chrono::microseconds( ulWaitUs );
+    std::chrono::steady_clock::time_point xNow;
+    std::uint32_t ulCheckCnt = 0;
+
+    bool isDataReady = loadHead();
+
+    if( !isDataReady )
+    {
+        while( !isDataReady && ( ulCheckCnt < ulDataSpinCnt ) )
+        {
+            ++ulCheckCnt;
+            isDataReady = loadHead();
+        }
+
+        ulDataSpinCnt = isDataReady ? std::min( ( ulDataSpinCnt * 2U ), ulSpinMax ) 
+                                    : std::max( ( ulDataSpinCnt / 2U ), ulSpinMin );
+    }
+
+    while( !isDataReady && ( ( xNow = std::chrono::steady_clock::now() ) < xDeadline ) )
+    {
+        pxCtrl->ulDataWaiter.store( 1U, std::memory_order_relaxed );
+
+        /* Pairs with the fence of notify(). */
+        std::atomic_thread_fence( std::memory_order_seq_cst );
+
+        isDataReady = loadHead();
+
+        if( !isDataReady )
+        {
+            park( &pxCtrl->ulDataWaiter, ( std::uint32_t )std::chrono::duration_cast<std::chrono::microseconds>( xDeadline - xNow ).count() + 1U );
+
+            isDataReady = loadHead();
+        }
+
+        pxCtrl->ulDataWaiter.store( 0, std::memory_order_relaxed );
+    }
+
+    return isDataReady;
+}
+
+/**
+ * @brief Deletes the tail (oldest item) of the ring buffer.
+ *
+ * @note Consumer side. The space is handed back to the producer.
+ *       A tail with a corrupted header cannot be skipped and is kept.
+ *
+ * @param[out] True when the tail is successfully deleted.
+ *
+ */
+
+bool ringbuf_spsc::deleteTail( void )
+{
+    bool isTailDeleted = false;
+
+    if( loadHead() )
+    {
+        const std::size_t xTailPos = pxCtrl->xTail.load( std::memory_order_relaxed );
+        const std::size_t xItemSize = getItemSize( xTailPos );
+
+        if( xItemSize > 0 )
+        {
+            pxCtrl->xPopCnt.store( pxCtrl->xPopCnt.load( std::memory_order_relaxed ) + 1, std::memory_order_release );
+
+            /* Release the space to the producer. */
+            pxCtrl->xTail.store( advance( xTailPos, getItemSpan( xItemSize ) ), std::memory_order_release );
+
+            notify( &pxCtrl->ulSpaceWaiter );
+
+            isTailDeleted = true;
+        }
+    }
+
+    return isTailDeleted;
+}
+
+/**
+ * @brief Copies data of the tail (oldest item) into the destination buffer.
+ *
+ * @note Consumer side. The item is not removed, use deleteTail().
+ *
+ * @param[in] pcDstBuf Destination buffer, at least getTailSize() [byte].
+ * @param[out] True when data successfully copied.
+ *
+ */
+
+bool ringbuf_spsc::getData( std::uint8_t* pcDstBuf )
+{
+    bool isDataCopied = false;
+
+    rbConstSpan_t axSpans[ 2 ];
+
+    if( peek( axSpans ) )
+    {
+        std::memcpy( pcDstBuf, axSpans[ 0 ].pcData, axSpans[ 0 ].xSize );
+        std::memcpy( pcDstBuf + axSpans[ 0 ].xSize, axSpans[ 1 ].pcData, axSpans[ 1 ].xSize );
+
+        isDataCopied = true;
+    }
+
+    return isDataCopied;
+}
+
+/**
+ * @brief Gets the parts of the memory pool holding data of the tail
+ *        (oldest item), so that it can be accessed in place.
+ *
+ * @note Consumer side. Spans stay valid until the tail is released
+ *       with consume() or deleteTail().
+ *
+ * @param[in] pxSpans Array of two spans filled with the read-only parts of
+ *            the tail data; the second part has size zero unless data rolls
+ *            over the end of the memory pool.
+ * @param[out] True when the ring buffer is not empty and the tail
+ *             header is valid.
+ *
+ */
+
+bool ringbuf_spsc::peek( rbConstSpan_t* pxSpans )
+{
+    bool isDataPeeked = false;
+
+    if( loadHead() )
+    {
+        isDataPeeked = ( getSpans( pxCtrl->xTail.load( std::memory_order_relaxed ), pxSpans ) > 0 );
+    }
+
+    return isDataPeeked;
+}
+
+/**
+ * @brief Releases the tail (oldest item) once its data, accessed by
+ *        peek(), is not needed anymore.
+ *
+ * @note Consumer side.
+ *
+ * @param[out] True when the tail is successfully released.
+ *
+ */
+
+bool ringbuf_spsc::consume( void )
+{
+    return deleteTail();
+}
+
+/**
+ * @brief Hands the data of the oldest items to a callback and then releases
+ *        all of them to the producer with a single tail update.
+ *
+ * @note Consumer side. Draining stops at an item with a corrupted header.
+ *
+ * @param[in] pxCallback Function called for each item, from the tail on.
+ * @param[in] pvContext User context passed to the callback.
+ * @param[in] xMaxItems Maximum number of items to remove.
+ * @param[in] xMaxBytes Maximum amount of data [byte] to remove; the item
+ *            that would exceed it is not handed out.
+ * @param[out] Number of items removed.
+ *
+ */
+
+std::size_t ringbuf_spsc::drain( rbDrainCallback_t pxCallback,
+                                 void* pvContext,
+                                 const std::size_t xMaxItems,
+                                 const std::size_t xMaxBytes )
+{
+    std::size_t xDrainedCnt = 0;
+    std::size_t xDrainedSize = 0;
+    bool isDraining = true;
+
+    std::size_t xTailPos = pxCtrl->xTail.load( std::memory_order_relaxed );
+    rbConstSpan_t axSpans[ 2 ];
+
+    /* One look at the head for the whole batch. */
+    xHeadCache = pxCtrl->xHead.load( std::memory_order_acquire );
+
+    while( isDraining && ( xTailPos != xHeadCache ) && ( xDrainedCnt < xMaxItems ) )
+    {
+        const std::size_t xItemSize = getSpans( xTailPos, axSpans );
+
+        isDraining =    ( xItemSize > 0 ) \
+                     && ( ( xDrainedSize + xItemSize ) <= xMaxBytes ) \
+                     && pxCallback( axSpans, pvContext );
+
+        if( isDraining )
+        {
+            ++xDrainedCnt;
+            xDrainedSize += xItemSize;
+
+            xTailPos = advance( xTailPos, getItemSpan( xItemSize ) );
+        }
+    }
+
+    if( xDrainedCnt > 0 )
+    {
+        pxCtrl->xPopCnt.store( pxCtrl->xPopCnt.load( std::memory_order_relaxed ) + xDrainedCnt, std::memory_order_release );
+
+        /* Release the space of all drained items to the producer. */
+        pxCtrl->xTail.store( xTailPos, std::memory_order_release );
+
+        notify( &pxCtrl->ulSpaceWaiter );
+    }
+
+    return xDrainedCnt;
+}
+
+/**
+ * @brief Gets the size of data in the tail of the ring buffer.
+ *
+ * @note Consumer side.
+ *
+ * @param[out] Tail data size, zero when empty or when the
+ *             tail header is not valid.
+ *
+ */
+
+const std::size_t ringbuf_spsc::getTailSize( void )
+{
+    std::size_t xTailSize = 0;
+
+    if( loadHead() )
+    {
+        xTailSize = getItemSize( pxCtrl->xTail.load( std::memory_order_relaxed ) );
+    }
+
+    return xTailSize;
+}
+
+/**
+ * @brief Gets the number of items present in the ring buffer.
+ *
+ * @note Any side. With both sides running the value is a snapshot
+ *       and may count an item still being pushed.
+ *
+ * @param[out] Items count.
+ *
+ */
+
+const std::size_t ringbuf_spsc::getItemsCnt( void )
+{
+    /* Read deletions first: the push count can only be larger. */
+    const std::size_t xPopped = pxCtrl->xPopCnt.load( std::memory_order_acquire );
+
+    return pxCtrl->xPushCnt.load( std::memory_order_acquire ) - xPopped;
+}
+
+/**
+ * @brief Gets the number of items and bytes lost because of lack of space.
+ *
+ * @note Any side. Items are never evicted, only rejected.
+ *
+ * @param[out] Counters since the ring buffer was created.
+ *
+ */
+
+rbStats_t ringbuf_spsc::getStats( void )
+{
+    rbStats_t xStats;
+
+    xStats.xEvictedItems = 0;
+    xStats.xEvictedBytes = 0;
+    xStats.xRejectedItems = pxCtrl->xRejectedItems.load( std::memory_order_relaxed );
+    xStats.xRejectedBytes = pxCtrl->xRejectedBytes.load( std::memory_order_relaxed );
+
+    return xStats;
+}
+
+/*---------------------------------------------------------------------------*/
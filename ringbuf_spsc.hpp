@@ -0,0 +1,187 @@
+/**
+ * \file            ringbuf_spsc.hpp
+ * \brief           Lock-free single-producer/single-consumer ring buffer
+ *                  to store data of different size.
+ */
+
+/*
+ * Copyright (C) 2021 Giancarlo Marcolin
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without restriction,
+ * including without limitation the rights to use, copy, modify, merge,
+ * publish, distribute, sublicense, and/or sell copies of the Software,
+ * and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE
+ * AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * This file is part of ringbuf - Ring buffer for variable size elements.
+ *
+ * Author:          Giancarlo Marcolin <giancarlo.marcolin@gmail.com>
+ * Version:         v1.0.0
+ */
+
+#ifndef C_RING_BUF_SPSC_HPP
+#define C_RING_BUF_SPSC_HPP
+
+
+#include <atomic>
+#include <cstdint>
+#include <cstddef>
+
+#include "ringbuf.hpp"
+
+/**
+ * @ingroup ringbuf_struct_types
+ * @brief Header stored in front of every item of a ringbuf_spsc.
+ *
+ * @note Items are laid out one after the other, so the position of
+ *       the next item is implicit and no pointers are stored.
+ */
+
+struct rbSpscItem {
+    std::size_t xItemSize;  /**< Size [byte] of the item data. */
+  };
+
+typedef struct rbSpscItem rbSpscItem_t;
+
+/**
+ * @ingroup ringbuf_struct_types
+ * @brief State of a ringbuf_spsc shared by the producer and the consumer.
+ *
+ * @note The producer only writes its cache line and the consumer only
+ *       writes its own. Only offsets are stored, so ringbuf_shm can
+ *       place the control block in a region shared between processes.
+ */
+
+struct rbSpscCtrl {
+    /* Producer cache line. */
+    alignas( RINGBUF_CACHE_LINE_SIZE )
+    std::atomic<std::size_t> xHead;         /**< Offset where the next item is written. */
+    std::atomic<std::size_t> xPushCnt;      /**< Number of items pushed so far. */
+    std::atomic<std::size_t> xRejectedItems;    /**< New items not inserted. */
+    std::atomic<std::size_t> xRejectedBytes;    /**< Data [byte] of the new items not inserted. */
+    std::atomic<std::uint32_t> ulDataWaiter;    /**< Non-zero while the consumer sleeps in waitForData(). */
+
+    /* Consumer cache line. */
+    alignas( RINGBUF_CACHE_LINE_SIZE )
+    std::atomic<std::size_t> xTail;         /**< Offset of the oldest item retained. */
+    std::atomic<std::size_t> xPopCnt;       /**< Number of items deleted so far. */
+    std::atomic<std::uint32_t> ulSpaceWaiter;   /**< Non-zero while the producer sleeps in waitForSpace(). */
+  };
+
+typedef struct rbSpscCtrl rbSpscCtrl_t;
+
+/**
+ * @class ringbuf_spsc
+ *
+ * @brief Ring buffer safe for exactly one producer thread and one
+ *        consumer thread running concurrently, without locks.
+ *
+ * @note The producer only writes the head index and the consumer only
+ *       writes the tail index, each on its own cache line. push() never
+ *       evicts items: it returns false when the buffer is full, or waits
+ *       for the consumer with RB_OVERFLOW_BLOCK.
+ *       push(), setOverflowPolicy() and waitForSpace() belong to the
+ *       producer thread, every other method (except getItemsCnt() and
+ *       getStats()) to the consumer thread.
+ *
+ * @note A side waiting for the other one spins for a while, then sleeps
+ *       (on a futex on Linux). The other side makes a syscall to wake it
+ *       up only when it is actually sleeping.
+ *
+ * @note The shared state lives in a rbSpscCtrl_t: the instance's own, or
+ *       the one in a shared memory region for ringbuf_shm.
+ *
+ * @note The instance is over-aligned: allocate it statically, on the
+ *       stack or with an aligned allocator.
+ */
+
+class ringbuf_spsc {
+
+  private:
+    rbSpscCtrl_t* const pxCtrl;   /**< Shared state: xCtrl, or the control block given by ringbuf_shm. */
+    std::uint8_t* const pcBuf;    /**< Pointer to the memory where the ringbuf_spsc instance is implemented. */
+    const std::size_t xBufSize;   /**< Size of the memory in [byte], multiple of the item header size. */
+    const bool isProcessShared;   /**< True when the control block is shared between processes. */
+
+    /* Producer local data. */
+    alignas( RINGBUF_CACHE_LINE_SIZE )
+    std::size_t xTailCache;             /**< Last tail offset seen by the producer. */
+    rbOverflow_t eOverflow;             /**< Behaviour when there is not enough space. */
+    std::uint32_t ulTimeoutUs;          /**< Maximum wait [us] with RB_OVERFLOW_BLOCK. */
+    std::uint32_t ulSpaceSpinCnt;       /**< Checks of the tail index before sleeping, adapted at each wait. */
+
+    /* Consumer local data. */
+    alignas( RINGBUF_CACHE_LINE_SIZE )
+    std::size_t xHeadCache;             /**< Last head offset seen by the consumer. */
+    std::uint32_t ulDataSpinCnt;        /**< Checks of the head index before sleeping, adapted at each wait. */
+
+    rbSpscCtrl_t xCtrl;                 /**< Control block used when none is given. */
+
+    /* Private methods. */
+    std::size_t getItemSpan( const std::size_t xItemSize ) const;
+    std::size_t getFreeSpace( const std::size_t xHeadPos, const std::size_t xTailPos ) const;
+    std::size_t advance( const std::size_t xPos, const std::size_t xSpan ) const;
+    bool isItemSizeValid( const std::size_t xItemSize ) const;
+    std::size_t getItemSize( const std::size_t xPos ) const;
+    std::size_t getSpans( const std::size_t xPos, rbConstSpan_t* pxSpans ) const;
+    bool loadHead( void );
+    bool hasSpace( const std::size_t xItemSpan );
+    void park( std::atomic<std::uint32_t>* pulWaiter, const std::uint32_t ulWaitUs );
+    void notify( std::atomic<std::uint32_t>* pulWaiter );
+
+  protected:
+
+    ringbuf_spsc( rbSpscCtrl_t* pxSharedCtrl, std::uint8_t* pcPool, const std::size_t xPoolSize );
+
+  public:
+
+    ringbuf_spsc( std::uint8_t* pcPool, const std::size_t xPoolSize );
+
+    /* Producer side. */
+    bool setOverflowPolicy( const rbOverflow_t eOverflowPolicy, const std::uint32_t ulWaitUs = 0 );
+
+    bool push( const void* pxItem, const std::size_t xItemSize );
+
+    bool waitForSpace( const std::size_t xItemSize, const std::uint32_t ulWaitUs );
+
+    /* Consumer side. */
+    void flush( void );
+
+    bool isEmpty( void );
+
+    bool waitForData( const std::uint32_t ulWaitUs );
+
+    bool deleteTail( void );
+
+    bool getData( std::uint8_t* pcDstBuf );
+
+    bool peek( rbConstSpan_t* pxSpans );
+
+    bool consume( void );
+
+    std::size_t drain( rbDrainCallback_t pxCallback, void* pvContext, const std::size_t xMaxItems, const std::size_t xMaxBytes );
+
+    const std::size_t getTailSize( void );
+
+    /* Any side. */
+    const std::size_t getItemsCnt( void );
+
+    rbStats_t getStats( void );
+};
+
+
+#endif //C_RING_BUF_SPSC_HPP
@@ -0,0 +1,571 @@
+/**
+ * \file            static_ringbuf.hpp
+ * \brief           Ring buffer for variable size elements with
+ *                  a compile-time capacity and embedded storage.
+ */
+
+/*
+ * Copyright (C) 2021 Giancarlo Marcolin
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without restriction,
+ * including without limitation the rights to use, copy, modify, merge,
+ * publish, distribute, sublicense, and/or sell copies of the Software,
+ * and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE
+ * AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * This file is part of ringbuf - Ring buffer for variable size elements.
+ *
+ * Author:          Giancarlo Marcolin <giancarlo.marcolin@gmail.com>
+ * Version:         v1.0.0
+ */
+
+
+#ifndef C_STATIC_RING_BUF_HPP
+#define C_STATIC_RING_BUF_HPP
+
+
+#include <array>
+#include <cstdint>
+#include <cstddef>
+#include <cstring>
+
+#include "ringbuf.hpp"
+
+/**
+ * @class static_ringbuf
+ *
+ * @brief Ring buffer of N bytes embedded in the instance, storing items of
+ *        different size.
+ *
+ * @note The capacity is a compile-time constant, so the bounds and the wrap
+ *       around of the offsets are folded by the compiler (into a mask when
+ *       N is a power of two). The constructor is constexpr: a static
+ *       instance is initialized at compile time, before any constructor of
+ *       the program runs.
+ *
+ * @note Items are laid out one after the other as in ringbuf_spsc: each one
+ *       takes a size_t header plus its data rounded up to a multiple of
+ *       size_t, and data rolling over the end of the storage is split in two
+ *       parts. Items are read and deleted from the tail; push() deletes the
+ *       oldest items when there is not enough space (RB_OVERFLOW_OVERWRITE).
+ */
+
+template< std::size_t N >
+class static_ringbuf {
+
+    static_assert( ( N > 0 ) && ( ( N % sizeof( std::size_t ) ) == 0 ), "static_ringbuf size shall be a multiple of sizeof( size_t )." );
+
+  private:
+    alignas( std::size_t )
+    std::array<std::uint8_t, N> axPool;  /**< Memory where items are stored. */
+    rbOverflow_t eOverflow;       /**< Behaviour when there is not enough space. */
+    rbStats_t xStats;             /**< Counters of data lost because of lack of space. */
+    std::size_t xHead;            /**< Offset where the next item is written. */
+    std::size_t xTail;            /**< Offset of the oldest item retained. */
+    std::size_t xUsedSize;        /**< Space [byte] taken by the items retained. */
+    std::size_t xTotItemCnt;      /**< Number of element present in the buffer. */
+    std::size_t xHeadSize;        /**< Size of data in the head. */
+
+    static std::size_t getItemSpan( const std::size_t xItemSize );
+    static std::size_t advance( const std::size_t xPos, const std::size_t xSpan );
+    std::size_t getSpans( const std::size_t xPos, rbConstSpan_t* pxSpans ) const;
+    void evictTail( void );
+
+  public:
+
+    constexpr static_ringbuf( void ) : 
+                              axPool(), 
+                              eOverflow( RB_OVERFLOW_OVERWRITE ), 
+                              xStats(), 
+                              xHead( 0 ), 
+                              xTail( 0 ), 
+                              xUsedSize( 0 ), 
+                              xTotItemCnt( 0 ), 
+                              xHeadSize( 0 )
+    {
+    }
+
+    void flush( void );
+
+    bool setOverflowPolicy( const rbOverflow_t eOverflowPolicy );
+
+    rbStats_t getStats( void );
+
+    bool push( const void* pxItem, const std::size_t xItemSize );
+
+    bool isEmpty( void );
+
+    bool deleteTail( void );
+
+    bool getData( std::uint8_t* pcDstBuf );
+
+    bool peek( rbConstSpan_t* pxSpans );
+
+    bool consume( void );
+
+    std::size_t drain( rbDrainCallback_t pxCallback, void* pvContext, const std::size_t xMaxItems, const std::size_t xMaxBytes );
+
+    const std::size_t getHeadSize( void );
+
+    const std::size_t getTailSize( void );
+
+    const std::size_t getItemsCnt( void );
+
+    static constexpr std::size_t getCapacity( void ) { return N; }
+};
+
+/*--------------------- Private methods ---------------------*/
+
+/**
+ * @brief Gets the space taken by an item in the storage.
+ *
+ * @note Private method.
+ *
+ * @param[in] xItemSize Size [byte] of the item data.
+ * @param[out] Header plus data, rounded up to a multiple of the header size.
+ *
+ */
+
+template< std::size_t N >
+std::size_t static_ringbuf<N>::getItemSpan( const std::size_t xItemSize )
+{
+    return sizeof( std::size_t ) + ( ( xItemSize + sizeof( std::size_t ) - 1 ) & ~( sizeof( std::size_t ) - 1 ) );
+}
+
+/**
+ * @brief Moves an offset forward, wrapping around the end of the storage.
+ *
+ * @note Private method. With N a power of two the wrap is a mask.
+ *
+ * @param[in] xPos Offset to move, less than N.
+ * @param[in] xSpan Distance [byte], not more than N.
+ * @param[out] New offset.
+ *
+ */
+
+template< std::size_t N >
+std::size_t static_ringbuf<N>::advance( const std::size_t xPos, 
+                                        const std::size_t xSpan )
+{
+    std::size_t xNewPos = xPos + xSpan;
+
+    if( ( N & ( N - 1 ) ) == 0 )
+    {
+        xNewPos &= ( N - 1 );
+    }
+    else if( xNewPos >= N )
+    {
+        xNewPos -= N;
+    }
+
+    return xNewPos;
+}
+
+/**
+ * @brief Identifies the parts of the storage holding the data of an item.
+ *
+ * @note Private method.
+ *
+ * @param[in] xPos Offset of the item header.
+ * @param[in] pxSpans Array of two spans filled with the data parts; the
+ *            second part has size zero unless data rolls over.
+ * @param[out] Size [byte] of the item data.
+ *
+ */
+
+template< std::size_t N >
+std::size_t static_ringbuf<N>::getSpans( const std::size_t xPos, 
+                                         rbConstSpan_t* pxSpans ) const
+{
+    std::size_t xItemSize;
+
+    std::memcpy( &xItemSize, &axPool[ xPos ], sizeof( std::size_t ) );
+
+    const std::size_t xDataPos = advance( xPos, sizeof( std::size_t ) );
+    const std::size_t xTopPartSize = N - xDataPos;
+
+    pxSpans[ 0 ].pcData = &axPool[ xDataPos ];
+    pxSpans[ 1 ].pcData = axPool.data();
+
+    if( xItemSize <= xTopPartSize )
+    {
+        pxSpans[ 0 ].xSize = xItemSize;
+        pxSpans[ 1 ].xSize = 0;
+    }
+    else
+    {
+        /* Data rolls over. */
+        pxSpans[ 0 ].xSize = xTopPartSize;
+        pxSpans[ 1 ].xSize = xItemSize - xTopPartSize;
+    }
+
+    return xItemSize;
+}
+
+/**
+ * @brief Deletes the tail to make room for a new item.
+ *
+ * @note Private method.
+ *
+ */
+
+template< std::size_t N >
+void static_ringbuf<N>::evictTail( void )
+{
+    ++xStats.xEvictedItems;
+    xStats.xEvictedBytes += getTailSize();
+
+    deleteTail();
+}
+
+/*--------------------- Public methods ---------------------*/
+
+/**
+ * @brief Deletes all the elements of the ring buffer.
+ *
+ */
+
+template< std::size_t N >
+void static_ringbuf<N>::flush( void ) 
+{
+    xHead = 0;
+    xTail = 0;
+    xUsedSize = 0;
+    xTotItemCnt = 0;
+    xHeadSize = 0;
+}
+
+/**
+ * @brief Selects what push() does when there is not enough space.
+ *
+ * @note RB_OVERFLOW_BLOCK needs a concurrent consumer and is not
+ *       supported by this class.
+ *
+ * @param[in] eOverflowPolicy RB_OVERFLOW_OVERWRITE (default) to delete
+ *            the oldest items, RB_OVERFLOW_REJECT to fail the insertion.
+ * @param[out] True when the policy is supported.
+ *
+ */
+
+template< std::size_t N >
+bool static_ringbuf<N>::setOverflowPolicy( const rbOverflow_t eOverflowPolicy ) 
+{
+    bool isPolicySet = false;
+
+    if( eOverflowPolicy != RB_OVERFLOW_BLOCK )
+    {
+        eOverflow = eOverflowPolicy;
+
+        isPolicySet = true;
+    }
+
+    return isPolicySet;
+}
+
+/**
+ * @brief Gets the number of items and bytes lost because of lack of space.
+ *
+ * @param[out] Counters since the ring buffer was created.
+ *
+ */
+
+template< std::size_t N >
+rbStats_t static_ringbuf<N>::getStats( void ) 
+{
+    return xStats;
+}
+
+/**
+ * @brief Inserts a new item in the ring buffer.
+ *
+ * @param[in] pxItem Pointer to the item data.
+ * @param[in] xItemSize Size of the item data; header plus data shall fit in N.
+ * @param[out] True when item successfully inserted.
+ *
+ */
+
+template< std::size_t N >
+bool static_ringbuf<N>::push( const void* pxItem, 
+                              const std::size_t xItemSize ) 
+{
+    bool isItemPushed = false;
+
+    if( ( xItemSize > 0 ) && ( xItemSize <= ( N - sizeof( std::size_t ) ) ) )
+    {
+        const std::size_t xItemSpan = getItemSpan( xItemSize );
+
+        if( ( eOverflow == RB_OVERFLOW_REJECT ) && ( ( N - xUsedSize ) < xItemSpan ) )
+        {
+            /* Old items shall not be removed. */
+            ++xStats.xRejectedItems;
+            xStats.xRejectedBytes += xItemSize;
+        }
+        else
+        {
+            /* Remove old items if space is not enough. */
+            while( ( N - xUsedSize ) < xItemSpan )
+            {
+                evictTail();
+            }
+
+            std::memcpy( &axPool[ xHead ], &xItemSize, sizeof( std::size_t ) );
+
+            const std::size_t xDataPos = advance( xHead, sizeof( std::size_t ) );
+            const std::size_t xTopPartSize = N - xDataPos;
+
+            if( xItemSize <= xTopPartSize )
+            {
+                std::memcpy( &axPool[ xDataPos ], pxItem, xItemSize );
+            }
+            else
+            {
+                /* Data rolls over. */
+                std::memcpy( &axPool[ xDataPos ], pxItem, xTopPartSize );
+                std::memcpy( axPool.data(), ( const std::uint8_t* )pxItem + xTopPartSize, xItemSize - xTopPartSize );
+            }
+
+            xHead = advance( xHead, xItemSpan );
+            xUsedSize += xItemSpan;
+            ++xTotItemCnt;
+            xHeadSize = xItemSize;
+
+            isItemPushed = true;
+        }
+    }
+
+    return isItemPushed;
+}
+
+/**
+ * @brief Checks whether the ring buffer is empty.
+ *
+ * @param[out] True when empty.
+ *
+ */
+
+template< std::size_t N >
+bool static_ringbuf<N>::isEmpty( void ) 
+{
+    return ( xTotItemCnt == 0 );
+}
+
+/**
+ * @brief Deletes the tail (oldest item) of the ring buffer.
+ *
+ * @param[out] True when the tail is successfully deleted.
+ *
+ */
+
+template< std::size_t N >
+bool static_ringbuf<N>::deleteTail( void ) 
+{
+    bool isTailDeleted = false;
+
+    if( xTotItemCnt > 0 )
+    {
+        const std::size_t xItemSpan = getItemSpan( getTailSize() );
+
+        xTail = advance( xTail, xItemSpan );
+        xUsedSize -= xItemSpan;
+        --xTotItemCnt;
+
+        if( xTotItemCnt == 0 )
+        {
+            xHeadSize = 0;
+        }
+
+        isTailDeleted = true;
+    }
+
+    return isTailDeleted;
+}
+
+/**
+ * @brief Copies data of the tail (oldest item) into the destination buffer.
+ *
+ * @param[in] pcDstBuf Destination buffer where data is copied.
+ * @param[out] True when data successfully copied.
+ *
+ */
+
+template< std::size_t N >
+bool static_ringbuf<N>::getData( std::uint8_t* pcDstBuf )
+{
+    bool isDataCopied = false;
+
+    rbConstSpan_t axSpans[ 2 ];
+
+    if( peek( axSpans ) )
+    { 
+        std::memcpy( pcDstBuf, axSpans[ 0 ].pcData, axSpans[ 0 ].xSize );
+        std::memcpy( ( pcDstBuf + axSpans[ 0 ].xSize ), axSpans[ 1 ].pcData, axSpans[ 1 ].xSize );
+
+        isDataCopied = true;
+    }
+
+    return isDataCopied;
+}
+
+/**
+ * @brief Gets the parts of the storage holding data of the tail
+ *        (oldest item), so that it can be accessed in place.
+ *
+ * @note Spans stay valid until the tail is deleted or overwritten.
+ *
+ * @param[in] pxSpans Array of two spans filled with the read-only parts of
+ *            the tail data; the second part has size zero unless data rolls
+ *            over the end of the storage.
+ * @param[out] True when the ring buffer is not empty.
+ *
+ */
+
+template< std::size_t N >
+bool static_ringbuf<N>::peek( rbConstSpan_t* pxSpans )
+{
+    bool isDataPeeked = false;
+
+    if( xTotItemCnt > 0 )
+    {
+        getSpans( xTail, pxSpans );
+
+        isDataPeeked = true;
+    }
+
+    return isDataPeeked;
+}
+
+/**
+ * @brief Releases the tail (oldest item) once its data, accessed by
+ *        peek(), is not needed anymore.
+ *
+ * @param[out] True when the tail is successfully released.
+ *
+ */
+
+template< std::size_t N >
+bool static_ringbuf<N>::consume( void ) 
+{
+    return deleteTail();
+}
+
+/**
+ * @brief Hands the data of the oldest items to a callback and then removes
+ *        all of them with a single tail update.
+ *
+ * @param[in] pxCallback Function called for each item, from the tail on.
+ * @param[in] pvContext User context passed to the callback.
+ * @param[in] xMaxItems Maximum number of items to remove.
+ * @param[in] xMaxBytes Maximum amount of data [byte] to remove; the item
+ *            that would exceed it is not handed out.
+ * @param[out] Number of items removed.
+ *
+ */
+
+template< std::size_t N >
+std::size_t static_ringbuf<N>::drain( rbDrainCallback_t pxCallback, 
+                                      void* pvContext, 
+                                      const std::size_t xMaxItems, 
+                                      const std::size_t xMaxBytes )
+{
+    std::size_t xDrainedCnt = 0;
+    std::size_t xDrainedSize = 0;
+    std::size_t xDrainedSpan = 0;
+    bool isDraining = true;
+
+    std::size_t xTailPos = xTail;
+    rbConstSpan_t axSpans[ 2 ];
+
+    while( isDraining && ( xDrainedCnt < xTotItemCnt ) && ( xDrainedCnt < xMaxItems ) )
+    {
+        const std::size_t xItemSize = getSpans( xTailPos, axSpans );
+
+        isDraining =    ( ( xDrainedSize + xItemSize ) <= xMaxBytes ) \
+                     && pxCallback( axSpans, pvContext );
+
+        if( isDraining )
+        {
+            ++xDrainedCnt;
+            xDrainedSize += xItemSize;
+            xDrainedSpan += getItemSpan( xItemSize );
+
+            xTailPos = advance( xTailPos, getItemSpan( xItemSize ) );
+        }
+    }
+
+    /* Remove all drained items at once. */
+    xTail = xTailPos;
+    xUsedSize -= xDrainedSpan;
+    xTotItemCnt -= xDrainedCnt;
+
+    if( xTotItemCnt == 0 )
+    {
+        xHeadSize = 0;
+    }
+
+    return xDrainedCnt;
+}
+
+/**
+ * @brief Gets the size of data in the head of the ring buffer.
+ *
+ * @param[out] Head size, zero when empty.
+ *
+ */
+
+template< std::size_t N >
+const std::size_t static_ringbuf<N>::getHeadSize( void ) 
+{
+    return xHeadSize;
+}
+
+/**
+ * @brief Gets the size of data in the tail of the ring buffer.
+ *
+ * @param[out] Tail size, zero when empty.
+ *
+ */
+
+template< std::size_t N >
+const std::size_t static_ringbuf<N>::getTailSize( void ) 
+{
+    std::size_t xItemSize = 0;
+
+    if( xTotItemCnt > 0 )
+    {
+        std::memcpy( &xItemSize, &axPool[ xTail ], sizeof( std::size_t ) );
+    }
+
+    return xItemSize;
+}
+
+/**
+ * @brief Gets the number of items present in the ring buffer.
+ *
+ * @param[out] Items count.
+ *
+ */
+
+template< std::size_t N >
+const std::size_t static_ringbuf<N>::getItemsCnt( void ) 
+{
+    return xTotItemCnt;
+}
+
+/*---------------------------------------------------------------------------*/
+
+
+#endif //C_STATIC_RING_BUF_HPP
@@ -0,0 +1,329 @@
+/*
+ * rbdump - dumps the items of a ring buffer image (see ringbuf::mapImage())
+ *          from the oldest to the most recent.
+ *
+ * Usage: rbdump [-f raw|hex|len] [-o output] [-s offset] [-i] image
+ *
+ *   -f  output format: "len" (default) prefixes every payload with its size
+ *       as a 32-bit little-endian number, "raw" writes payloads back to back,
+ *       "hex" writes one line per item: index, size and hex payload
+ *   -o  output file, standard output by default
+ *   -s  offset [byte] of the image in the file, e.g. a core dump extract
+ *   -i  only check the image and print its header
+ *
+ * The file is mapped privately, so recovering the items never modifies it.
+ * Compressed items (see ringbuf::setCompression()) are dumped decompressed,
+ * deltas of numeric samples (see ringbuf::pushDelta()) as stored.
+ * Build with the same RINGBUF_CFG_... options as the program writing the image.
+ *
+ * Exit status: 0 image dumped, 1 usage or I/O error, 2 image not valid
+ *              (including a compressed item that does not decode).
+ */
+
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "ringbuf.hpp"
+
+/* Output formats. */
+typedef enum {
+	DUMP_FORMAT_LEN,
+	DUMP_FORMAT_RAW,
+	DUMP_FORMAT_HEX
+} dumpFormat_t;
+
+/* Build options of this tool, as recorded in the images it can read. */
+static constexpr std::uint32_t ulToolFlags = ( ( RINGBUF_CFG_COMPACT_HEADER == 1 ) ? RB_IMAGE_FLAG_COMPACT : 0U )
+                                           | ( ( RINGBUF_CFG_ITEM_SEQUENCE == 1 ) ? RB_IMAGE_FLAG_SEQUENCE : 0U )
+                                           | ( ( RINGBUF_CFG_ITEM_TIMESTAMP == 1 ) ? RB_IMAGE_FLAG_TIMESTAMP : 0U );
+
+/* Size of the output buffer [byte]. */
+static constexpr std::size_t xOutBufSize = 1024 * 1024;
+
+static void printUsage( void )
+{
+	std::fprintf( stderr, "usage: rbdump [-f raw|hex|len] [-o output] [-s offset] [-i] image\n" );
+}
+
+static void printHeader( const rbImage_t* pxImage )
+{
+	std::fprintf( stderr, "magic:        0x%08x\n", pxImage->ulMagic );
+	std::fprintf( stderr, "version:      %u\n", pxImage->ulVersion );
+	std::fprintf( stderr, "header size:  %u (item %u)\n", pxImage->ulHeaderSize, pxImage->ulItemHeaderSize );
+	std::fprintf( stderr, "flags:        0x%x\n", pxImage->ulFlags );
+	std::fprintf( stderr, "layout:       %u\n", pxImage->ulLayout );
+	std::fprintf( stderr, "pool size:    %llu\n", ( unsigned long long )pxImage->ullPoolSize );
+	std::fprintf( stderr, "head offset:  %llu\n", ( unsigned long long )pxImage->ullHeadOff );
+	std::fprintf( stderr, "tail offset:  %llu\n", ( unsigned long long )pxImage->ullTailOff );
+	std::fprintf( stderr, "items:        %llu\n", ( unsigned long long )pxImage->ullItemsCnt );
+	std::fprintf( stderr, "next seq:     %llu\n", ( unsigned long long )pxImage->ullNextSeq );
+}
+
+/* Explains why the header cannot be used by this tool, nullptr when it can. */
+static const char* checkHeader( const rbImage_t* pxImage, const std::size_t xImageSize )
+{
+	const char* pcError = nullptr;
+
+	if( pxImage->ulMagic != RB_IMAGE_MAGIC )
+	{
+		pcError = "not a ring buffer image";
+	}
+	else if( pxImage->ulVersion != RB_IMAGE_VERSION )
+	{
+		pcError = "unsupported image version";
+	}
+	else if( pxImage->ulFlags != ulToolFlags )
+	{
+		pcError = "image written with other RINGBUF_CFG_... options, rebuild rbdump with them";
+	}
+	else if(    ( pxImage->ulHeaderSize != sizeof( rbImage_t ) ) \
+	         || ( pxImage->ulItemHeaderSize != sizeof( rbItem_t ) )    )
+	{
+		pcError = "image written for another target";
+	}
+	else if( pxImage->ullPoolSize > ( xImageSize - sizeof( rbImage_t ) ) )
+	{
+		pcError = "image truncated";
+	}
+
+	return pcError;
+}
+
+static bool writeItem( FILE* pxOut, const dumpFormat_t eFormat, const std::size_t xIndex,
+                       const rbConstSpan_t* pxSpans )
+{
+	static const char acHexDigits[] = "0123456789abcdef";
+
+	const std::size_t xItemSize = pxSpans[ 0 ].xSize + pxSpans[ 1 ].xSize;
+	bool isWritten = true;
+
+	if( eFormat == DUMP_FORMAT_LEN )
+	{
+		const std::uint32_t ulSize = ( std::uint32_t )xItemSize;
+		const std::uint8_t acSize[ 4 ] = { ( std::uint8_t )ulSize, ( std::uint8_t )( ulSize >> 8 ),
+		                                   ( std::uint8_t )( ulSize >> 16 ), ( std::uint8_t )( ulSize >> 24 ) };
+
+		isWritten = ( std::fwrite( acSize, 1, sizeof( acSize ), pxOut ) == sizeof( acSize ) );
+	}
+	else if( eFormat == DUMP_FORMAT_HEX )
+	{
+		isWritten = ( std::fprintf( pxOut, "%zu %zu ", xIndex, xItemSize ) > 0 );
+	}
+
+	for( std::size_t i = 0; ( i < 2 ) && isWritten; ++i )
+	{
+		if( eFormat == DUMP_FORMAT_HEX )
+		{
+			for( std::size_t j = 0; ( j < pxSpans[ i ].xSize ) && isWritten; ++j )
+			{
+				isWritten =    ( std::fputc( acHexDigits[ pxSpans[ i ].pcData[ j ] >> 4 ], pxOut ) != EOF ) \
+				            && ( std::fputc( acHexDigits[ pxSpans[ i ].pcData[ j ] & 0xF ], pxOut ) != EOF );
+			}
+		}
+		else
+		{
+			/* Payload straight from the mapped image. */
+			isWritten = ( std::fwrite( pxSpans[ i ].pcData, 1, pxSpans[ i ].xSize, pxOut ) == pxSpans[ i ].xSize );
+		}
+	}
+
+	if( ( eFormat == DUMP_FORMAT_HEX ) && isWritten )
+	{
+		isWritten = ( std::fputc( '\n', pxOut ) != EOF );
+	}
+
+	return isWritten;
+}
+
+int main( int argc, char** argv )
+{
+	dumpFormat_t eFormat = DUMP_FORMAT_LEN;
+	const char* pcOutPath = nullptr;
+	std::size_t xOffset = 0;
+	bool isInfoOnly = false;
+	bool isArgValid = true;
+	int iOpt;
+
+	while( ( iOpt = getopt( argc, argv, "f:o:s:i" ) ) != -1 )
+	{
+		switch( iOpt )
+		{
+			case 'f':
+				if( std::strcmp( optarg, "len" ) == 0 )
+				{
+					eFormat = DUMP_FORMAT_LEN;
+				}
+				else if( std::strcmp( optarg, "raw" ) == 0 )
+				{
+					eFormat = DUMP_FORMAT_RAW;
+				}
+				else if( std::strcmp( optarg, "hex" ) == 0 )
+				{
+					eFormat = DUMP_FORMAT_HEX;
+				}
+				else
+				{
+					isArgValid = false;
+				}
+				break;
+
+			case 'o':
+				pcOutPath = optarg;
+				break;
+
+			case 's':
+				xOffset = ( std::size_t )std::strtoull( optarg, nullptr, 0 );
+				break;
+
+			case 'i':
+				isInfoOnly = true;
+				break;
+
+			default:
+				isArgValid = false;
+				break;
+		}
+	}
+
+	if( !isArgValid || ( optind != ( argc - 1 ) ) )
+	{
+		printUsage();
+		return 1;
+	}
+
+	const int iFd = open( argv[ optind ], O_RDONLY );
+	struct stat xStat;
+
+	if( ( iFd < 0 ) || ( fstat( iFd, &xStat ) != 0 ) )
+	{
+		std::perror( argv[ optind ] );
+		return 1;
+	}
+
+	const std::size_t xFileSize = ( std::size_t )xStat.st_size;
+
+	if(    ( xOffset >= xFileSize ) \
+	    || ( ( xFileSize - xOffset ) <= sizeof( rbImage_t ) ) \
+	    || ( ( xOffset % alignof( rbImage_t ) ) != 0 )    )
+	{
+		std::fprintf( stderr, "%s: no image at offset %zu\n", argv[ optind ], xOffset );
+		return 2;
+	}
+
+	/* Private mapping: links relocated by the recovery stay in memory. */
+	void* pvFile = mmap( nullptr, xFileSize, PROT_READ | PROT_WRITE, MAP_PRIVATE, iFd, 0 );
+
+	close( iFd );
+
+	if( pvFile == MAP_FAILED )
+	{
+		std::perror( argv[ optind ] );
+		return 1;
+	}
+
+	std::uint8_t* pcImage = ( std::uint8_t* )pvFile + xOffset;
+	const std::size_t xImageSize = xFileSize - xOffset;
+	const rbImage_t xHeader = *( const rbImage_t* )pcImage;
+
+	const char* pcError = checkHeader( &xHeader, xImageSize );
+
+	if( isInfoOnly || ( pcError != nullptr ) )
+	{
+		printHeader( &xHeader );
+	}
+
+	if( pcError != nullptr )
+	{
+		std::fprintf( stderr, "%s: %s\n", argv[ optind ], pcError );
+		return 2;
+	}
+
+	ringbuf xBuf( pcImage, xImageSize, RB_IMAGE_RECOVER );
+
+	if( !xBuf.isRecovered() )
+	{
+		std::fprintf( stderr, "%s: items chain not valid\n", argv[ optind ] );
+		return 2;
+	}
+
+	const std::size_t xItemsCnt = xBuf.getItemsCnt();
+
+	std::fprintf( stderr, "%s: %zu items (%llu recorded)\n", argv[ optind ], xItemsCnt,
+	              ( unsigned long long )xHeader.ullItemsCnt );
+
+	int iStatus = 0;
+
+	if( !isInfoOnly )
+	{
+		FILE* pxOut = ( pcOutPath != nullptr ) ? std::fopen( pcOutPath, "wb" ) : stdout;
+
+		if( pxOut == nullptr )
+		{
+			std::perror( pcOutPath );
+			return 1;
+		}
+
+		std::setvbuf( pxOut, nullptr, _IOFBF, xOutBufSize );
+
+		const rbItem_t* pxItem = xBuf.getTail();
+		rbConstSpan_t axSpans[ 2 ];
+		std::vector<std::uint8_t> xDataBuf;
+		bool isWritten = true;
+		bool isDecoded = true;
+		std::size_t i = 0;
+
+		for( ; ( i < xItemsCnt ) && isWritten && isDecoded; ++i )
+		{
+			isWritten = xBuf.peek( pxItem, axSpans );
+
+			if( isWritten && xBuf.isCompressed( pxItem ) )
+			{
+				/* Compressed items are written as they were inserted, which
+				   was smaller than the pool: larger sizes are corrupted. */
+				const std::size_t xDataSize = xBuf.getDataSize( pxItem );
+
+				isDecoded = ( xDataSize > 0 ) && ( xDataSize < xHeader.ullPoolSize );
+
+				if( isDecoded )
+				{
+					xDataBuf.resize( xDataSize );
+
+					isDecoded = xBuf.getData( pxItem, xDataBuf.data() );
+				}
+
+				axSpans[ 0 ].pcData = xDataBuf.data();
+				axSpans[ 0 ].xSize = xDataBuf.size();
+				axSpans[ 1 ].xSize = 0;
+			}
+
+			isWritten = isWritten && isDecoded && writeItem( pxOut, eFormat, i, axSpans );
+
+			pxItem = xBuf.getNext( pxItem );
+		}
+
+		const bool isClosed = ( std::fclose( pxOut ) == 0 );
+
+		if( !isDecoded )
+		{
+			std::fprintf( stderr, "%s: compressed item %zu not valid\n", argv[ optind ], i - 1 );
+			iStatus = 2;
+		}
+		else if( !isClosed || !isWritten )
+		{
+			std::perror( ( pcOutPath != nullptr ) ? pcOutPath : "stdout" );
+			iStatus = 1;
+		}
+	}
+
+	munmap( pvFile, xFileSize );
+
+	return iStatus;
+}